@@ -51,6 +51,39 @@ function(cocos_mark_multi_resources res_out)
     set(${res_out} ${tmp_file_list} PARENT_SCOPE)
 endfunction()
 
+# pack `FOLDERS` into the asset pack `OUTPUT` before building `cocos_target`, see FileUtils::mountAssetPack
+# files with an extension listed in `DEFLATE` are compressed, the others are stored
+function(cocos_add_asset_pack cocos_target)
+    set(oneValueArgs OUTPUT ROOT)
+    set(multiValueArgs FOLDERS DEFLATE)
+    cmake_parse_arguments(opt "" "${oneValueArgs}" "${multiValueArgs}" ${ARGN})
+    find_package(PythonInterp REQUIRED)
+
+    set(pack_args -o ${opt_OUTPUT})
+    if(opt_ROOT)
+        list(APPEND pack_args --root ${opt_ROOT})
+    endif()
+    if(opt_DEFLATE)
+        string(REPLACE ";" "," deflate_exts "${opt_DEFLATE}")
+        list(APPEND pack_args --deflate ${deflate_exts})
+    endif()
+
+    set(pack_depends)
+    foreach(cc_folder ${opt_FOLDERS})
+        file(GLOB_RECURSE folder_files "${cc_folder}/*")
+        list(APPEND pack_depends ${folder_files})
+    endforeach()
+
+    get_filename_component(pack_name ${opt_OUTPUT} NAME)
+    add_custom_command(OUTPUT ${opt_OUTPUT}
+        COMMAND ${PYTHON_EXECUTABLE} ${COCOS2DX_ROOT_PATH}/tools/asset-pack/pack-assets.py ${pack_args} ${opt_FOLDERS}
+        DEPENDS ${pack_depends}
+        COMMENT "pack asset pack: ${pack_name} ..."
+    )
+    add_custom_target(${cocos_target}_asset_pack_${pack_name} DEPENDS ${opt_OUTPUT})
+    add_dependencies(${cocos_target} ${cocos_target}_asset_pack_${pack_name})
+endfunction()
+
 # get all linked libraries including transitive ones, recursive
 function(search_depend_libs_recursive cocos_target all_depends_out)
     set(all_depends_inner)
@@ -74,6 +74,8 @@ void ActionInstant::update(float /*time*/)
 // Show
 //
 
+CC_DEFINE_ALLOCATOR_POOL(Show, 100)
+
 Show* Show::create() 
 {
     Show* ret = new (std::nothrow) Show();
@@ -106,6 +108,8 @@ Show* Show::clone() const
 //
 // Hide
 //
+CC_DEFINE_ALLOCATOR_POOL(Hide, 100)
+
 Hide * Hide::create() 
 {
     Hide *ret = new (std::nothrow) Hide();
@@ -170,6 +174,8 @@ ToggleVisibility * ToggleVisibility::clone() const
 //
 // Remove Self
 //
+CC_DEFINE_ALLOCATOR_POOL(RemoveSelf, 100)
+
 RemoveSelf * RemoveSelf::create(bool isNeedCleanUp /*= true*/) 
 {
     RemoveSelf *ret = new (std::nothrow) RemoveSelf();
@@ -332,6 +338,8 @@ void Place::update(float time)
 // CallFunc
 //
 
+CC_DEFINE_ALLOCATOR_POOL(CallFunc, 100)
+
 CallFunc * CallFunc::create(const std::function<void()> &func)
 {
     CallFunc *ret = new (std::nothrow) CallFunc();
@@ -434,6 +442,8 @@ void CallFunc::execute()
 // CallFuncN
 //
 
+CC_DEFINE_ALLOCATOR_POOL(CallFuncN, 100)
+
 CallFuncN * CallFuncN::create(const std::function<void(Node*)> &func)
 {
     auto ret = new (std::nothrow) CallFuncN();
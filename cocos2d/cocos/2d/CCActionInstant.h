@@ -31,6 +31,7 @@ THE SOFTWARE.
 
 #include <functional>
 #include "2d/CCAction.h"
+#include "base/allocator/CCAllocatorStrategyPool.h"
 
 NS_CC_BEGIN
 
@@ -82,6 +83,8 @@ private:
 class CC_DLL Show : public ActionInstant
 {
 public:
+    CC_DECLARE_ALLOCATOR_POOL(Show)
+
     /** Allocates and initializes the action.
      *
      * @return  An autoreleased Show object.
@@ -112,6 +115,8 @@ private:
 class CC_DLL Hide : public ActionInstant
 {
 public:
+    CC_DECLARE_ALLOCATOR_POOL(Hide)
+
     /** Allocates and initializes the action.
      *
      * @return An autoreleased Hide object.
@@ -172,6 +177,8 @@ private:
 class CC_DLL RemoveSelf : public ActionInstant
 {
 public:
+    CC_DECLARE_ALLOCATOR_POOL(RemoveSelf)
+
     /** Create the action.
      *
      * @param isNeedCleanUp Is need to clean up, the default value is true.
@@ -324,6 +331,8 @@ private:
 class CC_DLL CallFunc : public ActionInstant
 {
 public:
+    CC_DECLARE_ALLOCATOR_POOL(CallFunc)
+
     /** Creates the action with the callback of type std::function<void()>.
      This is the preferred way to create the callback.
      * When this function bound in js or lua ,the input param will be changed.
@@ -425,6 +434,8 @@ private:
 class CC_DLL CallFuncN : public CallFunc
 {
 public:
+    CC_DECLARE_ALLOCATOR_POOL(CallFuncN)
+
     /** Creates the action with the callback of type std::function<void()>.
      This is the preferred way to create the callback.
      *
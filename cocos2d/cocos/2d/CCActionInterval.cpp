@@ -164,6 +164,8 @@ void ActionInterval::startWithTarget(Node *target)
 // Sequence
 //
 
+CC_DEFINE_ALLOCATOR_POOL(Sequence, 100)
+
 Sequence* Sequence::createWithTwoActions(FiniteTimeAction *actionOne, FiniteTimeAction *actionTwo)
 {
     Sequence *sequence = new (std::nothrow) Sequence();
@@ -431,6 +433,8 @@ Sequence* Sequence::reverse() const
 // Repeat
 //
 
+CC_DEFINE_ALLOCATOR_POOL(Repeat, 100)
+
 Repeat* Repeat::create(FiniteTimeAction *action, unsigned int times)
 {
     Repeat* repeat = new (std::nothrow) Repeat();
@@ -556,6 +560,8 @@ Repeat* Repeat::reverse() const
 //
 // RepeatForever
 //
+CC_DEFINE_ALLOCATOR_POOL(RepeatForever, 100)
+
 RepeatForever::~RepeatForever()
 {
     CC_SAFE_RELEASE(_innerAction);
@@ -631,6 +637,8 @@ RepeatForever *RepeatForever::reverse() const
 // Spawn
 //
 
+CC_DEFINE_ALLOCATOR_POOL(Spawn, 100)
+
 #if (CC_TARGET_PLATFORM == CC_PLATFORM_WINRT)
 Spawn* Spawn::variadicCreate(FiniteTimeAction *action1, ...)
 {
@@ -847,6 +855,8 @@ Spawn* Spawn::reverse() const
 // RotateTo
 //
 
+CC_DEFINE_ALLOCATOR_POOL(RotateTo, 100)
+
 RotateTo* RotateTo::create(float duration, float dstAngle)
 {
     RotateTo* rotateTo = new (std::nothrow) RotateTo();
@@ -1012,6 +1022,8 @@ RotateTo *RotateTo::reverse() const
 // RotateBy
 //
 
+CC_DEFINE_ALLOCATOR_POOL(RotateBy, 100)
+
 RotateBy* RotateBy::create(float duration, float deltaAngle)
 {
     RotateBy *rotateBy = new (std::nothrow) RotateBy();
@@ -1171,6 +1183,8 @@ RotateBy* RotateBy::reverse() const
 // MoveBy
 //
 
+CC_DEFINE_ALLOCATOR_POOL(MoveBy, 100)
+
 MoveBy* MoveBy::create(float duration, const Vec2& deltaPosition)
 {
     return MoveBy::create(duration, Vec3(deltaPosition.x, deltaPosition.y, 0));
@@ -1247,6 +1261,8 @@ void MoveBy::update(float t)
 // MoveTo
 //
 
+CC_DEFINE_ALLOCATOR_POOL(MoveTo, 100)
+
 MoveTo* MoveTo::create(float duration, const Vec2& position)
 {
     return MoveTo::create(duration, Vec3(position.x, position.y, 0));
@@ -1871,6 +1887,8 @@ BezierTo* BezierTo::reverse() const
 //
 // ScaleTo
 //
+CC_DEFINE_ALLOCATOR_POOL(ScaleTo, 100)
+
 ScaleTo* ScaleTo::create(float duration, float s)
 {
     ScaleTo *scaleTo = new (std::nothrow) ScaleTo();
@@ -1989,6 +2007,8 @@ void ScaleTo::update(float time)
 // ScaleBy
 //
 
+CC_DEFINE_ALLOCATOR_POOL(ScaleBy, 100)
+
 ScaleBy* ScaleBy::create(float duration, float s)
 {
     ScaleBy *scaleBy = new (std::nothrow) ScaleBy();
@@ -2120,6 +2140,8 @@ Blink* Blink::reverse() const
 // FadeIn
 //
 
+CC_DEFINE_ALLOCATOR_POOL(FadeIn, 100)
+
 FadeIn* FadeIn::create(float d)
 {
     FadeIn* action = new (std::nothrow) FadeIn();
@@ -2170,6 +2192,8 @@ void FadeIn::startWithTarget(cocos2d::Node *target)
 // FadeOut
 //
 
+CC_DEFINE_ALLOCATOR_POOL(FadeOut, 100)
+
 FadeOut* FadeOut::create(float d)
 {
     FadeOut* action = new (std::nothrow) FadeOut();
@@ -2219,6 +2243,8 @@ FadeTo* FadeOut::reverse() const
 // FadeTo
 //
 
+CC_DEFINE_ALLOCATOR_POOL(FadeTo, 100)
+
 FadeTo* FadeTo::create(float duration, GLubyte opacity)
 {
     FadeTo *fadeTo = new (std::nothrow) FadeTo();
@@ -2276,6 +2302,8 @@ void FadeTo::update(float time)
 //
 // TintTo
 //
+CC_DEFINE_ALLOCATOR_POOL(TintTo, 100)
+
 TintTo* TintTo::create(float duration, GLubyte red, GLubyte green, GLubyte blue)
 {
     TintTo *tintTo = new (std::nothrow) TintTo();
@@ -2404,6 +2432,8 @@ TintBy* TintBy::reverse() const
 //
 // DelayTime
 //
+CC_DEFINE_ALLOCATOR_POOL(DelayTime, 100)
+
 DelayTime* DelayTime::create(float d)
 {
     DelayTime* action = new (std::nothrow) DelayTime();
@@ -30,8 +30,6 @@
 #define __MISCNODE_CCCLIPPING_RECTANGLE_NODE_H__
 
 #include "2d/CCNode.h"
-#include "renderer/CCCustomCommand.h"
-#include "platform/CCGL.h"
 
 NS_CC_BEGIN
 
@@ -99,14 +97,11 @@ protected:
     {
     }
     
-    void onBeforeVisitScissor();
-    void onAfterVisitScissor();
+    /** The clipping region in world space, only the scale of the node and its parents is applied. */
+    Rect getWorldClippingRegion() const;
     
     Rect _clippingRegion;
     bool _clippingEnabled;
-    
-    CustomCommand _beforeVisitCmdScissor;
-    CustomCommand _afterVisitCmdScissor;
 };
 
 // end of _2d group
@@ -32,6 +32,7 @@
 #include "base/CCDirector.h"
 #include "base/CCEventListenerCustom.h"
 #include "base/CCEventDispatcher.h"
+#include "base/CCFrameArena.h"
 #include "2d/CCActionCatmullRom.h"
 #include "platform/CCGL.h"
 
@@ -98,6 +99,10 @@ static inline Tex2F __t(const Vec2 &v)
     return *(Tex2F*)&v;
 }
 
+// the nodes with more triangle vertices keep drawing them from their VBO,
+// copying and transforming them every frame would cost more than the draw call
+static const GLsizei MAX_BATCHED_VERTICES = 1024;
+
 // implementation of DrawNode
 
 DrawNode::DrawNode(GLfloat lineWidth)
@@ -260,14 +265,110 @@ void DrawNode::setupBuffer()
         glBindBuffer(GL_ARRAY_BUFFER, 0);
     }
 
+    _upload.vboCapacity = _bufferCapacity;
+    _upload.validCount = _bufferCount;
+    _uploadGLLine.vboCapacity = _bufferCapacityGLLine;
+    _uploadGLLine.validCount = _bufferCountGLLine;
+    _uploadGLPoint.vboCapacity = _bufferCapacityGLPoint;
+    _uploadGLPoint.validCount = _bufferCountGLPoint;
+    _upload.dirtyBegin = _upload.dirtyEnd = 0;
+    _uploadGLLine.dirtyBegin = _uploadGLLine.dirtyEnd = 0;
+    _uploadGLPoint.dirtyBegin = _uploadGLPoint.dirtyEnd = 0;
+
     CHECK_GL_ERROR_DEBUG();
 }
 
+void DrawNode::invalidateVertices(VertexUpload& upload, GLsizei begin, GLsizei end, bool moved)
+{
+    if (moved)
+    {
+        // the vertices after begin moved, all of them are uploaded again
+        upload.validCount = std::min(upload.validCount, begin);
+    }
+    else if (begin < upload.validCount)
+    {
+        end = std::min(end, upload.validCount);
+        if (upload.dirtyBegin < upload.dirtyEnd)
+        {
+            upload.dirtyBegin = std::min(upload.dirtyBegin, begin);
+            upload.dirtyEnd = std::max(upload.dirtyEnd, end);
+        }
+        else
+        {
+            upload.dirtyBegin = begin;
+            upload.dirtyEnd = end;
+        }
+    }
+}
+
+bool DrawNode::getDirtyRange(VertexUpload& upload, GLsizei count, GLsizei& begin, GLsizei& end)
+{
+    begin = count;
+    end = 0;
+    if (upload.dirtyBegin < upload.dirtyEnd)
+    {
+        begin = upload.dirtyBegin;
+        end = std::min(upload.dirtyEnd, count);
+    }
+    // the vertices drawn since the last upload
+    if (upload.validCount < count)
+    {
+        begin = std::min(begin, upload.validCount);
+        end = count;
+    }
+
+    upload.validCount = count;
+    upload.dirtyBegin = upload.dirtyEnd = 0;
+    return begin < end;
+}
+
+void DrawNode::uploadVertices(GLuint vbo, const V2F_C4B_T2F* buffer, GLsizei count, int capacity, VertexUpload& upload)
+{
+    GLsizei begin, end;
+    if (upload.vboCapacity != capacity)
+    {
+        glBindBuffer(GL_ARRAY_BUFFER, vbo);
+        glBufferData(GL_ARRAY_BUFFER, sizeof(V2F_C4B_T2F)*capacity, buffer, GL_STREAM_DRAW);
+        upload.vboCapacity = capacity;
+        getDirtyRange(upload, count, begin, end);
+    }
+    else if (getDirtyRange(upload, count, begin, end))
+    {
+        glBindBuffer(GL_ARRAY_BUFFER, vbo);
+        glBufferSubData(GL_ARRAY_BUFFER, sizeof(V2F_C4B_T2F)*begin, sizeof(V2F_C4B_T2F)*(end - begin), buffer + begin);
+    }
+}
+
+GLsizei DrawNode::spliceVertices(V2F_C4B_T2F* buffer, GLsizei& bufferCount, GLsizei recordStart, GLsizei start, GLsizei count)
+{
+    // the new vertices of the shape were drawn at the end of the buffer, from recordStart
+    GLsizei newCount = bufferCount - recordStart;
+    if (newCount == count)
+    {
+        memcpy(buffer + start, buffer + recordStart, sizeof(V2F_C4B_T2F)*newCount);
+    }
+    else
+    {
+        // moving the vertices after the shape may overwrite the new ones
+        FrameArena* arena = Director::getInstance()->getFrameArena();
+        V2F_C4B_T2F* vertices = arena->allocateArray<V2F_C4B_T2F>(newCount);
+        memcpy(vertices, buffer + recordStart, sizeof(V2F_C4B_T2F)*newCount);
+        memmove(buffer + start + newCount, buffer + start + count, sizeof(V2F_C4B_T2F)*(recordStart - start - count));
+        memcpy(buffer + start, vertices, sizeof(V2F_C4B_T2F)*newCount);
+        arena->deallocate(vertices, sizeof(V2F_C4B_T2F)*newCount);
+    }
+
+    bufferCount = recordStart + newCount - count;
+    return newCount - count;
+}
+
 bool DrawNode::init()
 {
     _blendFunc = BlendFunc::ALPHA_PREMULTIPLIED;
 
-    setGLProgramState(GLProgramState::getOrCreateWithGLProgramName(GLProgram::SHADER_NAME_POSITION_LENGTH_TEXTURE_COLOR));
+    _defaultGLProgramState = GLProgramState::getOrCreateWithGLProgramName(GLProgram::SHADER_NAME_POSITION_LENGTH_TEXTURE_COLOR);
+    _batchedGLProgramState = GLProgramState::getOrCreateWithGLProgramName(GLProgram::SHADER_NAME_POSITION_LENGTH_TEXTURE_COLOR_NO_MVP);
+    setGLProgramState(_defaultGLProgramState);
     
     ensureCapacity(512);
     ensureCapacityGLPoint(64);
@@ -285,9 +386,19 @@ void DrawNode::draw(Renderer *renderer, const Mat4 &transform, uint32_t flags)
 {
     if(_bufferCount)
     {
-        _customCommand.init(_globalZOrder, transform, flags);
-        _customCommand.func = CC_CALLBACK_0(DrawNode::onDraw, this, transform, flags);
-        renderer->addCommand(&_customCommand);
+        if (_bufferCount <= MAX_BATCHED_VERTICES && getGLProgramState() == _defaultGLProgramState)
+        {
+            updateBatchedTriangles();
+            TrianglesCommand::Triangles triangles = { _batchedVertices.data(), _batchedIndices.data(), (int)_bufferCount, (int)_bufferCount };
+            _trianglesCommand.init(_globalZOrder, (GLuint)0, _batchedGLProgramState, _blendFunc, triangles, transform, flags);
+            renderer->addCommand(&_trianglesCommand);
+        }
+        else
+        {
+            _customCommand.init(_globalZOrder, transform, flags);
+            _customCommand.func = CC_CALLBACK_0(DrawNode::onDraw, this, transform, flags);
+            renderer->addCommand(&_customCommand);
+        }
     }
     
     if(_bufferCountGLPoint)
@@ -305,6 +416,40 @@ void DrawNode::draw(Renderer *renderer, const Mat4 &transform, uint32_t flags)
     }
 }
 
+void DrawNode::updateBatchedTriangles()
+{
+    GLsizei begin, end;
+    bool dirty = getDirtyRange(_batchedUpload, _bufferCount, begin, end);
+    // the opacity is in the vertex colors instead of u_alpha
+    if (_batchedOpacity != _displayedOpacity)
+    {
+        _batchedOpacity = _displayedOpacity;
+        begin = 0;
+        end = _bufferCount;
+        dirty = true;
+    }
+    if (!dirty)
+    {
+        return;
+    }
+
+    _batchedVertices.resize(_bufferCount);
+    for (auto i = (GLsizei)_batchedIndices.size(); i < _bufferCount; ++i)
+    {
+        _batchedIndices.push_back((unsigned short)i);
+    }
+
+    for (auto i = begin; i < end; ++i)
+    {
+        const auto& vertex = _buffer[i];
+        auto& batched = _batchedVertices[i];
+        batched.vertices.set(vertex.vertices.x, vertex.vertices.y, 0.0f);
+        batched.colors = vertex.colors;
+        batched.colors.a = vertex.colors.a * _batchedOpacity / 255;
+        batched.texCoords = vertex.texCoords;
+    }
+}
+
 void DrawNode::onDraw(const Mat4 &transform, uint32_t /*flags*/)
 {
     getGLProgramState()->apply(transform);
@@ -312,13 +457,8 @@ void DrawNode::onDraw(const Mat4 &transform, uint32_t /*flags*/)
     glProgram->setUniformLocationWith1f(glProgram->getUniformLocation("u_alpha"), _displayedOpacity / 255.0);
     GL::blendFunc(_blendFunc.src, _blendFunc.dst);
 
-    if (_dirty)
-    {
-        glBindBuffer(GL_ARRAY_BUFFER, _vbo);
-        glBufferData(GL_ARRAY_BUFFER, sizeof(V2F_C4B_T2F)*_bufferCapacity, _buffer, GL_STREAM_DRAW);
-        
-        _dirty = false;
-    }
+    uploadVertices(_vbo, _buffer, _bufferCount, _bufferCapacity, _upload);
+    _dirty = false;
     if (Configuration::getInstance()->supportsShareableVAO())
     {
         GL::bindVAO(_vao);
@@ -357,12 +497,8 @@ void DrawNode::onDrawGLLine(const Mat4 &transform, uint32_t /*flags*/)
 
     GL::blendFunc(_blendFunc.src, _blendFunc.dst);
 
-    if (_dirtyGLLine)
-    {
-        glBindBuffer(GL_ARRAY_BUFFER, _vboGLLine);
-        glBufferData(GL_ARRAY_BUFFER, sizeof(V2F_C4B_T2F)*_bufferCapacityGLLine, _bufferGLLine, GL_STREAM_DRAW);
-        _dirtyGLLine = false;
-    }
+    uploadVertices(_vboGLLine, _bufferGLLine, _bufferCountGLLine, _bufferCapacityGLLine, _uploadGLLine);
+    _dirtyGLLine = false;
     if (Configuration::getInstance()->supportsShareableVAO())
     {
         GL::bindVAO(_vaoGLLine);
@@ -402,13 +538,8 @@ void DrawNode::onDrawGLPoint(const Mat4 &transform, uint32_t /*flags*/)
 
     GL::blendFunc(_blendFunc.src, _blendFunc.dst);
 
-    if (_dirtyGLPoint)
-    {
-        glBindBuffer(GL_ARRAY_BUFFER, _vboGLPoint);
-        glBufferData(GL_ARRAY_BUFFER, sizeof(V2F_C4B_T2F)*_bufferCapacityGLPoint, _bufferGLPoint, GL_STREAM_DRAW);
-        
-        _dirtyGLPoint = false;
-    }
+    uploadVertices(_vboGLPoint, _bufferGLPoint, _bufferCountGLPoint, _bufferCapacityGLPoint, _uploadGLPoint);
+    _dirtyGLPoint = false;
     
     if (Configuration::getInstance()->supportsShareableVAO())
     {
@@ -534,7 +665,8 @@ void DrawNode::drawCircle(const Vec2& center, float radius, float angle, unsigne
 {
     const float coef = 2.0f * (float)M_PI/segments;
     
-    Vec2 *vertices = new (std::nothrow) Vec2[segments+2];
+    FrameArena* arena = Director::getInstance()->getFrameArena();
+    Vec2* vertices = arena->allocateArray<Vec2>(segments+2);
     if( ! vertices )
         return;
     
@@ -555,7 +687,7 @@ void DrawNode::drawCircle(const Vec2& center, float radius, float angle, unsigne
     else
         drawPoly(vertices, segments+1, true, color);
     
-    CC_SAFE_DELETE_ARRAY(vertices);
+    arena->deallocate(vertices, sizeof(Vec2) * (segments+2));
 }
 
 void DrawNode::drawCircle(const Vec2 &center, float radius, float angle, unsigned int segments, bool drawLineToCenter, const Color4F &color)
@@ -565,7 +697,8 @@ void DrawNode::drawCircle(const Vec2 &center, float radius, float angle, unsigne
 
 void DrawNode::drawQuadBezier(const Vec2 &origin, const Vec2 &control, const Vec2 &destination, unsigned int segments, const Color4F &color)
 {
-    Vec2* vertices = new (std::nothrow) Vec2[segments + 1];
+    FrameArena* arena = Director::getInstance()->getFrameArena();
+    Vec2* vertices = arena->allocateArray<Vec2>(segments + 1);
     if( ! vertices )
         return;
     
@@ -581,12 +714,13 @@ void DrawNode::drawQuadBezier(const Vec2 &origin, const Vec2 &control, const Vec
     
     drawPoly(vertices, segments+1, false, color);
 
-    CC_SAFE_DELETE_ARRAY(vertices);
+    arena->deallocate(vertices, sizeof(Vec2) * (segments + 1));
 }
 
 void DrawNode::drawCubicBezier(const Vec2 &origin, const Vec2 &control1, const Vec2 &control2, const Vec2 &destination, unsigned int segments, const Color4F &color)
 {
-    Vec2* vertices = new (std::nothrow) Vec2[segments + 1];
+    FrameArena* arena = Director::getInstance()->getFrameArena();
+    Vec2* vertices = arena->allocateArray<Vec2>(segments + 1);
     if( ! vertices )
         return;
     
@@ -602,12 +736,13 @@ void DrawNode::drawCubicBezier(const Vec2 &origin, const Vec2 &control1, const V
     
     drawPoly(vertices, segments+1, false, color);
 
-    CC_SAFE_DELETE_ARRAY(vertices);
+    arena->deallocate(vertices, sizeof(Vec2) * (segments + 1));
 }
 
 void DrawNode::drawCardinalSpline(PointArray *config, float tension,  unsigned int segments, const Color4F &color)
 {
-    Vec2* vertices = new (std::nothrow) Vec2[segments + 1];
+    FrameArena* arena = Director::getInstance()->getFrameArena();
+    Vec2* vertices = arena->allocateArray<Vec2>(segments + 1);
     if( ! vertices )
         return;
     
@@ -641,7 +776,7 @@ void DrawNode::drawCardinalSpline(PointArray *config, float tension,  unsigned i
     
     drawPoly(vertices, segments+1, false, color);
     
-    CC_SAFE_DELETE_ARRAY(vertices);
+    arena->deallocate(vertices, sizeof(Vec2) * (segments + 1));
 }
 
 void DrawNode::drawCatmullRom(PointArray *points, unsigned int segments, const Color4F &color)
@@ -778,8 +913,8 @@ void DrawNode::drawPolygon(const Vec2 *verts, int count, const Color4F &fillColo
     if(outline)
     {
         struct ExtrudeVerts {Vec2 offset, n;};
-        struct ExtrudeVerts* extrude = (struct ExtrudeVerts*)malloc(sizeof(struct ExtrudeVerts)*count);
-        memset(extrude, 0, sizeof(struct ExtrudeVerts)*count);
+        FrameArena* arena = Director::getInstance()->getFrameArena();
+        struct ExtrudeVerts* extrude = arena->allocateArray<struct ExtrudeVerts>(count);
         
         for (int i = 0; i < count; i++)
         {
@@ -826,7 +961,7 @@ void DrawNode::drawPolygon(const Vec2 *verts, int count, const Color4F &fillColo
             *cursor++ = tmp2;
         }
         
-        free(extrude);
+        arena->deallocate(extrude, sizeof(struct ExtrudeVerts)*count);
     }
     
     _bufferCount += vertex_count;
@@ -855,7 +990,8 @@ void DrawNode::drawSolidCircle(const Vec2& center, float radius, float angle, un
 {
     const float coef = 2.0f * (float)M_PI/segments;
     
-    Vec2 *vertices = new (std::nothrow) Vec2[segments];
+    FrameArena* arena = Director::getInstance()->getFrameArena();
+    Vec2* vertices = arena->allocateArray<Vec2>(segments);
     if( ! vertices )
         return;
     
@@ -871,7 +1007,7 @@ void DrawNode::drawSolidCircle(const Vec2& center, float radius, float angle, un
     
     drawSolidPoly(vertices, segments, color);
     
-    CC_SAFE_DELETE_ARRAY(vertices);
+    arena->deallocate(vertices, sizeof(Vec2) * (segments));
 }
 
 void DrawNode::drawSolidCircle( const Vec2& center, float radius, float angle, unsigned int segments, const Color4F& color)
@@ -911,6 +1047,112 @@ void DrawNode::clear()
     _bufferCountGLPoint = 0;
     _dirtyGLPoint = true;
     _lineWidth = _defaultLineWidth;
+
+    invalidateVertices(_upload, 0, 0, true);
+    invalidateVertices(_uploadGLLine, 0, 0, true);
+    invalidateVertices(_uploadGLPoint, 0, 0, true);
+    invalidateVertices(_batchedUpload, 0, 0, true);
+    _shapes.clear();
+    _recordedShape.start = _recordedShape.startGLLine = _recordedShape.startGLPoint = 0;
+}
+
+void DrawNode::beginShape()
+{
+    CCASSERT(!_recordingShape, "endShape() must be called before beginning another shape");
+    _recordingShape = true;
+    _recordedShape.id = 0;
+    _recordedShape.start = _bufferCount;
+    _recordedShape.startGLLine = _bufferCountGLLine;
+    _recordedShape.startGLPoint = _bufferCountGLPoint;
+}
+
+void DrawNode::beginShape(unsigned int shape)
+{
+    beginShape();
+    _recordedShape.id = shape;
+}
+
+unsigned int DrawNode::endShape()
+{
+    CCASSERT(_recordingShape, "beginShape() must be called before endShape()");
+    _recordingShape = false;
+
+    auto recorded = _recordedShape;
+    recorded.count = _bufferCount - recorded.start;
+    recorded.countGLLine = _bufferCountGLLine - recorded.startGLLine;
+    recorded.countGLPoint = _bufferCountGLPoint - recorded.startGLPoint;
+
+    auto it = std::lower_bound(_shapes.begin(), _shapes.end(), recorded.id, [](const Shape& shape, unsigned int id) {
+        return shape.id < id;
+    });
+    if (recorded.id == 0 || it == _shapes.end() || it->id != recorded.id)
+    {
+        CCASSERT(recorded.id == 0, "the shape was removed, it is added again as a new shape");
+        // a new shape is drawn after all the others
+        recorded.id = _nextShapeId++;
+        _shapes.push_back(recorded);
+        return recorded.id;
+    }
+
+    // the new vertices replace the ones of the shape, the vertices after it move when their number changed
+    auto delta = spliceVertices(_buffer, _bufferCount, recorded.start, it->start, it->count);
+    invalidateVertices(_upload, it->start, it->start + recorded.count, delta != 0);
+    invalidateVertices(_batchedUpload, it->start, it->start + recorded.count, delta != 0);
+    auto deltaGLLine = spliceVertices(_bufferGLLine, _bufferCountGLLine, recorded.startGLLine, it->startGLLine, it->countGLLine);
+    invalidateVertices(_uploadGLLine, it->startGLLine, it->startGLLine + recorded.countGLLine, deltaGLLine != 0);
+    auto deltaGLPoint = spliceVertices(_bufferGLPoint, _bufferCountGLPoint, recorded.startGLPoint, it->startGLPoint, it->countGLPoint);
+    invalidateVertices(_uploadGLPoint, it->startGLPoint, it->startGLPoint + recorded.countGLPoint, deltaGLPoint != 0);
+
+    it->count = recorded.count;
+    it->countGLLine = recorded.countGLLine;
+    it->countGLPoint = recorded.countGLPoint;
+    for (auto next = it + 1; next != _shapes.end(); ++next)
+    {
+        next->start += delta;
+        next->startGLLine += deltaGLLine;
+        next->startGLPoint += deltaGLPoint;
+    }
+
+    _dirty = _dirtyGLLine = _dirtyGLPoint = true;
+    return recorded.id;
+}
+
+void DrawNode::removeShape(unsigned int shape)
+{
+    auto it = std::lower_bound(_shapes.begin(), _shapes.end(), shape, [](const Shape& shape, unsigned int id) {
+        return shape.id < id;
+    });
+    if (it == _shapes.end() || it->id != shape)
+    {
+        CCLOG("DrawNode: shape %u was already removed", shape);
+        return;
+    }
+
+    // splicing no new vertices in removes the ones of the shape
+    spliceVertices(_buffer, _bufferCount, _bufferCount, it->start, it->count);
+    invalidateVertices(_upload, it->start, it->start, true);
+    invalidateVertices(_batchedUpload, it->start, it->start, true);
+    spliceVertices(_bufferGLLine, _bufferCountGLLine, _bufferCountGLLine, it->startGLLine, it->countGLLine);
+    invalidateVertices(_uploadGLLine, it->startGLLine, it->startGLLine, true);
+    spliceVertices(_bufferGLPoint, _bufferCountGLPoint, _bufferCountGLPoint, it->startGLPoint, it->countGLPoint);
+    invalidateVertices(_uploadGLPoint, it->startGLPoint, it->startGLPoint, true);
+
+    for (auto next = it + 1; next != _shapes.end(); ++next)
+    {
+        next->start -= it->count;
+        next->startGLLine -= it->countGLLine;
+        next->startGLPoint -= it->countGLPoint;
+    }
+    // the shape being drawn is at the end of the buffers
+    if (_recordingShape)
+    {
+        _recordedShape.start -= it->count;
+        _recordedShape.startGLLine -= it->countGLLine;
+        _recordedShape.startGLPoint -= it->countGLPoint;
+    }
+    _shapes.erase(it);
+
+    _dirty = _dirtyGLLine = _dirtyGLPoint = true;
 }
 
 const BlendFunc& DrawNode::getBlendFunc() const
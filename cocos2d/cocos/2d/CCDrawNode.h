@@ -35,6 +35,7 @@
 #include "2d/CCNode.h"
 #include "base/ccTypes.h"
 #include "renderer/CCCustomCommand.h"
+#include "renderer/CCTrianglesCommand.h"
 #include "math/CCMath.h"
 
 NS_CC_BEGIN
@@ -285,6 +286,36 @@ public:
     
     /** Clear the geometry in the node's buffer. */
     void clear();
+
+    /** Starts a shape: the primitives drawn until endShape() can be replaced or removed later on,
+     * without drawing the other primitives of the node again. Only the vertices that changed are uploaded.
+     * @code
+     * drawNode->beginShape();
+     * drawNode->drawSolidCircle(position, 10, 0, 16, Color4F::RED);
+     * auto shape = drawNode->endShape();
+     * // next frame
+     * drawNode->beginShape(shape);
+     * drawNode->drawSolidCircle(newPosition, 10, 0, 16, Color4F::RED);
+     * drawNode->endShape();
+     * @endcode
+     */
+    void beginShape();
+    /** Starts replacing the primitives of a shape, with the ones drawn until endShape().
+     * Replacing them with the same number of vertices updates them in place, which is the cheapest.
+     *
+     * @param shape A shape returned by endShape().
+     */
+    void beginShape(unsigned int shape);
+    /** Ends the shape started by beginShape().
+     *
+     * @return The handle of the shape, valid until it is removed or the node is cleared.
+     */
+    unsigned int endShape();
+    /** Removes the primitives of a shape.
+     *
+     * @param shape A shape returned by endShape().
+     */
+    void removeShape(unsigned int shape);
     /** Get the color mixed mode.
     * @lua NA
     */
@@ -341,6 +372,34 @@ protected:
 
     void setupBuffer();
 
+    // the range of the vertices of a buffer which the VBO, or the batched vertices, are missing
+    struct VertexUpload
+    {
+        int vboCapacity;
+        // the vertices before it are valid, except the ones between dirtyBegin and dirtyEnd
+        GLsizei validCount;
+        GLsizei dirtyBegin;
+        GLsizei dirtyEnd;
+    };
+
+    // the vertices of a shape in each buffer, the shapes are sorted by id which is also the order of their vertices
+    struct Shape
+    {
+        unsigned int id;
+        GLsizei start;
+        GLsizei count;
+        GLsizei startGLLine;
+        GLsizei countGLLine;
+        GLsizei startGLPoint;
+        GLsizei countGLPoint;
+    };
+
+    static void invalidateVertices(VertexUpload& upload, GLsizei begin, GLsizei end, bool moved);
+    static bool getDirtyRange(VertexUpload& upload, GLsizei count, GLsizei& begin, GLsizei& end);
+    static void uploadVertices(GLuint vbo, const V2F_C4B_T2F* buffer, GLsizei count, int capacity, VertexUpload& upload);
+    static GLsizei spliceVertices(V2F_C4B_T2F* buffer, GLsizei& bufferCount, GLsizei recordStart, GLsizei start, GLsizei count);
+    void updateBatchedTriangles();
+
     GLuint      _vao = 0;
     GLuint      _vbo = 0;
     GLuint      _vaoGLPoint = 0;
@@ -367,6 +426,25 @@ protected:
     CustomCommand _customCommandGLPoint;
     CustomCommand _customCommandGLLine;
 
+    VertexUpload _upload = {};
+    VertexUpload _uploadGLPoint = {};
+    VertexUpload _uploadGLLine = {};
+
+    std::vector<Shape> _shapes;
+    unsigned int _nextShapeId = 1;
+    // the shape being drawn, see beginShape(), and where its vertices start in each buffer
+    Shape _recordedShape = {};
+    bool _recordingShape = false;
+
+    // the small nodes are drawn with a TrianglesCommand, which the renderer batches with the other draw nodes
+    TrianglesCommand _trianglesCommand;
+    GLProgramState* _defaultGLProgramState = nullptr;
+    GLProgramState* _batchedGLProgramState = nullptr;
+    std::vector<V3F_C4B_T2F> _batchedVertices;
+    std::vector<unsigned short> _batchedIndices;
+    VertexUpload _batchedUpload = {};
+    GLubyte _batchedOpacity = 0;
+
     bool        _dirty = false;
     bool        _dirtyGLPoint = false;
     bool        _dirtyGLLine = false;
@@ -54,6 +54,11 @@ const int TMXLayer::FAST_TMX_ORIENTATION_ORTHO = 0;
 const int TMXLayer::FAST_TMX_ORIENTATION_HEX = 1;
 const int TMXLayer::FAST_TMX_ORIENTATION_ISO = 2;
 
+// 64x64 quads fit in a chunk with 16 bit indices
+static const int CHUNK_SIZE = 64;
+// the tiles changed after this number are updated in their chunk instead of the dynamic buffer
+static const int MAX_ANIMATED_TILES = 1024;
+
 // FastTMXLayer - init & alloc & dealloc
 TMXLayer * TMXLayer::create(TMXTilesetInfo *tilesetInfo, TMXLayerInfo *layerInfo, TMXMapInfo *mapInfo)
 {
@@ -120,11 +125,13 @@ TMXLayer::TMXLayer()
 , _vertexZvalue(0)
 , _useAutomaticVertexZ(false)
 , _quadsDirty(true)
+, _chunksWide(0)
+, _animatedQuadsDirty(false)
 , _dirty(true)
-, _vertexBuffer(nullptr)
-, _vData(nullptr)
-, _indexBuffer(nullptr)
 {
+    _visibleChunkBegin[0] = _visibleChunkBegin[1] = 0;
+    _visibleChunkEnd[0] = _visibleChunkEnd[1] = 0;
+    _visibleVertexZ[0] = _visibleVertexZ[1] = 0;
 }
 
 TMXLayer::~TMXLayer()
@@ -132,15 +139,16 @@ TMXLayer::~TMXLayer()
     CC_SAFE_RELEASE(_tileSet);
     CC_SAFE_RELEASE(_texture);
     CC_SAFE_FREE(_tiles);
-    CC_SAFE_RELEASE(_vData);
-    CC_SAFE_RELEASE(_vertexBuffer);
-    CC_SAFE_RELEASE(_indexBuffer);
-    
+    for (auto& chunk : _chunks)
+    {
+        releaseTileBuffer(chunk);
+    }
+    releaseTileBuffer(_animatedBuffer);
 }
 
 void TMXLayer::draw(Renderer *renderer, const Mat4& transform, uint32_t flags)
 {
-    updateTotalQuads();
+    updateChunks();
 
     bool isViewProjectionUpdated = true;
     auto visitingCamera = Camera::getVisitingCamera();
@@ -149,7 +157,7 @@ void TMXLayer::draw(Renderer *renderer, const Mat4& transform, uint32_t flags)
         isViewProjectionUpdated = visitingCamera->isViewProjectionUpdated();
     }
     
-    if( flags != 0 || _dirty || _quadsDirty || isViewProjectionUpdated)
+    if( flags != 0 || _dirty || isViewProjectionUpdated)
     {
         Size s = Director::getInstance()->getVisibleSize();
         auto rect = Rect(Camera::getVisitingCamera()->getPositionX() - s.width * 0.5f,
@@ -161,26 +169,55 @@ void TMXLayer::draw(Renderer *renderer, const Mat4& transform, uint32_t flags)
         inv.inverse();
         rect = RectApplyTransform(rect, inv);
         
-        updateTiles(rect);
-        updateIndexBuffer();
-        updatePrimitives();
+        updateVisibleChunks(rect);
         _dirty = false;
     }
-    
-    if(_renderCommands.size() < static_cast<size_t>(_primitives.size()))
+
+    // the chunks are built the first time they are visible
+    _visiblePrimitives.clear();
+    for (int y = _visibleChunkBegin[1]; y < _visibleChunkEnd[1]; ++y)
+    {
+        for (int x = _visibleChunkBegin[0]; x < _visibleChunkEnd[0]; ++x)
+        {
+            auto& chunk = _chunks[x + y * _chunksWide];
+            if (!chunk.built)
+            {
+                buildChunk(chunk);
+            }
+            if (chunk.indicesDirty)
+            {
+                updateChunkIndices(chunk);
+            }
+            addPrimitives(chunk);
+        }
+    }
+    updateAnimatedTiles();
+    addPrimitives(_animatedBuffer);
+
+    // the commands are added once they are all allocated, resizing moves them
+    if(_renderCommands.size() < _visiblePrimitives.size())
     {
-        _renderCommands.resize(_primitives.size());
+        _renderCommands.resize(_visiblePrimitives.size());
     }
     
+    auto blendfunc = _texture->hasPremultipliedAlpha() ? BlendFunc::ALPHA_PREMULTIPLIED : BlendFunc::ALPHA_NON_PREMULTIPLIED;
     int index = 0;
-    for(const auto& iter : _primitives)
+    for(const auto& iter : _visiblePrimitives)
+    {
+        auto& cmd = _renderCommands[index++];
+        cmd.init(iter.first, _texture->getName(), getGLProgramState(), blendfunc, iter.second, _modelViewTransform, flags);
+        renderer->addCommand(&cmd);
+    }
+}
+
+void TMXLayer::addPrimitives(const TileBuffer& buffer)
+{
+    for(const auto& iter : buffer.primitives)
     {
-        if(iter.second->getCount() > 0)
+        // with an automatic vertex z, the rows of tiles out of the view have their own primitives
+        if(iter.second->getCount() > 0 && iter.first >= _visibleVertexZ[0] && iter.first <= _visibleVertexZ[1])
         {
-            auto& cmd = _renderCommands[index++];
-            auto blendfunc = _texture->hasPremultipliedAlpha() ? BlendFunc::ALPHA_PREMULTIPLIED : BlendFunc::ALPHA_NON_PREMULTIPLIED;
-            cmd.init(iter.first, _texture->getName(), getGLProgramState(), blendfunc, iter.second, _modelViewTransform, flags);
-            renderer->addCommand(&cmd);
+            _visiblePrimitives.push_back(std::make_pair(iter.first, iter.second));
         }
     }
 }
@@ -197,7 +234,7 @@ void TMXLayer::onDraw(Primitive *primitive)
     CC_INCREMENT_GL_DRAWN_BATCHES_AND_VERTICES(1, primitive->getCount() * 4);
 }
 
-void TMXLayer::updateTiles(const Rect& culledRect)
+void TMXLayer::updateVisibleChunks(const Rect& culledRect)
 {
     Rect visibleTiles = Rect(culledRect.origin, culledRect.size * Director::getInstance()->getContentScaleFactor());
     Size mapTileSize = CC_SIZE_PIXELS_TO_POINTS(_mapTileSize);
@@ -243,86 +280,216 @@ void TMXLayer::updateTiles(const Rect& culledRect)
         //CCASSERT(0, "TMX invalid value");
     }
     
-    _indicesVertexZNumber.clear();
-    
-    for(const auto& iter : _indicesVertexZOffsets)
-    {
-        _indicesVertexZNumber[iter.first] = iter.second;
-    }
-    
     int yBegin = std::max(0.f,visibleTiles.origin.y - tilesOverY);
     int yEnd = std::min(_layerSize.height,visibleTiles.origin.y + visibleTiles.size.height + tilesOverY);
     int xBegin = std::max(0.f,visibleTiles.origin.x - tilesOverX);
     int xEnd = std::min(_layerSize.width,visibleTiles.origin.x + visibleTiles.size.width + tilesOverX);
-    
-    for (int y =  yBegin; y < yEnd; ++y)
+
+    // no tile is visible, the animated ones included
+    if (xBegin >= xEnd || yBegin >= yEnd)
     {
-        for (int x = xBegin; x < xEnd; ++x)
-        {
-            int tileIndex = getTileIndexByPos(x, y);
-            if(_tiles[tileIndex] == 0) continue;
-            
-            int vertexZ = getVertexZForPos(Vec2(x,y));
-            auto iter = _indicesVertexZNumber.find(vertexZ);
-            int offset = iter->second;
-            iter->second++;
-            
-            int quadIndex = _tileToQuadIndex[tileIndex];
-            CC_ASSERT(-1 != quadIndex);
-            _indices[6 * offset + 0] = quadIndex * 4 + 0;
-            _indices[6 * offset + 1] = quadIndex * 4 + 1;
-            _indices[6 * offset + 2] = quadIndex * 4 + 2;
-            _indices[6 * offset + 3] = quadIndex * 4 + 3;
-            _indices[6 * offset + 4] = quadIndex * 4 + 2;
-            _indices[6 * offset + 5] = quadIndex * 4 + 1;
-            
-        } // for x
-    } // for y
-    
-    for(const auto& iter : _indicesVertexZOffsets)
+        _visibleChunkBegin[0] = _visibleChunkEnd[0] = 0;
+        _visibleChunkBegin[1] = _visibleChunkEnd[1] = 0;
+        _visibleVertexZ[0] = 1;
+        _visibleVertexZ[1] = 0;
+        return;
+    }
+    _visibleChunkBegin[0] = xBegin / CHUNK_SIZE;
+    _visibleChunkBegin[1] = yBegin / CHUNK_SIZE;
+    _visibleChunkEnd[0] = (xEnd - 1) / CHUNK_SIZE + 1;
+    _visibleChunkEnd[1] = (yEnd - 1) / CHUNK_SIZE + 1;
+
+    // the automatic vertex z changes linearly with the tile coordinates, the corners have the extremes
+    int corners[4] = {
+        getVertexZForPos(Vec2(xBegin, yBegin)), getVertexZForPos(Vec2(xEnd - 1, yBegin)),
+        getVertexZForPos(Vec2(xBegin, yEnd - 1)), getVertexZForPos(Vec2(xEnd - 1, yEnd - 1))
+    };
+    _visibleVertexZ[0] = *std::min_element(corners, corners + 4);
+    _visibleVertexZ[1] = *std::max_element(corners, corners + 4);
+}
+
+void TMXLayer::releaseTileBuffer(TileBuffer& buffer)
+{
+    CC_SAFE_RELEASE_NULL(buffer.vertexData);
+    CC_SAFE_RELEASE_NULL(buffer.vertexBuffer);
+    CC_SAFE_RELEASE_NULL(buffer.indexBuffer);
+    buffer.primitives.clear();
+    buffer.indicesDirty = true;
+}
+
+void TMXLayer::updateIndices(TileBuffer& buffer, int maxQuads)
+{
+    // the quads are drawn by vertex z, in the order of their tiles for each one
+    if (_useAutomaticVertexZ)
+    {
+        std::stable_sort(_quadsByVertexZ.begin(), _quadsByVertexZ.end(), [](const std::pair<int, int>& a, const std::pair<int, int>& b) {
+            return a.first < b.first;
+        });
+    }
+
+    _indices.resize(6 * _quadsByVertexZ.size());
+    for (size_t i = 0; i < _quadsByVertexZ.size(); ++i)
+    {
+        int quadIndex = _quadsByVertexZ[i].second;
+        _indices[6 * i + 0] = quadIndex * 4 + 0;
+        _indices[6 * i + 1] = quadIndex * 4 + 1;
+        _indices[6 * i + 2] = quadIndex * 4 + 2;
+        _indices[6 * i + 3] = quadIndex * 4 + 3;
+        _indices[6 * i + 4] = quadIndex * 4 + 2;
+        _indices[6 * i + 5] = quadIndex * 4 + 1;
+    }
+
+    if(nullptr == buffer.indexBuffer)
+    {
+#ifdef CC_FAST_TILEMAP_32_BIT_INDICES
+        buffer.indexBuffer = IndexBuffer::create(IndexBuffer::IndexType::INDEX_TYPE_UINT_32, 6 * maxQuads);
+#else
+        buffer.indexBuffer = IndexBuffer::create(IndexBuffer::IndexType::INDEX_TYPE_SHORT_16, 6 * maxQuads);
+#endif
+        CC_SAFE_RETAIN(buffer.indexBuffer);
+    }
+    if (!_indices.empty())
+    {
+        buffer.indexBuffer->updateIndices(&_indices[0], (int)_indices.size(), 0);
+    }
+
+    for(const auto& iter : buffer.primitives)
     {
-        _indicesVertexZNumber[iter.first] -= iter.second;
-        if(_indicesVertexZNumber[iter.first] == 0)
+        iter.second->setCount(0);
+    }
+    size_t start = 0;
+    while (start < _quadsByVertexZ.size())
+    {
+        int vertexZ = _quadsByVertexZ[start].first;
+        size_t end = start + 1;
+        while (end < _quadsByVertexZ.size() && _quadsByVertexZ[end].first == vertexZ)
+        {
+            ++end;
+        }
+
+        auto primitive = buffer.primitives.at(vertexZ);
+        if(nullptr == primitive)
         {
-            _indicesVertexZNumber.erase(iter.first);
+            primitive = Primitive::create(buffer.vertexData, buffer.indexBuffer, GL_TRIANGLES);
+            buffer.primitives.insert(vertexZ, primitive);
         }
+        primitive->setCount((int)(end - start) * 6);
+        primitive->setStart((int)start * 6);
+        start = end;
     }
-    
+    buffer.indicesDirty = false;
 }
 
-void TMXLayer::updateVertexBuffer()
+TMXLayer::TileChunk& TMXLayer::getChunkForTile(int x, int y)
 {
+    return _chunks[x / CHUNK_SIZE + y / CHUNK_SIZE * _chunksWide];
+}
+
+void TMXLayer::buildChunk(TileChunk& chunk)
+{
+    chunk.built = true;
+
+    std::vector<V3F_C4B_T2F_Quad> quads(chunk.width * chunk.height);
+    bool empty = true;
+    for (int y = 0; y < chunk.height; ++y)
+    {
+        for (int x = 0; x < chunk.width; ++x)
+        {
+            uint32_t tileGID = _tiles[getTileIndexByPos(chunk.x + x, chunk.y + y)];
+            if (tileGID == 0 || _animatedTileQuads.count(getTileIndexByPos(chunk.x + x, chunk.y + y))) continue;
+
+            setupQuad(quads[x + y * chunk.width], chunk.x + x, chunk.y + y, tileGID);
+            empty = false;
+        }
+    }
+    // an empty chunk gets its buffers when a tile is put in it, see setFlaggedTileGIDByIndex()
+    if (empty)
+    {
+        chunk.indicesDirty = false;
+        return;
+    }
+
     GL::bindVAO(0);
-    if(nullptr == _vData)
+    chunk.vertexBuffer = VertexBuffer::create(sizeof(V3F_C4B_T2F), (int)quads.size() * 4);
+    chunk.vertexData = VertexData::create();
+    chunk.vertexData->setStream(chunk.vertexBuffer, VertexStreamAttribute(0, GLProgram::VERTEX_ATTRIB_POSITION, GL_FLOAT, 3));
+    chunk.vertexData->setStream(chunk.vertexBuffer, VertexStreamAttribute(offsetof(V3F_C4B_T2F, colors), GLProgram::VERTEX_ATTRIB_COLOR, GL_UNSIGNED_BYTE, 4, true));
+    chunk.vertexData->setStream(chunk.vertexBuffer, VertexStreamAttribute(offsetof(V3F_C4B_T2F, texCoords), GLProgram::VERTEX_ATTRIB_TEX_COORD, GL_FLOAT, 2));
+    CC_SAFE_RETAIN(chunk.vertexData);
+    CC_SAFE_RETAIN(chunk.vertexBuffer);
+    chunk.vertexBuffer->updateVertices((void*)&quads[0], (int)quads.size() * 4, 0);
+
+    updateChunkIndices(chunk);
+}
+
+void TMXLayer::updateChunkIndices(TileChunk& chunk)
+{
+    if (nullptr == chunk.vertexBuffer)
     {
-        _vertexBuffer = VertexBuffer::create(sizeof(V3F_C4B_T2F), (int)_totalQuads.size() * 4);
-        _vData = VertexData::create();
-        _vData->setStream(_vertexBuffer, VertexStreamAttribute(0, GLProgram::VERTEX_ATTRIB_POSITION, GL_FLOAT, 3));
-        _vData->setStream(_vertexBuffer, VertexStreamAttribute(offsetof(V3F_C4B_T2F, colors), GLProgram::VERTEX_ATTRIB_COLOR, GL_UNSIGNED_BYTE, 4, true));
-        _vData->setStream(_vertexBuffer, VertexStreamAttribute(offsetof(V3F_C4B_T2F, texCoords), GLProgram::VERTEX_ATTRIB_TEX_COORD, GL_FLOAT, 2));
-        CC_SAFE_RETAIN(_vData);
-        CC_SAFE_RETAIN(_vertexBuffer);
+        chunk.indicesDirty = false;
+        return;
     }
-    if(_vertexBuffer)
+
+    _quadsByVertexZ.clear();
+    for (int y = 0; y < chunk.height; ++y)
     {
-        _vertexBuffer->updateVertices((void*)&_totalQuads[0], (int)_totalQuads.size() * 4, 0);
+        for (int x = 0; x < chunk.width; ++x)
+        {
+            int tileIndex = getTileIndexByPos(chunk.x + x, chunk.y + y);
+            // the animated tiles are drawn from the dynamic buffer
+            if (_tiles[tileIndex] == 0 || _animatedTileQuads.count(tileIndex)) continue;
+
+            _quadsByVertexZ.push_back(std::make_pair(getVertexZForPos(Vec2(chunk.x + x, chunk.y + y)), x + y * chunk.width));
+        }
     }
-    
+    updateIndices(chunk, chunk.width * chunk.height);
 }
 
-void TMXLayer::updateIndexBuffer()
+void TMXLayer::updateAnimatedTiles()
 {
-    if(nullptr == _indexBuffer)
+    if (!_animatedQuadsDirty && !_animatedBuffer.indicesDirty)
     {
-#ifdef CC_FAST_TILEMAP_32_BIT_INDICES
-        _indexBuffer = IndexBuffer::create(IndexBuffer::IndexType::INDEX_TYPE_UINT_32, (int)_indices.size());
-#else
-        _indexBuffer = IndexBuffer::create(IndexBuffer::IndexType::INDEX_TYPE_SHORT_16, (int)_indices.size());
-#endif
-        CC_SAFE_RETAIN(_indexBuffer);
+        return;
+    }
+
+    int count = (int)_animatedQuads.size();
+    if (_animatedBuffer.vertexBuffer && _animatedBuffer.vertexBuffer->getVertexNumber() < count * 4)
+    {
+        releaseTileBuffer(_animatedBuffer);
+    }
+    if (nullptr == _animatedBuffer.vertexBuffer)
+    {
+        if (count == 0)
+        {
+            return;
+        }
+        int capacity = std::min(MAX_ANIMATED_TILES, std::max(64, count * 2));
+        GL::bindVAO(0);
+        _animatedBuffer.vertexBuffer = VertexBuffer::create(sizeof(V3F_C4B_T2F), capacity * 4, GL_DYNAMIC_DRAW);
+        _animatedBuffer.vertexData = VertexData::create();
+        _animatedBuffer.vertexData->setStream(_animatedBuffer.vertexBuffer, VertexStreamAttribute(0, GLProgram::VERTEX_ATTRIB_POSITION, GL_FLOAT, 3));
+        _animatedBuffer.vertexData->setStream(_animatedBuffer.vertexBuffer, VertexStreamAttribute(offsetof(V3F_C4B_T2F, colors), GLProgram::VERTEX_ATTRIB_COLOR, GL_UNSIGNED_BYTE, 4, true));
+        _animatedBuffer.vertexData->setStream(_animatedBuffer.vertexBuffer, VertexStreamAttribute(offsetof(V3F_C4B_T2F, texCoords), GLProgram::VERTEX_ATTRIB_TEX_COORD, GL_FLOAT, 2));
+        CC_SAFE_RETAIN(_animatedBuffer.vertexData);
+        CC_SAFE_RETAIN(_animatedBuffer.vertexBuffer);
+        _animatedQuadsDirty = true;
+    }
+
+    if (_animatedQuadsDirty && count > 0)
+    {
+        _animatedBuffer.vertexBuffer->updateVertices((void*)&_animatedQuads[0], count * 4, 0);
+    }
+    _animatedQuadsDirty = false;
+
+    if (_animatedBuffer.indicesDirty)
+    {
+        _quadsByVertexZ.clear();
+        for (int i = 0; i < count; ++i)
+        {
+            _quadsByVertexZ.push_back(std::make_pair((int)_animatedQuads[i].bl.vertices.z, i));
+        }
+        updateIndices(_animatedBuffer, _animatedBuffer.vertexBuffer->getVertexNumber() / 4);
     }
-    _indexBuffer->updateIndices(&_indices[0], (int)_indices.size(), 0);
-    
 }
 
 // FastTMXLayer - setup Tiles
@@ -418,158 +585,127 @@ Mat4 TMXLayer::tileToNodeTransform()
     
 }
 
-void TMXLayer::updatePrimitives()
+void TMXLayer::updateChunks()
 {
-    for(const auto& iter : _indicesVertexZNumber)
+    if(_quadsDirty)
     {
-        int start = _indicesVertexZOffsets.at(iter.first);
-        
-        auto primitiveIter= _primitives.find(iter.first);
-        if(primitiveIter == _primitives.end())
+        for (auto& chunk : _chunks)
         {
-            auto primitive = Primitive::create(_vData, _indexBuffer, GL_TRIANGLES);
-            primitive->setCount(iter.second * 6);
-            primitive->setStart(start * 6);
-            
-            _primitives.insert(iter.first, primitive);
+            releaseTileBuffer(chunk);
         }
-        else
+        releaseTileBuffer(_animatedBuffer);
+        _animatedTileQuads.clear();
+        _animatedTiles.clear();
+        _animatedQuads.clear();
+
+        int width = (int)_layerSize.width;
+        int height = (int)_layerSize.height;
+        _chunksWide = (width + CHUNK_SIZE - 1) / CHUNK_SIZE;
+        int chunksHigh = (height + CHUNK_SIZE - 1) / CHUNK_SIZE;
+        _chunks.clear();
+        _chunks.resize(_chunksWide * chunksHigh);
+        for (int y = 0; y < chunksHigh; ++y)
         {
-            primitiveIter->second->setCount(iter.second * 6);
-            primitiveIter->second->setStart(start * 6);
+            for (int x = 0; x < _chunksWide; ++x)
+            {
+                auto& chunk = _chunks[x + y * _chunksWide];
+                chunk.x = x * CHUNK_SIZE;
+                chunk.y = y * CHUNK_SIZE;
+                chunk.width = std::min(CHUNK_SIZE, width - chunk.x);
+                chunk.height = std::min(CHUNK_SIZE, height - chunk.y);
+            }
         }
+
+        _quadsDirty = false;
+        _dirty = true;
     }
 }
 
-void TMXLayer::updateTotalQuads()
+void TMXLayer::setupQuad(V3F_C4B_T2F_Quad& quad, int x, int y, uint32_t tileGID)
 {
-    if(_quadsDirty)
+    Size tileSize = CC_SIZE_PIXELS_TO_POINTS(_tileSet->_tileSize);
+    Size texSize = _tileSet->_imageSize;
+
+    Vec3 nodePos(float(x), float(y), 0);
+    _tileToNodeTransform.transformPoint(&nodePos);
+    
+    float left, right, top, bottom, z;
+    
+    z = getVertexZForPos(Vec2(x, y));
+
+    // vertices
+    if (tileGID & kTMXTileDiagonalFlag)
     {
-        Size tileSize = CC_SIZE_PIXELS_TO_POINTS(_tileSet->_tileSize);
-        Size texSize = _tileSet->_imageSize;
-        _tileToQuadIndex.clear();
-        _totalQuads.resize(int(_layerSize.width * _layerSize.height));
-        _indices.resize(6 * int(_layerSize.width * _layerSize.height));
-        _tileToQuadIndex.resize(int(_layerSize.width * _layerSize.height),-1);
-        _indicesVertexZOffsets.clear();
-        
-        int quadIndex = 0;
-        for(int y = 0; y < _layerSize.height; ++y)
-        {
-            for(int x =0; x < _layerSize.width; ++x)
-            {
-                int tileIndex = getTileIndexByPos(x, y);
-                int tileGID = _tiles[tileIndex];
-                
-                if(tileGID == 0) continue;
-                
-                _tileToQuadIndex[tileIndex] = quadIndex;
-                
-                auto& quad = _totalQuads[quadIndex];
-                
-                Vec3 nodePos(float(x), float(y), 0);
-                _tileToNodeTransform.transformPoint(&nodePos);
-                
-                float left, right, top, bottom, z;
-                
-                z = getVertexZForPos(Vec2(x, y));
-                auto iter = _indicesVertexZOffsets.find(z);
-                if(iter == _indicesVertexZOffsets.end())
-                {
-                    _indicesVertexZOffsets[z] = 1;
-                }
-                else
-                {
-                    iter->second++;
-                }
-                // vertices
-                if (tileGID & kTMXTileDiagonalFlag)
-                {
-                    left = nodePos.x;
-                    right = nodePos.x + tileSize.height;
-                    bottom = nodePos.y + tileSize.width;
-                    top = nodePos.y;
-                }
-                else
-                {
-                    left = nodePos.x;
-                    right = nodePos.x + tileSize.width;
-                    bottom = nodePos.y + tileSize.height;
-                    top = nodePos.y;
-                }
-                
-                if(tileGID & kTMXTileVerticalFlag)
-                    std::swap(top, bottom);
-                if(tileGID & kTMXTileHorizontalFlag)
-                    std::swap(left, right);
-                
-                if(tileGID & kTMXTileDiagonalFlag)
-                {
-                    // FIXME: not working correctly
-                    quad.bl.vertices.x = left;
-                    quad.bl.vertices.y = bottom;
-                    quad.bl.vertices.z = z;
-                    quad.br.vertices.x = left;
-                    quad.br.vertices.y = top;
-                    quad.br.vertices.z = z;
-                    quad.tl.vertices.x = right;
-                    quad.tl.vertices.y = bottom;
-                    quad.tl.vertices.z = z;
-                    quad.tr.vertices.x = right;
-                    quad.tr.vertices.y = top;
-                    quad.tr.vertices.z = z;
-                }
-                else
-                {
-                    quad.bl.vertices.x = left;
-                    quad.bl.vertices.y = bottom;
-                    quad.bl.vertices.z = z;
-                    quad.br.vertices.x = right;
-                    quad.br.vertices.y = bottom;
-                    quad.br.vertices.z = z;
-                    quad.tl.vertices.x = left;
-                    quad.tl.vertices.y = top;
-                    quad.tl.vertices.z = z;
-                    quad.tr.vertices.x = right;
-                    quad.tr.vertices.y = top;
-                    quad.tr.vertices.z = z;
-                }
-                
-                // texcoords
-                Rect tileTexture = _tileSet->getRectForGID(tileGID);
-                left   = (tileTexture.origin.x / texSize.width);
-                right  = left + (tileTexture.size.width / texSize.width);
-                bottom = (tileTexture.origin.y / texSize.height);
-                top    = bottom + (tileTexture.size.height / texSize.height);
-                
-                quad.bl.texCoords.u = left;
-                quad.bl.texCoords.v = bottom;
-                quad.br.texCoords.u = right;
-                quad.br.texCoords.v = bottom;
-                quad.tl.texCoords.u = left;
-                quad.tl.texCoords.v = top;
-                quad.tr.texCoords.u = right;
-                quad.tr.texCoords.v = top;
-                
-                quad.bl.colors = Color4B::WHITE;
-                quad.br.colors = Color4B::WHITE;
-                quad.tl.colors = Color4B::WHITE;
-                quad.tr.colors = Color4B::WHITE;
-                
-                ++quadIndex;
-            }
-        }
-        
-        int offset = 0;
-        for(auto& vertexZOffset : _indicesVertexZOffsets)
-        {
-            std::swap(offset, vertexZOffset.second);
-            offset += vertexZOffset.second;
-        }
-        updateVertexBuffer();
-        
-        _quadsDirty = false;
+        left = nodePos.x;
+        right = nodePos.x + tileSize.height;
+        bottom = nodePos.y + tileSize.width;
+        top = nodePos.y;
+    }
+    else
+    {
+        left = nodePos.x;
+        right = nodePos.x + tileSize.width;
+        bottom = nodePos.y + tileSize.height;
+        top = nodePos.y;
+    }
+    
+    if(tileGID & kTMXTileVerticalFlag)
+        std::swap(top, bottom);
+    if(tileGID & kTMXTileHorizontalFlag)
+        std::swap(left, right);
+    
+    if(tileGID & kTMXTileDiagonalFlag)
+    {
+        // FIXME: not working correctly
+        quad.bl.vertices.x = left;
+        quad.bl.vertices.y = bottom;
+        quad.bl.vertices.z = z;
+        quad.br.vertices.x = left;
+        quad.br.vertices.y = top;
+        quad.br.vertices.z = z;
+        quad.tl.vertices.x = right;
+        quad.tl.vertices.y = bottom;
+        quad.tl.vertices.z = z;
+        quad.tr.vertices.x = right;
+        quad.tr.vertices.y = top;
+        quad.tr.vertices.z = z;
     }
+    else
+    {
+        quad.bl.vertices.x = left;
+        quad.bl.vertices.y = bottom;
+        quad.bl.vertices.z = z;
+        quad.br.vertices.x = right;
+        quad.br.vertices.y = bottom;
+        quad.br.vertices.z = z;
+        quad.tl.vertices.x = left;
+        quad.tl.vertices.y = top;
+        quad.tl.vertices.z = z;
+        quad.tr.vertices.x = right;
+        quad.tr.vertices.y = top;
+        quad.tr.vertices.z = z;
+    }
+    
+    // texcoords
+    Rect tileTexture = _tileSet->getRectForGID(tileGID);
+    left   = (tileTexture.origin.x / texSize.width);
+    right  = left + (tileTexture.size.width / texSize.width);
+    bottom = (tileTexture.origin.y / texSize.height);
+    top    = bottom + (tileTexture.size.height / texSize.height);
+    
+    quad.bl.texCoords.u = left;
+    quad.bl.texCoords.v = bottom;
+    quad.br.texCoords.u = right;
+    quad.br.texCoords.v = bottom;
+    quad.tl.texCoords.u = left;
+    quad.tl.texCoords.v = top;
+    quad.tr.texCoords.u = right;
+    quad.tr.texCoords.v = top;
+    
+    quad.bl.colors = Color4B::WHITE;
+    quad.br.colors = Color4B::WHITE;
+    quad.tl.colors = Color4B::WHITE;
+    quad.tr.colors = Color4B::WHITE;
 }
 
 // removing / getting tiles
@@ -701,9 +837,65 @@ void TMXLayer::removeTileAt(const Vec2& tileCoordinate)
 void TMXLayer::setFlaggedTileGIDByIndex(int index, uint32_t gid)
 {
     if(gid == _tiles[index]) return;
+    uint32_t previousGID = _tiles[index];
     _tiles[index] = gid;
-    _quadsDirty = true;
-    _dirty = true;
+    if (_quadsDirty) return;
+
+    int x = index % (int)_layerSize.width;
+    int y = index / (int)_layerSize.width;
+    auto& chunk = getChunkForTile(x, y);
+    // it is built from the tiles the first time it is visible
+    if (!chunk.built) return;
+
+    auto animated = _animatedTileQuads.find(index);
+    if (animated != _animatedTileQuads.end())
+    {
+        int quadIndex = animated->second;
+        if (gid != 0)
+        {
+            setupQuad(_animatedQuads[quadIndex], x, y, gid);
+        }
+        else
+        {
+            // the last animated tile takes its place
+            _animatedQuads[quadIndex] = _animatedQuads.back();
+            _animatedTiles[quadIndex] = _animatedTiles.back();
+            _animatedTileQuads[_animatedTiles[quadIndex]] = quadIndex;
+            _animatedQuads.pop_back();
+            _animatedTiles.pop_back();
+            _animatedTileQuads.erase(index);
+            _animatedBuffer.indicesDirty = true;
+        }
+        _animatedQuadsDirty = true;
+        return;
+    }
+
+    if (gid != 0 && (int)_animatedQuads.size() < MAX_ANIMATED_TILES)
+    {
+        _animatedTileQuads[index] = (int)_animatedQuads.size();
+        _animatedTiles.push_back(index);
+        _animatedQuads.push_back(V3F_C4B_T2F_Quad());
+        setupQuad(_animatedQuads.back(), x, y, gid);
+        _animatedQuadsDirty = true;
+        _animatedBuffer.indicesDirty = true;
+        // its quad in the chunk isn't drawn anymore
+        chunk.indicesDirty = chunk.indicesDirty || previousGID != 0;
+        return;
+    }
+
+    // the dynamic buffer is full, the quad of the tile is updated in its chunk
+    if (gid != 0)
+    {
+        if (nullptr == chunk.vertexBuffer)
+        {
+            chunk.built = false;
+            return;
+        }
+        V3F_C4B_T2F_Quad quad;
+        setupQuad(quad, x, y, gid);
+        chunk.vertexBuffer->updateVertices(&quad, 4, ((x - chunk.x) + (y - chunk.y) * chunk.width) * 4);
+    }
+    chunk.indicesDirty = chunk.indicesDirty || previousGID == 0 || gid == 0;
 }
 
 void TMXLayer::removeChild(Node* node, bool cleanup)
@@ -69,6 +69,10 @@ namespace experimental{
  * "value" by default is 0, but you can change it from Tiled by adding the "cc_alpha_func" property to the layer.
  * The value 0 should work for most cases, but if you have tiles that are semi-transparent, then you might want to use a different
  * value, like 0.5.
+
+ * The tiles are drawn by chunks of 64x64 tiles, only the chunks in the view of the camera are drawn. The vertices of a chunk are
+ * uploaded once, when it is visible for the first time. The tiles changed with setTileGID() after that, like animated tiles, are
+ * drawn from a small dynamic buffer instead.
  
  * For further information, please see the programming guide:
  * http://www.cocos2d-iphone.org/wiki/doku.php/prog_guide:tiled_maps
@@ -274,7 +278,7 @@ public:
 protected:
 
     bool initWithTilesetInfo(TMXTilesetInfo *tilesetInfo, TMXLayerInfo *layerInfo, TMXMapInfo *mapInfo);
-    void updateTiles(const Rect& culledRect);
+    void updateVisibleChunks(const Rect& culledRect);
     Vec2 calculateLayerOffset(const Vec2& offset);
 
     /* The layer recognizes some special properties, like cc_vertexz */
@@ -288,15 +292,39 @@ protected:
     //Flip flags is packed into gid
     void setFlaggedTileGIDByIndex(int index, uint32_t gid);
     
+    // the vertices and the indices of a part of the layer, with a primitive for each vertex z
+    struct TileBuffer
+    {
+        VertexBuffer* vertexBuffer = nullptr;
+        VertexData* vertexData = nullptr;
+        IndexBuffer* indexBuffer = nullptr;
+        Map<int/*vertexZ*/, Primitive*> primitives;
+        bool indicesDirty = true;
+    };
+
+    // the quads of a chunk are in the order of its tiles, the empty ones are left out of the indices
+    struct TileChunk : public TileBuffer
+    {
+        int x = 0;
+        int y = 0;
+        int width = 0;
+        int height = 0;
+        bool built = false;
+    };
+
     //
-    void updateTotalQuads();
-    
+    void updateChunks();
+    void buildChunk(TileChunk& chunk);
+    void updateChunkIndices(TileChunk& chunk);
+    void updateAnimatedTiles();
+    void setupQuad(V3F_C4B_T2F_Quad& quad, int x, int y, uint32_t tileGID);
+    void updateIndices(TileBuffer& buffer, int maxQuads);
+    void addPrimitives(const TileBuffer& buffer);
+    static void releaseTileBuffer(TileBuffer& buffer);
+    TileChunk& getChunkForTile(int x, int y);
+
     void onDraw(Primitive* primitive);
     int getTileIndexByPos(int x, int y) const { return x + y * (int) _layerSize.width; }
-    
-    void updateVertexBuffer();
-    void updateIndexBuffer();
-    void updatePrimitives();
 protected:
     
     //! name of the layer
@@ -333,26 +361,32 @@ protected:
     Mat4 _tileToNodeTransform;
     /** data for rendering */
     bool _quadsDirty;
-    std::vector<int> _tileToQuadIndex;
-    std::vector<V3F_C4B_T2F_Quad> _totalQuads;
+    std::vector<TileChunk> _chunks;
+    int _chunksWide;
+    /** the visible chunks, from the first one to the last one in each direction */
+    int _visibleChunkBegin[2];
+    int _visibleChunkEnd[2];
+    /** the range of the vertex z of the visible tiles */
+    int _visibleVertexZ[2];
+
+    /** the tiles changed after their chunk was built: map<tile index, quad> */
+    std::unordered_map<int, int> _animatedTileQuads;
+    std::vector<int> _animatedTiles;
+    std::vector<V3F_C4B_T2F_Quad> _animatedQuads;
+    TileBuffer _animatedBuffer;
+    bool _animatedQuadsDirty;
+
+    /** scratch data, the quads of a buffer sorted by vertex z and their indices */
+    std::vector<std::pair<int/*vertexZ*/, int/*quad*/>> _quadsByVertexZ;
 #ifdef CC_FAST_TILEMAP_32_BIT_INDICES
     std::vector<GLuint> _indices;
 #else
     std::vector<GLushort> _indices;
 #endif
-    std::map<int/*vertexZ*/, int/*offset to _indices by quads*/> _indicesVertexZOffsets;
-    std::unordered_map<int/*vertexZ*/, int/*number to quads*/> _indicesVertexZNumber;
+    std::vector<std::pair<int/*vertexZ*/, Primitive*>> _visiblePrimitives;
     std::vector<PrimitiveCommand> _renderCommands;
     bool _dirty;
     
-    VertexBuffer* _vertexBuffer;
-    
-    VertexData* _vData;
-    
-    IndexBuffer* _indexBuffer;
-    
-    Map<int , Primitive*> _primitives;
-    
 public:
     /** Possible orientations of the TMX map */
     static const int FAST_TMX_ORIENTATION_ORTHO;
@@ -30,15 +30,145 @@
 #elif CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID
 #include "platform/android/jni/Java_org_cocos2dx_lib_Cocos2dxHelper.h"
 #endif
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
 #include "2d/CCFontFreeType.h"
 #include "base/ccUTF8.h"
 #include "base/CCDirector.h"
 #include "base/CCEventListenerCustom.h"
 #include "base/CCEventDispatcher.h"
 #include "base/CCEventType.h"
+#include "base/CCAsyncTaskPool.h"
+#include "base/CCJobSystem.h"
+#include "platform/CCFileUtils.h"
 
 NS_CC_BEGIN
 
+// Lives as long as the atlas or the last task rasterizing letters for it. The tasks only read the font,
+// the atlas waits for them to stop before it releases the font.
+struct FontAtlas::AsyncRasterizer
+{
+    struct Letter
+    {
+        char32_t utf32Char;
+        unsigned int charCode;
+        FontGlyphBitmap glyph;
+    };
+
+    explicit AsyncRasterizer(const FontFreeType* font_)
+    : font(font_)
+    , jobSystem(JobSystem::getInstance())
+    , cancelled(false)
+    , activeTasks(0)
+    {
+    }
+
+    ~AsyncRasterizer()
+    {
+        for (auto& item : faces)
+        {
+            FontFreeType::destroyThreadFace(item.second);
+        }
+    }
+
+    // the face of the calling thread, created the first time the thread rasterizes a letter
+    const FontFreeType::ThreadFace* getThreadFace()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = faces.find(std::this_thread::get_id());
+        if (it == faces.end())
+        {
+            FontFreeType::ThreadFace face;
+            if (!font->createThreadFace(face))
+            {
+                return nullptr;
+            }
+            it = faces.emplace(std::this_thread::get_id(), face).first;
+        }
+        return &it->second;
+    }
+
+    void rasterize(std::vector<Letter>& letters)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (cancelled)
+                return;
+            ++activeTasks;
+        }
+
+        jobSystem->parallelFor(static_cast<int>(letters.size()), [this, &letters](int i) {
+            auto face = cancelled ? nullptr : getThreadFace();
+            if (face == nullptr || !font->rasterizeGlyph(letters[i].charCode, letters[i].glyph, face))
+            {
+                letters[i].glyph.pixelsWidth = letters[i].glyph.pixelsHeight = 0;
+                letters[i].glyph.bitmapWidth = letters[i].glyph.bitmapHeight = 0;
+                letters[i].glyph.pixels.clear();
+            }
+        });
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!cancelled)
+            {
+                std::move(letters.begin(), letters.end(), std::back_inserter(rasterizedLetters));
+            }
+            --activeTasks;
+        }
+        idle.notify_all();
+    }
+
+    const FontFreeType* font;
+    JobSystem* jobSystem;
+    std::mutex mutex;
+    std::condition_variable idle;
+    std::atomic<bool> cancelled;
+    int activeTasks;
+    std::unordered_map<std::thread::id, FontFreeType::ThreadFace> faces;
+    std::vector<Letter> rasterizedLetters;
+};
+
+namespace {
+
+// the files written by FontAtlas::saveToFile() stay on the device, they are in its byte order
+const char ATLAS_FILE_MAGIC[] = "CCFA";
+const uint32_t ATLAS_FILE_VERSION = 1;
+
+struct AtlasFileHeader
+{
+    char magic[4];
+    uint32_t version;
+    uint32_t key;
+    int32_t pageWidth;
+    int32_t pageHeight;
+    int32_t pageDataSize;
+    int32_t pageCount;
+    int32_t letterCount;
+    float currentPageOrigX;
+    float currentPageOrigY;
+    int32_t currLineHeight;
+};
+
+struct AtlasFileLetter
+{
+    uint32_t utf32Char;
+    float U;
+    float V;
+    float width;
+    float height;
+    float offsetX;
+    float offsetY;
+    int32_t textureID;
+    int32_t xAdvance;
+    int32_t validDefinition;
+};
+
+}
+
 const int FontAtlas::CacheTextureWidth = 512;
 const int FontAtlas::CacheTextureHeight = 512;
 const char* FontAtlas::CMD_PURGE_FONTATLAS = "__cc_PURGE_FONTATLAS";
@@ -53,6 +183,8 @@ FontAtlas::FontAtlas(Font &theFont)
 , _rendererRecreatedListener(nullptr)
 , _antialiasEnabled(true)
 , _currLineHeight(0)
+, _letterGeneration(0)
+, _pageDataRetained(false)
 {
     _font->retain();
 
@@ -113,6 +245,8 @@ void FontAtlas::reinit()
 
 FontAtlas::~FontAtlas()
 {
+    stopAsyncRasterization();
+
 #if CC_ENABLE_CACHE_TEXTURE_DATA
     if (_fontFreeType && _rendererRecreatedListener)
     {
@@ -145,6 +279,7 @@ void FontAtlas::reset()
     _currentPageOrigX = 0;
     _currentPageOrigY = 0;
     _letterDefinitions.clear();
+    _retainedPages.clear();
     
     reinit();
 }
@@ -280,7 +415,7 @@ void FontAtlas::findNewCharacters(const std::u32string& u32Text, std::unordered_
     FT_Encoding charEncoding = _fontFreeType->getEncoding();
 
     //find new characters
-    if (_letterDefinitions.empty())
+    if (_letterDefinitions.empty() && _pendingLetters.empty())
     {
         // fixed #16169: new android project crash in android 5.0.2 device (Nexus 7) when use 3.12.
         // While using clang compiler with gnustl_static on android, the copy assignment operator of `std::u32string`
@@ -304,7 +439,7 @@ void FontAtlas::findNewCharacters(const std::u32string& u32Text, std::unordered_
         for (size_t i = 0; i < length; ++i)
         {
             auto outIterator = _letterDefinitions.find(u32Text[i]);
-            if (outIterator == _letterDefinitions.end())
+            if (outIterator == _letterDefinitions.end() && !_pendingLetters.count(u32Text[i]))
             {
                 newChars.push_back(u32Text[i]);
             }
@@ -352,118 +487,383 @@ bool FontAtlas::prepareLetterDefinitions(const std::u32string& utf32Text)
         return false;
     }
 
+    if (_asyncRasterizer)
+    {
+        auto letters = std::make_shared<std::vector<AsyncRasterizer::Letter>>();
+        letters->reserve(codeMapOfNewChar.size());
+        for (auto&& it : codeMapOfNewChar)
+        {
+            _pendingLetters.insert(it.first);
+            letters->push_back({ it.first, it.second, FontGlyphBitmap() });
+        }
+        auto rasterizer = _asyncRasterizer;
+        AsyncTaskPool::getInstance()->enqueue(AsyncTaskPool::TaskType::TASK_OTHER, [rasterizer, letters]() {
+            rasterizer->rasterize(*letters);
+        });
+        return false;
+    }
+
+    auto  pixelFormat = _fontFreeType->getOutlineSize() > 0 ? Texture2D::PixelFormat::AI88 : Texture2D::PixelFormat::A8;
+    float startY = _currentPageOrigY;
+    FontGlyphBitmap glyph;
+    for (auto&& it : codeMapOfNewChar)
+    {
+        _fontFreeType->rasterizeGlyph(it.second, glyph);
+        addLetter(it.first, glyph, startY);
+    }
+    updateTextureContent(pixelFormat, startY);
+
+    return true;
+}
+
+void FontAtlas::addLetter(char32_t utf32Char, const FontGlyphBitmap& glyph, float& startY)
+{
     int adjustForDistanceMap = _letterPadding / 2;
     int adjustForExtend = _letterEdgeExtend / 2;
-    long bitmapWidth;
-    long bitmapHeight;
-    int glyphHeight;
-    Rect tempRect;
     FontLetterDefinition tempDef;
+    tempDef.xAdvance = glyph.xAdvance;
 
     auto scaleFactor = CC_CONTENT_SCALE_FACTOR();
     auto  pixelFormat = _fontFreeType->getOutlineSize() > 0 ? Texture2D::PixelFormat::AI88 : Texture2D::PixelFormat::A8;
 
-    float startY = _currentPageOrigY;
-
-    for (auto&& it : codeMapOfNewChar)
+    if (!glyph.pixels.empty())
     {
-        auto bitmap = _fontFreeType->getGlyphBitmap(it.second, bitmapWidth, bitmapHeight, tempRect, tempDef.xAdvance);
-        if (bitmap && bitmapWidth > 0 && bitmapHeight > 0)
-        {
-            tempDef.validDefinition = true;
-            tempDef.width = tempRect.size.width + _letterPadding + _letterEdgeExtend;
-            tempDef.height = tempRect.size.height + _letterPadding + _letterEdgeExtend;
-            tempDef.offsetX = tempRect.origin.x - adjustForDistanceMap - adjustForExtend;
-            tempDef.offsetY = _fontAscender + tempRect.origin.y - adjustForDistanceMap - adjustForExtend;
+        tempDef.validDefinition = true;
+        tempDef.width = glyph.rect.size.width + _letterPadding + _letterEdgeExtend;
+        tempDef.height = glyph.rect.size.height + _letterPadding + _letterEdgeExtend;
+        tempDef.offsetX = glyph.rect.origin.x - adjustForDistanceMap - adjustForExtend;
+        tempDef.offsetY = _fontAscender + glyph.rect.origin.y - adjustForDistanceMap - adjustForExtend;
 
-            if (_currentPageOrigX + tempDef.width > CacheTextureWidth)
+        if (_currentPageOrigX + tempDef.width > CacheTextureWidth)
+        {
+            _currentPageOrigY += _currLineHeight;
+            _currLineHeight = 0;
+            _currentPageOrigX = 0;
+            if (_currentPageOrigY + _lineHeight + _letterPadding + _letterEdgeExtend >= CacheTextureHeight)
             {
-                _currentPageOrigY += _currLineHeight;
-                _currLineHeight = 0;
-                _currentPageOrigX = 0;
-                if (_currentPageOrigY + _lineHeight + _letterPadding + _letterEdgeExtend >= CacheTextureHeight)
+                updateTextureContent(pixelFormat, startY);
+
+                startY = 0.0f;
+
+                if (_pageDataRetained)
                 {
-                    unsigned char *data = nullptr;
-                    if (pixelFormat == Texture2D::PixelFormat::AI88)
-                    {
-                        data = _currentPageData + CacheTextureWidth * (int)startY * 2;
-                    }
-                    else
-                    {
-                        data = _currentPageData + CacheTextureWidth * (int)startY;
-                    }
-                    _atlasTextures[_currentPage]->updateWithData(data, 0, startY,
-                        CacheTextureWidth, CacheTextureHeight - startY);
-
-                    startY = 0.0f;
-
-                    _currentPageOrigY = 0;
-                    memset(_currentPageData, 0, _currentPageDataSize);
-                    _currentPage++;
-                    auto tex = new (std::nothrow) Texture2D;
-                    if (_antialiasEnabled)
-                    {
-                        tex->setAntiAliasTexParameters();
-                    }
-                    else
-                    {
-                        tex->setAliasTexParameters();
-                    }
-                    tex->initWithData(_currentPageData, _currentPageDataSize,
-                        pixelFormat, CacheTextureWidth, CacheTextureHeight, Size(CacheTextureWidth, CacheTextureHeight));
-                    addTexture(tex, _currentPage);
-                    tex->release();
+                    _retainedPages.emplace_back(_currentPageData, _currentPageData + _currentPageDataSize);
                 }
+                _currentPageOrigY = 0;
+                memset(_currentPageData, 0, _currentPageDataSize);
+                _currentPage++;
+                addPageTexture(_currentPage, _currentPageData, pixelFormat);
             }
-            glyphHeight = static_cast<int>(bitmapHeight) + _letterPadding + _letterEdgeExtend;
-            if (glyphHeight > _currLineHeight)
-            {
-                _currLineHeight = glyphHeight;
-            }
-            _fontFreeType->renderCharAt(_currentPageData, _currentPageOrigX + adjustForExtend, _currentPageOrigY + adjustForExtend, bitmap, bitmapWidth, bitmapHeight);
-
-            tempDef.U = _currentPageOrigX;
-            tempDef.V = _currentPageOrigY;
-            tempDef.textureID = _currentPage;
-            _currentPageOrigX += tempDef.width + 1;
-            // take from pixels to points
-            tempDef.width = tempDef.width / scaleFactor;
-            tempDef.height = tempDef.height / scaleFactor;
-            tempDef.U = tempDef.U / scaleFactor;
-            tempDef.V = tempDef.V / scaleFactor;
         }
-        else{
-            if(bitmap)
-                delete[] bitmap;
-            if (tempDef.xAdvance)
-                tempDef.validDefinition = true;
-            else
-                tempDef.validDefinition = false;
-
-            tempDef.width = 0;
-            tempDef.height = 0;
-            tempDef.U = 0;
-            tempDef.V = 0;
-            tempDef.offsetX = 0;
-            tempDef.offsetY = 0;
-            tempDef.textureID = 0;
-            _currentPageOrigX += 1;
+        int glyphHeight = static_cast<int>(glyph.bitmapHeight) + _letterPadding + _letterEdgeExtend;
+        if (glyphHeight > _currLineHeight)
+        {
+            _currLineHeight = glyphHeight;
+        }
+
+        // the pixels as FontFreeType::renderCharAt() writes them into the page
+        int bytesPerPixel = pixelFormat == Texture2D::PixelFormat::AI88 ? 2 : 1;
+        int posX = static_cast<int>(_currentPageOrigX) + adjustForExtend;
+        int posY = static_cast<int>(_currentPageOrigY) + adjustForExtend;
+        for (long y = 0; y < glyph.pixelsHeight; ++y)
+        {
+            memcpy(_currentPageData + (posX + (posY + y) * CacheTextureWidth) * bytesPerPixel,
+                   glyph.pixels.data() + y * glyph.pixelsWidth * bytesPerPixel, glyph.pixelsWidth * bytesPerPixel);
         }
 
-        _letterDefinitions[it.first] = tempDef;
+        tempDef.U = _currentPageOrigX;
+        tempDef.V = _currentPageOrigY;
+        tempDef.textureID = _currentPage;
+        _currentPageOrigX += tempDef.width + 1;
+        // take from pixels to points
+        tempDef.width = tempDef.width / scaleFactor;
+        tempDef.height = tempDef.height / scaleFactor;
+        tempDef.U = tempDef.U / scaleFactor;
+        tempDef.V = tempDef.V / scaleFactor;
+    }
+    else{
+        if (tempDef.xAdvance)
+            tempDef.validDefinition = true;
+        else
+            tempDef.validDefinition = false;
+
+        tempDef.width = 0;
+        tempDef.height = 0;
+        tempDef.U = 0;
+        tempDef.V = 0;
+        tempDef.offsetX = 0;
+        tempDef.offsetY = 0;
+        tempDef.textureID = 0;
+        _currentPageOrigX += 1;
     }
 
+    _letterDefinitions[utf32Char] = tempDef;
+}
+
+void FontAtlas::addPageTexture(int slot, const unsigned char* data, Texture2D::PixelFormat format)
+{
+    auto tex = new (std::nothrow) Texture2D;
+    if (_antialiasEnabled)
+    {
+        tex->setAntiAliasTexParameters();
+    }
+    else
+    {
+        tex->setAliasTexParameters();
+    }
+    tex->initWithData(data, _currentPageDataSize,
+        format, CacheTextureWidth, CacheTextureHeight, Size(CacheTextureWidth, CacheTextureHeight));
+    addTexture(tex, slot);
+    tex->release();
+}
+
+void FontAtlas::updateTextureContent(Texture2D::PixelFormat format, int startY)
+{
     unsigned char *data = nullptr;
-    if (pixelFormat == Texture2D::PixelFormat::AI88)
+    if (format == Texture2D::PixelFormat::AI88)
     {
-        data = _currentPageData + CacheTextureWidth * (int)startY * 2;
+        data = _currentPageData + CacheTextureWidth * startY * 2;
     }
     else
     {
-        data = _currentPageData + CacheTextureWidth * (int)startY;
+        data = _currentPageData + CacheTextureWidth * startY;
     }
     _atlasTextures[_currentPage]->updateWithData(data, 0, startY, CacheTextureWidth, _currentPageOrigY - startY + _currLineHeight);
+}
+
+bool FontAtlas::prewarmWithCharsetFile(const std::string& filename)
+{
+    std::string charset = FileUtils::getInstance()->getStringFromFile(filename);
+    std::u32string utf32;
+    if (charset.empty() || !StringUtils::UTF8ToUTF32(charset, utf32))
+    {
+        CCLOG("FontAtlas::prewarmWithCharsetFile: can't read %s", filename.c_str());
+        return false;
+    }
+
+    // one character per line is the usual layout of these files
+    utf32.erase(std::remove_if(utf32.begin(), utf32.end(), [](char32_t c) {
+        return c == StringUtils::UnicodeCharacters::NewLine || c == StringUtils::UnicodeCharacters::CarriageReturn;
+    }), utf32.end());
+    prepareLetterDefinitions(utf32);
+    return true;
+}
+
+void FontAtlas::setAsyncRasterizationEnabled(bool enabled)
+{
+    if (enabled && !_asyncRasterizer && _fontFreeType)
+    {
+        _asyncRasterizer = std::make_shared<AsyncRasterizer>(_fontFreeType);
+    }
+    else if (!enabled && _asyncRasterizer)
+    {
+        // the letters being rasterized are dropped, the labels waiting for them rasterize them again
+        stopAsyncRasterization();
+        _pendingLetters.clear();
+        ++_letterGeneration;
+    }
+}
+
+void FontAtlas::stopAsyncRasterization()
+{
+    if (_asyncRasterizer)
+    {
+        std::unique_lock<std::mutex> lock(_asyncRasterizer->mutex);
+        _asyncRasterizer->cancelled = true;
+        _asyncRasterizer->idle.wait(lock, [this] { return _asyncRasterizer->activeTasks == 0; });
+        lock.unlock();
+        _asyncRasterizer = nullptr;
+    }
+}
+
+bool FontAtlas::hasPendingLetters(const std::u32string& utf32Text) const
+{
+    if (_pendingLetters.empty())
+    {
+        return false;
+    }
+    for (auto c : utf32Text)
+    {
+        if (_pendingLetters.count(c))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool FontAtlas::commitRasterizedLetters()
+{
+    if (!_asyncRasterizer)
+    {
+        return false;
+    }
+
+    std::vector<AsyncRasterizer::Letter> letters;
+    {
+        std::lock_guard<std::mutex> lock(_asyncRasterizer->mutex);
+        letters.swap(_asyncRasterizer->rasterizedLetters);
+    }
+    if (letters.empty())
+    {
+        return false;
+    }
+
+    if (!_currentPageData)
+        reinit();
+
+    auto  pixelFormat = _fontFreeType->getOutlineSize() > 0 ? Texture2D::PixelFormat::AI88 : Texture2D::PixelFormat::A8;
+    float startY = _currentPageOrigY;
+    for (auto& letter : letters)
+    {
+        _pendingLetters.erase(letter.utf32Char);
+        addLetter(letter.utf32Char, letter.glyph, startY);
+    }
+    updateTextureContent(pixelFormat, startY);
+    ++_letterGeneration;
+    return true;
+}
+
+void FontAtlas::setPageDataRetained(bool retained)
+{
+    _pageDataRetained = retained;
+    if (!retained)
+    {
+        _retainedPages.clear();
+        _retainedPages.shrink_to_fit();
+    }
+}
+
+bool FontAtlas::saveToFile(const std::string& filename, unsigned int key) const
+{
+    if (!_currentPageData || static_cast<int>(_retainedPages.size()) != _currentPage)
+    {
+        CCLOG("FontAtlas::saveToFile: the full pages of the atlas weren't retained");
+        return false;
+    }
+
+    AtlasFileHeader header;
+    memcpy(header.magic, ATLAS_FILE_MAGIC, sizeof(header.magic));
+    header.version = ATLAS_FILE_VERSION;
+    header.key = key;
+    header.pageWidth = CacheTextureWidth;
+    header.pageHeight = CacheTextureHeight;
+    header.pageDataSize = _currentPageDataSize;
+    header.pageCount = _currentPage + 1;
+    header.letterCount = static_cast<int32_t>(_letterDefinitions.size());
+    header.currentPageOrigX = _currentPageOrigX;
+    header.currentPageOrigY = _currentPageOrigY;
+    header.currLineHeight = _currLineHeight;
+
+    ssize_t size = sizeof(header) + header.letterCount * sizeof(AtlasFileLetter) + header.pageCount * static_cast<ssize_t>(_currentPageDataSize);
+    auto bytes = static_cast<unsigned char*>(malloc(size));
+    if (!bytes)
+    {
+        return false;
+    }
+
+    auto out = bytes;
+    memcpy(out, &header, sizeof(header));
+    out += sizeof(header);
+    for (auto&& item : _letterDefinitions)
+    {
+        auto& letterDefinition = item.second;
+        AtlasFileLetter letter;
+        letter.utf32Char = item.first;
+        letter.U = letterDefinition.U;
+        letter.V = letterDefinition.V;
+        letter.width = letterDefinition.width;
+        letter.height = letterDefinition.height;
+        letter.offsetX = letterDefinition.offsetX;
+        letter.offsetY = letterDefinition.offsetY;
+        letter.textureID = letterDefinition.textureID;
+        letter.xAdvance = letterDefinition.xAdvance;
+        letter.validDefinition = letterDefinition.validDefinition;
+        memcpy(out, &letter, sizeof(letter));
+        out += sizeof(letter);
+    }
+    for (auto& page : _retainedPages)
+    {
+        memcpy(out, page.data(), _currentPageDataSize);
+        out += _currentPageDataSize;
+    }
+    memcpy(out, _currentPageData, _currentPageDataSize);
+
+    Data data;
+    data.fastSet(bytes, size);
+    return FileUtils::getInstance()->writeDataToFile(data, filename);
+}
+
+bool FontAtlas::initWithFile(const std::string& filename, unsigned int key)
+{
+    if (_fontFreeType == nullptr)
+    {
+        return false;
+    }
+
+    if (!_currentPageData)
+        reinit();
+
+    Data data = FileUtils::getInstance()->getDataFromFile(filename);
+    auto bytes = data.getBytes();
+    AtlasFileHeader header;
+    if (static_cast<size_t>(data.getSize()) < sizeof(header))
+    {
+        return false;
+    }
+    memcpy(&header, bytes, sizeof(header));
+    if (memcmp(header.magic, ATLAS_FILE_MAGIC, sizeof(header.magic)) != 0 || header.version != ATLAS_FILE_VERSION
+        || header.key != key || header.pageWidth != CacheTextureWidth || header.pageHeight != CacheTextureHeight
+        || header.pageDataSize != _currentPageDataSize || header.pageCount <= 0 || header.letterCount < 0
+        || data.getSize() != static_cast<ssize_t>(sizeof(header) + header.letterCount * sizeof(AtlasFileLetter)
+            + header.pageCount * static_cast<ssize_t>(_currentPageDataSize)))
+    {
+        CCLOG("FontAtlas::initWithFile: %s is not an atlas of this font", filename.c_str());
+        return false;
+    }
+
+    auto in = bytes + sizeof(header);
+    _letterDefinitions.clear();
+    for (int i = 0; i < header.letterCount; ++i)
+    {
+        AtlasFileLetter letter;
+        memcpy(&letter, in, sizeof(letter));
+        in += sizeof(letter);
+        FontLetterDefinition letterDefinition;
+        letterDefinition.U = letter.U;
+        letterDefinition.V = letter.V;
+        letterDefinition.width = letter.width;
+        letterDefinition.height = letter.height;
+        letterDefinition.offsetX = letter.offsetX;
+        letterDefinition.offsetY = letter.offsetY;
+        letterDefinition.textureID = letter.textureID;
+        letterDefinition.xAdvance = letter.xAdvance;
+        letterDefinition.validDefinition = letter.validDefinition != 0;
+        _letterDefinitions[letter.utf32Char] = letterDefinition;
+    }
+
+    auto pixelFormat = _fontFreeType->getOutlineSize() > 0 ? Texture2D::PixelFormat::AI88 : Texture2D::PixelFormat::A8;
+    releaseTextures();
+    _retainedPages.clear();
+    for (int page = 0; page < header.pageCount; ++page)
+    {
+        addPageTexture(page, in, pixelFormat);
+        if (_pageDataRetained && page + 1 < header.pageCount)
+        {
+            _retainedPages.emplace_back(in, in + _currentPageDataSize);
+        }
+        if (page + 1 < header.pageCount)
+        {
+            in += _currentPageDataSize;
+        }
+    }
+    memcpy(_currentPageData, in, _currentPageDataSize);
 
+    _currentPage = header.pageCount - 1;
+    _currentPageOrigX = header.currentPageOrigX;
+    _currentPageOrigY = header.currentPageOrigY;
+    _currLineHeight = header.currLineHeight;
+    ++_letterGeneration;
     return true;
 }
 
@@ -29,17 +29,20 @@
 
 /// @cond DO_NOT_SHOW
 
+#include <memory>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 #include "platform/CCPlatformMacros.h"
 #include "base/CCRef.h"
 #include "platform/CCStdC.h" // ssize_t on windows
+#include "renderer/CCTexture2D.h"
 
 NS_CC_BEGIN
 
 class Font;
-class Texture2D;
 class EventCustom;
 class EventListenerCustom;
 class FontFreeType;
@@ -57,6 +60,18 @@ struct FontLetterDefinition
     int xAdvance;
 };
 
+/** A glyph rendered the way it is stored in the atlas, with the metrics of FontFreeType::getGlyphBitmap(). */
+struct FontGlyphBitmap
+{
+    std::vector<unsigned char> pixels;  // 2 bytes per pixel with an outline, 1 otherwise
+    long pixelsWidth;                   // the distance map is 2 * FontFreeType::DistanceMapSpread larger than the bitmap
+    long pixelsHeight;
+    long bitmapWidth;
+    long bitmapHeight;
+    Rect rect;
+    int xAdvance;
+};
+
 class CC_DLL FontAtlas : public Ref
 {
 public:
@@ -79,6 +94,44 @@ public:
     
     bool prepareLetterDefinitions(const std::u32string& utf16String);
 
+    /**
+     * Prepares the letters of a UTF-8 text file, like the few thousand most common hanzi, so that labels don't
+     * rasterize them the first time they show them. Returns false if the file can't be read.
+     */
+    bool prewarmWithCharsetFile(const std::string& filename);
+
+    /**
+     * Rasterizes new letters on worker threads, each with a FreeType face of its own. prepareLetterDefinitions()
+     * then only queues the letters it doesn't have, commitRasterizedLetters() adds them to the atlas on the cocos
+     * thread. A label stays hidden until all of its letters are in the atlas.
+     */
+    void setAsyncRasterizationEnabled(bool enabled);
+    bool isAsyncRasterizationEnabled() const { return _asyncRasterizer != nullptr; }
+
+    /** Returns true if some letters of the text are being rasterized. */
+    bool hasPendingLetters(const std::u32string& utf32Text) const;
+
+    /** Adds the letters rasterized since the last call to the atlas, returns true if there were any. */
+    bool commitRasterizedLetters();
+
+    /** Changes whenever letters are committed, labels waiting for letters lay out again when it does. */
+    unsigned int getLetterGeneration() const { return _letterGeneration; }
+
+    /**
+     * Keeps a copy of the pages which are full, for saveToFile(). Otherwise only the page letters are added to
+     * stays in memory, the full ones are only in their textures.
+     */
+    void setPageDataRetained(bool retained);
+
+    /** Writes the letters and the pages of the atlas to a file, with a key initWithFile() checks. */
+    bool saveToFile(const std::string& filename, unsigned int key) const;
+
+    /**
+     * Replaces the letters and the pages of the atlas with the ones of a file written by saveToFile() for the
+     * same font, returns false if the file can't be read or has another key.
+     */
+    bool initWithFile(const std::string& filename, unsigned int key);
+
     const std::unordered_map<ssize_t, Texture2D*>& getTextures() const { return _atlasTextures; }
     void  addTexture(Texture2D *texture, int slot);
     float getLineHeight() const { return _lineHeight; }
@@ -122,6 +175,18 @@ protected:
 
     void conversionU32TOGB2312(const std::u32string& u32Text, std::unordered_map<unsigned int, unsigned int>& charCodeMap);
 
+    /** Places a rasterized letter in the current page, a full page is uploaded from startY and a new one started. */
+    void addLetter(char32_t utf32Char, const FontGlyphBitmap& glyph, float& startY);
+
+    /** Creates the texture of a page from its pixels. */
+    void addPageTexture(int slot, const unsigned char* data, Texture2D::PixelFormat format);
+
+    /** Uploads the rows of the current page from startY. */
+    void updateTextureContent(Texture2D::PixelFormat format, int startY);
+
+    struct AsyncRasterizer;
+    void stopAsyncRasterization();
+
     /**
      * Scale each font letter by scaleFactor.
      *
@@ -150,6 +215,15 @@ protected:
     bool _antialiasEnabled;
     int _currLineHeight;
 
+    // shared with the tasks rasterizing letters, the letters they have queued are pending
+    std::shared_ptr<AsyncRasterizer> _asyncRasterizer;
+    std::unordered_set<char32_t> _pendingLetters;
+    unsigned int _letterGeneration;
+
+    // the pages before _currentPage, while setPageDataRetained(true)
+    std::vector<std::vector<unsigned char>> _retainedPages;
+    bool _pageDataRetained;
+
     friend class Label;
 };
 
@@ -25,7 +25,10 @@
  ****************************************************************************/
 #include "2d/CCFontAtlasCache.h"
 
+#include "xxhash.h"
+
 #include "base/CCDirector.h"
+#include "base/ccUTF8.h"
 #include "2d/CCFontFNT.h"
 #include "2d/CCFontFreeType.h"
 #include "2d/CCFontAtlas.h"
@@ -36,8 +39,49 @@
 NS_CC_BEGIN
 
 std::unordered_map<std::string, FontAtlas *> FontAtlasCache::_atlasMap;
+std::unordered_map<std::string, std::string> FontAtlasCache::_distanceFieldCharsets;
 #define ATLAS_MAP_KEY_PREFIX_BUFFER_SIZE 255
 
+const float FontAtlasCache::DistanceFieldFontSize = 48.0f;
+
+// Loads a distance field atlas from the disk cache, or prewarms it with the charset and saves it there,
+// the file name is a hash of the font file, the size of the letters and the charset.
+static void loadDistanceFieldFontAtlas(FontAtlas* atlas, FontFreeType* font, const std::string& charsetFile)
+{
+    auto fileUtils = FileUtils::getInstance();
+    std::string charset = fileUtils->getStringFromFile(charsetFile);
+    if (charset.empty())
+    {
+        CCLOG("FontAtlasCache: can't read the charset file %s", charsetFile.c_str());
+        return;
+    }
+
+    unsigned int key = XXH32(font->getFontData(), font->getFontDataSize(), 0);
+    key = XXH32(charset.data(), charset.size(), key);
+    const int parameters[] = {
+        static_cast<int>(FontAtlasCache::DistanceFieldFontSize * CC_CONTENT_SCALE_FACTOR() * 64),
+        FontFreeType::DistanceMapSpread,
+        FontAtlas::CacheTextureWidth,
+        FontAtlas::CacheTextureHeight
+    };
+    key = XXH32(parameters, sizeof(parameters), key);
+
+    std::string directory = fileUtils->getWritablePath() + "fontatlas/";
+    std::string cacheFile = directory + StringUtils::format("%08x.atlas", key);
+    if (fileUtils->isFileExist(cacheFile) && atlas->initWithFile(cacheFile, key))
+    {
+        return;
+    }
+
+    atlas->setPageDataRetained(true);
+    atlas->prewarmWithCharsetFile(charsetFile);
+    if (!fileUtils->createDirectory(directory) || !atlas->saveToFile(cacheFile, key))
+    {
+        CCLOG("FontAtlasCache: can't write %s", cacheFile.c_str());
+    }
+    atlas->setPageDataRetained(false);
+}
+
 void FontAtlasCache::purgeCachedData()
 {
     auto atlasMapCopy = _atlasMap;
@@ -60,9 +104,12 @@ FontAtlas* FontAtlasCache::getFontAtlasTTF(const _ttfConfig* config)
         useDistanceField = false;
     }
 
+    // labels scale the letters of distance field atlases, all the sizes share one
+    float fontSize = useDistanceField ? DistanceFieldFontSize : config->fontSize;
+
     std::string key;
     char keyPrefix[ATLAS_MAP_KEY_PREFIX_BUFFER_SIZE];
-    snprintf(keyPrefix, ATLAS_MAP_KEY_PREFIX_BUFFER_SIZE, useDistanceField ? "df %.2f %d " : "%.2f %d ", config->fontSize, config->outlineSize);
+    snprintf(keyPrefix, ATLAS_MAP_KEY_PREFIX_BUFFER_SIZE, useDistanceField ? "df %.2f %d " : "%.2f %d ", fontSize, config->outlineSize);
     std::string atlasName(keyPrefix);
     atlasName += realFontFilename;
 
@@ -70,13 +117,18 @@ FontAtlas* FontAtlasCache::getFontAtlasTTF(const _ttfConfig* config)
 
     if ( it == _atlasMap.end() )
     {
-        auto font = FontFreeType::create(realFontFilename, config->fontSize, config->glyphs,
+        auto font = FontFreeType::create(realFontFilename, fontSize, config->glyphs,
             config->customGlyphs, useDistanceField, config->outlineSize);
         if (font)
         {
             auto tempAtlas = font->createFontAtlas();
             if (tempAtlas)
             {
+                auto charset = _distanceFieldCharsets.find(realFontFilename);
+                if (useDistanceField && charset != _distanceFieldCharsets.end())
+                {
+                    loadDistanceFieldFontAtlas(tempAtlas, font, charset->second);
+                }
                 _atlasMap[atlasName] = tempAtlas;
                 return _atlasMap[atlasName];
             }
@@ -88,6 +140,19 @@ FontAtlas* FontAtlasCache::getFontAtlasTTF(const _ttfConfig* config)
     return nullptr;
 }
 
+void FontAtlasCache::setDistanceFieldCharsetFile(const std::string& fontFilePath, const std::string& charsetFile)
+{
+    auto realFontFilename = FileUtils::getInstance()->getNewFilename(fontFilePath);
+    if (charsetFile.empty())
+    {
+        _distanceFieldCharsets.erase(realFontFilename);
+    }
+    else
+    {
+        _distanceFieldCharsets[realFontFilename] = charsetFile;
+    }
+}
+
 FontAtlas* FontAtlasCache::getFontAtlasFNT(const std::string& fontFileName, const Vec2& imageOffset /* = Vec2::ZERO */)
 {
     auto realFontFilename = FileUtils::getInstance()->getNewFilename(fontFileName);  // resolves real file path, to prevent storing multiple atlases for the same file.
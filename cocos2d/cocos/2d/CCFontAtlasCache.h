@@ -41,7 +41,19 @@ struct _ttfConfig;
 class CC_DLL FontAtlasCache
 {  
 public:
+    /** The size of the letters in distance field atlases, one atlas serves the labels of all sizes of a font. */
+    static const float DistanceFieldFontSize;
+
     static FontAtlas* getFontAtlasTTF(const _ttfConfig* config);
+
+    /**
+     * Sets the file listing the letters, in UTF-8, that the distance field atlas of a font is prewarmed with.
+     * The atlas is saved under the writable path the first time it is built, and loaded from there by
+     * getFontAtlasTTF() on the next launches, as long as the font file, the size and the charset file are the same.
+     * An empty charset file turns it off.
+     */
+    static void setDistanceFieldCharsetFile(const std::string& fontFilePath, const std::string& charsetFile);
+
     static FontAtlas* getFontAtlasFNT(const std::string& fontFileName, const Vec2& imageOffset = Vec2::ZERO);
 
     static FontAtlas* getFontAtlasCharMap(const std::string& charMapFile, int itemWidth, int itemHeight, int startCharMap);
@@ -69,6 +81,7 @@ public:
 
 private:
     static std::unordered_map<std::string, FontAtlas *> _atlasMap;
+    static std::unordered_map<std::string, std::string> _distanceFieldCharsets;
 };
 
 NS_CC_END
@@ -102,6 +102,9 @@ FontFreeType::FontFreeType(bool distanceFieldEnabled /* = false */, float outlin
 : _fontRef(nullptr)
 , _stroker(nullptr)
 , _encoding(FT_ENCODING_UNICODE)
+, _fontData(nullptr)
+, _fontDataSize(0)
+, _fontSizePoints(0)
 , _distanceFieldEnabled(distanceFieldEnabled)
 , _outlineSize(0.0f)
 , _lineHeight(0)
@@ -177,6 +180,9 @@ bool FontFreeType::createFontObject(const std::string &fontName, float fontSize)
     
     // store the face globally
     _fontRef = face;
+    _fontData = s_cacheFontData[fontName].data.getBytes();
+    _fontDataSize = s_cacheFontData[fontName].data.getSize();
+    _fontSizePoints = fontSizePoints;
     _lineHeight = static_cast<int>((_fontRef->size->metrics.ascender - _fontRef->size->metrics.descender) >> 6);
     
     // done and good
@@ -289,38 +295,116 @@ const char* FontFreeType::getFontFamily() const
     return _fontRef->family_name;
 }
 
+bool FontFreeType::createThreadFace(ThreadFace& threadFace) const
+{
+    threadFace.library = nullptr;
+    threadFace.face = nullptr;
+    threadFace.stroker = nullptr;
+    if (_fontRef == nullptr || FT_Init_FreeType(&threadFace.library))
+        return false;
+
+    // the font file is shared, FreeType only reads it
+    if (FT_New_Memory_Face(threadFace.library, _fontData, _fontDataSize, 0, &threadFace.face)
+        || FT_Select_Charmap(threadFace.face, _encoding)
+        || FT_Set_Char_Size(threadFace.face, _fontSizePoints, _fontSizePoints, 72, 72))
+    {
+        destroyThreadFace(threadFace);
+        return false;
+    }
+
+    if (_stroker)
+    {
+        FT_Stroker_New(threadFace.library, &threadFace.stroker);
+        FT_Stroker_Set(threadFace.stroker,
+            (int)(_outlineSize * 64),
+            FT_STROKER_LINECAP_ROUND,
+            FT_STROKER_LINEJOIN_ROUND,
+            0);
+    }
+    return true;
+}
+
+void FontFreeType::destroyThreadFace(ThreadFace& threadFace)
+{
+    if (threadFace.stroker)
+    {
+        FT_Stroker_Done(threadFace.stroker);
+        threadFace.stroker = nullptr;
+    }
+    if (threadFace.face)
+    {
+        FT_Done_Face(threadFace.face);
+        threadFace.face = nullptr;
+    }
+    if (threadFace.library)
+    {
+        FT_Done_FreeType(threadFace.library);
+        threadFace.library = nullptr;
+    }
+}
+
+bool FontFreeType::rasterizeGlyph(uint64_t theChar, FontGlyphBitmap& glyph, const ThreadFace* threadFace) const
+{
+    ThreadFace face = { _FTlibrary, _fontRef, _stroker };
+    auto bitmap = getGlyphBitmap(threadFace ? *threadFace : face, theChar, glyph.bitmapWidth, glyph.bitmapHeight, glyph.rect, glyph.xAdvance);
+    if (bitmap == nullptr || glyph.bitmapWidth <= 0 || glyph.bitmapHeight <= 0)
+    {
+        // the outline bitmaps are allocated, the others belong to the face
+        if (bitmap && _outlineSize > 0)
+            delete [] bitmap;
+        glyph.pixelsWidth = 0;
+        glyph.pixelsHeight = 0;
+        glyph.pixels.clear();
+        return false;
+    }
+
+    int spread = _distanceFieldEnabled ? DistanceMapSpread : 0;
+    glyph.pixelsWidth = glyph.bitmapWidth + 2 * spread;
+    glyph.pixelsHeight = glyph.bitmapHeight + 2 * spread;
+    glyph.pixels.assign(glyph.pixelsWidth * glyph.pixelsHeight * (_outlineSize > 0 ? 2 : 1), 0);
+    renderCharAt(glyph.pixels.data(), static_cast<int>(glyph.pixelsWidth), 0, 0, bitmap, glyph.bitmapWidth, glyph.bitmapHeight);
+    return true;
+}
+
 unsigned char* FontFreeType::getGlyphBitmap(uint64_t theChar, long &outWidth, long &outHeight, Rect &outRect,int &xAdvance)
+{
+    ThreadFace face = { _FTlibrary, _fontRef, _stroker };
+    return getGlyphBitmap(face, theChar, outWidth, outHeight, outRect, xAdvance);
+}
+
+unsigned char* FontFreeType::getGlyphBitmap(const ThreadFace& face, uint64_t theChar, long &outWidth, long &outHeight, Rect &outRect, int &xAdvance) const
 {
     bool invalidChar = true;
     unsigned char* ret = nullptr;
+    FT_Face fontRef = face.face;
 
     do
     {
-        if (_fontRef == nullptr)
+        if (fontRef == nullptr)
             break;
 
         if (_distanceFieldEnabled)
         {
-            if (FT_Load_Char(_fontRef, theChar, FT_LOAD_RENDER | FT_LOAD_NO_HINTING | FT_LOAD_NO_AUTOHINT))
+            if (FT_Load_Char(fontRef, theChar, FT_LOAD_RENDER | FT_LOAD_NO_HINTING | FT_LOAD_NO_AUTOHINT))
                 break;
         }
         else
         {
-            if (FT_Load_Char(_fontRef, theChar, FT_LOAD_RENDER | FT_LOAD_NO_AUTOHINT))
+            if (FT_Load_Char(fontRef, theChar, FT_LOAD_RENDER | FT_LOAD_NO_AUTOHINT))
                 break;
         }
 
-        auto& metrics = _fontRef->glyph->metrics;
+        auto& metrics = fontRef->glyph->metrics;
         outRect.origin.x = metrics.horiBearingX >> 6;
         outRect.origin.y = -(metrics.horiBearingY >> 6);
         outRect.size.width = (metrics.width >> 6);
         outRect.size.height = (metrics.height >> 6);
 
-        xAdvance = (static_cast<int>(_fontRef->glyph->metrics.horiAdvance >> 6));
+        xAdvance = (static_cast<int>(fontRef->glyph->metrics.horiAdvance >> 6));
 
-        outWidth  = _fontRef->glyph->bitmap.width;
-        outHeight = _fontRef->glyph->bitmap.rows;
-        ret = _fontRef->glyph->bitmap.buffer;
+        outWidth  = fontRef->glyph->bitmap.width;
+        outHeight = fontRef->glyph->bitmap.rows;
+        ret = fontRef->glyph->bitmap.buffer;
 
         if (_outlineSize > 0 && outWidth > 0 && outHeight > 0)
         {
@@ -328,7 +412,7 @@ unsigned char* FontFreeType::getGlyphBitmap(uint64_t theChar, long &outWidth, lo
             memcpy(copyBitmap,ret,outWidth * outHeight * sizeof(unsigned char));
 
             FT_BBox bbox;
-            auto outlineBitmap = getGlyphBitmapWithOutline(theChar,bbox);
+            auto outlineBitmap = getGlyphBitmapWithOutline(face, theChar, bbox);
             if(outlineBitmap == nullptr)
             {
                 ret = nullptr;
@@ -415,17 +499,18 @@ unsigned char* FontFreeType::getGlyphBitmap(uint64_t theChar, long &outWidth, lo
     }
 }
 
-unsigned char * FontFreeType::getGlyphBitmapWithOutline(uint64_t theChar, FT_BBox &bbox)
+unsigned char * FontFreeType::getGlyphBitmapWithOutline(const ThreadFace& face, uint64_t theChar, FT_BBox &bbox) const
 {   
     unsigned char* ret = nullptr;
-    if (FT_Load_Char(_fontRef, theChar, FT_LOAD_NO_BITMAP) == 0)
+    FT_Face fontRef = face.face;
+    if (FT_Load_Char(fontRef, theChar, FT_LOAD_NO_BITMAP) == 0)
     {
-        if (_fontRef->glyph->format == FT_GLYPH_FORMAT_OUTLINE)
+        if (fontRef->glyph->format == FT_GLYPH_FORMAT_OUTLINE)
         {
             FT_Glyph glyph;
-            if (FT_Get_Glyph(_fontRef->glyph, &glyph) == 0)
+            if (FT_Get_Glyph(fontRef->glyph, &glyph) == 0)
             {
-                FT_Glyph_StrokeBorder(&glyph, _stroker, 0, 1);
+                FT_Glyph_StrokeBorder(&glyph, face.stroker, 0, 1);
                 if (glyph->format == FT_GLYPH_FORMAT_OUTLINE)
                 {
                     FT_Outline *outline = &reinterpret_cast<FT_OutlineGlyph>(glyph)->outline;
@@ -448,7 +533,7 @@ unsigned char * FontFreeType::getGlyphBitmapWithOutline(uint64_t theChar, FT_BBo
                     params.target = &bmp;
                     params.flags = FT_RASTER_FLAG_AA;
                     FT_Outline_Translate(outline,-bbox.xMin,-bbox.yMin);
-                    FT_Outline_Render(_FTlibrary, outline, &params);
+                    FT_Outline_Render(face.library, outline, &params);
 
                     ret = bmp.buffer;
                 }
@@ -542,6 +627,11 @@ unsigned char * makeDistanceMap( unsigned char *img, long width, long height)
 }
 
 void FontFreeType::renderCharAt(unsigned char *dest,int posX, int posY, unsigned char* bitmap,long bitmapWidth,long bitmapHeight)
+{
+    renderCharAt(dest, FontAtlas::CacheTextureWidth, posX, posY, bitmap, bitmapWidth, bitmapHeight);
+}
+
+void FontFreeType::renderCharAt(unsigned char *dest, int destWidth, int posX, int posY, unsigned char* bitmap, long bitmapWidth, long bitmapHeight) const
 {
     int iX = posX;
     int iY = posY;
@@ -567,7 +657,7 @@ void FontFreeType::renderCharAt(unsigned char *dest,int posX, int posY, unsigned
                 dest[index + 2] = out[index2 + 2];*/
 
                 //Single channel 8-bit output 
-                dest[iX + ( iY * FontAtlas::CacheTextureWidth )] = distanceMap[bitmap_y + x];
+                dest[iX + ( iY * destWidth )] = distanceMap[bitmap_y + x];
 
                 iX += 1;
             }
@@ -587,9 +677,9 @@ void FontFreeType::renderCharAt(unsigned char *dest,int posX, int posY, unsigned
             for (int x = 0; x < bitmapWidth; ++x)
             {
                 tempChar = bitmap[(bitmap_y + x) * 2];
-                dest[(iX + ( iY * FontAtlas::CacheTextureWidth ) ) * 2] = tempChar;
+                dest[(iX + ( iY * destWidth ) ) * 2] = tempChar;
                 tempChar = bitmap[(bitmap_y + x) * 2 + 1];
-                dest[(iX + ( iY * FontAtlas::CacheTextureWidth ) ) * 2 + 1] = tempChar;
+                dest[(iX + ( iY * destWidth ) ) * 2 + 1] = tempChar;
 
                 iX += 1;
             }
@@ -610,7 +700,7 @@ void FontFreeType::renderCharAt(unsigned char *dest,int posX, int posY, unsigned
                 unsigned char cTemp = bitmap[bitmap_y + x];
 
                 // the final pixel
-                dest[(iX + ( iY * FontAtlas::CacheTextureWidth ) )] = cTemp;
+                dest[(iX + ( iY * destWidth ) )] = cTemp;
 
                 iX += 1;
             }
@@ -49,11 +49,21 @@
 
 NS_CC_BEGIN
 
+struct FontGlyphBitmap;
+
 class CC_DLL FontFreeType : public Font
 {
 public:
     static const int DistanceMapSpread;
 
+    /** A FreeType library, face and stroker of their own, so that glyphs of a font can be rasterized on another thread. */
+    struct ThreadFace
+    {
+        FT_Library library;
+        FT_Face face;
+        FT_Stroker stroker;
+    };
+
     static FontFreeType* create(const std::string &fontName, float fontSize, GlyphCollection glyphs,
         const char *customGlyphs,bool distanceFieldEnabled = false, float outline = 0);
 
@@ -67,9 +77,23 @@ public:
 
     FT_Encoding getEncoding() const { return _encoding; }
 
+    /** The bytes of the font file, shared by the faces of all the sizes of the font. */
+    const unsigned char* getFontData() const { return _fontData; }
+    ssize_t getFontDataSize() const { return _fontDataSize; }
+
     int* getHorizontalKerningForTextUTF32(const std::u32string& text, int &outNumLetters) const override;
     
     unsigned char* getGlyphBitmap(uint64_t theChar, long &outWidth, long &outHeight, Rect &outRect,int &xAdvance);
+
+    /** Creates a face of the font for the calling thread, destroy it with destroyThreadFace(). */
+    bool createThreadFace(ThreadFace& threadFace) const;
+    static void destroyThreadFace(ThreadFace& threadFace);
+
+    /**
+     * Rasterizes a glyph into pixels of its own, with the face of the font on the cocos thread or with a thread face
+     * on another thread. Returns false if the glyph has no pixels, its advance may still be set.
+     */
+    bool rasterizeGlyph(uint64_t theChar, FontGlyphBitmap& glyph, const ThreadFace* threadFace = nullptr) const;
     
     int getFontAscender() const;
     const char* getFontFamily() const;
@@ -95,7 +119,9 @@ private:
     FT_Library getFTLibrary();
     
     int getHorizontalKerningForChars(uint64_t firstChar, uint64_t secondChar) const;
-    unsigned char* getGlyphBitmapWithOutline(uint64_t code, FT_BBox &bbox);
+    unsigned char* getGlyphBitmap(const ThreadFace& face, uint64_t theChar, long &outWidth, long &outHeight, Rect &outRect, int &xAdvance) const;
+    unsigned char* getGlyphBitmapWithOutline(const ThreadFace& face, uint64_t code, FT_BBox &bbox) const;
+    void renderCharAt(unsigned char *dest, int destWidth, int posX, int posY, unsigned char* bitmap, long bitmapWidth, long bitmapHeight) const;
 
     void setGlyphCollection(GlyphCollection glyphs, const char* customGlyphs = nullptr);
     const char* getGlyphCollection() const;
@@ -105,6 +131,10 @@ private:
     FT_Encoding _encoding;
 
     std::string _fontName;
+    // the font file in s_cacheFontData and the size given to FT_Set_Char_Size(), for the thread faces
+    const unsigned char* _fontData;
+    ssize_t _fontDataSize;
+    int _fontSizePoints;
     bool _distanceFieldEnabled;
     float _outlineSize;
     int _lineHeight;
@@ -57,6 +57,7 @@ public:
     {
         _textureAtlas = nullptr;
         _letterVisible = true;
+        _textColor = Color4B::WHITE;
     }
 
     static LabelLetter* createWithTexture(Texture2D *texture, const Rect& rect, bool rotated = false)
@@ -144,6 +145,13 @@ public:
             color4.g *= displayedOpacity / 255.0f;
             color4.b *= displayedOpacity / 255.0f;
         }
+        if (_textColor != Color4B::WHITE)
+        {
+            color4.r = color4.r * _textColor.r / 255;
+            color4.g = color4.g * _textColor.g / 255;
+            color4.b = color4.b * _textColor.b / 255;
+            color4.a = color4.a * _textColor.a / 255;
+        }
         _quad.bl.colors = color4;
         _quad.br.colors = color4;
         _quad.tl.colors = color4;
@@ -162,6 +170,13 @@ public:
     {
         return _letterVisible;
     }
+
+    // the text color of the label when it is in the vertex colors, see Label::updateQuadsTextColor()
+    void setTextColor(const Color4B& textColor)
+    {
+        _textColor = textColor;
+        updateColor();
+    }
     
     //LabelLetter doesn't need to draw directly.
     void draw(Renderer* /*renderer*/, const Mat4 & /*transform*/, uint32_t /*flags*/) override
@@ -170,8 +185,11 @@ public:
     
 private:
     bool _letterVisible;
+    Color4B _textColor;
 };
 
+CC_DEFINE_ALLOCATOR_POOL(Label, 16)
+
 Label* Label::create()
 {
     auto ret = new (std::nothrow) Label;
@@ -385,11 +403,14 @@ Label::Label(TextHAlignment hAlignment /* = TextHAlignment::LEFT */,
 : _textSprite(nullptr)
 , _shadowNode(nullptr)
 , _fontAtlas(nullptr)
+, _lettersPending(false)
+, _letterGeneration(0)
 , _reusedLetter(nullptr)
 , _horizontalKernings(nullptr)
 , _boldEnabled(false)
 , _underlineNode(nullptr)
 , _strikethroughEnabled(false)
+, _incrementalLayoutEnabled(true)
 {
     setAnchorPoint(Vec2::ANCHOR_MIDDLE);
     reset();
@@ -409,6 +430,7 @@ Label::Label(TextHAlignment hAlignment /* = TextHAlignment::LEFT */,
                 it.second->setTexture(nullptr);
             }
             _batchNodes.clear();
+            _layoutValid = false;
 
             if (_fontAtlas)
             {
@@ -453,6 +475,11 @@ Label::~Label()
 
     CC_SAFE_RELEASE_NULL(_textSprite);
     CC_SAFE_RELEASE_NULL(_shadowNode);
+
+    for (auto&& command : _pageQuadCommands)
+    {
+        delete command;
+    }
 }
 
 void Label::reset()
@@ -469,6 +496,11 @@ void Label::reset()
         FontAtlasCache::releaseFontAtlas(_fontAtlas);
         _fontAtlas = nullptr;
     }
+    _lettersPending = false;
+    _layoutValid = false;
+    _layoutText.clear();
+    _lineStarts.clear();
+    _relayout.firstLine = -1;
 
     _currentLabelType = LabelType::STRING_TEXTURE;
     _currLabelEffect = LabelEffect::NORMAL;
@@ -518,6 +550,7 @@ void Label::reset()
 
     _useDistanceField = false;
     _useA8Shader = false;
+    _textColorInQuads = false;
     _clipEnabled = false;
     _blendFuncDirty = false;
     _blendFunc = BlendFunc::ALPHA_PREMULTIPLIED;
@@ -554,13 +587,19 @@ static Texture2D* _getTexture(Label* label)
 
 void Label::updateShaderProgram()
 {
+    // the shadow draws the quads of the text again with u_textColor set to the shadow color
+    bool textColorInQuads = false;
+
     switch (_currLabelEffect)
     {
     case cocos2d::LabelEffect::NORMAL:
+        textColorInQuads = !_shadowEnabled && (_useDistanceField || _useA8Shader);
         if (_useDistanceField)
-            setGLProgramState(GLProgramState::getOrCreateWithGLProgramName(GLProgram::SHADER_NAME_LABEL_DISTANCEFIELD_NORMAL));
+            setGLProgramState(GLProgramState::getOrCreateWithGLProgramName(textColorInQuads ?
+                GLProgram::SHADER_NAME_LABEL_DISTANCEFIELD_NORMAL_NO_MVP : GLProgram::SHADER_NAME_LABEL_DISTANCEFIELD_NORMAL));
         else if (_useA8Shader)
-            setGLProgramState(GLProgramState::getOrCreateWithGLProgramName(GLProgram::SHADER_NAME_LABEL_NORMAL));
+            setGLProgramState(GLProgramState::getOrCreateWithGLProgramName(textColorInQuads ?
+                GLProgram::SHADER_NAME_LABEL_NORMAL_NO_MVP : GLProgram::SHADER_NAME_LABEL_NORMAL));
         else if (_shadowEnabled)
             setGLProgramState(GLProgramState::getOrCreateWithGLProgramName(GLProgram::SHADER_NAME_POSITION_TEXTURE_COLOR, _getTexture(this)));
         else
@@ -582,6 +621,12 @@ void Label::updateShaderProgram()
     default:
         return;
     }
+
+    if (textColorInQuads != _textColorInQuads)
+    {
+        _textColorInQuads = textColorInQuads;
+        updateQuadsTextColor();
+    }
     
     _uniformTextColor = glGetUniformLocation(getGLProgram()->getProgram(), "u_textColor");
 }
@@ -603,6 +648,7 @@ void Label::setFontAtlas(FontAtlas* atlas,bool distanceFieldEnabled /* = false *
         FontAtlasCache::releaseFontAtlas(_fontAtlas);
     }
     _fontAtlas = atlas;
+    _layoutValid = false;
     
     if (_reusedLetter == nullptr)
     {
@@ -675,7 +721,7 @@ void Label::setString(const std::string& text)
         std::u32string utf32String;
         if (StringUtils::UTF8ToUTF32(_utf8Text, utf32String))
         {
-            _utf32Text  = utf32String;
+            _utf32Text.swap(utf32String);
         }
 
         CCASSERT(_utf32Text.length() <= CC_LABEL_MAX_LENGTH, "Length of text should be less then 16384");
@@ -819,8 +865,21 @@ bool Label::alignText()
     }
 
     bool ret = true;
+    bool incremental = _relayout.firstLine >= 0;
     do {
-        _fontAtlas->prepareLetterDefinitions(_utf32Text);
+        if (incremental)
+        {
+            // the letters of the rest of the string are in the atlas already
+            auto changedText = _utf32Text.substr(_relayout.changeBegin, _relayout.changeEnd - _relayout.changeBegin);
+            _fontAtlas->prepareLetterDefinitions(changedText);
+            _lettersPending = _fontAtlas->hasPendingLetters(changedText);
+        }
+        else
+        {
+            _fontAtlas->prepareLetterDefinitions(_utf32Text);
+            _lettersPending = _fontAtlas->hasPendingLetters(_utf32Text);
+        }
+        _letterGeneration = _fontAtlas->getLetterGeneration();
         auto& textures = _fontAtlas->getTextures();
         auto size = textures.size();
         if (size > static_cast<size_t>(_batchNodes.size()))
@@ -845,14 +904,17 @@ bool Label::alignText()
         // optimize for one-texture-only scenario
         // if multiple textures, then we should count how many chars
         // are per texture
-        if (_batchNodes.size()==1)
+        if (_batchNodes.size()==1 && !incremental)
             _batchNodes.at(0)->reserveCapacity(_utf32Text.size());
 
         _reusedLetter->setBatchNode(_batchNodes.at(0));
         
         _lengthOfString = 0;
         _textDesiredHeight = 0.f;
-        _linesWidth.clear();
+        if (!incremental)
+        {
+            _linesWidth.clear();
+        }
         if (_maxLineWidth > 0.f && !_lineBreakWithoutSpaces)
         {
             multilineTextWrapByWord();
@@ -871,6 +933,12 @@ bool Label::alignText()
             }
         }
 
+        if (incremental && updateChangedQuads())
+        {
+            updateLabelLetters();
+            break;
+        }
+
         if(!updateQuads()){
             ret = false;
             if(_overflow == Overflow::SHRINK){
@@ -887,6 +955,102 @@ bool Label::alignText()
     return ret;
 }
 
+bool Label::LayoutSettings::operator==(const LayoutSettings& other) const
+{
+    return fontAtlas == other.fontAtlas && bmfontScale == other.bmfontScale
+        && lineHeight == other.lineHeight && lineSpacing == other.lineSpacing
+        && additionalKerning == other.additionalKerning && maxLineWidth == other.maxLineWidth
+        && labelWidth == other.labelWidth && labelHeight == other.labelHeight
+        && contentScaleFactor == other.contentScaleFactor
+        && hAlignment == other.hAlignment && vAlignment == other.vAlignment && overflow == other.overflow
+        && enableWrap == other.enableWrap && lineBreakWithoutSpaces == other.lineBreakWithoutSpaces;
+}
+
+Label::LayoutSettings Label::getLayoutSettings() const
+{
+    LayoutSettings settings;
+    settings.fontAtlas = _fontAtlas;
+    settings.bmfontScale = _bmfontScale;
+    settings.lineHeight = _lineHeight;
+    settings.lineSpacing = _lineSpacing;
+    settings.additionalKerning = _additionalKerning;
+    settings.maxLineWidth = _maxLineWidth;
+    settings.labelWidth = _labelWidth;
+    settings.labelHeight = _labelHeight;
+    settings.contentScaleFactor = CC_CONTENT_SCALE_FACTOR();
+    settings.hAlignment = _hAlignment;
+    settings.vAlignment = _vAlignment;
+    settings.overflow = _overflow;
+    settings.enableWrap = _enableWrap;
+    settings.lineBreakWithoutSpaces = _lineBreakWithoutSpaces;
+    return settings;
+}
+
+bool Label::prepareIncrementalLayout()
+{
+    _relayout.firstLine = -1;
+    if (!_incrementalLayoutEnabled || !_layoutValid || _overflow == Overflow::SHRINK || !_letters.empty()
+        || _utf32Text.empty() || _lineStarts.empty())
+    {
+        return false;
+    }
+
+    // anything but the string changed lays out everything again
+    updateBMFontScale();
+    if (!(getLayoutSettings() == _layoutSettings))
+    {
+        return false;
+    }
+
+    int oldLen = static_cast<int>(_layoutText.length());
+    int textLen = static_cast<int>(_utf32Text.length());
+    int minLen = std::min(oldLen, textLen);
+    int changeBegin = 0;
+    while (changeBegin < minLen && _layoutText[changeBegin] == _utf32Text[changeBegin])
+        ++changeBegin;
+    int suffixLen = 0;
+    while (suffixLen < minLen - changeBegin && _layoutText[oldLen - 1 - suffixLen] == _utf32Text[textLen - 1 - suffixLen])
+        ++suffixLen;
+
+    // a kerning reaches two letters back, and a line breaks depending on the first word of the next one
+    int lineOfChange = static_cast<int>(std::upper_bound(_lineStarts.begin(), _lineStarts.end(), std::max(changeBegin - 2, 0),
+        [](int index, const LineStart& lineStart) { return index < lineStart.index; }) - _lineStarts.begin()) - 1;
+
+    auto& relayout = _relayout;
+    relayout.firstLine = std::max(lineOfChange - 1, 0);
+    relayout.textDelta = textLen - oldLen;
+    relayout.changeBegin = changeBegin;
+    relayout.changeEnd = textLen - suffixLen;
+    relayout.oldLineStarts.assign(_lineStarts.begin() + relayout.firstLine, _lineStarts.end());
+    relayout.oldLinesWidth.assign(_linesWidth.begin() + relayout.firstLine, _linesWidth.end());
+    relayout.oldLinesOffsetX = _linesOffsetX;
+    relayout.oldContentSize = _contentSize;
+    relayout.oldLetterOffsetY = _letterOffsetY;
+    relayout.oldTailoredTopY = _tailoredTopY;
+    relayout.oldTailoredBottomY = _tailoredBottomY;
+    _lineStarts.resize(relayout.firstLine);
+    _linesWidth.resize(relayout.firstLine);
+
+    updateHorizontalKernings(changeBegin, relayout.changeEnd, relayout.textDelta);
+
+    // the letters after the change keep their layout if their lines do, they move with the string
+    _lettersInfo.resize(oldLen);
+    auto oldChangeEnd = _lettersInfo.begin() + (oldLen - suffixLen);
+    if (relayout.textDelta > 0)
+    {
+        _lettersInfo.resize(textLen);
+        oldChangeEnd = _lettersInfo.begin() + (oldLen - suffixLen);
+        std::move_backward(oldChangeEnd, _lettersInfo.begin() + oldLen, _lettersInfo.end());
+    }
+    else if (relayout.textDelta < 0)
+    {
+        std::move(oldChangeEnd, _lettersInfo.end(), _lettersInfo.begin() + relayout.changeEnd);
+        _lettersInfo.resize(textLen);
+    }
+
+    return true;
+}
+
 bool Label::computeHorizontalKernings(const std::u32string& stringToRender)
 {
     if (_horizontalKernings)
@@ -904,6 +1068,41 @@ bool Label::computeHorizontalKernings(const std::u32string& stringToRender)
         return true;
 }
 
+void Label::updateHorizontalKernings(int changeBegin, int changeEnd, int textDelta)
+{
+    int textLen = static_cast<int>(_utf32Text.length());
+    int oldLen = textLen - textDelta;
+    if (!_horizontalKernings || textLen <= 0)
+    {
+        computeHorizontalKernings(_utf32Text);
+        return;
+    }
+
+    // a kerning depends on the letter before or after it, the ones at the ends of the computed part are dropped
+    int begin = std::max(changeBegin - 3, 0);
+    int end = std::min(changeEnd + 3, textLen);
+    int letterCount = 0;
+    int* kernings = _fontAtlas->getFont()->getHorizontalKerningForTextUTF32(_utf32Text.substr(begin, end - begin), letterCount);
+    if (!kernings)
+    {
+        computeHorizontalKernings(_utf32Text);
+        return;
+    }
+
+    int copyBegin = begin > 0 ? begin + 1 : 0;
+    int copyEnd = end < textLen ? end - 1 : textLen;
+    int* oldKernings = _horizontalKernings;
+    _horizontalKernings = new (std::nothrow) int[textLen];
+    if (_horizontalKernings)
+    {
+        std::copy(oldKernings, oldKernings + copyBegin, _horizontalKernings);
+        std::copy(kernings + (copyBegin - begin), kernings + (copyEnd - begin), _horizontalKernings + copyBegin);
+        std::copy(oldKernings + copyEnd - textDelta, oldKernings + oldLen, _horizontalKernings + copyEnd);
+    }
+    delete [] oldKernings;
+    delete [] kernings;
+}
+
 bool Label::isHorizontalClamped(float letterPositionX, int lineIndex)
 {
     auto wordWidth = this->_linesWidth[lineIndex];
@@ -915,6 +1114,55 @@ bool Label::isHorizontalClamped(float letterPositionX, int lineIndex)
     }
 }
 
+bool Label::getLetterQuad(int letterIndex, Rect& textureRect, Vec2& position, int& textureID)
+{
+    auto& letterInfo = _lettersInfo[letterIndex];
+    auto& letterDef = _fontAtlas->_letterDefinitions[letterInfo.utf32Char];
+    textureID = letterDef.textureID;
+
+    textureRect.size.height = letterDef.height;
+    textureRect.size.width  = letterDef.width;
+    textureRect.origin.x    = letterDef.U;
+    textureRect.origin.y    = letterDef.V;
+
+    auto py = letterInfo.positionY + _letterOffsetY;
+    if (_labelHeight > 0.f) {
+        if (py > _tailoredTopY)
+        {
+            auto clipTop = py - _tailoredTopY;
+            textureRect.origin.y += clipTop;
+            textureRect.size.height -= clipTop;
+            py -= clipTop;
+        }
+        if (py - letterDef.height * _bmfontScale < _tailoredBottomY)
+        {
+            textureRect.size.height = (py < _tailoredBottomY) ? 0.f : (py - _tailoredBottomY);
+        }
+    }
+
+    auto lineIndex = letterInfo.lineIndex;
+    auto px = letterInfo.positionX + letterDef.width/2 * _bmfontScale + _linesOffsetX[lineIndex];
+
+    if(_labelWidth > 0.f){
+        if (this->isHorizontalClamped(px, lineIndex)) {
+            if(_overflow == Overflow::CLAMP){
+                textureRect.size.width = 0;
+            }else if(_overflow == Overflow::SHRINK){
+                if (_contentSize.width > letterDef.width) {
+                    return false;
+                }else{
+                    textureRect.size.width = 0;
+                }
+
+            }
+        }
+    }
+
+    position.x = letterInfo.positionX + _linesOffsetX[lineIndex];
+    position.y = py;
+    return true;
+}
+
 bool Label::updateQuads()
 {
     bool ret = true;
@@ -923,69 +1171,181 @@ bool Label::updateQuads()
         batchNode->getTextureAtlas()->removeAllQuads();
     }
     
+    Vec2 letterPosition;
+    int textureID;
     for (int ctr = 0; ctr < _lengthOfString; ++ctr)
     {
         if (_lettersInfo[ctr].valid)
         {
-            auto& letterDef = _fontAtlas->_letterDefinitions[_lettersInfo[ctr].utf32Char];
-            
-            _reusedRect.size.height = letterDef.height;
-            _reusedRect.size.width  = letterDef.width;
-            _reusedRect.origin.x    = letterDef.U;
-            _reusedRect.origin.y    = letterDef.V;
-
-            auto py = _lettersInfo[ctr].positionY + _letterOffsetY;
-            if (_labelHeight > 0.f) {
-                if (py > _tailoredTopY)
-                {
-                    auto clipTop = py - _tailoredTopY;
-                    _reusedRect.origin.y += clipTop;
-                    _reusedRect.size.height -= clipTop;
-                    py -= clipTop;
-                }
-                if (py - letterDef.height * _bmfontScale < _tailoredBottomY)
-                {
-                    _reusedRect.size.height = (py < _tailoredBottomY) ? 0.f : (py - _tailoredBottomY);
-                }
+            // an incremental layout keeps the letters before the change as they were
+            _lettersInfo[ctr].atlasIndex = -1;
+            if (!getLetterQuad(ctr, _reusedRect, letterPosition, textureID))
+            {
+                ret = false;
+                break;
             }
 
-            auto lineIndex = _lettersInfo[ctr].lineIndex;
-            auto px = _lettersInfo[ctr].positionX + letterDef.width/2 * _bmfontScale + _linesOffsetX[lineIndex];
-
-            if(_labelWidth > 0.f){
-                if (this->isHorizontalClamped(px, lineIndex)) {
-                    if(_overflow == Overflow::CLAMP){
-                        _reusedRect.size.width = 0;
-                    }else if(_overflow == Overflow::SHRINK){
-                        if (_contentSize.width > letterDef.width) {
-                            ret = false;
-                            break;
-                        }else{
-                            _reusedRect.size.width = 0;
-                        }
+            if (_reusedRect.size.height > 0.f && _reusedRect.size.width > 0.f)
+            {
+                _reusedLetter->setTextureRect(_reusedRect, false, _reusedRect.size);
+                _reusedLetter->setPosition(letterPosition);
+                auto index = static_cast<int>(_batchNodes.at(textureID)->getTextureAtlas()->getTotalQuads());
+                _lettersInfo[ctr].atlasIndex = index;
 
-                    }
-                }
+                this->updateLetterSpriteScale(_reusedLetter);
+
+                _batchNodes.at(textureID)->insertQuadFromSprite(_reusedLetter, index);
             }
+        }     
+    }
+
+
+    return ret;
+}
 
+bool Label::updateChangedQuads()
+{
+    auto& relayout = _relayout;
 
+    // the quads of the other letters stay as they are only if they are placed and clipped the same way
+    if (_letterOffsetY != relayout.oldLetterOffsetY || _tailoredTopY != relayout.oldTailoredTopY
+        || _tailoredBottomY != relayout.oldTailoredBottomY || !_contentSize.equals(relayout.oldContentSize))
+    {
+        return false;
+    }
+    auto lineCount = static_cast<int>(_linesOffsetX.size());
+    for (int line = 0; line < relayout.firstLine; ++line)
+    {
+        if (_linesOffsetX[line] != relayout.oldLinesOffsetX[line])
+            return false;
+    }
+    for (int line = relayout.endLine; line < lineCount; ++line)
+    {
+        if (_linesOffsetX[line] != relayout.oldLinesOffsetX[line])
+            return false;
+    }
+
+    auto batchCount = static_cast<int>(_batchNodes.size());
+    std::vector<ssize_t> blockBegin(batchCount, -1);
+    std::vector<ssize_t> blockEnd(batchCount, -1);
+    std::vector<ssize_t> quadCount(batchCount, 0);
+    int letterBegin = _lineStarts[relayout.firstLine].index;
+    int letterEnd = relayout.endIndex;
+
+    // the quads of a texture are in the order of the letters, the ones of the changed letters are between the
+    // last quad of the letters before and the first quad of the letters after
+    int found = 0;
+    for (int ctr = letterBegin - 1; ctr >= 0 && found < batchCount; --ctr)
+    {
+        auto& letterInfo = _lettersInfo[ctr];
+        if (letterInfo.valid && letterInfo.atlasIndex >= 0)
+        {
+            auto textureID = _fontAtlas->_letterDefinitions[letterInfo.utf32Char].textureID;
+            if (blockBegin[textureID] < 0)
+            {
+                blockBegin[textureID] = letterInfo.atlasIndex + 1;
+                ++found;
+            }
+        }
+    }
+    found = 0;
+    for (int ctr = letterEnd; ctr < _lengthOfString && found < batchCount; ++ctr)
+    {
+        auto& letterInfo = _lettersInfo[ctr];
+        if (letterInfo.valid && letterInfo.atlasIndex >= 0)
+        {
+            auto textureID = _fontAtlas->_letterDefinitions[letterInfo.utf32Char].textureID;
+            if (blockEnd[textureID] < 0)
+            {
+                blockEnd[textureID] = letterInfo.atlasIndex;
+                ++found;
+            }
+        }
+    }
+
+    Vec2 letterPosition;
+    int textureID;
+    for (int ctr = letterBegin; ctr < letterEnd; ++ctr)
+    {
+        if (_lettersInfo[ctr].valid)
+        {
+            getLetterQuad(ctr, _reusedRect, letterPosition, textureID);
+            if (_reusedRect.size.height > 0.f && _reusedRect.size.width > 0.f)
+            {
+                ++quadCount[textureID];
+            }
+        }
+    }
+
+    // makes room for the quads of the changed letters at once
+    std::vector<ssize_t> quadDelta(batchCount, 0);
+    for (int index = 0; index < batchCount; ++index)
+    {
+        auto batchNode = _batchNodes.at(index);
+        auto textureAtlas = batchNode->getTextureAtlas();
+        if (blockBegin[index] < 0)
+            blockBegin[index] = 0;
+        if (blockEnd[index] < 0)
+            blockEnd[index] = textureAtlas->getTotalQuads();
+
+        quadDelta[index] = quadCount[index] - (blockEnd[index] - blockBegin[index]);
+        if (quadDelta[index] > 0)
+        {
+            batchNode->reserveCapacity(textureAtlas->getTotalQuads() + quadDelta[index]);
+            _reusedQuads.resize(quadDelta[index]);
+            textureAtlas->insertQuads(_reusedQuads.data(), blockEnd[index], quadDelta[index]);
+        }
+        else if (quadDelta[index] < 0)
+        {
+            textureAtlas->removeQuadsAtIndex(blockBegin[index] + quadCount[index], -quadDelta[index]);
+        }
+    }
+
+    std::vector<ssize_t> quadIndex(blockBegin);
+    for (int ctr = letterBegin; ctr < letterEnd; ++ctr)
+    {
+        if (_lettersInfo[ctr].valid)
+        {
+            getLetterQuad(ctr, _reusedRect, letterPosition, textureID);
             if (_reusedRect.size.height > 0.f && _reusedRect.size.width > 0.f)
             {
                 _reusedLetter->setTextureRect(_reusedRect, false, _reusedRect.size);
-                float letterPositionX = _lettersInfo[ctr].positionX + _linesOffsetX[_lettersInfo[ctr].lineIndex];
-                _reusedLetter->setPosition(letterPositionX, py);
-                auto index = static_cast<int>(_batchNodes.at(letterDef.textureID)->getTextureAtlas()->getTotalQuads());
-                _lettersInfo[ctr].atlasIndex = index;
+                _reusedLetter->setPosition(letterPosition);
+                auto index = quadIndex[textureID]++;
+                _lettersInfo[ctr].atlasIndex = static_cast<int>(index);
 
                 this->updateLetterSpriteScale(_reusedLetter);
 
-                _batchNodes.at(letterDef.textureID)->insertQuadFromSprite(_reusedLetter, index);
+                // the quad is there already, the sprite overwrites it
+                _reusedLetter->setBatchNode(_batchNodes.at(textureID));
+                _reusedLetter->setAtlasIndex(index);
+                _reusedLetter->setDirty(true);
+                _reusedLetter->updateTransform();
             }
-        }     
+        }
     }
 
+    bool moved = false;
+    for (int index = 0; index < batchCount; ++index)
+    {
+        updateQuadsColor(_batchNodes.at(index)->getTextureAtlas(), blockBegin[index], quadCount[index]);
+        moved = moved || quadDelta[index] != 0;
+    }
 
-    return ret;
+    if (moved)
+    {
+        for (int ctr = letterEnd; ctr < _lengthOfString; ++ctr)
+        {
+            auto& letterInfo = _lettersInfo[ctr];
+            if (letterInfo.valid && letterInfo.atlasIndex >= 0)
+            {
+                auto textureID = batchCount == 1 ? 0 : _fontAtlas->_letterDefinitions[letterInfo.utf32Char].textureID;
+                letterInfo.atlasIndex += static_cast<int>(quadDelta[textureID]);
+            }
+        }
+    }
+
+    return true;
 }
 
 bool Label::setTTFConfigInternal(const TTFConfig& ttfConfig)
@@ -1159,6 +1519,10 @@ void Label::enableShadow(const Color4B& shadowColor /* = Color4B::BLACK */,
     {
         setGLProgramState(GLProgramState::getOrCreateWithGLProgramName(_shadowEnabled ? GLProgram::SHADER_NAME_POSITION_TEXTURE_COLOR : GLProgram::SHADER_NAME_POSITION_TEXTURE_COLOR_NO_MVP, _getTexture(this)));
     }
+    else if (_textColorInQuads)
+    {
+        updateShaderProgram();
+    }
 }
 
 void Label::enableItalics()
@@ -1403,17 +1767,29 @@ void Label::updateContent()
     CC_SAFE_RELEASE_NULL(_textSprite);
     CC_SAFE_RELEASE_NULL(_shadowNode);
     bool updateFinished = true;
+    _lettersPending = false;
 
     if (_fontAtlas)
     {
         std::u32string utf32String;
         if (StringUtils::UTF8ToUTF32(_utf8Text, utf32String))
         {
-            _utf32Text = utf32String;
+            _utf32Text.swap(utf32String);
         }
 
-        computeHorizontalKernings(_utf32Text);
+        if (!prepareIncrementalLayout())
+        {
+            computeHorizontalKernings(_utf32Text);
+        }
         updateFinished = alignText();
+        _relayout.firstLine = -1;
+
+        _layoutValid = updateFinished && !_lettersPending && !_batchNodes.empty() && !_utf32Text.empty();
+        if (_layoutValid)
+        {
+            _layoutText = _utf32Text;
+            _layoutSettings = getLayoutSettings();
+        }
     }
     else
     {
@@ -1619,18 +1995,32 @@ void Label::draw(Renderer *renderer, const Mat4 &transform, uint32_t flags)
     if (_insideBounds)
 #endif
     {
-        if (!_shadowEnabled && (_currentLabelType == LabelType::BMFONT || _currentLabelType == LabelType::CHARMAP))
+        if (_textColorInQuads || (!_shadowEnabled && (_currentLabelType == LabelType::BMFONT || _currentLabelType == LabelType::CHARMAP)))
         {
             for (auto&& it : _letters)
             {
                 it.second->updateTransform();
             }
-            // ETC1 ALPHA supports for BMFONT & CHARMAP
-            auto textureAtlas = _batchNodes.at(0)->getTextureAtlas();
-            auto texture = textureAtlas->getTexture();
-            _quadCommand.init(_globalZOrder, texture, getGLProgramState(), 
-                _blendFunc, textureAtlas->getQuads(), textureAtlas->getTotalQuads(), transform, flags);
-            renderer->addCommand(&_quadCommand);
+            // one command per texture of the font atlas, the renderer batches them with the commands
+            // of the other labels and sprites using the same texture, shader and blend function
+            for (ssize_t i = 0, count = _batchNodes.size(); i < count; ++i)
+            {
+                // ETC1 ALPHA supports for BMFONT & CHARMAP
+                auto textureAtlas = _batchNodes.at(i)->getTextureAtlas();
+                if (textureAtlas->getTotalQuads() == 0)
+                {
+                    continue;
+                }
+
+                while (i > static_cast<ssize_t>(_pageQuadCommands.size()))
+                {
+                    _pageQuadCommands.push_back(new (std::nothrow) QuadCommand());
+                }
+                auto command = i == 0 ? &_quadCommand : _pageQuadCommands[i - 1];
+                command->init(_globalZOrder, textureAtlas->getTexture(), getGLProgramState(),
+                    _blendFunc, textureAtlas->getQuads(), textureAtlas->getTotalQuads(), transform, flags);
+                renderer->addCommand(command);
+            }
         }
         else
         {
@@ -1648,11 +2038,25 @@ void Label::visit(Renderer *renderer, const Mat4 &parentTransform, uint32_t pare
     {
         return;
     }
+
+    if (_lettersPending && _fontAtlas)
+    {
+        _fontAtlas->commitRasterizedLetters();
+        if (_fontAtlas->getLetterGeneration() != _letterGeneration)
+        {
+            _contentDirty = true;
+        }
+    }
     
     if (_systemFontDirty || _contentDirty)
     {
         updateContent();
     }
+
+    if (_lettersPending)
+    {
+        return;
+    }
     
     uint32_t flags = processParentFlags(parentTransform, parentFlags);
 
@@ -1809,6 +2213,7 @@ Sprite* Label::getLetter(int letterIndex)
                     this->updateLetterSpriteScale(letter);
                 }
                 
+                static_cast<LabelLetter*>(letter)->setTextColor(_textColorInQuads ? _textColor : Color4B::WHITE);
                 addChild(letter);
                 _letters[letterIndex] = letter;
             }
@@ -1986,20 +2391,41 @@ void Label::setTextColor(const Color4B &color)
         _contentDirty = true;
     }
 
+    bool quadsDirty = _textColorInQuads && _textColor != color;
+
     _textColor = color;
     _textColorF.r = _textColor.r / 255.0f;
     _textColorF.g = _textColor.g / 255.0f;
     _textColorF.b = _textColor.b / 255.0f;
     _textColorF.a = _textColor.a / 255.0f;
+
+    if (quadsDirty)
+    {
+        updateQuadsTextColor();
+    }
 }
 
 void Label::updateColor()
 {
-    if (_batchNodes.empty())
+    for (auto&& batchNode:_batchNodes)
     {
-        return;
+        auto textureAtlas = batchNode->getTextureAtlas();
+        updateQuadsColor(textureAtlas, 0, textureAtlas->getTotalQuads());
     }
+}
 
+void Label::updateQuadsTextColor()
+{
+    auto textColor = _textColorInQuads ? _textColor : Color4B::WHITE;
+    for (auto&& it : _letters)
+    {
+        static_cast<LabelLetter*>(it.second)->setTextColor(textColor);
+    }
+    updateColor();
+}
+
+void Label::updateQuadsColor(TextureAtlas* textureAtlas, ssize_t index, ssize_t count)
+{
     Color4B color4( _displayedColor.r, _displayedColor.g, _displayedColor.b, _displayedOpacity );
 
     // special opacity for premultiplied textures
@@ -2009,23 +2435,22 @@ void Label::updateColor()
         color4.g *= _displayedOpacity/255.0f;
         color4.b *= _displayedOpacity/255.0f;
     }
-
-    cocos2d::TextureAtlas* textureAtlas;
-    V3F_C4B_T2F_Quad *quads;
-    for (auto&& batchNode:_batchNodes)
+    if (_textColorInQuads)
     {
-        textureAtlas = batchNode->getTextureAtlas();
-        quads = textureAtlas->getQuads();
-        auto count = textureAtlas->getTotalQuads();
+        color4.r = color4.r * _textColor.r / 255;
+        color4.g = color4.g * _textColor.g / 255;
+        color4.b = color4.b * _textColor.b / 255;
+        color4.a = color4.a * _textColor.a / 255;
+    }
 
-        for (int index = 0; index < count; ++index)
-        {
-            quads[index].bl.colors = color4;
-            quads[index].br.colors = color4;
-            quads[index].tl.colors = color4;
-            quads[index].tr.colors = color4;
-            textureAtlas->updateQuad(&quads[index], index);
-        }
+    V3F_C4B_T2F_Quad *quads = textureAtlas->getQuads();
+    for (auto end = index + count; index < end; ++index)
+    {
+        quads[index].bl.colors = color4;
+        quads[index].br.colors = color4;
+        quads[index].tl.colors = color4;
+        quads[index].tr.colors = color4;
+        textureAtlas->updateQuad(&quads[index], index);
     }
 }
 
@@ -2219,7 +2644,7 @@ Label::Overflow Label::getOverflow()const
 
 void Label::updateLetterSpriteScale(Sprite* sprite)
 {
-    if (_currentLabelType == LabelType::BMFONT && _bmFontSize > 0)
+    if ((_currentLabelType == LabelType::BMFONT && _bmFontSize > 0) || (_currentLabelType == LabelType::TTF && _useDistanceField))
     {
         sprite->setScale(_bmfontScale);
     }
@@ -32,6 +32,7 @@
 #include "renderer/CCQuadCommand.h"
 #include "2d/CCFontAtlas.h"
 #include "base/ccTypes.h"
+#include "base/allocator/CCAllocatorStrategyPool.h"
 
 NS_CC_BEGIN
 
@@ -85,6 +86,7 @@ typedef struct _ttfConfig
 
 class Sprite;
 class SpriteBatchNode;
+class TextureAtlas;
 class DrawNode;
 class EventListenerCustom;
 
@@ -107,6 +109,8 @@ class EventListenerCustom;
 class CC_DLL Label : public Node, public LabelProtocol, public BlendProtocol
 {
 public:
+    CC_DECLARE_ALLOCATOR_POOL(Label)
+
     enum class Overflow
     {
         //In NONE mode, the dimensions is (0,0) and the content size will change dynamically to fit the label.
@@ -488,6 +492,16 @@ public:
      */
     bool isWrapEnabled()const;
 
+    /**
+     * Lays out a new string again only from the line before its first change, until a line starts like it did
+     * before, and only replaces the quads of those letters. It is used as long as nothing but the string changed
+     * since the last layout and the label doesn't shrink, it is enabled by default.
+     *
+     * @param enabled Set false to lay out the whole string every time.
+     */
+    void setIncrementalLayoutEnabled(bool enabled) { _incrementalLayoutEnabled = enabled; }
+    bool isIncrementalLayoutEnabled() const { return _incrementalLayoutEnabled; }
+
     /**
      * Change the label's Overflow type, currently only TTF and BMFont support all the valid Overflow type.
      * Char Map font supports all the Overflow type except for SHRINK, because we can't measure it's font size.
@@ -648,6 +662,58 @@ protected:
         int lineIndex;
     };
 
+    // the state of multilineTextWrap() where a line starts, an incremental layout wraps again from one of them
+    struct LineStart
+    {
+        int index;
+        float tokenY;
+        float whitespaceWidth;
+        bool changeSize;
+        // the top of the highest letter and the bottom of the lowest letter of the line
+        float highestY;
+        float lowestY;
+    };
+
+    // what the last layout depended on besides the string, an incremental layout needs the same
+    struct LayoutSettings
+    {
+        FontAtlas* fontAtlas;
+        float bmfontScale;
+        float lineHeight;
+        float lineSpacing;
+        float additionalKerning;
+        float maxLineWidth;
+        float labelWidth;
+        float labelHeight;
+        float contentScaleFactor;
+        TextHAlignment hAlignment;
+        TextVAlignment vAlignment;
+        Overflow overflow;
+        bool enableWrap;
+        bool lineBreakWithoutSpaces;
+
+        bool operator==(const LayoutSettings& other) const;
+    };
+
+    // what an incremental layout keeps of the last one
+    struct Relayout
+    {
+        int firstLine;      // the first line wrapped again, -1 for a full layout
+        int textDelta;      // the number of letters added by the new string, negative if it is shorter
+        int changeBegin;    // the letters of the new string before it are the first ones of the old string
+        int changeEnd;      // the letters of the new string from it on are the last ones of the old string
+        int endIndex;       // the letters from it on kept their layout, they moved by textDelta
+        int endLine;        // the lines from it on kept their layout
+        std::vector<LineStart> oldLineStarts;   // the old lines from firstLine on
+        std::vector<LetterInfo> tokenLetters;   // the letters of the token being wrapped, as they were
+        std::vector<float> oldLinesWidth;
+        std::vector<float> oldLinesOffsetX;
+        Size oldContentSize;
+        float oldLetterOffsetY;
+        float oldTailoredTopY;
+        float oldTailoredBottomY;
+    };
+
     virtual void setFontAtlas(FontAtlas* atlas, bool distanceFieldEnabled = false, bool useA8Shader = false);
     bool getFontLetterDef(char32_t character, FontLetterDefinition& letterDef) const;
 
@@ -669,11 +735,19 @@ protected:
     virtual bool alignText();
     void computeAlignmentOffset();
     bool computeHorizontalKernings(const std::u32string& stringToRender);
+    void updateHorizontalKernings(int changeBegin, int changeEnd, int textDelta);
+    LayoutSettings getLayoutSettings() const;
+    bool prepareIncrementalLayout();
+    bool addLineStart(int index, float tokenY, float whitespaceWidth, bool changeSize);
 
     void recordLetterInfo(const cocos2d::Vec2& point, char32_t utf32Char, int letterIndex, int lineIndex);
     void recordPlaceholderInfo(int letterIndex, char32_t utf16Char);
     
     bool updateQuads();
+    bool getLetterQuad(int letterIndex, Rect& textureRect, Vec2& position, int& textureID);
+    bool updateChangedQuads();
+    void updateQuadsColor(TextureAtlas* textureAtlas, ssize_t index, ssize_t count);
+    void updateQuadsTextColor();
 
     void createSpriteForSystemFont(const FontDefinition& fontDef);
     void createShadowSpriteForSystemFont(const FontDefinition& fontDef);
@@ -712,12 +786,23 @@ protected:
     Sprite* _shadowNode;
 
     FontAtlas* _fontAtlas;
+    // some letters are being rasterized by the atlas, the label is hidden until they are committed
+    bool _lettersPending;
+    unsigned int _letterGeneration;
     Vector<SpriteBatchNode*> _batchNodes;
     std::vector<LetterInfo> _lettersInfo;
 
+    bool _incrementalLayoutEnabled;
+    bool _layoutValid;
+    std::u32string _layoutText;
+    LayoutSettings _layoutSettings;
+    std::vector<LineStart> _lineStarts;
+    Relayout _relayout;
+
     //! used for optimization
     Sprite *_reusedLetter;
     Rect _reusedRect;
+    std::vector<V3F_C4B_T2F_Quad> _reusedQuads;
     int _lengthOfString;
 
     //layout relevant properties.
@@ -746,6 +831,8 @@ protected:
     Color4F _textColorF;
 
     QuadCommand _quadCommand;
+    // the quad commands of the other textures of a TTF font atlas, _quadCommand draws the first one
+    std::vector<QuadCommand*> _pageQuadCommands;
     CustomCommand _customCommand;
     Mat4  _shadowTransform;
     GLint _uniformEffectColor;
@@ -753,6 +840,9 @@ protected:
     GLint _uniformTextColor;
     bool _useDistanceField;
     bool _useA8Shader;
+    // the text color is multiplied into the vertex colors instead of u_textColor, and the quads are drawn
+    // with QuadCommands which the renderer batches with the other labels sharing the font atlas
+    bool _textColorInQuads;
 
     bool _shadowDirty;
     bool _shadowEnabled;
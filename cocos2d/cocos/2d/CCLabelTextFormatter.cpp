@@ -29,6 +29,7 @@
 #include "base/ccUTF8.h"
 #include "base/CCDirector.h"
 #include "2d/CCFontAtlas.h"
+#include "2d/CCFontAtlasCache.h"
 #include "2d/CCFontFNT.h"
 
 NS_CC_BEGIN
@@ -142,6 +143,9 @@ void Label::updateBMFontScale()
         FontFNT *bmFont = (FontFNT*)font;
         float originalFontSize = bmFont->getOriginalFontSize();
         _bmfontScale = _bmFontSize * CC_CONTENT_SCALE_FACTOR() / originalFontSize;
+    }else if (_currentLabelType == LabelType::TTF && _useDistanceField) {
+        // all the sizes share the distance field atlas
+        _bmfontScale = _fontConfig.fontSize / FontAtlasCache::DistanceFieldFontSize;
     }else{
         _bmfontScale = 1.0f;
     }
@@ -164,10 +168,30 @@ bool Label::multilineTextWrap(const std::function<int(const std::u32string&, int
     FontLetterDefinition letterDef;
     Vec2 letterPosition;
     bool nextChangeSize = true;
+    bool converged = false;
+    int startIndex = 0;
 
     this->updateBMFontScale();
 
-    for (int index = 0; index < textLen; )
+    // an incremental layout wraps again from the state of the first line that may change
+    if (_relayout.firstLine >= 0)
+    {
+        auto& lineStart = _relayout.oldLineStarts.front();
+        lineIndex = _relayout.firstLine;
+        startIndex = lineStart.index;
+        nextTokenY = lineStart.tokenY;
+        nextWhitespaceWidth = lineStart.whitespaceWidth;
+        nextChangeSize = lineStart.changeSize;
+        _relayout.endIndex = textLen;
+        _relayout.endLine = INT_MAX;
+    }
+    else
+    {
+        _lineStarts.clear();
+    }
+    _lineStarts.push_back({startIndex, nextTokenY, nextWhitespaceWidth, nextChangeSize, -FLT_MAX, FLT_MAX});
+
+    for (int index = startIndex; index < textLen; )
     {
         char32_t character = _utf32Text[index];
         if (character == StringUtils::UnicodeCharacters::NewLine)
@@ -179,12 +203,23 @@ bool Label::multilineTextWrap(const std::function<int(const std::u32string&, int
             nextTokenY -= _lineHeight*_bmfontScale + lineSpacing;
             recordPlaceholderInfo(index, character);
             index++;
+            if (addLineStart(index, nextTokenY, nextWhitespaceWidth, nextChangeSize))
+            {
+                converged = true;
+                break;
+            }
             continue;
         }
 
         auto tokenLen = nextTokenLen(_utf32Text, index, textLen);
-        float tokenHighestY = highestY;
-        float tokenLowestY = lowestY;
+        // the letters of a token are recorded again on the next line when it wraps, they are kept as they were
+        // in case the rest of the string turns out to be laid out as before from there
+        if (_relayout.firstLine >= 0 && index >= _relayout.changeEnd)
+        {
+            _relayout.tokenLetters.assign(_lettersInfo.begin() + index, _lettersInfo.begin() + index + tokenLen);
+        }
+        float tokenHighestY = -FLT_MAX;
+        float tokenLowestY = FLT_MAX;
         float tokenRight = letterRight;
         float nextLetterX = nextTokenX;
         float whitespaceWidth = nextWhitespaceWidth;
@@ -210,7 +245,10 @@ bool Label::multilineTextWrap(const std::function<int(const std::u32string&, int
             if (!getFontLetterDef(character, letterDef))
             {
                 recordPlaceholderInfo(letterIndex, character);
-                CCLOG("LabelTextFormatter error: can't find letter definition in font file for letter: 0x%x", character);
+                if (!_lettersPending)
+                {
+                    CCLOG("LabelTextFormatter error: can't find letter definition in font file for letter: 0x%x", character);
+                }
                 continue;
             }
 
@@ -238,7 +276,7 @@ bool Label::multilineTextWrap(const std::function<int(const std::u32string&, int
             {
                 float newLetterWidth = 0.f;
                 if (_horizontalKernings && letterIndex < textLen - 1)
-                    newLetterWidth = _horizontalKernings[letterIndex + 1];
+                    newLetterWidth = _horizontalKernings[letterIndex + 1] * (_currentLabelType == LabelType::TTF ? _bmfontScale : 1.0f);
                 newLetterWidth += letterDef.xAdvance * _bmfontScale + _additionalKerning;
 
                 nextLetterX += newLetterWidth;
@@ -263,35 +301,55 @@ bool Label::multilineTextWrap(const std::function<int(const std::u32string&, int
 
         if (newLine)
         {
+            if (addLineStart(index, nextTokenY, nextWhitespaceWidth, nextChangeSize))
+            {
+                std::copy(_relayout.tokenLetters.begin(), _relayout.tokenLetters.end(), _lettersInfo.begin() + index);
+                converged = true;
+                break;
+            }
             continue;
         }
 
         nextTokenX = nextLetterX;
         letterRight = tokenRight;
-        if (highestY < tokenHighestY)
-            highestY = tokenHighestY;
-        if (lowestY > tokenLowestY)
-            lowestY = tokenLowestY;
+        auto& lineStart = _lineStarts.back();
+        if (lineStart.highestY < tokenHighestY)
+            lineStart.highestY = tokenHighestY;
+        if (lineStart.lowestY > tokenLowestY)
+            lineStart.lowestY = tokenLowestY;
 
         index += tokenLen;
     }
 
-    if (_linesWidth.empty())
+    if (!converged)
     {
-        _linesWidth.push_back(letterRight);
-        longestLine = letterRight;
+        if (_linesWidth.empty())
+            _linesWidth.push_back(letterRight);
+        else
+            _linesWidth.push_back(letterRight - nextWhitespaceWidth);
+    }
+
+    if (_linesWidth.size() == 1)
+    {
+        longestLine = _linesWidth.front();
     }
     else
     {
-        _linesWidth.push_back(letterRight - nextWhitespaceWidth);
         for (auto && lineWidth : _linesWidth)
         {
             if (longestLine < lineWidth)
                 longestLine = lineWidth;
         }
     }
+    for (auto&& lineStart : _lineStarts)
+    {
+        if (highestY < lineStart.highestY)
+            highestY = lineStart.highestY;
+        if (lowestY > lineStart.lowestY)
+            lowestY = lineStart.lowestY;
+    }
 
-    _numberOfLines = lineIndex + 1;
+    _numberOfLines = static_cast<int>(_lineStarts.size());
     _textDesiredHeight = (_numberOfLines * _lineHeight * _bmfontScale) / contentScaleFactor;
     if (_numberOfLines > 1)
         _textDesiredHeight += (_numberOfLines - 1) * _lineSpacing;
@@ -312,6 +370,37 @@ bool Label::multilineTextWrap(const std::function<int(const std::u32string&, int
     return true;
 }
 
+bool Label::addLineStart(int index, float tokenY, float whitespaceWidth, bool changeSize)
+{
+    int lineIndex = static_cast<int>(_lineStarts.size());
+    auto& relayout = _relayout;
+    if (relayout.firstLine >= 0 && index >= relayout.changeEnd)
+    {
+        // the rest of the string is laid out as before once a line of it starts like it did
+        auto oldLine = static_cast<size_t>(lineIndex - relayout.firstLine);
+        if (oldLine < relayout.oldLineStarts.size())
+        {
+            auto& oldStart = relayout.oldLineStarts[oldLine];
+            if (oldStart.index + relayout.textDelta == index && oldStart.tokenY == tokenY
+                && oldStart.whitespaceWidth == whitespaceWidth && oldStart.changeSize == changeSize)
+            {
+                for (auto it = relayout.oldLineStarts.begin() + oldLine; it != relayout.oldLineStarts.end(); ++it)
+                {
+                    _lineStarts.push_back(*it);
+                    _lineStarts.back().index += relayout.textDelta;
+                }
+                _linesWidth.insert(_linesWidth.end(), relayout.oldLinesWidth.begin() + oldLine, relayout.oldLinesWidth.end());
+                relayout.endIndex = index;
+                relayout.endLine = lineIndex;
+                return true;
+            }
+        }
+    }
+
+    _lineStarts.push_back({index, tokenY, whitespaceWidth, changeSize, -FLT_MAX, FLT_MAX});
+    return false;
+}
+
 bool Label::multilineTextWrapByWord()
 {
     return multilineTextWrap(CC_CALLBACK_3(Label::getFirstWordLen, this));
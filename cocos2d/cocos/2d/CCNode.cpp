@@ -32,6 +32,8 @@ THE SOFTWARE.
 #include <algorithm>
 #include <string>
 #include <regex>
+#include <iterator>
+#include <unordered_map>
 
 #include "base/CCDirector.h"
 #include "base/CCScheduler.h"
@@ -39,6 +41,7 @@ THE SOFTWARE.
 #include "base/ccUTF8.h"
 #include "2d/CCCamera.h"
 #include "2d/CCActionManager.h"
+#include "2d/CCTweenManager.h"
 #include "2d/CCScene.h"
 #include "2d/CCComponent.h"
 #include "renderer/CCGLProgram.h"
@@ -58,6 +61,46 @@ NS_CC_BEGIN
 
 // FIXME:: Yes, nodes might have a sort problem once every 30 days if the game runs at 60 FPS and each frame sprites are reordered.
 std::uint32_t Node::s_globalOrderOfArrival = 0;
+
+// up to this many moved children are reinserted one by one, more than that and all the children are sorted
+static const size_t MAX_REORDERED_CHILDREN = 16;
+
+struct Node::ChildLookupIndex
+{
+    std::unordered_multimap<int, Node*> byTag;
+    std::unordered_multimap<size_t, Node*> byNameHash;
+
+    // untagged and unnamed children are left out, they can't be looked up
+    void add(Node* child)
+    {
+        if (child->_tag != Node::INVALID_TAG)
+            byTag.emplace(child->_tag, child);
+        if (!child->_name.empty())
+            byNameHash.emplace(child->_hashOfName, child);
+    }
+
+    void remove(Node* child)
+    {
+        if (child->_tag != Node::INVALID_TAG)
+            erase(byTag, child->_tag, child);
+        if (!child->_name.empty())
+            erase(byNameHash, child->_hashOfName, child);
+    }
+
+    template <typename Map, typename Key>
+    static void erase(Map& map, const Key& key, Node* child)
+    {
+        auto range = map.equal_range(key);
+        for (auto it = range.first; it != range.second; ++it)
+        {
+            if (it->second == child)
+            {
+                map.erase(it);
+                return;
+            }
+        }
+    }
+};
 int Node::__attachedNodeCount = 0;
 
 // MARK: Constructor, Destructor, Init
@@ -82,11 +125,15 @@ Node::Node()
 , _inverseDirty(true)
 , _additionalTransform(nullptr)
 , _additionalTransformDirty(false)
+, _worldTransformCache(nullptr)
+, _worldTransformDirty(true)
+, _worldInverseDirty(true)
 , _transformUpdated(true)
 // children (lazy allocs)
 // lazy alloc
 , _localZOrder$Arrival(0LL)
 , _globalZOrder(0)
+, _childLookupIndex(nullptr)
 , _parent(nullptr)
 // "whole screen" objects. like Scenes and Layers, should set _ignoreAnchorPointForPosition to true
 , _tag(Node::INVALID_TAG)
@@ -96,6 +143,7 @@ Node::Node()
 , _userData(nullptr)
 , _userObject(nullptr)
 , _glProgramState(nullptr)
+, _hitTestIndexEnabled(false)
 , _running(false)
 , _visible(true)
 , _ignoreAnchorPointForPosition(false)
@@ -171,6 +219,7 @@ Node::~Node()
     for (auto& child : _children)
     {
         child->_parent = nullptr;
+        child->markWorldTransformDirty();
     }
 
     removeAllComponents();
@@ -183,6 +232,10 @@ Node::~Node()
     CC_SAFE_RELEASE_NULL(_scheduler);
     
     _eventDispatcher->removeEventListenersForTarget(this);
+    if (_hitTestIndexEnabled)
+    {
+        _eventDispatcher->removeHitTestBounds(this);
+    }
     
 #if CC_NODE_DEBUG_VERIFY_EVENT_LISTENERS && COCOS2D_DEBUG > 0
     _eventDispatcher->debugCheckNodeHasNoEventListenersOnDestruction(this);
@@ -192,6 +245,8 @@ Node::~Node()
     CC_SAFE_RELEASE(_eventDispatcher);
 
     delete[] _additionalTransform;
+    delete[] _worldTransformCache;
+    delete _childLookupIndex;
 }
 
 bool Node::init()
@@ -215,6 +270,7 @@ void Node::cleanup()
     
     // actions
     this->stopAllActions();
+    _director->getTweenManager()->removeAllTweensFromTarget(this);
     // timers
     this->unscheduleAllCallbacks();
 
@@ -251,6 +307,7 @@ void Node::setSkewX(float skewX)
     
     _skewX = skewX;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    markWorldTransformDirty();
 }
 
 float Node::getSkewY() const
@@ -265,6 +322,7 @@ void Node::setSkewY(float skewY)
     
     _skewY = skewY;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    markWorldTransformDirty();
 }
 
 void Node::setLocalZOrder(std::int32_t z)
@@ -317,6 +375,7 @@ void Node::setRotation(float rotation)
     
     _rotationZ_X = _rotationZ_Y = rotation;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    markWorldTransformDirty();
     
     updateRotationQuat();
 }
@@ -334,6 +393,7 @@ void Node::setRotation3D(const Vec3& rotation)
         return;
     
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    markWorldTransformDirty();
 
     _rotationX = rotation.x;
     _rotationY = rotation.y;
@@ -385,6 +445,7 @@ void Node::setRotationQuat(const Quaternion& quat)
     _rotationQuat = quat;
     updateRotation3D();
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    markWorldTransformDirty();
 }
 
 Quaternion Node::getRotationQuat() const
@@ -399,6 +460,7 @@ void Node::setRotationSkewX(float rotationX)
     
     _rotationZ_X = rotationX;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    markWorldTransformDirty();
     
     updateRotationQuat();
 }
@@ -415,6 +477,7 @@ void Node::setRotationSkewY(float rotationY)
     
     _rotationZ_Y = rotationY;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    markWorldTransformDirty();
     
     updateRotationQuat();
 }
@@ -434,6 +497,7 @@ void Node::setScale(float scale)
     
     _scaleX = _scaleY = _scaleZ = scale;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    markWorldTransformDirty();
 }
 
 /// scaleX getter
@@ -451,6 +515,7 @@ void Node::setScale(float scaleX,float scaleY)
     _scaleX = scaleX;
     _scaleY = scaleY;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    markWorldTransformDirty();
 }
 
 /// scaleX setter
@@ -461,6 +526,7 @@ void Node::setScaleX(float scaleX)
     
     _scaleX = scaleX;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    markWorldTransformDirty();
 }
 
 /// scaleY getter
@@ -477,6 +543,7 @@ void Node::setScaleZ(float scaleZ)
     
     _scaleZ = scaleZ;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    markWorldTransformDirty();
 }
 
 /// scaleY getter
@@ -493,6 +560,7 @@ void Node::setScaleY(float scaleY)
     
     _scaleY = scaleY;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    markWorldTransformDirty();
 }
 
 
@@ -523,6 +591,7 @@ void Node::setPosition(float x, float y)
     _position.y = y;
     
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    markWorldTransformDirty();
     _usingNormalizedPosition = false;
 }
 
@@ -568,6 +637,7 @@ void Node::setPositionZ(float positionZ)
         return;
     
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    markWorldTransformDirty();
 
     _positionZ = positionZ;
 }
@@ -588,6 +658,7 @@ void Node::setPositionNormalized(const Vec2& position)
     _usingNormalizedPosition = true;
     _normalizedPositionDirty = true;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    markWorldTransformDirty();
 }
 
 ssize_t Node::getChildrenCount() const
@@ -630,6 +701,7 @@ void Node::setAnchorPoint(const Vec2& point)
         _anchorPoint = point;
         _anchorPointInPoints.set(_contentSize.width * _anchorPoint.x, _contentSize.height * _anchorPoint.y);
         _transformUpdated = _transformDirty = _inverseDirty = true;
+        markWorldTransformDirty();
     }
 }
 
@@ -647,6 +719,7 @@ void Node::setContentSize(const Size & size)
 
         _anchorPointInPoints.set(_contentSize.width * _anchorPoint.x, _contentSize.height * _anchorPoint.y);
         _transformUpdated = _transformDirty = _inverseDirty = _contentSizeDirty = true;
+        markWorldTransformDirty();
     }
 }
 
@@ -661,6 +734,7 @@ void Node::setParent(Node * parent)
 {
     _parent = parent;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    markWorldTransformDirty();
 }
 
 /// isRelativeAnchorPoint getter
@@ -676,6 +750,7 @@ void Node::setIgnoreAnchorPointForPosition(bool newValue)
     {
         _ignoreAnchorPointForPosition = newValue;
         _transformUpdated = _transformDirty = _inverseDirty = true;
+        markWorldTransformDirty();
     }
 }
 
@@ -688,6 +763,14 @@ int Node::getTag() const
 /// tag setter
 void Node::setTag(int tag)
 {
+    if (_parent && _parent->_childLookupIndex)
+    {
+        _parent->_childLookupIndex->remove(this);
+        _tag = tag;
+        _parent->_childLookupIndex->add(this);
+        return;
+    }
+
     _tag = tag ;
 }
 
@@ -698,9 +781,15 @@ const std::string& Node::getName() const
 
 void Node::setName(const std::string& name)
 {
+    if (_parent && _parent->_childLookupIndex)
+        _parent->_childLookupIndex->remove(this);
+
     _name = name;
     std::hash<std::string> h;
     _hashOfName = h(name);
+
+    if (_parent && _parent->_childLookupIndex)
+        _parent->_childLookupIndex->add(this);
 }
 
 /// userData setter
@@ -794,6 +883,16 @@ Node* Node::getChildByTag(int tag) const
 {
     CCASSERT(tag != Node::INVALID_TAG, "Invalid tag");
 
+    if (_childLookupIndex)
+    {
+        auto range = _childLookupIndex->byTag.equal_range(tag);
+        if (range.first == range.second)
+            return nullptr;
+        // with several matches the first one in the children array wins, which the index doesn't know
+        if (std::next(range.first) == range.second)
+            return range.first->second;
+    }
+
     for (const auto child : _children)
     {
         if(child && child->_tag == tag)
@@ -808,6 +907,23 @@ Node* Node::getChildByName(const std::string& name) const
     
     std::hash<std::string> h;
     size_t hash = h(name);
+
+    if (_childLookupIndex)
+    {
+        Node* found = nullptr;
+        size_t matches = 0;
+        auto range = _childLookupIndex->byNameHash.equal_range(hash);
+        for (auto it = range.first; it != range.second; ++it)
+        {
+            if (it->second->_name.compare(name) == 0)
+            {
+                found = it->second;
+                ++matches;
+            }
+        }
+        if (matches <= 1)
+            return found;
+    }
     
     for (const auto& child : _children)
     {
@@ -986,6 +1102,9 @@ void Node::addChildHelper(Node* child, int localZOrder, int tag, const std::stri
 
     child->updateOrderOfArrival();
 
+    if (_childLookupIndex)
+        _childLookupIndex->add(child);
+
     if( _running )
     {
         child->onEnter();
@@ -1116,6 +1235,12 @@ void Node::removeAllChildrenWithCleanup(bool cleanup)
     }
     
     _children.clear();
+    _reorderedChildren.clear();
+    if (_childLookupIndex)
+    {
+        _childLookupIndex->byTag.clear();
+        _childLookupIndex->byNameHash.clear();
+    }
 }
 
 void Node::detachChild(Node *child, ssize_t childIndex, bool doCleanup)
@@ -1143,6 +1268,16 @@ void Node::detachChild(Node *child, ssize_t childIndex, bool doCleanup)
         sEngine->releaseScriptObject(this, child);
     }
 #endif // CC_ENABLE_GC_FOR_NATIVE_OBJECTS
+    if (_childLookupIndex)
+        _childLookupIndex->remove(child);
+
+    if (!_reorderedChildren.empty())
+    {
+        auto it = std::find(_reorderedChildren.begin(), _reorderedChildren.end(), child);
+        if (it != _reorderedChildren.end())
+            _reorderedChildren.erase(it);
+    }
+
     // set parent nil at the end
     child->setParent(nullptr);
 
@@ -1161,7 +1296,7 @@ void Node::insertChild(Node* child, int z)
     }
 #endif // CC_ENABLE_GC_FOR_NATIVE_OBJECTS
     _transformUpdated = true;
-    _reorderChildDirty = true;
+    recordReorderedChild(child);
     _children.pushBack(child);
     child->_setLocalZOrder(z);
 }
@@ -1169,18 +1304,88 @@ void Node::insertChild(Node* child, int z)
 void Node::reorderChild(Node *child, int zOrder)
 {
     CCASSERT( child != nullptr, "Child must be non-nil");
-    _reorderChildDirty = true;
+    recordReorderedChild(child);
     child->updateOrderOfArrival();
     child->_setLocalZOrder(zOrder);
+
+    // only the child moved, the listeners of its siblings keep their order
+    _eventDispatcher->setDirtyForNode(child);
+}
+
+void Node::recordReorderedChild(Node* child)
+{
+    // an empty record on a dirty node means that the order changed some other way, so everything gets sorted
+    if (!_reorderChildDirty)
+    {
+        _reorderedChildren.clear();
+        _reorderedChildren.push_back(child);
+    }
+    else if (!_reorderedChildren.empty())
+    {
+        if (_reorderedChildren.size() >= MAX_REORDERED_CHILDREN)
+            _reorderedChildren.clear();
+        else if (std::find(_reorderedChildren.begin(), _reorderedChildren.end(), child) == _reorderedChildren.end())
+            _reorderedChildren.push_back(child);
+    }
+
+    _reorderChildDirty = true;
 }
 
 void Node::sortAllChildren()
 {
     if (_reorderChildDirty)
     {
-        sortNodes(_children);
+        if (_reorderedChildren.empty())
+        {
+            sortNodes(_children);
+        }
+        else
+        {
+            auto less = [](const Node* n1, const Node* n2) {
+#if CC_64BITS
+                return n1->_localZOrder$Arrival < n2->_localZOrder$Arrival;
+#else
+                return (n1->_localZOrder == n2->_localZOrder && n1->_orderOfArrival < n2->_orderOfArrival) || n1->_localZOrder < n2->_localZOrder;
+#endif
+            };
+
+            // the other children are still in order, take the moved ones out and insert them back where they belong
+            auto reordered = [this](const Node* child) {
+                return std::find(_reorderedChildren.begin(), _reorderedChildren.end(), child) != _reorderedChildren.end();
+            };
+            auto first = _children.begin();
+            auto last = std::remove_if(first, _children.end(), reordered);
+            CCASSERT(_children.end() - last == (ssize_t)_reorderedChildren.size(), "Reordered children must be children of this node");
+
+            std::sort(_reorderedChildren.begin(), _reorderedChildren.end(), less);
+            for (const auto child : _reorderedChildren)
+            {
+                auto position = std::upper_bound(first, last, child, less);
+                std::copy_backward(position, last, last + 1);
+                *position = child;
+                first = position + 1;
+                ++last;
+            }
+            _reorderedChildren.clear();
+        }
         _reorderChildDirty = false;
-        _eventDispatcher->setDirtyForNode(this);
+    }
+}
+
+void Node::setChildLookupIndexEnabled(bool enabled)
+{
+    if (enabled == (_childLookupIndex != nullptr))
+        return;
+
+    if (enabled)
+    {
+        _childLookupIndex = new (std::nothrow) ChildLookupIndex();
+        for (const auto child : _children)
+            _childLookupIndex->add(child);
+    }
+    else
+    {
+        CC_SAFE_DELETE(_childLookupIndex);
     }
 }
 
@@ -1214,6 +1419,7 @@ uint32_t Node::processParentFlags(const Mat4& parentTransform, uint32_t parentFl
             _position.x = _normalizedPosition.x * s.width;
             _position.y = _normalizedPosition.y * s.height;
             _transformUpdated = _transformDirty = _inverseDirty = true;
+            markWorldTransformDirty();
             _normalizedPositionDirty = false;
         }
     }
@@ -1229,7 +1435,12 @@ uint32_t Node::processParentFlags(const Mat4& parentTransform, uint32_t parentFl
     
 
     if(flags & FLAGS_DIRTY_MASK)
+    {
         _modelViewTransform = this->transform(parentTransform);
+
+        if (_hitTestIndexEnabled)
+            _eventDispatcher->setHitTestBounds(this, RectApplyTransform(Rect(Vec2::ZERO, _contentSize), _modelViewTransform));
+    }
     
     _transformUpdated = false;
     _contentSizeDirty = false;
@@ -1434,12 +1645,33 @@ void Node::setEventDispatcher(EventDispatcher* dispatcher)
     if (dispatcher != _eventDispatcher)
     {
         _eventDispatcher->removeEventListenersForTarget(this);
+        if (_hitTestIndexEnabled)
+        {
+            _eventDispatcher->removeHitTestBounds(this);
+            dispatcher->setHitTestBounds(this, RectApplyTransform(Rect(Vec2::ZERO, _contentSize), getNodeToWorldTransform()));
+        }
         CC_SAFE_RETAIN(dispatcher);
         CC_SAFE_RELEASE(_eventDispatcher);
         _eventDispatcher = dispatcher;
     }
 }
 
+void Node::setHitTestIndexEnabled(bool enabled)
+{
+    if (_hitTestIndexEnabled == enabled)
+        return;
+
+    _hitTestIndexEnabled = enabled;
+    if (enabled)
+    {
+        _eventDispatcher->setHitTestBounds(this, RectApplyTransform(Rect(Vec2::ZERO, _contentSize), getNodeToWorldTransform()));
+    }
+    else
+    {
+        _eventDispatcher->removeHitTestBounds(this);
+    }
+}
+
 void Node::setActionManager(ActionManager* actionManager)
 {
     if( actionManager != _actionManager )
@@ -1630,6 +1862,7 @@ void Node::resume()
 {
     _scheduler->resumeTarget(this);
     _actionManager->resumeTarget(this);
+    _director->getTweenManager()->resumeTarget(this);
     _eventDispatcher->resumeEventListenersForTarget(this);
 }
 
@@ -1637,6 +1870,7 @@ void Node::pause()
 {
     _scheduler->pauseTarget(this);
     _actionManager->pauseTarget(this);
+    _director->getTweenManager()->pauseTarget(this);
     _eventDispatcher->pauseEventListenersForTarget(this);
 }
 
@@ -1812,6 +2046,8 @@ void Node::setNodeToParentTransform(const Mat4& transform)
     if (_additionalTransform)
         // _additionalTransform[1] has a copy of lastest transform
         _additionalTransform[1] = transform;
+
+    markWorldTransformDirty();
 }
 
 void Node::setAdditionalTransform(const AffineTransform& additionalTransform)
@@ -1841,6 +2077,7 @@ void Node::setAdditionalTransform(const Mat4* additionalTransform)
         _additionalTransform[0] = *additionalTransform;
     }
     _transformUpdated = _additionalTransformDirty = _inverseDirty = true;
+    markWorldTransformDirty();
 }
 
 void Node::setAdditionalTransform(const Mat4& additionalTransform)
@@ -1875,6 +2112,9 @@ AffineTransform Node::getNodeToWorldAffineTransform() const
 
 Mat4 Node::getNodeToWorldTransform() const
 {
+    if (_worldTransformCache)
+        return computeNodeToWorldTransform();
+
     return this->getNodeToParentTransform(nullptr);
 }
 
@@ -1885,9 +2125,67 @@ AffineTransform Node::getWorldToNodeAffineTransform() const
 
 Mat4 Node::getWorldToNodeTransform() const
 {
+    if (_worldTransformCache)
+    {
+        if (_worldTransformDirty)
+            computeNodeToWorldTransform();
+
+        if (_worldInverseDirty)
+        {
+            _worldTransformCache[1] = _worldTransformCache[0].getInversed();
+            _worldInverseDirty = false;
+        }
+        return _worldTransformCache[1];
+    }
+
     return getNodeToWorldTransform().getInversed();
 }
 
+void Node::setWorldTransformCacheEnabled(bool enabled)
+{
+    if (enabled == (_worldTransformCache != nullptr))
+        return;
+
+    if (enabled)
+    {
+        _worldTransformCache = new Mat4[2];
+        markWorldTransformDirty();
+    }
+    else
+    {
+        delete[] _worldTransformCache;
+        _worldTransformCache = nullptr;
+    }
+}
+
+void Node::markWorldTransformDirty()
+{
+    // nodes are only clean when their ancestors are, so the descendants of a dirty node are dirty too
+    if (_worldTransformDirty)
+        return;
+
+    _worldTransformDirty = true;
+    for (const auto& child : _children)
+        child->markWorldTransformDirty();
+}
+
+Mat4 Node::computeNodeToWorldTransform() const
+{
+    if (_worldTransformCache && !_worldTransformDirty)
+        return _worldTransformCache[0];
+
+    Mat4 world = _parent ? _parent->computeNodeToWorldTransform() * getNodeToParentTransform() : getNodeToParentTransform();
+
+    // cleared on the way up even without a cache, so that moving an ancestor reaches the caches below it
+    _worldTransformDirty = false;
+    if (_worldTransformCache)
+    {
+        _worldTransformCache[0] = world;
+        _worldInverseDirty = true;
+    }
+    return world;
+}
+
 
 Vec2 Node::convertToNodeSpace(const Vec2& worldPoint) const
 {
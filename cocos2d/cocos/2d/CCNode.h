@@ -835,6 +835,18 @@ public:
      * @since v3.2
      */
     virtual void enumerateChildren(const std::string &name, std::function<bool(Node* node)> callback) const;
+    /**
+     * Indexes the children by tag and by name, so getChildByTag() and getChildByName() don't scan all of them.
+     * Children sharing a tag or a name are still looked up by scanning, which keeps the results unchanged.
+     *
+     * @param enabled True to index the children of this node.
+     */
+    void setChildLookupIndexEnabled(bool enabled);
+    /** Whether the children of the node are indexed by tag and by name.
+     *
+     * @return True if the children of this node are indexed.
+     */
+    bool isChildLookupIndexEnabled() const { return _childLookupIndex != nullptr; }
     /**
      * Returns the array of the node's children.
      *
@@ -1210,6 +1222,19 @@ public:
      */
     virtual EventDispatcher* getEventDispatcher() const { return _eventDispatcher; };
 
+    /** Registers the bounding box of the node in world space with the event dispatcher, so that its one by one
+     * touch listeners are only asked about the touches which begin inside it.
+     * The bounds are updated when the node is visited. Only use it for 2D nodes drawn by the default camera.
+     *
+     * @param enabled True to hit test the touches of this node.
+     */
+    void setHitTestIndexEnabled(bool enabled);
+    /** Whether the event dispatcher hit tests the touches of this node.
+     *
+     * @return True if the bounds of this node are registered with the event dispatcher.
+     */
+    bool isHitTestIndexEnabled() const { return _hitTestIndexEnabled; }
+
     /// @{
     /// @name Actions
 
@@ -1616,6 +1641,21 @@ public:
     /** @deprecated Use getWorldToNodeTransform() instead */
     CC_DEPRECATED_ATTRIBUTE virtual AffineTransform worldToNodeTransform() const { return getWorldToNodeAffineTransform(); }
 
+    /**
+     * Caches the world transform of the node and its inverse, so getNodeToWorldTransform(), getWorldToNodeTransform()
+     * and the coordinate converters don't walk the parents again until the node or one of its ancestors moves.
+     * Don't enable it on or below a node that computes its transform in an override of getNodeToParentTransform(),
+     * like PhysicsSprite or AttachNode, since nothing tells the cache when their transform changes.
+     *
+     * @param enabled True to cache the world transforms of this node.
+     */
+    void setWorldTransformCacheEnabled(bool enabled);
+    /** Whether the world transforms of the node are cached.
+     *
+     * @return True if the world transforms of this node are cached.
+     */
+    bool isWorldTransformCacheEnabled() const { return _worldTransformCache != nullptr; }
+
     /// @} end of Transformations
 
 
@@ -1880,6 +1920,11 @@ protected:
     Mat4 transform(const Mat4 &parentTransform);
     uint32_t processParentFlags(const Mat4& parentTransform, uint32_t parentFlags);
 
+    /// Marks the cached world transforms of this node and of its descendants as stale, nodes with more children override it.
+    virtual void markWorldTransformDirty();
+    /// Computes the node to world transform, refreshing the caches of this node and of its ancestors on the way.
+    Mat4 computeNodeToWorldTransform() const;
+
     virtual void updateCascadeOpacity();
     virtual void disableCascadeOpacity();
     virtual void updateCascadeColor();
@@ -1899,6 +1944,7 @@ protected:
     
 private:
     void addChildHelper(Node* child, int localZOrder, int tag, const std::string &name, bool setTag);
+    void recordReorderedChild(Node* child);
     
 protected:
 
@@ -1939,6 +1985,9 @@ protected:
     mutable bool _inverseDirty;     ///< inverse transform dirty flag
     mutable Mat4* _additionalTransform; ///< two transforms needed by additional transforms
     mutable bool _additionalTransformDirty; ///< transform dirty ?
+    mutable Mat4* _worldTransformCache; ///< node to world and world to node transforms, allocated by setWorldTransformCacheEnabled()
+    mutable bool _worldTransformDirty;  ///< cached world transforms of this node and of all its descendants are stale
+    mutable bool _worldInverseDirty;    ///< cached world to node transform is stale
     bool _transformUpdated;         ///< Whether or not the Transform object was updated since the last frame
 
 #if CC_LITTLE_ENDIAN
@@ -1964,6 +2013,11 @@ protected:
     static std::uint32_t s_globalOrderOfArrival;
 
     Vector<Node*> _children;        ///< array of children nodes
+    std::vector<Node*> _reorderedChildren; ///< children moved since the last sort, empty when all of them need sorting
+
+    struct ChildLookupIndex;
+    ChildLookupIndex* _childLookupIndex; ///< children by tag and by name, allocated by setChildLookupIndexEnabled()
+
     Node *_parent;                  ///< weak reference to parent node
     Director* _director;            //cached director pointer to improve rendering performance
     int _tag;                       ///< a tag. Can be any number you assigned just to identify this node
@@ -1982,6 +2036,8 @@ protected:
 
     EventDispatcher* _eventDispatcher;  ///< event dispatcher used to dispatch all kinds of events
 
+    bool _hitTestIndexEnabled;      ///< whether the world bounds are registered with the event dispatcher
+
     bool _running;                  ///< is running
 
     bool _visible;                  ///< is this node visible
@@ -2034,6 +2090,11 @@ public:
     friend class PhysicsBody;
 #endif
 
+    // sorts scene graph priority listeners by the children sort key
+    friend class EventDispatcher;
+    // marks the world transforms of its protected children dirty too
+    friend class ProtectedNode;
+
     static int __attachedNodeCount;
     
 private:
@@ -0,0 +1,470 @@
+/****************************************************************************
+Copyright (c) 2019 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#include "2d/CCParticleKernels.h"
+
+#include <math.h>
+
+#include "base/ccMacros.h"
+#include "math/CCMathBase.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CC_PARTICLE_USE_SSE2
+#include <emmintrin.h>
+#elif defined(__aarch64__)
+// ARMv7 NEON has no square root and division, the gravity mode could not match the scalar code there
+#define CC_PARTICLE_USE_NEON
+#include <arm_neon.h>
+#endif
+
+NS_CC_BEGIN
+
+namespace ParticleKernels {
+
+namespace {
+
+// there is no SIMD cosf and sinf which matches the C library
+void placeOnCircle(float* posx, float* posy, const float* angle, const float* radius, int count, float yCoordFlipped)
+{
+    for (int i = 0; i < count; ++i)
+    {
+        posx[i] = - cosf(angle[i]) * radius[i];
+    }
+    for (int i = 0; i < count; ++i)
+    {
+        posy[i] = - sinf(angle[i]) * radius[i] * yCoordFlipped;
+    }
+}
+
+} // anonymous namespace
+
+namespace Scalar {
+
+void decay(float* values, int count, float dt)
+{
+    for (int i = 0; i < count; ++i)
+    {
+        values[i] -= dt;
+    }
+}
+
+void integrate(float* values, const float* deltas, int count, float dt)
+{
+    for (int i = 0; i < count; ++i)
+    {
+        values[i] += deltas[i] * dt;
+    }
+}
+
+void integrateNonNegative(float* values, const float* deltas, int count, float dt)
+{
+    for (int i = 0; i < count; ++i)
+    {
+        values[i] += deltas[i] * dt;
+        values[i] = MAX(0, values[i]);
+    }
+}
+
+int findExpired(const float* timeToLive, int begin, int end)
+{
+    for (int i = begin; i < end; ++i)
+    {
+        if (timeToLive[i] <= 0.0f)
+            return i;
+    }
+    return end;
+}
+
+void updateGravityMode(float* posx, float* posy, float* dirX, float* dirY, const float* radialAccel, const float* tangentialAccel,
+                       int count, float gravityX, float gravityY, float dt, float yCoordFlipped)
+{
+    for (int i = 0; i < count; ++i)
+    {
+        float radialX = 0.0f;
+        float radialY = 0.0f;
+
+        // radial acceleration, a unit vector is left at 0 like before
+        if (posx[i] || posy[i])
+        {
+            float n = posx[i] * posx[i] + posy[i] * posy[i];
+            if (n != 1.0f)
+            {
+                n = sqrtf(n);
+                if (!(n < MATH_TOLERANCE))
+                {
+                    n = 1.0f / n;
+                    radialX = posx[i] * n;
+                    radialY = posy[i] * n;
+                }
+            }
+        }
+
+        // tangential acceleration is the radial direction turned by 90 degrees
+        float tangentialX = radialY * -tangentialAccel[i];
+        float tangentialY = radialX * tangentialAccel[i];
+        radialX *= radialAccel[i];
+        radialY *= radialAccel[i];
+
+        // (gravity + radial + tangential) * dt
+        dirX[i] += (radialX + tangentialX + gravityX) * dt;
+        dirY[i] += (radialY + tangentialY + gravityY) * dt;
+
+        posx[i] += dirX[i] * dt * yCoordFlipped;
+        posy[i] += dirY[i] * dt * yCoordFlipped;
+    }
+}
+
+void updateRadiusMode(float* posx, float* posy, float* angle, const float* degreesPerSecond, float* radius, const float* deltaRadius,
+                      int count, float dt, float yCoordFlipped)
+{
+    integrate(angle, degreesPerSecond, count, dt);
+    integrate(radius, deltaRadius, count, dt);
+    placeOnCircle(posx, posy, angle, radius, count, yCoordFlipped);
+}
+
+} // namespace Scalar
+
+namespace {
+
+#if defined(CC_PARTICLE_USE_SSE2)
+
+int decaySSE2(float* values, int count, float dt)
+{
+    const __m128 delta = _mm_set1_ps(dt);
+    int i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        _mm_storeu_ps(values + i, _mm_sub_ps(_mm_loadu_ps(values + i), delta));
+    }
+    return i;
+}
+
+int integrateSSE2(float* values, const float* deltas, int count, float dt)
+{
+    const __m128 time = _mm_set1_ps(dt);
+    int i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 v = _mm_add_ps(_mm_loadu_ps(values + i), _mm_mul_ps(_mm_loadu_ps(deltas + i), time));
+        _mm_storeu_ps(values + i, v);
+    }
+    return i;
+}
+
+int integrateNonNegativeSSE2(float* values, const float* deltas, int count, float dt)
+{
+    const __m128 time = _mm_set1_ps(dt);
+    const __m128 zero = _mm_setzero_ps();
+    int i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 v = _mm_add_ps(_mm_loadu_ps(values + i), _mm_mul_ps(_mm_loadu_ps(deltas + i), time));
+        // maxps returns the second operand for NaN and -0, like MAX(0, v)
+        _mm_storeu_ps(values + i, _mm_max_ps(v, zero));
+    }
+    return i;
+}
+
+int findExpiredSSE2(const float* timeToLive, int begin, int end)
+{
+    const __m128 zero = _mm_setzero_ps();
+    int i = begin;
+    for (; i + 4 <= end; i += 4)
+    {
+        int expired = _mm_movemask_ps(_mm_cmple_ps(_mm_loadu_ps(timeToLive + i), zero));
+        if (expired)
+        {
+            while (!(expired & 1))
+            {
+                expired >>= 1;
+                ++i;
+            }
+            return i;
+        }
+    }
+    return i;
+}
+
+int updateGravityModeSSE2(float* posx, float* posy, float* dirX, float* dirY, const float* radialAccel, const float* tangentialAccel,
+                          int count, float gravityX, float gravityY, float dt, float yCoordFlipped)
+{
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 tolerance = _mm_set1_ps(MATH_TOLERANCE);
+    const __m128 gx = _mm_set1_ps(gravityX);
+    const __m128 gy = _mm_set1_ps(gravityY);
+    const __m128 time = _mm_set1_ps(dt);
+    const __m128 flip = _mm_set1_ps(yCoordFlipped);
+    const __m128 sign = _mm_set1_ps(-0.0f);
+    int i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 x = _mm_loadu_ps(posx + i);
+        __m128 y = _mm_loadu_ps(posy + i);
+        __m128 n = _mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y));
+        __m128 length = _mm_sqrt_ps(n);
+        __m128 inverse = _mm_div_ps(one, length);
+
+        // the lanes the scalar code normalizes, the others keep a radial direction of 0
+        __m128 normalized = _mm_or_ps(_mm_cmpneq_ps(x, zero), _mm_cmpneq_ps(y, zero));
+        normalized = _mm_and_ps(normalized, _mm_cmpneq_ps(n, one));
+        normalized = _mm_and_ps(normalized, _mm_cmpnlt_ps(length, tolerance));
+        __m128 radialX = _mm_and_ps(normalized, _mm_mul_ps(x, inverse));
+        __m128 radialY = _mm_and_ps(normalized, _mm_mul_ps(y, inverse));
+
+        __m128 tangential = _mm_loadu_ps(tangentialAccel + i);
+        __m128 tangentialX = _mm_mul_ps(radialY, _mm_xor_ps(tangential, sign));
+        __m128 tangentialY = _mm_mul_ps(radialX, tangential);
+        __m128 radial = _mm_loadu_ps(radialAccel + i);
+        radialX = _mm_mul_ps(radialX, radial);
+        radialY = _mm_mul_ps(radialY, radial);
+
+        __m128 dx = _mm_add_ps(_mm_loadu_ps(dirX + i), _mm_mul_ps(_mm_add_ps(_mm_add_ps(radialX, tangentialX), gx), time));
+        __m128 dy = _mm_add_ps(_mm_loadu_ps(dirY + i), _mm_mul_ps(_mm_add_ps(_mm_add_ps(radialY, tangentialY), gy), time));
+        _mm_storeu_ps(dirX + i, dx);
+        _mm_storeu_ps(dirY + i, dy);
+
+        _mm_storeu_ps(posx + i, _mm_add_ps(x, _mm_mul_ps(_mm_mul_ps(dx, time), flip)));
+        _mm_storeu_ps(posy + i, _mm_add_ps(y, _mm_mul_ps(_mm_mul_ps(dy, time), flip)));
+    }
+    return i;
+}
+
+#elif defined(CC_PARTICLE_USE_NEON)
+
+// Multiplies and adds are kept apart, a fused multiply-add would round differently than the scalar code.
+
+int decayNEON(float* values, int count, float dt)
+{
+    const float32x4_t delta = vdupq_n_f32(dt);
+    int i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        vst1q_f32(values + i, vsubq_f32(vld1q_f32(values + i), delta));
+    }
+    return i;
+}
+
+int integrateNEON(float* values, const float* deltas, int count, float dt)
+{
+    const float32x4_t time = vdupq_n_f32(dt);
+    int i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        vst1q_f32(values + i, vaddq_f32(vld1q_f32(values + i), vmulq_f32(vld1q_f32(deltas + i), time)));
+    }
+    return i;
+}
+
+int integrateNonNegativeNEON(float* values, const float* deltas, int count, float dt)
+{
+    const float32x4_t time = vdupq_n_f32(dt);
+    const float32x4_t zero = vdupq_n_f32(0.0f);
+    int i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        float32x4_t v = vaddq_f32(vld1q_f32(values + i), vmulq_f32(vld1q_f32(deltas + i), time));
+        // vmaxq_f32 propagates NaN, MAX(0, v) doesn't
+        vst1q_f32(values + i, vbslq_f32(vcgtq_f32(v, zero), v, zero));
+    }
+    return i;
+}
+
+int findExpiredNEON(const float* timeToLive, int begin, int end)
+{
+    const float32x4_t zero = vdupq_n_f32(0.0f);
+    int i = begin;
+    for (; i + 4 <= end; i += 4)
+    {
+        if (vmaxvq_u32(vcleq_f32(vld1q_f32(timeToLive + i), zero)))
+        {
+            while (!(timeToLive[i] <= 0.0f))
+            {
+                ++i;
+            }
+            return i;
+        }
+    }
+    return i;
+}
+
+int updateGravityModeNEON(float* posx, float* posy, float* dirX, float* dirY, const float* radialAccel, const float* tangentialAccel,
+                          int count, float gravityX, float gravityY, float dt, float yCoordFlipped)
+{
+    const float32x4_t zero = vdupq_n_f32(0.0f);
+    const float32x4_t one = vdupq_n_f32(1.0f);
+    const float32x4_t tolerance = vdupq_n_f32(MATH_TOLERANCE);
+    const float32x4_t gx = vdupq_n_f32(gravityX);
+    const float32x4_t gy = vdupq_n_f32(gravityY);
+    const float32x4_t time = vdupq_n_f32(dt);
+    const float32x4_t flip = vdupq_n_f32(yCoordFlipped);
+    int i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        float32x4_t x = vld1q_f32(posx + i);
+        float32x4_t y = vld1q_f32(posy + i);
+        float32x4_t n = vaddq_f32(vmulq_f32(x, x), vmulq_f32(y, y));
+        float32x4_t length = vsqrtq_f32(n);
+        float32x4_t inverse = vdivq_f32(one, length);
+
+        // the lanes the scalar code normalizes, the others keep a radial direction of 0
+        uint32x4_t normalized = vorrq_u32(vmvnq_u32(vceqq_f32(x, zero)), vmvnq_u32(vceqq_f32(y, zero)));
+        normalized = vandq_u32(normalized, vmvnq_u32(vceqq_f32(n, one)));
+        normalized = vandq_u32(normalized, vmvnq_u32(vcltq_f32(length, tolerance)));
+        float32x4_t radialX = vreinterpretq_f32_u32(vandq_u32(normalized, vreinterpretq_u32_f32(vmulq_f32(x, inverse))));
+        float32x4_t radialY = vreinterpretq_f32_u32(vandq_u32(normalized, vreinterpretq_u32_f32(vmulq_f32(y, inverse))));
+
+        float32x4_t tangential = vld1q_f32(tangentialAccel + i);
+        float32x4_t tangentialX = vmulq_f32(radialY, vnegq_f32(tangential));
+        float32x4_t tangentialY = vmulq_f32(radialX, tangential);
+        float32x4_t radial = vld1q_f32(radialAccel + i);
+        radialX = vmulq_f32(radialX, radial);
+        radialY = vmulq_f32(radialY, radial);
+
+        float32x4_t dx = vaddq_f32(vld1q_f32(dirX + i), vmulq_f32(vaddq_f32(vaddq_f32(radialX, tangentialX), gx), time));
+        float32x4_t dy = vaddq_f32(vld1q_f32(dirY + i), vmulq_f32(vaddq_f32(vaddq_f32(radialY, tangentialY), gy), time));
+        vst1q_f32(dirX + i, dx);
+        vst1q_f32(dirY + i, dy);
+
+        vst1q_f32(posx + i, vaddq_f32(x, vmulq_f32(vmulq_f32(dx, time), flip)));
+        vst1q_f32(posy + i, vaddq_f32(y, vmulq_f32(vmulq_f32(dy, time), flip)));
+    }
+    return i;
+}
+
+#endif
+
+bool detectSIMD()
+{
+#if defined(CC_PARTICLE_USE_SSE2) || defined(CC_PARTICLE_USE_NEON)
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool s_simdEnabled = detectSIMD();
+
+} // anonymous namespace
+
+bool isSIMDSupported()
+{
+    static const bool supported = detectSIMD();
+    return supported;
+}
+
+bool isSIMDEnabled()
+{
+    return s_simdEnabled;
+}
+
+void setSIMDEnabled(bool enabled)
+{
+    s_simdEnabled = enabled && isSIMDSupported();
+}
+
+// The SIMD kernels process whole blocks of 4 particles and return how many they did, the scalar code finishes the tail.
+
+void decay(float* values, int count, float dt)
+{
+    int done = 0;
+    if (s_simdEnabled)
+    {
+#if defined(CC_PARTICLE_USE_SSE2)
+        done = decaySSE2(values, count, dt);
+#elif defined(CC_PARTICLE_USE_NEON)
+        done = decayNEON(values, count, dt);
+#endif
+    }
+    Scalar::decay(values + done, count - done, dt);
+}
+
+void integrate(float* values, const float* deltas, int count, float dt)
+{
+    int done = 0;
+    if (s_simdEnabled)
+    {
+#if defined(CC_PARTICLE_USE_SSE2)
+        done = integrateSSE2(values, deltas, count, dt);
+#elif defined(CC_PARTICLE_USE_NEON)
+        done = integrateNEON(values, deltas, count, dt);
+#endif
+    }
+    Scalar::integrate(values + done, deltas + done, count - done, dt);
+}
+
+void integrateNonNegative(float* values, const float* deltas, int count, float dt)
+{
+    int done = 0;
+    if (s_simdEnabled)
+    {
+#if defined(CC_PARTICLE_USE_SSE2)
+        done = integrateNonNegativeSSE2(values, deltas, count, dt);
+#elif defined(CC_PARTICLE_USE_NEON)
+        done = integrateNonNegativeNEON(values, deltas, count, dt);
+#endif
+    }
+    Scalar::integrateNonNegative(values + done, deltas + done, count - done, dt);
+}
+
+int findExpired(const float* timeToLive, int begin, int end)
+{
+    if (s_simdEnabled)
+    {
+#if defined(CC_PARTICLE_USE_SSE2)
+        begin = findExpiredSSE2(timeToLive, begin, end);
+#elif defined(CC_PARTICLE_USE_NEON)
+        begin = findExpiredNEON(timeToLive, begin, end);
+#endif
+    }
+    return Scalar::findExpired(timeToLive, begin, end);
+}
+
+void updateGravityMode(float* posx, float* posy, float* dirX, float* dirY, const float* radialAccel, const float* tangentialAccel,
+                       int count, float gravityX, float gravityY, float dt, float yCoordFlipped)
+{
+    int done = 0;
+    if (s_simdEnabled)
+    {
+#if defined(CC_PARTICLE_USE_SSE2)
+        done = updateGravityModeSSE2(posx, posy, dirX, dirY, radialAccel, tangentialAccel, count, gravityX, gravityY, dt, yCoordFlipped);
+#elif defined(CC_PARTICLE_USE_NEON)
+        done = updateGravityModeNEON(posx, posy, dirX, dirY, radialAccel, tangentialAccel, count, gravityX, gravityY, dt, yCoordFlipped);
+#endif
+    }
+    Scalar::updateGravityMode(posx + done, posy + done, dirX + done, dirY + done, radialAccel + done, tangentialAccel + done,
+                              count - done, gravityX, gravityY, dt, yCoordFlipped);
+}
+
+void updateRadiusMode(float* posx, float* posy, float* angle, const float* degreesPerSecond, float* radius, const float* deltaRadius,
+                      int count, float dt, float yCoordFlipped)
+{
+    integrate(angle, degreesPerSecond, count, dt);
+    integrate(radius, deltaRadius, count, dt);
+    placeOnCircle(posx, posy, angle, radius, count, yCoordFlipped);
+}
+
+} // namespace ParticleKernels
+
+NS_CC_END
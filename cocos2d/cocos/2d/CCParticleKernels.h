@@ -0,0 +1,97 @@
+/****************************************************************************
+Copyright (c) 2019 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#ifndef __cocos2dx__CCParticleKernels__
+#define __cocos2dx__CCParticleKernels__
+
+#include "platform/CCPlatformMacros.h"
+
+/**
+ * @addtogroup _2d
+ * @{
+ */
+
+NS_CC_BEGIN
+
+/**
+ * The per frame integration steps of ParticleSystem::update, on the arrays of ParticleData.
+ *
+ * Every function has a scalar reference implementation and, where the target supports it, an SSE2 or
+ * NEON (AArch64) one which produces bit-exact the same output, except updateRadiusMode which always
+ * uses the C library for cosf and sinf. setSIMDEnabled(false) forces the scalar path, e.g. to compare
+ * results or measure the speedup.
+ *
+ * All functions take the number of particles, the arrays must not overlap.
+ */
+namespace ParticleKernels {
+
+/** Returns true if an SSE2 or NEON implementation is compiled in and the CPU supports it. */
+CC_DLL bool isSIMDSupported();
+
+/** Returns true if the SIMD implementations are used. */
+CC_DLL bool isSIMDEnabled();
+
+/** Enables or disables the SIMD implementations, it has no effect if isSIMDSupported() is false. */
+CC_DLL void setSIMDEnabled(bool enabled);
+
+/** values[i] -= dt, the time to live decay. */
+CC_DLL void decay(float* values, int count, float dt);
+
+/** values[i] += deltas[i] * dt, used for colors, rotation, and angle and radius of the radius mode. */
+CC_DLL void integrate(float* values, const float* deltas, int count, float dt);
+
+/** values[i] = MAX(0, values[i] + deltas[i] * dt), used for the size. */
+CC_DLL void integrateNonNegative(float* values, const float* deltas, int count, float dt);
+
+/** Returns the index of the first particle in [begin, end) whose time to live is over, or end. */
+CC_DLL int findExpired(const float* timeToLive, int begin, int end);
+
+/** Applies gravity, radial and tangential acceleration to the directions, then moves the particles. */
+CC_DLL void updateGravityMode(float* posx, float* posy, float* dirX, float* dirY, const float* radialAccel, const float* tangentialAccel,
+                              int count, float gravityX, float gravityY, float dt, float yCoordFlipped);
+
+/** Turns and grows the particles, then places them around the emitter. */
+CC_DLL void updateRadiusMode(float* posx, float* posy, float* angle, const float* degreesPerSecond, float* radius, const float* deltaRadius,
+                             int count, float dt, float yCoordFlipped);
+
+/** Scalar reference implementations, always available. */
+namespace Scalar {
+CC_DLL void decay(float* values, int count, float dt);
+CC_DLL void integrate(float* values, const float* deltas, int count, float dt);
+CC_DLL void integrateNonNegative(float* values, const float* deltas, int count, float dt);
+CC_DLL int findExpired(const float* timeToLive, int begin, int end);
+CC_DLL void updateGravityMode(float* posx, float* posy, float* dirX, float* dirY, const float* radialAccel, const float* tangentialAccel,
+                              int count, float gravityX, float gravityY, float dt, float yCoordFlipped);
+CC_DLL void updateRadiusMode(float* posx, float* posy, float* angle, const float* degreesPerSecond, float* radius, const float* deltaRadius,
+                             int count, float dt, float yCoordFlipped);
+} // namespace Scalar
+
+} // namespace ParticleKernels
+
+NS_CC_END
+
+// end of _2d group
+/** @} */
+
+#endif /** defined(__cocos2dx__CCParticleKernels__) */
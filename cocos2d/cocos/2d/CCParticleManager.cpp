@@ -0,0 +1,103 @@
+/****************************************************************************
+Copyright (c) 2019 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#include "2d/CCParticleManager.h"
+
+#include <thread>
+
+#include "2d/CCParticleSystem.h"
+#include "base/CCJobSystem.h"
+
+NS_CC_BEGIN
+
+ParticleManager::ParticleManager()
+: _jobSystem(nullptr)
+, _parallelEnabled(true)
+{
+}
+
+ParticleManager::~ParticleManager()
+{
+    for (auto emitter : _emitters)
+    {
+        emitter->_stepQueued = false;
+        emitter->release();
+    }
+}
+
+JobSystem* ParticleManager::getJobSystem() const
+{
+    return _jobSystem ? _jobSystem : JobSystem::getInstance();
+}
+
+bool ParticleManager::isParallel() const
+{
+    if (!_parallelEnabled)
+        return false;
+    // don't start the workers of the shared job system on a single core
+    if (_jobSystem == nullptr && std::thread::hardware_concurrency() <= 1)
+        return false;
+    return getJobSystem()->getWorkerCount() > 0;
+}
+
+void ParticleManager::addEmitter(ParticleSystem* emitter, float dt)
+{
+    emitter->retain();
+    emitter->_stepDelta = dt;
+    emitter->_stepQueued = true;
+    _emitters.push_back(emitter);
+}
+
+void ParticleManager::updateEmitters()
+{
+    if (_emitters.empty())
+        return;
+
+    // systems removed by a later update of this frame are skipped, as they would be by the scheduler
+    _updatingEmitters.clear();
+    for (auto emitter : _emitters)
+    {
+        emitter->_stepQueued = false;
+        if (emitter->isRunning())
+        {
+            emitter->prepareStep();
+            _updatingEmitters.push_back(emitter);
+        }
+    }
+
+    getJobSystem()->parallelFor(static_cast<int>(_updatingEmitters.size()), [this](int i) {
+        auto emitter = _updatingEmitters[i];
+        emitter->simulateStep(emitter->_stepDelta);
+    });
+
+    // finishStep() may remove a system from the scene, the queue keeps it alive until the loop is done
+    for (auto emitter : _updatingEmitters)
+        emitter->finishStep();
+    _updatingEmitters.clear();
+    for (auto emitter : _emitters)
+        emitter->release();
+    _emitters.clear();
+}
+
+NS_CC_END
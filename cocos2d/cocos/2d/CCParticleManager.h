@@ -0,0 +1,104 @@
+/****************************************************************************
+Copyright (c) 2019 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#ifndef __CCPARTICLEMANAGER_H__
+#define __CCPARTICLEMANAGER_H__
+
+#include <vector>
+
+#include "base/CCRef.h"
+
+NS_CC_BEGIN
+
+class JobSystem;
+class ParticleSystem;
+
+/**
+ * @addtogroup _2d
+ * @{
+ */
+
+/** @class ParticleManager
+ @brief ParticleManager updates the particle systems of a frame in parallel.
+
+ The scheduled update of a particle system queues it here instead of stepping it. Director calls
+ updateEmitters() once the scheduler has run and before the scene is visited. The queued systems then
+ capture their world transform on the cocos thread and run their simulation, including the vertex
+ generation of updateParticleQuads(), on the workers of a JobSystem. Finally the cocos thread stops
+ or removes the finished systems and uploads the vertices.
+
+ Every system draws its random numbers from its own generator, so the particles do not depend on the
+ number of workers or on the order the systems are run in. Systems rendered by a ParticleBatchNode share
+ its atlas and are still updated by their own scheduled update. Without a second core everything runs
+ on the cocos thread as before.
+ Use Director::getParticleManager() to get the instance.
+ */
+class CC_DLL ParticleManager : public Ref
+{
+public:
+    /**
+     * @js ctor
+     */
+    ParticleManager();
+
+    /**
+     * @js NA
+     * @lua NA
+     */
+    virtual ~ParticleManager();
+
+    /** Enables the parallel update, it is enabled by default. */
+    void setParallelEnabled(bool enabled) { _parallelEnabled = enabled; }
+    bool isParallelEnabled() const { return _parallelEnabled; }
+
+    /** Sets the job system the systems are updated on, nullptr uses JobSystem::getInstance(). */
+    void setJobSystem(JobSystem* jobSystem) { _jobSystem = jobSystem; }
+
+    /** Returns true if the scheduled updates of particle systems are queued, which needs a job system with workers. */
+    bool isParallel() const;
+
+    /** Queues the update of a particle system with a time step of dt, called by ParticleSystem::update(). */
+    void addEmitter(ParticleSystem* emitter, float dt);
+
+    /** Returns the number of particle systems waiting for updateEmitters(). */
+    size_t getQueuedEmitterCount() const { return _emitters.size(); }
+
+    /** Updates the queued particle systems and returns when all of them are done, called by Director each frame. */
+    void updateEmitters();
+
+protected:
+    JobSystem* getJobSystem() const;
+
+    std::vector<ParticleSystem*> _emitters;
+    std::vector<ParticleSystem*> _updatingEmitters;
+    JobSystem* _jobSystem;
+    bool _parallelEnabled;
+};
+
+// end of _2d group
+/// @}
+
+NS_CC_END
+
+#endif // __CCPARTICLEMANAGER_H__
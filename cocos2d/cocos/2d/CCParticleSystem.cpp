@@ -48,6 +48,8 @@ THE SOFTWARE.
 #include <string>
 
 #include "2d/CCParticleBatchNode.h"
+#include "2d/CCParticleKernels.h"
+#include "2d/CCParticleManager.h"
 #include "renderer/CCTextureAtlas.h"
 #include "base/base64.h"
 #include "base/ZipUtils.h"
@@ -79,23 +81,6 @@ NS_CC_BEGIN
 //
 
 
-inline void normalize_point(float x, float y, particle_point* out)
-{
-    float n = x * x + y * y;
-    // Already normalized.
-    if (n == 1.0f)
-        return;
-    
-    n = sqrt(n);
-    // Too close to zero.
-    if (n < MATH_TOLERANCE)
-        return;
-    
-    n = 1.0f / n;
-    out->x = x * n;
-    out->y = y * n;
-}
-
 /**
  A more effect random number getter function, get from ejoy2d.
  */
@@ -225,6 +210,11 @@ ParticleSystem::ParticleSystem()
 , _positionType(PositionType::FREE)
 , _paused(false)
 , _sourcePositionCompatible(true) // In the furture this member's default value maybe false or be removed.
+, _random(rand())
+, _stepDelta(0)
+, _stepQueued(false)
+, _stepStopSystem(false)
+, _stepAutoRemove(false)
 {
     modeA.gravity.setZero();
     modeA.speed = 0;
@@ -609,10 +599,20 @@ ParticleSystem::~ParticleSystem()
 }
 
 void ParticleSystem::addParticles(int count)
+{
+    if (_positionType == PositionType::FREE)
+    {
+        _stepWorldPosition = this->convertToWorldSpace(Vec2::ZERO);
+    }
+    emitParticles(count);
+}
+
+void ParticleSystem::emitParticles(int count)
 {
     if (_paused)
         return;
-    uint32_t RANDSEED = rand();
+    // each emitter has its own generator, rand() is neither thread safe nor repeatable per emitter
+    uint32_t RANDSEED = _random();
 
     int start = _particleCount;
     _particleCount += count;
@@ -702,7 +702,7 @@ dc[i] = (dc[i] - c[i]) / _particleData.timeToLive[i];\
     Vec2 pos;
     if (_positionType == PositionType::FREE)
     {
-        pos = this->convertToWorldSpace(Vec2::ZERO);
+        pos = _stepWorldPosition;
     }
     else if (_positionType == PositionType::RELATIVE)
     {
@@ -863,8 +863,37 @@ bool ParticleSystem::isFull()
 // ParticleSystem - MainLoop
 void ParticleSystem::update(float dt)
 {
+    // only the scheduled updates are queued, batched emitters disable their dead particles in the shared atlas
+    auto particleManager = _director->getParticleManager();
+    if (_running && !_batchNode && !_stepQueued && particleManager && particleManager->isParallel())
+    {
+        particleManager->addEmitter(this, dt);
+        return;
+    }
+
     CC_PROFILER_START_CATEGORY(kProfilerCategoryParticles , "CCParticleSystem - update");
 
+    prepareStep();
+    simulateStep(dt);
+    finishStep();
+
+    CC_PROFILER_STOP_CATEGORY(kProfilerCategoryParticles , "CCParticleSystem - update");
+}
+
+void ParticleSystem::prepareStep()
+{
+    // the world transform is computed lazily, which writes to the ancestors shared with other emitters
+    if (_positionType == PositionType::FREE)
+    {
+        _stepWorldPosition = this->convertToWorldSpace(Vec2::ZERO);
+        _stepWorldToNodeTransform = this->getWorldToNodeTransform();
+    }
+    _stepStopSystem = false;
+    _stepAutoRemove = false;
+}
+
+void ParticleSystem::simulateStep(float dt)
+{
     if (_isActive && _emissionRate)
     {
         float rate = 1.0f / _emissionRate;
@@ -879,7 +908,7 @@ void ParticleSystem::update(float dt)
         }
         
         int emitCount = MIN(totalParticles - _particleCount, _emitCounter / rate);
-        addParticles(emitCount);
+        emitParticles(emitCount);
         _emitCounter -= rate * emitCount;
         
         _elapsed += dt;
@@ -887,160 +916,102 @@ void ParticleSystem::update(float dt)
             _elapsed = 0.f;
         if (_duration != DURATION_INFINITY && _duration < _elapsed)
         {
-            this->stopSystem();
+            // nothing below reads what stopSystem() resets
+            _stepStopSystem = true;
         }
     }
     
     {
-        for (int i = 0; i < _particleCount; ++i)
-        {
-            _particleData.timeToLive[i] -= dt;
-        }
-        
-        for (int i = 0; i < _particleCount; ++i)
-        {
-            if (_particleData.timeToLive[i] <= 0.0f)
-            {
-                int j = _particleCount - 1;
-                while (j > 0 && _particleData.timeToLive[j] <= 0)
-                {
-                    _particleCount--;
-                    j--;
-                }
-                _particleData.copyParticle(i, _particleCount - 1);
-                if (_batchNode)
-                {
-                    //disable the switched particle
-                    int currentIndex = _particleData.atlasIndex[i];
-                    _batchNode->disableParticle(_atlasIndex + currentIndex);
-                    //switch indexes
-                    _particleData.atlasIndex[_particleCount - 1] = currentIndex;
-                }
-                --_particleCount;
-                if( _particleCount == 0 && _isAutoRemoveOnFinish )
-                {
-                    this->unscheduleUpdate();
-                    _parent->removeChild(this, true);
-                    return;
-                }
-            }
-        }
-        
-        if (_emitterMode == Mode::GRAVITY)
-        {
-            for (int i = 0 ; i < _particleCount; ++i)
-            {
-                particle_point tmp, radial = {0.0f, 0.0f}, tangential;
-                
-                // radial acceleration
-                if (_particleData.posx[i] || _particleData.posy[i])
-                {
-                    normalize_point(_particleData.posx[i], _particleData.posy[i], &radial);
-                }
-                tangential = radial;
-                radial.x *= _particleData.modeA.radialAccel[i];
-                radial.y *= _particleData.modeA.radialAccel[i];
-                
-                // tangential acceleration
-                std::swap(tangential.x, tangential.y);
-                tangential.x *= - _particleData.modeA.tangentialAccel[i];
-                tangential.y *= _particleData.modeA.tangentialAccel[i];
-                
-                // (gravity + radial + tangential) * dt
-                tmp.x = radial.x + tangential.x + modeA.gravity.x;
-                tmp.y = radial.y + tangential.y + modeA.gravity.y;
-                tmp.x *= dt;
-                tmp.y *= dt;
-                
-                _particleData.modeA.dirX[i] += tmp.x;
-                _particleData.modeA.dirY[i] += tmp.y;
-                
-                // this is cocos2d-x v3.0
-                // if (_configName.length()>0 && _yCoordFlipped != -1)
-                
-                // this is cocos2d-x v3.0
-                tmp.x = _particleData.modeA.dirX[i] * dt * _yCoordFlipped;
-                tmp.y = _particleData.modeA.dirY[i] * dt * _yCoordFlipped;
-                _particleData.posx[i] += tmp.x;
-                _particleData.posy[i] += tmp.y;
-            }
-        }
-        else
+        ParticleKernels::decay(_particleData.timeToLive, _particleCount, dt);
+
+        // move the last live particle into each expired one, most frames only the search runs
+        for (int i = ParticleKernels::findExpired(_particleData.timeToLive, 0, _particleCount);
+             i < _particleCount;
+             i = ParticleKernels::findExpired(_particleData.timeToLive, i + 1, _particleCount))
         {
-            //Why use so many for-loop separately instead of putting them together?
-            //When the processor needs to read from or write to a location in memory,
-            //it first checks whether a copy of that data is in the cache.
-            //And every property's memory of the particle system is continuous,
-            //for the purpose of improving cache hit rate, we should process only one property in one for-loop AFAP.
-            //It was proved to be effective especially for low-end machine. 
-            for (int i = 0; i < _particleCount; ++i)
+            int j = _particleCount - 1;
+            while (j > 0 && _particleData.timeToLive[j] <= 0)
             {
-                _particleData.modeB.angle[i] += _particleData.modeB.degreesPerSecond[i] * dt;
+                _particleCount--;
+                j--;
             }
-            
-            for (int i = 0; i < _particleCount; ++i)
+            _particleData.copyParticle(i, _particleCount - 1);
+            if (_batchNode)
             {
-                _particleData.modeB.radius[i] += _particleData.modeB.deltaRadius[i] * dt;
+                //disable the switched particle
+                int currentIndex = _particleData.atlasIndex[i];
+                _batchNode->disableParticle(_atlasIndex + currentIndex);
+                //switch indexes
+                _particleData.atlasIndex[_particleCount - 1] = currentIndex;
             }
-            
-            for (int i = 0; i < _particleCount; ++i)
+            --_particleCount;
+            if( _particleCount == 0 && _isAutoRemoveOnFinish )
             {
-                _particleData.posx[i] = - cosf(_particleData.modeB.angle[i]) * _particleData.modeB.radius[i];
+                _stepAutoRemove = true;
+                return;
             }
-            for (int i = 0; i < _particleCount; ++i)
-            {
-                _particleData.posy[i] = - sinf(_particleData.modeB.angle[i]) * _particleData.modeB.radius[i] * _yCoordFlipped;
-            }
-        }
-        
-        //color r,g,b,a
-        for (int i = 0 ; i < _particleCount; ++i)
-        {
-            _particleData.colorR[i] += _particleData.deltaColorR[i] * dt;
         }
         
-        for (int i = 0 ; i < _particleCount; ++i)
+        //Why use so many for-loop separately instead of putting them together?
+        //When the processor needs to read from or write to a location in memory,
+        //it first checks whether a copy of that data is in the cache.
+        //And every property's memory of the particle system is continuous,
+        //for the purpose of improving cache hit rate, we should process only one property in one for-loop AFAP.
+        //It was proved to be effective especially for low-end machine. 
+        if (_emitterMode == Mode::GRAVITY)
         {
-            _particleData.colorG[i] += _particleData.deltaColorG[i] * dt;
+            ParticleKernels::updateGravityMode(_particleData.posx, _particleData.posy, _particleData.modeA.dirX, _particleData.modeA.dirY,
+                                               _particleData.modeA.radialAccel, _particleData.modeA.tangentialAccel, _particleCount,
+                                               modeA.gravity.x, modeA.gravity.y, dt, static_cast<float>(_yCoordFlipped));
         }
-        
-        for (int i = 0 ; i < _particleCount; ++i)
+        else
         {
-            _particleData.colorB[i] += _particleData.deltaColorB[i] * dt;
+            ParticleKernels::updateRadiusMode(_particleData.posx, _particleData.posy, _particleData.modeB.angle, _particleData.modeB.degreesPerSecond,
+                                              _particleData.modeB.radius, _particleData.modeB.deltaRadius, _particleCount,
+                                              dt, static_cast<float>(_yCoordFlipped));
         }
         
-        for (int i = 0 ; i < _particleCount; ++i)
-        {
-            _particleData.colorA[i] += _particleData.deltaColorA[i] * dt;
-        }
+        //color r,g,b,a
+        ParticleKernels::integrate(_particleData.colorR, _particleData.deltaColorR, _particleCount, dt);
+        ParticleKernels::integrate(_particleData.colorG, _particleData.deltaColorG, _particleCount, dt);
+        ParticleKernels::integrate(_particleData.colorB, _particleData.deltaColorB, _particleCount, dt);
+        ParticleKernels::integrate(_particleData.colorA, _particleData.deltaColorA, _particleCount, dt);
         //size
-        for (int i = 0 ; i < _particleCount; ++i)
-        {
-            _particleData.size[i] += (_particleData.deltaSize[i] * dt);
-            _particleData.size[i] = MAX(0, _particleData.size[i]);
-        }
+        ParticleKernels::integrateNonNegative(_particleData.size, _particleData.deltaSize, _particleCount, dt);
         //angle
-        for (int i = 0 ; i < _particleCount; ++i)
-        {
-            _particleData.rotation[i] += _particleData.deltaRotation[i] * dt;
-        }
+        ParticleKernels::integrate(_particleData.rotation, _particleData.deltaRotation, _particleCount, dt);
         
         updateParticleQuads();
         _transformSystemDirty = false;
     }
+}
+
+void ParticleSystem::finishStep()
+{
+    if (_stepStopSystem)
+    {
+        this->stopSystem();
+    }
+    if (_stepAutoRemove)
+    {
+        this->unscheduleUpdate();
+        _parent->removeChild(this, true);
+        return;
+    }
 
     // only update gl buffer when visible
     if (_visible && ! _batchNode)
     {
         postStep();
     }
-
-    CC_PROFILER_STOP_CATEGORY(kProfilerCategoryParticles , "CCParticleSystem - update");
 }
 
 void ParticleSystem::updateWithNoTime(void)
 {
-    this->update(0.0f);
+    // runs right away, even when the scheduled updates go through ParticleManager
+    prepareStep();
+    simulateStep(0.0f);
+    finishStep();
 }
 
 void ParticleSystem::updateParticleQuads()
@@ -28,6 +28,8 @@ THE SOFTWARE.
 #ifndef __CCPARTICLE_SYSTEM_H__
 #define __CCPARTICLE_SYSTEM_H__
 
+#include <random>
+
 #include "base/CCProtocols.h"
 #include "2d/CCNode.h"
 #include "base/CCValue.h"
@@ -40,6 +42,7 @@ NS_CC_BEGIN
  */
 
 class ParticleBatchNode;
+class ParticleManager;
 
 /** @struct sParticle
 Structure that contains the values of each particle.
@@ -261,7 +264,7 @@ public:
     void stopSystem();
     /** Kill all living particles.
      */
-    void resetSystem();
+    virtual void resetSystem();
     /** Whether or not the system is full.
      *
      * @return True if the system is full.
@@ -270,6 +273,9 @@ public:
 
     /** Update the verts position data of particle,
      should be overridden by subclasses. 
+     It is called from the update of the emitter, which may run on a worker thread of ParticleManager,
+     so it must only touch the emitter's own data. Use the world position and transform captured
+     by the update, they are not kept up to date outside of it.
      */
     virtual void updateParticleQuads();
     /** Update the VBO verts buffer which does not use batch node,
@@ -280,6 +286,12 @@ public:
      */
     virtual void updateWithNoTime();
 
+    /** Sets the seed of the random numbers used to emit particles, an emitter given the same seed and
+     the same time steps emits the same particles.
+     The default seed is taken from rand() when the emitter is created.
+     */
+    void setRandomSeed(unsigned int seed) { _random.seed(seed); }
+
     /** Whether or not the particle system removed self on finish.
      *
      * @return True if the particle system removed self on finish.
@@ -823,9 +835,20 @@ CC_CONSTRUCTOR_ACCESS:
 
 protected:
     virtual void updateBlendFunc();
-    
+
+    /** Captures the world position and transform used by the update, on the cocos thread. */
+    void prepareStep();
+    /** Emits, moves and kills the particles and updates the quads. It only touches the data of this
+     emitter, so ParticleManager runs the steps of several emitters at the same time. */
+    void simulateStep(float dt);
+    /** Stops or removes the emitter when the step asked for it and uploads the quads, on the cocos thread. */
+    void finishStep();
+    /** Emits count particles at the world position captured by prepareStep(). */
+    void emitParticles(int count);
+
 private:
     friend class EngineDataManager;
+    friend class ParticleManager;
     /** Internal use only, it's used by EngineDataManager class for Android platform */
     static void setTotalParticleCountFactor(float factor);
     
@@ -992,6 +1015,19 @@ protected:
     /** is sourcePosition compatible */
     bool _sourcePositionCompatible;
 
+    /** seeds the random numbers of each emission */
+    std::minstd_rand _random;
+
+    /** world position of the emitter and inverse of its world transform, captured by prepareStep() */
+    Vec2 _stepWorldPosition;
+    Mat4 _stepWorldToNodeTransform;
+    /** time step of the update queued in ParticleManager */
+    float _stepDelta;
+    bool _stepQueued;
+    /** set by simulateStep(), handled by finishStep() */
+    bool _stepStopSystem;
+    bool _stepAutoRemove;
+
     static Vector<ParticleSystem*> __allInstances;
     
 private:
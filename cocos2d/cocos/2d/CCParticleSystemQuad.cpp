@@ -37,6 +37,7 @@ THE SOFTWARE.
 #include "renderer/CCTextureAtlas.h"
 #include "renderer/ccGLStateCache.h"
 #include "renderer/CCRenderer.h"
+#include "renderer/CCGLProgramCache.h"
 #include "base/CCDirector.h"
 #include "base/CCEventType.h"
 #include "base/CCConfiguration.h"
@@ -46,12 +47,31 @@ THE SOFTWARE.
 
 NS_CC_BEGIN
 
+namespace {
+    // attributes of ccShader_ParticleGPU.vert, in the order of the members of GPUVertex
+    const char* GPU_ATTRIBUTE_NAMES[] = { "a_spawn", "a_motion", "a_color", "a_deltaColor", "a_shape", "a_corner" };
+    const int GPU_ATTRIBUTE_COUNT = 6;
+    // GL::enableVertexAttribs() handles this many attributes
+    const int GPU_MAX_ATTRIBUTE_LOCATION = 16;
+    // the emission times are moved back by this much once the clock reaches it, so they keep their precision
+    const float GPU_TIME_REBASE = 1024.0f;
+}
+
 ParticleSystemQuad::ParticleSystemQuad()
 :_quads(nullptr)
 ,_indices(nullptr)
 ,_VAOname(0)
+,_gpuVBO(0)
+,_gpuSlotCount(0)
+,_gpuTime(0)
+,_gpuDirtyBegin(0)
+,_gpuDirtyEnd(0)
+,_gpuSimulationEnabled(false)
+,_gpuSimulationSupported(false)
+,_gpuSimulationActive(false)
 {
     memset(_buffersVBO, 0, sizeof(_buffersVBO));
+    memset(_gpuAttributes, 0, sizeof(_gpuAttributes));
 }
 
 ParticleSystemQuad::~ParticleSystemQuad()
@@ -60,13 +80,21 @@ ParticleSystemQuad::~ParticleSystemQuad()
     {
         CC_SAFE_FREE(_quads);
         CC_SAFE_FREE(_indices);
-        glDeleteBuffers(2, &_buffersVBO[0]);
-        if (Configuration::getInstance()->supportsShareableVAO())
+        // nothing to delete if the buffers were never created
+        if (_buffersVBO[0])
+        {
+            glDeleteBuffers(2, &_buffersVBO[0]);
+        }
+        if (_VAOname && Configuration::getInstance()->supportsShareableVAO())
         {
             glDeleteVertexArrays(1, &_VAOname);
             GL::bindVAO(0);
         }
     }
+    if (_gpuVBO)
+    {
+        glDeleteBuffers(1, &_gpuVBO);
+    }
 }
 
 // implementation ParticleSystemQuad
@@ -309,7 +337,7 @@ void ParticleSystemQuad::updateParticleQuads()
     Vec2 currentPosition;
     if (_positionType == PositionType::FREE)
     {
-        currentPosition = this->convertToWorldSpace(Vec2::ZERO);
+        currentPosition = _stepWorldPosition;
     }
     else if (_positionType == PositionType::RELATIVE)
     {
@@ -332,7 +360,7 @@ void ParticleSystemQuad::updateParticleQuads()
     if( _positionType == PositionType::FREE )
     {
         Vec3 p1(currentPosition.x, currentPosition.y, 0);
-        Mat4 worldToNodeTM = getWorldToNodeTransform();
+        const Mat4& worldToNodeTM = _stepWorldToNodeTransform;
         worldToNodeTM.transformPoint(&p1);
         Vec3 p2;
         Vec2 newPos;
@@ -457,14 +485,351 @@ void ParticleSystemQuad::postStep()
 // overriding draw method
 void ParticleSystemQuad::draw(Renderer *renderer, const Mat4 &transform, uint32_t flags)
 {
+    if (_particleCount > 0 && _gpuSimulationActive)
+    {
+        _gpuCommand.init(_globalZOrder, transform, flags);
+        _gpuCommand.func = CC_CALLBACK_0(ParticleSystemQuad::onDrawGPU, this, transform, flags);
+        renderer->addCommand(&_gpuCommand);
+    }
     //quad command
-    if(_particleCount > 0)
+    else if(_particleCount > 0)
     {
         _quadCommand.init(_globalZOrder, _texture, getGLProgramState(), _blendFunc, _quads, _particleCount, transform, flags);
         renderer->addCommand(&_quadCommand);
     }
 }
 
+void ParticleSystemQuad::update(float dt)
+{
+    bool gpu = _gpuSimulationEnabled && canSimulateOnGPU();
+    if (gpu != _gpuSimulationActive)
+    {
+        setGPUSimulationActive(gpu);
+    }
+
+    if (_gpuSimulationActive)
+    {
+        updateGPUSimulation(dt);
+    }
+    else
+    {
+        ParticleSystem::update(dt);
+    }
+}
+
+void ParticleSystemQuad::updateWithNoTime()
+{
+    if (_gpuSimulationActive)
+    {
+        updateGPUSimulation(0.0f);
+    }
+    else
+    {
+        ParticleSystem::updateWithNoTime();
+    }
+}
+
+void ParticleSystemQuad::resetSystem()
+{
+    ParticleSystem::resetSystem();
+
+    // the living particles die on the next update, like on the CPU
+    if (_gpuSimulationActive && _particleCount > 0)
+    {
+        for (int slot = 0; slot < _gpuSlotCount; ++slot)
+        {
+            if (_gpuDeathTimes[slot] > _gpuTime)
+            {
+                _gpuDeathTimes[slot] = _gpuTime;
+                for (int k = 0; k < 4; ++k)
+                {
+                    _gpuVertices[slot * 4 + k].spawn.w = _gpuTime - _gpuVertices[slot * 4 + k].spawn.z;
+                }
+                markGPUSlotDirty(slot);
+            }
+        }
+    }
+}
+
+void ParticleSystemQuad::setGPUSimulationEnabled(bool enabled)
+{
+    _gpuSimulationEnabled = enabled;
+    if (enabled)
+    {
+        _gpuSimulationSupported = isGPUSimulationSupported();
+        if (!_gpuSimulationSupported)
+        {
+            CCLOG("cocos2d: ParticleSystemQuad: the GPU simulation is not supported, the particles are simulated on the CPU");
+        }
+    }
+}
+
+bool ParticleSystemQuad::isGPUSimulationSupported()
+{
+    auto glProgram = GLProgramCache::getInstance()->getGLProgram(GLProgram::SHADER_PARTICLE_GPU);
+    if (glProgram == nullptr || glProgram->getProgram() == 0)
+    {
+        return false;
+    }
+    for (auto name : GPU_ATTRIBUTE_NAMES)
+    {
+        GLint location = glProgram->getAttribLocation(name);
+        if (location < 0 || location >= GPU_MAX_ATTRIBUTE_LOCATION)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool ParticleSystemQuad::canSimulateOnGPU() const
+{
+    // the radial and tangential accelerations depend on the position, which the shader doesn't keep
+    return _gpuSimulationSupported && !_batchNode && _emitterMode == Mode::GRAVITY
+        && modeA.radialAccel == 0 && modeA.radialAccelVar == 0
+        && modeA.tangentialAccel == 0 && modeA.tangentialAccelVar == 0;
+}
+
+void ParticleSystemQuad::setGPUSimulationActive(bool active)
+{
+    _gpuSimulationActive = active;
+    _particleCount = 0;
+    _gpuSlotCount = 0;
+    _gpuTime = 0;
+    _gpuFreeSlots.clear();
+    if (active)
+    {
+        _gpuVertices.assign(_totalParticles * 4, GPUVertex());
+        _gpuDeathTimes.assign(_totalParticles, 0.0f);
+        _gpuDirtyBegin = 0;
+        _gpuDirtyEnd = _totalParticles;
+    }
+    else
+    {
+        std::vector<GPUVertex>().swap(_gpuVertices);
+        std::vector<float>().swap(_gpuDeathTimes);
+        _gpuDirtyBegin = _gpuDirtyEnd = 0;
+    }
+}
+
+void ParticleSystemQuad::updateGPUSimulation(float dt)
+{
+    if (_gpuTime > GPU_TIME_REBASE)
+    {
+        for (auto& vertex : _gpuVertices)
+        {
+            vertex.spawn.z -= GPU_TIME_REBASE;
+        }
+        for (auto& deathTime : _gpuDeathTimes)
+        {
+            deathTime -= GPU_TIME_REBASE;
+        }
+        _gpuTime -= GPU_TIME_REBASE;
+        _gpuDirtyBegin = 0;
+        _gpuDirtyEnd = _gpuSlotCount;
+    }
+
+    // particles emitted in this update have lived dt when they are drawn, like on the CPU
+    float time = _gpuTime;
+    _gpuTime += dt;
+
+    // the slots of the dead particles are reused by the next ones, the shader hides them until then
+    int living = 0;
+    _gpuFreeSlots.clear();
+    for (int slot = _gpuSlotCount - 1; slot >= 0; --slot)
+    {
+        if (_gpuDeathTimes[slot] > _gpuTime)
+            ++living;
+        else
+            _gpuFreeSlots.push_back(slot);
+    }
+    bool died = living < _particleCount;
+    _particleCount = living;
+
+    if (_isActive && _emissionRate)
+    {
+        float rate = 1.0f / _emissionRate;
+        int totalParticles = static_cast<int>(_totalParticles * __totalParticleCountFactor);
+
+        //issue #1201, prevent bursts of particles, due to too high emitCounter
+        if (_particleCount < totalParticles)
+        {
+            _emitCounter += dt;
+            if (_emitCounter < 0.f)
+                _emitCounter = 0.f;
+        }
+
+        int emitCount = MIN(totalParticles - _particleCount, _emitCounter / rate);
+        emitGPUParticles(emitCount, time);
+        _emitCounter -= rate * emitCount;
+
+        _elapsed += dt;
+        if (_elapsed < 0.f)
+            _elapsed = 0.f;
+        if (_duration != DURATION_INFINITY && _duration < _elapsed)
+        {
+            this->stopSystem();
+        }
+    }
+
+    if (died && _particleCount == 0 && _isAutoRemoveOnFinish)
+    {
+        this->unscheduleUpdate();
+        _parent->removeChild(this, true);
+    }
+}
+
+void ParticleSystemQuad::emitGPUParticles(int count, float time)
+{
+    if (count <= 0 || _paused)
+    {
+        return;
+    }
+
+    // emitParticles() writes the new particles after the living ones, here the particle data only stages them
+    if (_positionType == PositionType::FREE)
+    {
+        _stepWorldPosition = this->convertToWorldSpace(Vec2::ZERO);
+    }
+    int living = _particleCount;
+    _particleCount = 0;
+    emitParticles(count);
+    _particleCount = living + count;
+
+    static const float cornerX[] = { -0.5f, -0.5f, 0.5f, 0.5f };
+    static const float cornerY[] = { 0.5f, -0.5f, 0.5f, -0.5f };
+    for (int i = 0; i < count; ++i)
+    {
+        // the lowest free slots first, so that the drawn slots stay few
+        int slot;
+        if (_gpuFreeSlots.empty())
+        {
+            slot = _gpuSlotCount++;
+        }
+        else
+        {
+            slot = _gpuFreeSlots.back();
+            _gpuFreeSlots.pop_back();
+        }
+
+        GPUVertex vertex;
+        vertex.spawn.set(_particleData.startPosX[i], _particleData.startPosY[i], time, _particleData.timeToLive[i]);
+        vertex.motion.set(_particleData.posx[i], _particleData.posy[i], _particleData.modeA.dirX[i], _particleData.modeA.dirY[i]);
+        vertex.color = Color4F(_particleData.colorR[i], _particleData.colorG[i], _particleData.colorB[i], _particleData.colorA[i]);
+        vertex.deltaColor = Color4F(_particleData.deltaColorR[i], _particleData.deltaColorG[i], _particleData.deltaColorB[i], _particleData.deltaColorA[i]);
+        vertex.shape.set(_particleData.size[i], _particleData.deltaSize[i], _particleData.rotation[i], _particleData.deltaRotation[i]);
+
+        // the corners in the order of V3F_C4B_T2F_Quad, with the texture coordinates set by initTexCoordsWithRect()
+        const V3F_C4B_T2F* corners = &_quads[slot].tl;
+        for (int k = 0; k < 4; ++k)
+        {
+            vertex.corner.set(cornerX[k], cornerY[k], corners[k].texCoords.u, corners[k].texCoords.v);
+            _gpuVertices[slot * 4 + k] = vertex;
+        }
+        _gpuDeathTimes[slot] = time + _particleData.timeToLive[i];
+        markGPUSlotDirty(slot);
+    }
+}
+
+void ParticleSystemQuad::markGPUSlotDirty(int slot)
+{
+    if (_gpuDirtyBegin == _gpuDirtyEnd)
+    {
+        _gpuDirtyBegin = slot;
+        _gpuDirtyEnd = slot + 1;
+    }
+    else
+    {
+        _gpuDirtyBegin = std::min(_gpuDirtyBegin, slot);
+        _gpuDirtyEnd = std::max(_gpuDirtyEnd, slot + 1);
+    }
+}
+
+void ParticleSystemQuad::setupGPUBuffer()
+{
+    auto glProgram = GLProgramCache::getInstance()->getGLProgram(GLProgram::SHADER_PARTICLE_GPU);
+    for (int i = 0; i < GPU_ATTRIBUTE_COUNT; ++i)
+    {
+        _gpuAttributes[i] = glProgram->getAttribLocation(GPU_ATTRIBUTE_NAMES[i]);
+    }
+
+    glGenBuffers(1, &_gpuVBO);
+    glBindBuffer(GL_ARRAY_BUFFER, _gpuVBO);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(_gpuVertices[0]) * _gpuVertices.size(), _gpuVertices.data(), GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    _gpuDirtyBegin = _gpuDirtyEnd = 0;
+
+    CHECK_GL_ERROR_DEBUG();
+}
+
+void ParticleSystemQuad::onDrawGPU(const Mat4& transform, uint32_t /*flags*/)
+{
+    if (_gpuVBO == 0)
+    {
+        setupGPUBuffer();
+    }
+
+    // like updateParticleQuads(), the particles move by the distance between the origin they were emitted at
+    // and the current origin, grouped particles ignore both
+    Mat4 originTransform = Mat4::ZERO;
+    Vec2 origin;
+    if (_positionType == PositionType::FREE)
+    {
+        originTransform = getWorldToNodeTransform();
+    }
+    else if (_positionType == PositionType::RELATIVE)
+    {
+        originTransform = Mat4::IDENTITY;
+        origin = _position;
+    }
+
+    auto glProgram = GLProgramCache::getInstance()->getGLProgram(GLProgram::SHADER_PARTICLE_GPU);
+    glProgram->use();
+    glProgram->setUniformsForBuiltins(transform);
+    glProgram->setUniformLocationWith1f(glProgram->getUniformLocation("u_time"), _gpuTime);
+    glProgram->setUniformLocationWith2f(glProgram->getUniformLocation("u_gravity"), modeA.gravity.x, modeA.gravity.y);
+    glProgram->setUniformLocationWith1f(glProgram->getUniformLocation("u_yCoordFlipped"), static_cast<float>(_yCoordFlipped));
+    glProgram->setUniformLocationWithMatrix4fv(glProgram->getUniformLocation("u_originTransform"), originTransform.m, 1);
+    glProgram->setUniformLocationWith2f(glProgram->getUniformLocation("u_origin"), origin.x, origin.y);
+    glProgram->setUniformLocationWith1f(glProgram->getUniformLocation("u_opacityModifyRGB"), _opacityModifyRGB ? 1.0f : 0.0f);
+
+    if (_texture)
+    {
+        GL::bindTexture2D(_texture);
+    }
+    GL::blendFunc(_blendFunc.src, _blendFunc.dst);
+
+    glBindBuffer(GL_ARRAY_BUFFER, _gpuVBO);
+    // upload the particles emitted since the last draw
+    if (_gpuDirtyBegin < _gpuDirtyEnd)
+    {
+        glBufferSubData(GL_ARRAY_BUFFER, sizeof(GPUVertex) * 4 * _gpuDirtyBegin, sizeof(GPUVertex) * 4 * (_gpuDirtyEnd - _gpuDirtyBegin),
+                        &_gpuVertices[_gpuDirtyBegin * 4]);
+        _gpuDirtyBegin = _gpuDirtyEnd = 0;
+    }
+
+    uint32_t attributeFlags = 0;
+    for (int i = 0; i < GPU_ATTRIBUTE_COUNT; ++i)
+    {
+        attributeFlags |= 1 << _gpuAttributes[i];
+    }
+    GL::enableVertexAttribs(attributeFlags);
+    glVertexAttribPointer(_gpuAttributes[0], 4, GL_FLOAT, GL_FALSE, sizeof(GPUVertex), (GLvoid*) offsetof(GPUVertex, spawn));
+    glVertexAttribPointer(_gpuAttributes[1], 4, GL_FLOAT, GL_FALSE, sizeof(GPUVertex), (GLvoid*) offsetof(GPUVertex, motion));
+    glVertexAttribPointer(_gpuAttributes[2], 4, GL_FLOAT, GL_FALSE, sizeof(GPUVertex), (GLvoid*) offsetof(GPUVertex, color));
+    glVertexAttribPointer(_gpuAttributes[3], 4, GL_FLOAT, GL_FALSE, sizeof(GPUVertex), (GLvoid*) offsetof(GPUVertex, deltaColor));
+    glVertexAttribPointer(_gpuAttributes[4], 4, GL_FLOAT, GL_FALSE, sizeof(GPUVertex), (GLvoid*) offsetof(GPUVertex, shape));
+    glVertexAttribPointer(_gpuAttributes[5], 4, GL_FLOAT, GL_FALSE, sizeof(GPUVertex), (GLvoid*) offsetof(GPUVertex, corner));
+
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _buffersVBO[1]);
+    glDrawElements(GL_TRIANGLES, (GLsizei) _gpuSlotCount * 6, GL_UNSIGNED_SHORT, (GLvoid*) 0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    CC_INCREMENT_GL_DRAWN_BATCHES_AND_VERTICES(1, _gpuSlotCount * 6);
+    CHECK_GL_ERROR_DEBUG();
+}
+
 void ParticleSystemQuad::setTotalParticles(int tp)
 {
     // If we are setting the total number of particles to a number higher
@@ -541,6 +906,17 @@ void ParticleSystemQuad::setTotalParticles(int tp)
     setEmissionRate(_totalParticles / _life);
     
     resetSystem();
+
+    // the GPU buffer is created again with the new size by the next draw
+    if (_gpuVBO)
+    {
+        glDeleteBuffers(1, &_gpuVBO);
+        _gpuVBO = 0;
+    }
+    if (_gpuSimulationActive)
+    {
+        setGPUSimulationActive(true);
+    }
 }
 
 void ParticleSystemQuad::setupVBOandVAO()
@@ -605,6 +981,8 @@ void ParticleSystemQuad::listenRendererRecreated(EventCustom* /*event*/)
     //when comes to foreground in android, _buffersVBO and _VAOname is a wild handle
     //before recreating, we need to reset them to 0
     memset(_buffersVBO, 0, sizeof(_buffersVBO));
+    // the GPU buffer is created again from _gpuVertices by the next draw
+    _gpuVBO = 0;
     if (Configuration::getInstance()->supportsShareableVAO())
     {
         _VAOname = 0;
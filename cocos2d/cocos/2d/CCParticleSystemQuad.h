@@ -31,6 +31,7 @@ THE SOFTWARE.
 
 #include "2d/CCParticleSystem.h"
 #include "renderer/CCQuadCommand.h"
+#include "renderer/CCCustomCommand.h"
 
 NS_CC_BEGIN
 
@@ -142,6 +143,43 @@ public:
      * @lua NA
      */
     virtual void setTotalParticles(int tp) override;
+    /**
+     * @js NA
+     * @lua NA
+     */
+    virtual void update(float dt) override;
+    /**
+     * @js NA
+     * @lua NA
+     */
+    virtual void resetSystem() override;
+    /**
+     * @js NA
+     * @lua NA
+     */
+    virtual void updateWithNoTime() override;
+
+    /** Simulates the particles in the vertex shader instead of on the CPU.
+     
+     Each particle is uploaded once, when it is emitted, with its position, velocity, color, size and
+     rotation and their rates of change, and the vertex shader computes its state at the current time.
+     The CPU only emits particles into the slots of dead ones, so large ambient effects cost
+     next to nothing per frame. The motion is integrated exactly rather than frame by frame, so the
+     particles don't follow the same paths as on the CPU.
+
+     Only ballistic emitters can be simulated this way: gravity mode without radial or tangential
+     acceleration, not rendered by a ParticleBatchNode. Other emitters, and all of them when
+     isGPUSimulationSupported() is false, keep being simulated on the CPU. Switching between both
+     kills the living particles.
+     */
+    void setGPUSimulationEnabled(bool enabled);
+    bool isGPUSimulationEnabled() const { return _gpuSimulationEnabled; }
+
+    /** Returns true if the particles are simulated by the vertex shader at the moment. */
+    bool isGPUSimulationActive() const { return _gpuSimulationActive; }
+
+    /** Returns true if the shader of the GPU simulation compiled and its attributes fit the GL state cache. */
+    static bool isGPUSimulationSupported();
 
     virtual std::string getDescription() const override;
     
@@ -185,6 +223,41 @@ protected:
     GLuint              _buffersVBO[2]; //0: vertex  1: indices
 
     QuadCommand _quadCommand;           // quad command
+
+    /** A vertex of a particle simulated by the vertex shader, the state of the particle when it was emitted. */
+    struct GPUVertex
+    {
+        Vec4 spawn;         // origin of the emitter, emission time, life
+        Vec4 motion;        // position, velocity
+        Color4F color;
+        Color4F deltaColor;
+        Vec4 shape;         // size, delta size, rotation, delta rotation
+        Vec4 corner;        // corner of the quad, texture coordinates
+    };
+
+    bool canSimulateOnGPU() const;
+    void setGPUSimulationActive(bool active);
+    void updateGPUSimulation(float dt);
+    void emitGPUParticles(int count, float time);
+    void markGPUSlotDirty(int slot);
+    void setupGPUBuffer();
+    void onDrawGPU(const Mat4& transform, uint32_t flags);
+
+    std::vector<GPUVertex> _gpuVertices;    // 4 per particle slot, in the order of the quads
+    GLuint _gpuVBO;
+    GLint _gpuAttributes[6];
+    CustomCommand _gpuCommand;
+    std::vector<float> _gpuDeathTimes;      // 1 per slot
+    std::vector<int> _gpuFreeSlots;         // slots of dead particles below _gpuSlotCount
+    // slots ever used, the ones drawn
+    int _gpuSlotCount;
+    float _gpuTime;
+    // slots to upload before the next draw
+    int _gpuDirtyBegin;
+    int _gpuDirtyEnd;
+    bool _gpuSimulationEnabled;
+    bool _gpuSimulationSupported;
+    bool _gpuSimulationActive;
     
 
 
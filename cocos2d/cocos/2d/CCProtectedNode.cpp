@@ -474,4 +474,14 @@ void ProtectedNode::setGlobalZOrder(float globalZOrder)
         child->setGlobalZOrder(globalZOrder);
 }
 
+void ProtectedNode::markWorldTransformDirty()
+{
+    if (_worldTransformDirty)
+        return;
+
+    Node::markWorldTransformDirty();
+    for (auto& child : _protectedChildren)
+        child->markWorldTransformDirty();
+}
+
 NS_CC_END
@@ -189,6 +189,8 @@ CC_CONSTRUCTOR_ACCESS:
     
 protected:
     
+    virtual void markWorldTransformDirty() override;
+
     /// helper that reorder a child
     void insertProtectedChild(Node* child, int z);
     
@@ -43,6 +43,8 @@ THE SOFTWARE.
 
 NS_CC_BEGIN
 
+CC_DEFINE_ALLOCATOR_POOL(Sprite, 100)
+
 // MARK: create, init, dealloc
 Sprite* Sprite::createWithTexture(Texture2D *texture)
 {
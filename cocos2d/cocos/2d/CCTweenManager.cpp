@@ -0,0 +1,494 @@
+/****************************************************************************
+Copyright (c) 2019 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#include "2d/CCTweenManager.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include "2d/CCNode.h"
+#include "base/ccMacros.h"
+
+NS_CC_BEGIN
+
+static const int TWEEN_PROPERTY_COUNT = static_cast<int>(TweenManager::Property::COUNT);
+static const int TWEEN_MAX_COMPONENTS = 3;
+
+// All tweens of one property, one array per field so that update() runs each step over contiguous memory.
+typedef struct _tweenChannel
+{
+    int                 components;
+    std::vector<Node*>  targets;
+    std::vector<float>  elapsed;
+    std::vector<float>  invDuration;
+    // 1 while running, 0 while the target is paused or the tween has been removed during update()
+    std::vector<float>  rate;
+    std::vector<int>    easing;
+    std::vector<int>    tags;
+    std::vector<float>  from[TWEEN_MAX_COMPONENTS];
+    std::vector<float>  delta[TWEEN_MAX_COMPONENTS];
+
+    // scratch buffers of update()
+    std::vector<float>  progress;
+    std::vector<float>  values[TWEEN_MAX_COMPONENTS];
+
+    int size() const { return static_cast<int>(targets.size()); }
+} tTweenChannel;
+
+static void makeTargetSlots(int* slots)
+{
+    std::fill(slots, slots + TWEEN_PROPERTY_COUNT, -1);
+}
+
+TweenManager::TweenManager()
+: _updating(false)
+{
+    static const int components[TWEEN_PROPERTY_COUNT] = { 2, 2, 1, 1, 3 };
+    for (int p = 0; p < TWEEN_PROPERTY_COUNT; ++p)
+    {
+        _channels[p] = new (std::nothrow) tTweenChannel();
+        _channels[p]->components = components[p];
+    }
+}
+
+TweenManager::~TweenManager()
+{
+    CCLOGINFO("deallocing TweenManager: %p", this);
+
+    removeAllTweens();
+    for (int p = 0; p < TWEEN_PROPERTY_COUNT; ++p)
+    {
+        delete _channels[p];
+    }
+}
+
+void TweenManager::addTween(Node* target, Property property, float duration, const float* from, const float* to, tweenfunc::TweenType easing, int tag)
+{
+    CCASSERT(target != nullptr, "target can't be nullptr!");
+    CCASSERT(easing != tweenfunc::CUSTOM_EASING, "custom easing isn't supported by TweenManager");
+
+    const int p = static_cast<int>(property);
+    auto iter = _targets.find(target);
+    if (iter != _targets.end() && iter->second.slots[p] >= 0)
+    {
+        removeTweenAtIndex(property, iter->second.slots[p]);
+        iter = _targets.find(target);
+    }
+    if (iter == _targets.end())
+    {
+        TargetSlots slots;
+        makeTargetSlots(slots.slots);
+        iter = _targets.emplace(target, slots).first;
+    }
+
+    tTweenChannel& channel = *_channels[p];
+    iter->second.slots[p] = channel.size();
+
+    target->retain();
+    channel.targets.push_back(target);
+    channel.elapsed.push_back(0.0f);
+    // same clamp as ActionInterval::initWithDuration
+    channel.invDuration.push_back(1.0f / std::max(duration, FLT_EPSILON));
+    channel.rate.push_back(target->isRunning() ? 1.0f : 0.0f);
+    channel.easing.push_back(easing);
+    channel.tags.push_back(tag);
+    for (int c = 0; c < channel.components; ++c)
+    {
+        channel.from[c].push_back(from[c]);
+        channel.delta[c].push_back(to[c] - from[c]);
+    }
+}
+
+void TweenManager::removeTweenAtIndex(Property property, int index)
+{
+    const int p = static_cast<int>(property);
+    tTweenChannel& channel = *_channels[p];
+
+    auto iter = _targets.find(channel.targets[index]);
+    if (iter != _targets.end() && iter->second.slots[p] == index)
+    {
+        iter->second.slots[p] = -1;
+        const int* slots = iter->second.slots;
+        if (std::all_of(slots, slots + TWEEN_PROPERTY_COUNT, [](int slot) { return slot < 0; }))
+        {
+            _targets.erase(iter);
+        }
+    }
+
+    if (_updating)
+    {
+        // update() is walking the arrays, stop the tween and let update() drop it
+        channel.rate[index] = 0.0f;
+        channel.elapsed[index] = std::numeric_limits<float>::infinity();
+        return;
+    }
+    eraseTweenAtIndex(property, index);
+}
+
+void TweenManager::eraseTweenAtIndex(Property property, int index)
+{
+    const int p = static_cast<int>(property);
+    tTweenChannel& channel = *_channels[p];
+    const int last = channel.size() - 1;
+    Node* target = channel.targets[index];
+
+    if (index != last)
+    {
+        auto iter = _targets.find(channel.targets[last]);
+        if (iter != _targets.end() && iter->second.slots[p] == last)
+        {
+            iter->second.slots[p] = index;
+        }
+
+        channel.targets[index] = channel.targets[last];
+        channel.elapsed[index] = channel.elapsed[last];
+        channel.invDuration[index] = channel.invDuration[last];
+        channel.rate[index] = channel.rate[last];
+        channel.easing[index] = channel.easing[last];
+        channel.tags[index] = channel.tags[last];
+        for (int c = 0; c < channel.components; ++c)
+        {
+            channel.from[c][index] = channel.from[c][last];
+            channel.delta[c][index] = channel.delta[c][last];
+        }
+    }
+
+    channel.targets.pop_back();
+    channel.elapsed.pop_back();
+    channel.invDuration.pop_back();
+    channel.rate.pop_back();
+    channel.easing.pop_back();
+    channel.tags.pop_back();
+    for (int c = 0; c < channel.components; ++c)
+    {
+        channel.from[c].pop_back();
+        channel.delta[c].pop_back();
+    }
+
+    target->release();
+}
+
+void TweenManager::moveTo(Node* target, float duration, const Vec2& position, tweenfunc::TweenType easing, int tag)
+{
+    const Vec2& current = target->getPosition();
+    const float from[] = { current.x, current.y };
+    const float to[] = { position.x, position.y };
+    addTween(target, Property::POSITION, duration, from, to, easing, tag);
+}
+
+void TweenManager::moveBy(Node* target, float duration, const Vec2& delta, tweenfunc::TweenType easing, int tag)
+{
+    moveTo(target, duration, target->getPosition() + delta, easing, tag);
+}
+
+void TweenManager::scaleTo(Node* target, float duration, float scaleX, float scaleY, tweenfunc::TweenType easing, int tag)
+{
+    const float from[] = { target->getScaleX(), target->getScaleY() };
+    const float to[] = { scaleX, scaleY };
+    addTween(target, Property::SCALE, duration, from, to, easing, tag);
+}
+
+void TweenManager::rotateTo(Node* target, float duration, float angle, tweenfunc::TweenType easing, int tag)
+{
+    // shortest way, see RotateTo::calculateAngles
+    float startAngle = target->getRotation();
+    startAngle = startAngle > 0 ? fmodf(startAngle, 360.0f) : fmodf(startAngle, -360.0f);
+    float diffAngle = angle - startAngle;
+    if (diffAngle > 180)
+    {
+        diffAngle -= 360;
+    }
+    if (diffAngle < -180)
+    {
+        diffAngle += 360;
+    }
+
+    const float from[] = { startAngle };
+    const float to[] = { startAngle + diffAngle };
+    addTween(target, Property::ROTATION, duration, from, to, easing, tag);
+}
+
+void TweenManager::rotateBy(Node* target, float duration, float deltaAngle, tweenfunc::TweenType easing, int tag)
+{
+    const float from[] = { target->getRotation() };
+    const float to[] = { from[0] + deltaAngle };
+    addTween(target, Property::ROTATION, duration, from, to, easing, tag);
+}
+
+void TweenManager::fadeTo(Node* target, float duration, GLubyte opacity, tweenfunc::TweenType easing, int tag)
+{
+    const float from[] = { static_cast<float>(target->getOpacity()) };
+    const float to[] = { static_cast<float>(opacity) };
+    addTween(target, Property::OPACITY, duration, from, to, easing, tag);
+}
+
+void TweenManager::tintTo(Node* target, float duration, const Color3B& color, tweenfunc::TweenType easing, int tag)
+{
+    const Color3B& current = target->getColor();
+    const float from[] = { static_cast<float>(current.r), static_cast<float>(current.g), static_cast<float>(current.b) };
+    const float to[] = { static_cast<float>(color.r), static_cast<float>(color.g), static_cast<float>(color.b) };
+    addTween(target, Property::COLOR, duration, from, to, easing, tag);
+}
+
+void TweenManager::removeTween(Node* target, Property property)
+{
+    auto iter = _targets.find(target);
+    if (iter != _targets.end() && iter->second.slots[static_cast<int>(property)] >= 0)
+    {
+        removeTweenAtIndex(property, iter->second.slots[static_cast<int>(property)]);
+    }
+}
+
+void TweenManager::removeTweensByTag(int tag, Node* target)
+{
+    auto iter = _targets.find(target);
+    if (iter == _targets.end())
+        return;
+
+    // removing the last tween erases the entry, work on a copy
+    const TargetSlots slots = iter->second;
+    for (int p = 0; p < TWEEN_PROPERTY_COUNT; ++p)
+    {
+        if (slots.slots[p] >= 0 && _channels[p]->tags[slots.slots[p]] == tag)
+        {
+            removeTweenAtIndex(static_cast<Property>(p), slots.slots[p]);
+        }
+    }
+}
+
+void TweenManager::removeAllTweensFromTarget(Node* target)
+{
+    auto iter = _targets.find(target);
+    if (iter == _targets.end())
+        return;
+
+    const TargetSlots slots = iter->second;
+    for (int p = 0; p < TWEEN_PROPERTY_COUNT; ++p)
+    {
+        if (slots.slots[p] >= 0)
+        {
+            removeTweenAtIndex(static_cast<Property>(p), slots.slots[p]);
+        }
+    }
+}
+
+void TweenManager::removeAllTweens()
+{
+    _targets.clear();
+    for (int p = 0; p < TWEEN_PROPERTY_COUNT; ++p)
+    {
+        tTweenChannel& channel = *_channels[p];
+        if (_updating)
+        {
+            std::fill(channel.rate.begin(), channel.rate.end(), 0.0f);
+            std::fill(channel.elapsed.begin(), channel.elapsed.end(), std::numeric_limits<float>::infinity());
+            continue;
+        }
+
+        // a release may destroy a node, empty the channel first
+        std::vector<Node*> targets;
+        targets.swap(channel.targets);
+        channel.elapsed.clear();
+        channel.invDuration.clear();
+        channel.rate.clear();
+        channel.easing.clear();
+        channel.tags.clear();
+        for (int c = 0; c < channel.components; ++c)
+        {
+            channel.from[c].clear();
+            channel.delta[c].clear();
+        }
+        for (auto target : targets)
+        {
+            target->release();
+        }
+    }
+}
+
+bool TweenManager::isTweening(Node* target, Property property) const
+{
+    auto iter = _targets.find(target);
+    return iter != _targets.end() && iter->second.slots[static_cast<int>(property)] >= 0;
+}
+
+ssize_t TweenManager::getNumberOfRunningTweensInTarget(Node* target) const
+{
+    auto iter = _targets.find(target);
+    if (iter == _targets.end())
+        return 0;
+
+    const int* slots = iter->second.slots;
+    return std::count_if(slots, slots + TWEEN_PROPERTY_COUNT, [](int slot) { return slot >= 0; });
+}
+
+ssize_t TweenManager::getNumberOfRunningTweens() const
+{
+    ssize_t count = 0;
+    for (const auto& iter : _targets)
+    {
+        const int* slots = iter.second.slots;
+        count += std::count_if(slots, slots + TWEEN_PROPERTY_COUNT, [](int slot) { return slot >= 0; });
+    }
+    return count;
+}
+
+void TweenManager::pauseTarget(Node* target)
+{
+    auto iter = _targets.find(target);
+    if (iter == _targets.end())
+        return;
+
+    for (int p = 0; p < TWEEN_PROPERTY_COUNT; ++p)
+    {
+        if (iter->second.slots[p] >= 0)
+        {
+            _channels[p]->rate[iter->second.slots[p]] = 0.0f;
+        }
+    }
+}
+
+void TweenManager::resumeTarget(Node* target)
+{
+    auto iter = _targets.find(target);
+    if (iter == _targets.end())
+        return;
+
+    for (int p = 0; p < TWEEN_PROPERTY_COUNT; ++p)
+    {
+        if (iter->second.slots[p] >= 0)
+        {
+            _channels[p]->rate[iter->second.slots[p]] = 1.0f;
+        }
+    }
+}
+
+void TweenManager::update(float dt)
+{
+    _updating = true;
+
+    for (int p = 0; p < TWEEN_PROPERTY_COUNT; ++p)
+    {
+        tTweenChannel& channel = *_channels[p];
+        const int count = channel.size();
+        if (count == 0)
+            continue;
+
+        channel.progress.resize(count);
+        float* progress = channel.progress.data();
+
+        // advance time, paused and removed tweens have a rate of 0
+        {
+            float* elapsed = channel.elapsed.data();
+            const float* invDuration = channel.invDuration.data();
+            const float* rate = channel.rate.data();
+            for (int i = 0; i < count; ++i)
+            {
+                elapsed[i] += dt * rate[i];
+                progress[i] = std::min(elapsed[i] * invDuration[i], 1.0f);
+            }
+        }
+
+        // easing, linear is the common case and needs nothing
+        {
+            const int* easing = channel.easing.data();
+            for (int i = 0; i < count; ++i)
+            {
+                if (easing[i] != tweenfunc::Linear)
+                {
+                    progress[i] = tweenfunc::tweenTo(progress[i], static_cast<tweenfunc::TweenType>(easing[i]), nullptr);
+                }
+            }
+        }
+
+        // interpolate every component
+        for (int c = 0; c < channel.components; ++c)
+        {
+            channel.values[c].resize(count);
+            float* values = channel.values[c].data();
+            const float* from = channel.from[c].data();
+            const float* delta = channel.delta[c].data();
+            for (int i = 0; i < count; ++i)
+            {
+                values[i] = from[i] + delta[i] * progress[i];
+            }
+        }
+
+        // apply, the setters are virtual and may add or remove tweens so nothing is cached across calls
+        const float* x = channel.values[0].data();
+        const float* y = channel.components > 1 ? channel.values[1].data() : nullptr;
+        const float* z = channel.components > 2 ? channel.values[2].data() : nullptr;
+        for (int i = 0; i < count; ++i)
+        {
+            if (channel.rate[i] == 0.0f)
+                continue;
+
+            Node* target = channel.targets[i];
+            switch (static_cast<Property>(p))
+            {
+                case Property::POSITION:
+                    target->setPosition(x[i], y[i]);
+                    break;
+                case Property::SCALE:
+                    target->setScale(x[i], y[i]);
+                    break;
+                case Property::ROTATION:
+                    target->setRotation(x[i]);
+                    break;
+                case Property::OPACITY:
+                    target->setOpacity(static_cast<GLubyte>(x[i]));
+                    break;
+                case Property::COLOR:
+                    target->setColor(Color3B(static_cast<GLubyte>(x[i]), static_cast<GLubyte>(y[i]), static_cast<GLubyte>(z[i])));
+                    break;
+                default:
+                    break;
+            }
+        }
+    }
+
+    // drop finished and removed tweens once every setter has run
+    for (int p = 0; p < TWEEN_PROPERTY_COUNT; ++p)
+    {
+        tTweenChannel& channel = *_channels[p];
+        for (int i = 0; i < channel.size(); )
+        {
+            if (channel.elapsed[i] * channel.invDuration[i] >= 1.0f)
+            {
+                removeTweenAtIndex(static_cast<Property>(p), i);
+                eraseTweenAtIndex(static_cast<Property>(p), i);
+            }
+            else
+            {
+                ++i;
+            }
+        }
+    }
+
+    _updating = false;
+}
+
+NS_CC_END
@@ -0,0 +1,157 @@
+/****************************************************************************
+Copyright (c) 2019 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#ifndef __CCTWEENMANAGER_H__
+#define __CCTWEENMANAGER_H__
+
+#include <unordered_map>
+
+#include "2d/CCTweenFunction.h"
+#include "base/CCRef.h"
+#include "base/ccTypes.h"
+#include "math/Vec2.h"
+
+NS_CC_BEGIN
+
+class Node;
+struct _tweenChannel;
+
+/**
+ * @addtogroup actions
+ * @{
+ */
+
+/** @class TweenManager
+ @brief TweenManager runs simple property tweens without allocating an Action per tween.
+
+ It covers the most common interval actions (MoveTo, MoveBy, ScaleTo, RotateTo, RotateBy, FadeTo and TintTo)
+ with an easing from tweenfunc. The tweens of each property are stored in contiguous arrays which are
+ updated in tight loops, so thousands of concurrent UI tweens cost little more than the setter calls.
+
+ A node has at most one tween per property, starting a new one replaces the running one.
+ Tweens coexist with actions run through ActionManager, if both animate the same property the
+ one updated last wins, TweenManager is updated after ActionManager.
+
+ Like actions, tweens retain their target, are paused together with it and are removed by Node::cleanup().
+ Use Director::getTweenManager() to get the instance.
+ */
+class CC_DLL TweenManager : public Ref
+{
+public:
+    /** The node properties that can be tweened. */
+    enum class Property
+    {
+        POSITION,
+        SCALE,
+        ROTATION,
+        OPACITY,
+        COLOR,
+        COUNT
+    };
+
+    /**
+     * @js ctor
+     */
+    TweenManager();
+
+    /**
+     * @js NA
+     * @lua NA
+     */
+    virtual ~TweenManager();
+
+    /** Moves the target to a position, like MoveTo. */
+    void moveTo(Node* target, float duration, const Vec2& position, tweenfunc::TweenType easing = tweenfunc::Linear, int tag = -1);
+
+    /** Moves the target by an offset from its current position, like MoveBy. */
+    void moveBy(Node* target, float duration, const Vec2& delta, tweenfunc::TweenType easing = tweenfunc::Linear, int tag = -1);
+
+    /** Scales the target to scaleX and scaleY, like ScaleTo. */
+    void scaleTo(Node* target, float duration, float scaleX, float scaleY, tweenfunc::TweenType easing = tweenfunc::Linear, int tag = -1);
+
+    /** Rotates the target to an angle in degrees by the shortest way, like RotateTo. */
+    void rotateTo(Node* target, float duration, float angle, tweenfunc::TweenType easing = tweenfunc::Linear, int tag = -1);
+
+    /** Rotates the target by an angle in degrees, like RotateBy. */
+    void rotateBy(Node* target, float duration, float deltaAngle, tweenfunc::TweenType easing = tweenfunc::Linear, int tag = -1);
+
+    /** Fades the target to an opacity, like FadeTo. */
+    void fadeTo(Node* target, float duration, GLubyte opacity, tweenfunc::TweenType easing = tweenfunc::Linear, int tag = -1);
+
+    /** Tints the target to a color, like TintTo. */
+    void tintTo(Node* target, float duration, const Color3B& color, tweenfunc::TweenType easing = tweenfunc::Linear, int tag = -1);
+
+    /** Removes the tween of a property from a target, the property keeps its current value. */
+    void removeTween(Node* target, Property property);
+
+    /** Removes all tweens with the given tag from a target. */
+    void removeTweensByTag(int tag, Node* target);
+
+    /** Removes all tweens from a target. */
+    void removeAllTweensFromTarget(Node* target);
+
+    /** Removes all tweens from all targets. */
+    void removeAllTweens();
+
+    /** Returns true if the property of the target is being tweened. */
+    bool isTweening(Node* target, Property property) const;
+
+    /** Returns the number of tweens running on a target. */
+    ssize_t getNumberOfRunningTweensInTarget(Node* target) const;
+
+    /** Returns the number of tweens running on all targets. */
+    ssize_t getNumberOfRunningTweens() const;
+
+    /** Pauses the tweens of a target, called by Node::pause(). */
+    void pauseTarget(Node* target);
+
+    /** Resumes the tweens of a target, called by Node::resume(). */
+    void resumeTarget(Node* target);
+
+    /** Main loop of TweenManager.
+     * @param dt    In seconds.
+     */
+    virtual void update(float dt);
+
+protected:
+    struct TargetSlots
+    {
+        int slots[static_cast<int>(Property::COUNT)];
+    };
+
+    void addTween(Node* target, Property property, float duration, const float* from, const float* to, tweenfunc::TweenType easing, int tag);
+    void removeTweenAtIndex(Property property, int index);
+    void eraseTweenAtIndex(Property property, int index);
+
+    struct _tweenChannel* _channels[static_cast<int>(Property::COUNT)];
+    std::unordered_map<Node*, TargetSlots> _targets;
+    bool _updating;
+};
+
+// end of actions group
+/// @}
+
+NS_CC_END
+
+#endif // __CCTWEENMANAGER_H__
@@ -1081,7 +1081,7 @@ bool Bundle3D::loadBinary(const std::string& path)
     
     // get file data
     _binaryBuffer.clear();
-    _binaryBuffer = FileUtils::getInstance()->getDataFromFile(path);
+    _binaryBuffer = FileUtils::getInstance()->getMappedDataFromFile(path, MappedData::Advice::RANDOM);
     if (_binaryBuffer.isNull())
     {
         clear();
@@ -66,6 +66,8 @@ cocos2d.cpp \
 2d/CCParallaxNode.cpp \
 2d/CCParticleBatchNode.cpp \
 2d/CCParticleExamples.cpp \
+2d/CCParticleKernels.cpp \
+2d/CCParticleManager.cpp \
 2d/CCParticleSystem.cpp \
 2d/CCParticleSystemQuad.cpp \
 2d/CCProgressTimer.cpp \
@@ -86,9 +88,11 @@ cocos2d.cpp \
 2d/CCTransitionPageTurn.cpp \
 2d/CCTransitionProgress.cpp \
 2d/CCTweenFunction.cpp \
+2d/CCTweenManager.cpp \
 2d/CCAutoPolygon.cpp \
 3d/CCFrustum.cpp \
 3d/CCPlane.cpp \
+platform/CCAssetPack.cpp \
 platform/CCDataManager.cpp \
 platform/CCFileUtils.cpp \
 platform/CCGLView.cpp \
@@ -133,7 +137,11 @@ base/CCEventListenerMouse.cpp \
 base/CCEventListenerTouch.cpp \
 base/CCEventMouse.cpp \
 base/CCEventTouch.cpp \
+base/CCFrameArena.cpp \
+base/CCFunctionQueue.cpp \
+base/CCHitTestIndex.cpp \
 base/CCIMEDispatcher.cpp \
+base/CCJobSystem.cpp \
 base/CCNS.cpp \
 base/CCProfiling.cpp \
 base/CCProperties.cpp \
@@ -150,15 +158,18 @@ base/ZipUtils.cpp \
 base/allocator/CCAllocatorDiagnostics.cpp \
 base/allocator/CCAllocatorGlobal.cpp \
 base/allocator/CCAllocatorGlobalNewDelete.cpp \
+base/allocator/CCAllocatorStrategyPool.cpp \
 base/atitc.cpp \
 base/base64.cpp \
 base/ccCArray.cpp \
 base/ccFPSImages.c \
+base/ccPixelUtils.cpp \
 base/ccRandom.cpp \
 base/ccTypes.cpp \
 base/ccUTF8.cpp \
 base/ccUtils.cpp \
 base/etc1.cpp \
+base/etc2.cpp \
 base/pvr.cpp \
 base/s3tc.cpp \
 renderer/CCBatchCommand.cpp \
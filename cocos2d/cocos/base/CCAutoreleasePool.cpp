@@ -25,6 +25,9 @@ THE SOFTWARE.
 ****************************************************************************/
 #include "base/CCAutoreleasePool.h"
 #include "base/ccMacros.h"
+#include "base/CCFrameArena.h"
+
+#include <chrono>
 
 NS_CC_BEGIN
 
@@ -59,18 +62,37 @@ AutoreleasePool::~AutoreleasePool()
 void AutoreleasePool::addObject(Ref* object)
 {
     _managedObjectArray.push_back(object);
+#if defined(COCOS2D_DEBUG) && (COCOS2D_DEBUG > 0)
+    _managedObjectSet.insert(object);
+#endif
 }
 
 void AutoreleasePool::clear()
 {
 #if defined(COCOS2D_DEBUG) && (COCOS2D_DEBUG > 0)
     _isClearing = true;
+    _managedObjectSet.clear();
 #endif
-    std::vector<Ref*> releasings;
-    releasings.swap(_managedObjectArray);
-    for (const auto &obj : releasings)
+    // objects autoreleased by the destructors go to _managedObjectArray, so release a copy
+    auto manager = PoolManager::getInstance();
+    if (manager->_frameArena && std::this_thread::get_id() == manager->_threadId)
+    {
+        // the arena gives the copy back when it goes out of scope, and the array keeps its capacity
+        FrameVector<Ref*> releasings(_managedObjectArray.begin(), _managedObjectArray.end(), FrameArenaAllocator<Ref*>(manager->_frameArena));
+        _managedObjectArray.clear();
+        for (const auto &obj : releasings)
+        {
+            obj->release();
+        }
+    }
+    else
     {
-        obj->release();
+        std::vector<Ref*> releasings;
+        releasings.swap(_managedObjectArray);
+        for (const auto &obj : releasings)
+        {
+            obj->release();
+        }
     }
 #if defined(COCOS2D_DEBUG) && (COCOS2D_DEBUG > 0)
     _isClearing = false;
@@ -79,12 +101,16 @@ void AutoreleasePool::clear()
 
 bool AutoreleasePool::contains(Ref* object) const
 {
+#if defined(COCOS2D_DEBUG) && (COCOS2D_DEBUG > 0)
+    return _managedObjectSet.find(object) != _managedObjectSet.end();
+#else
     for (const auto& obj : _managedObjectArray)
     {
         if (obj == object)
             return true;
     }
     return false;
+#endif
 }
 
 void AutoreleasePool::dump()
@@ -124,6 +150,10 @@ void PoolManager::destroyInstance()
 }
 
 PoolManager::PoolManager()
+: _deferredDestructionBudget(0)
+, _threadId(std::this_thread::get_id())
+, _freedObjectCount(0)
+, _frameArena(nullptr)
 {
     _releasePoolStack.reserve(10);
 }
@@ -138,6 +168,8 @@ PoolManager::~PoolManager()
         
         delete pool;
     }
+
+    destroyAllDeferredObjects();
 }
 
 
@@ -156,6 +188,73 @@ bool PoolManager::isObjectInPools(Ref* obj) const
     return false;
 }
 
+void PoolManager::setDeferredDestructionBudget(float budget)
+{
+    _deferredDestructionBudget = budget;
+    if (budget <= 0)
+        destroyAllDeferredObjects();
+}
+
+bool PoolManager::deferDestruction(Ref* object)
+{
+    // don't create a pool manager for objects released after it was destroyed
+    auto manager = s_singleInstance;
+    if (manager == nullptr)
+        return false;
+
+    // the budget belongs to the main thread, so check the thread before reading it
+    if (std::this_thread::get_id() == manager->_threadId && manager->_deferredDestructionBudget > 0)
+    {
+        // an object retained and released again while it waits is already queued
+        if (manager->_deferredObjectSet.insert(object).second)
+            manager->_deferredObjects.push_back(object);
+        return true;
+    }
+
+    manager->_freedObjectCount.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+void PoolManager::destroyFirstDeferredObject()
+{
+    Ref* object = _deferredObjects.front();
+    _deferredObjects.pop_front();
+    _deferredObjectSet.erase(object);
+
+    // retained again while it waited, it is queued once more when it is released
+    if (object->getReferenceCount() != 0)
+        return;
+
+    _freedObjectCount.fetch_add(1, std::memory_order_relaxed);
+    // may queue the objects it releases
+    delete object;
+}
+
+void PoolManager::destroyDeferredObjects()
+{
+    if (_deferredObjects.empty())
+        return;
+
+    const auto start = std::chrono::steady_clock::now();
+    const std::chrono::duration<float> budget(_deferredDestructionBudget);
+    do
+    {
+        // reading the clock costs about as much as a small destructor, so check it every few objects
+        for (int i = 0; i < 64 && !_deferredObjects.empty(); ++i)
+            destroyFirstDeferredObject();
+    } while (!_deferredObjects.empty() && std::chrono::steady_clock::now() - start < budget);
+}
+
+void PoolManager::destroyAllDeferredObjects()
+{
+    // objects released by these destructors are deleted right away instead of being queued
+    float budget = _deferredDestructionBudget;
+    _deferredDestructionBudget = 0;
+    while (!_deferredObjects.empty())
+        destroyFirstDeferredObject();
+    _deferredDestructionBudget = budget;
+}
+
 void PoolManager::push(AutoreleasePool *pool)
 {
     _releasePoolStack.push_back(pool);
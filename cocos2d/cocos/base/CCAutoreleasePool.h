@@ -28,6 +28,10 @@ THE SOFTWARE.
 
 #include <vector>
 #include <string>
+#include <deque>
+#include <atomic>
+#include <thread>
+#include <unordered_set>
 #include "base/CCRef.h"
 
 /**
@@ -36,6 +40,7 @@ THE SOFTWARE.
  */
 NS_CC_BEGIN
 
+class FrameArena;
 
 /**
  * A pool for managing autorelease objects.
@@ -141,6 +146,12 @@ private:
      *  The flag for checking whether the pool is doing `clear` operation.
      */
     bool _isClearing;
+
+    /**
+     * The objects of _managedObjectArray, so that Ref::release() can check whether an object is in a pool
+     * without scanning every pool.
+     */
+    std::unordered_set<Ref*> _managedObjectSet;
 #endif
 };
 
@@ -168,6 +179,42 @@ public:
 
     bool isObjectInPools(Ref* obj) const;
 
+    /**
+     * Defers the destruction of objects whose reference count drops to zero, so that freeing a large graph
+     * of objects, like a scene with tens of thousands of nodes, is spread over several frames.
+     * Only objects released on the thread which created the pool manager are deferred.
+     *
+     * @warning A deferred object keeps whatever its destructor would undo until it is destroyed. A deferred Node
+     * stays registered with the event dispatcher and the scheduler, its listeners paused by onExit(), and its
+     * children are only released when it is destroyed.
+     *
+     * @param budget Seconds spent destroying deferred objects per frame, 0 destroys them right away.
+     */
+    void setDeferredDestructionBudget(float budget);
+    float getDeferredDestructionBudget() const { return _deferredDestructionBudget; }
+
+    /** Destroys deferred objects until the budget of this frame is spent, Director calls it once per frame. */
+    void destroyDeferredObjects();
+    /** Destroys all the deferred objects, including the ones released by their destructors. */
+    void destroyAllDeferredObjects();
+    /** Number of objects waiting to be destroyed. */
+    size_t getDeferredObjectCount() const { return _deferredObjects.size(); }
+    /** Number of objects destroyed so far, the difference between two frames gives the objects freed per frame. */
+    unsigned int getFreedObjectCount() const { return _freedObjectCount; }
+
+    /**
+     * Called by Ref::release() when the reference count of an object drops to zero.
+     *
+     * @return True if the object is queued for deferred destruction, false if the caller has to delete it.
+     */
+    static bool deferDestruction(Ref* object);
+
+    /**
+     * Sets the arena AutoreleasePool::clear() takes its scratch copy of the released objects from,
+     * Director passes its frame arena. Only used on the thread which created the pool manager.
+     */
+    void setFrameArena(FrameArena* arena) { _frameArena = arena; }
+
 
     friend class AutoreleasePool;
     
@@ -177,10 +224,18 @@ private:
     
     void push(AutoreleasePool *pool);
     void pop();
+    void destroyFirstDeferredObject();
     
     static PoolManager* s_singleInstance;
     
     std::vector<AutoreleasePool*> _releasePoolStack;
+
+    std::deque<Ref*> _deferredObjects;
+    std::unordered_set<Ref*> _deferredObjectSet;
+    float _deferredDestructionBudget;
+    std::thread::id _threadId;
+    std::atomic<unsigned int> _freedObjectCount;
+    FrameArena* _frameArena;
 };
 /**
  * @endcond
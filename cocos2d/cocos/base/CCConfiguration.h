@@ -126,6 +126,19 @@ public:
      * @return Is true if supports ATITC Texture Compressed.
      */
     bool supportsATITC() const;
+
+    /** Whether or not ETC2 Texture Compressed is supported.
+     * ETC2 is part of OpenGL ES 3.0, so it is also available to ES 2.0 contexts created on ES 3.0 hardware.
+     *
+     * @return Is true if supports ETC2 Texture Compressed.
+     */
+    bool supportsETC2() const;
+
+    /** Whether or not ASTC (LDR profile) Texture Compressed is supported.
+     *
+     * @return Is true if supports ASTC Texture Compressed.
+     */
+    bool supportsASTC() const;
     
     /** Whether or not BGRA8888 textures are supported.
      *
@@ -263,6 +276,8 @@ protected:
     bool            _supportsETC1;
     bool            _supportsS3TC;
     bool            _supportsATITC;
+    bool            _supportsETC2;
+    bool            _supportsASTC;
     bool            _supportsNPOT;
     bool            _supportsBGRA8888;
     bool            _supportsDiscardFramebuffer;
@@ -37,6 +37,8 @@ THE SOFTWARE.
 #include "platform/CCFileUtils.h"
 
 #include "2d/CCActionManager.h"
+#include "2d/CCTweenManager.h"
+#include "2d/CCParticleManager.h"
 #include "2d/CCFontFNT.h"
 #include "2d/CCFontAtlasCache.h"
 #include "2d/CCAnimationCache.h"
@@ -56,11 +58,13 @@ THE SOFTWARE.
 #include "base/CCScheduler.h"
 #include "base/ccMacros.h"
 #include "base/CCEventDispatcher.h"
+#include "base/CCFrameArena.h"
 #include "base/CCEventCustom.h"
 #include "base/CCConsole.h"
 #include "base/CCAutoreleasePool.h"
 #include "base/CCConfiguration.h"
 #include "base/CCAsyncTaskPool.h"
+#include "base/CCJobSystem.h"
 #include "base/ObjectFactory.h"
 #include "platform/CCApplication.h"
 
@@ -130,8 +134,16 @@ bool Director::init()
     // action manager
     _actionManager = new (std::nothrow) ActionManager();
     _scheduler->scheduleUpdate(_actionManager, Scheduler::PRIORITY_SYSTEM, false);
+    // tween manager, updated right after the action manager
+    _tweenManager = new (std::nothrow) TweenManager();
+    _scheduler->scheduleUpdate(_tweenManager, Scheduler::PRIORITY_SYSTEM, false);
+    // particle manager, joined after the scheduler in drawScene()
+    _particleManager = new (std::nothrow) ParticleManager();
 
     _eventDispatcher = new (std::nothrow) EventDispatcher();
+
+    _frameArena = new (std::nothrow) FrameArena();
+    PoolManager::getInstance()->setFrameArena(_frameArena);
     
     _beforeSetNextScene = new (std::nothrow) EventCustom(EVENT_BEFORE_SET_NEXT_SCENE);
     _beforeSetNextScene->setUserData(this);
@@ -167,11 +179,15 @@ Director::~Director()
     CC_SAFE_RELEASE(_FPSLabel);
     CC_SAFE_RELEASE(_drawnVerticesLabel);
     CC_SAFE_RELEASE(_drawnBatchesLabel);
+    CC_SAFE_RELEASE(_frameArenaLabel);
+    CC_SAFE_RELEASE(_freedObjectsLabel);
 
     CC_SAFE_RELEASE(_runningScene);
     CC_SAFE_RELEASE(_notificationNode);
     CC_SAFE_RELEASE(_scheduler);
     CC_SAFE_RELEASE(_actionManager);
+    CC_SAFE_RELEASE(_tweenManager);
+    CC_SAFE_RELEASE(_particleManager);
 
     CC_SAFE_RELEASE(_beforeSetNextScene);
     CC_SAFE_RELEASE(_afterSetNextScene);
@@ -187,6 +203,8 @@ Director::~Director()
     delete _console;
 
     CC_SAFE_RELEASE(_eventDispatcher);
+    PoolManager::getInstance()->setFrameArena(nullptr);
+    CC_SAFE_DELETE(_frameArena);
     
     Configuration::destroyInstance();
     ObjectFactory::destroyInstance();
@@ -264,6 +282,8 @@ void Director::drawScene()
     {
         _eventDispatcher->dispatchEvent(_eventBeforeUpdate);
         _scheduler->update(_deltaTime);
+        // the particle systems queued by their updates have to be done before the scene is visited
+        _particleManager->updateEmitters();
         _eventDispatcher->dispatchEvent(_eventAfterUpdate);
     }
 
@@ -316,6 +336,9 @@ void Director::drawScene()
 
     _eventDispatcher->dispatchEvent(_eventAfterDraw);
 
+    // everything allocated for this frame has been consumed by now
+    _frameArena->reset();
+
     popMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
 
     _totalFrames++;
@@ -1073,6 +1096,11 @@ void Director::reset()
     CC_SAFE_RELEASE_NULL(_FPSLabel);
     CC_SAFE_RELEASE_NULL(_drawnBatchesLabel);
     CC_SAFE_RELEASE_NULL(_drawnVerticesLabel);
+    CC_SAFE_RELEASE_NULL(_frameArenaLabel);
+    CC_SAFE_RELEASE_NULL(_freedObjectsLabel);
+
+    // destroy the released scenes now, while the caches purged below are still around
+    PoolManager::getInstance()->destroyAllDeferredObjects();
     
     // purge bitmap cache
     FontFNT::purgeCachedData();
@@ -1103,6 +1131,7 @@ void Director::reset()
     GLProgramStateCache::destroyInstance();
     FileUtils::destroyInstance();
     AsyncTaskPool::destroyInstance();
+    JobSystem::destroyInstance();
     
     // cocos2d-x specific data structures
     UserDefault::destroyInstance();
@@ -1143,6 +1172,7 @@ void Director::restartDirector()
     
     // Reschedule for action manager
     getScheduler()->scheduleUpdate(getActionManager(), Scheduler::PRIORITY_SYSTEM, false);
+    getScheduler()->scheduleUpdate(getTweenManager(), Scheduler::PRIORITY_SYSTEM, false);
     
     // release the objects
     PoolManager::getInstance()->getCurrentPool()->clear();
@@ -1254,11 +1284,12 @@ void Director::showStats()
 
     static unsigned long prevCalls = 0;
     static unsigned long prevVerts = 0;
+    static unsigned int prevFreed = 0;
 
     ++_frames;
     _accumDt += _deltaTime;
     
-    if (_displayStats && _FPSLabel && _drawnBatchesLabel && _drawnVerticesLabel)
+    if (_displayStats && _FPSLabel && _drawnBatchesLabel && _drawnVerticesLabel && _frameArenaLabel && _freedObjectsLabel)
     {
         char buffer[30] = {0};
 
@@ -1269,6 +1300,17 @@ void Director::showStats()
         {
             sprintf(buffer, "%.1f / %.3f", _frames / _accumDt, _secondsPerFrame);
             _FPSLabel->setString(buffer);
+            sprintf(buffer, "Arena KB:%5lu / %5lu",
+                    (unsigned long)(_frameArena->getPeakUsage() / 1024),
+                    (unsigned long)(_frameArena->getAverageUsage() / 1024));
+            _frameArenaLabel->setString(buffer);
+            auto poolManager = PoolManager::getInstance();
+            auto currentFreed = poolManager->getFreedObjectCount();
+            sprintf(buffer, "Freed:%6lu / %6lu",
+                    (unsigned long)((currentFreed - prevFreed) / _frames),
+                    (unsigned long)poolManager->getDeferredObjectCount());
+            _freedObjectsLabel->setString(buffer);
+            prevFreed = currentFreed;
             _accumDt = 0;
             _frames = 0;
         }
@@ -1288,6 +1330,8 @@ void Director::showStats()
         }
 
         const Mat4& identity = Mat4::IDENTITY;
+        _freedObjectsLabel->visit(_renderer, identity, 0);
+        _frameArenaLabel->visit(_renderer, identity, 0);
         _drawnVerticesLabel->visit(_renderer, identity, 0);
         _drawnBatchesLabel->visit(_renderer, identity, 0);
         _FPSLabel->visit(_renderer, identity, 0);
@@ -1317,15 +1361,21 @@ void Director::createStatsLabel()
     std::string fpsString = "00.0";
     std::string drawBatchString = "000";
     std::string drawVerticesString = "00000";
+    std::string frameArenaString = "0";
+    std::string freedObjectsString = "0";
     if (_FPSLabel)
     {
         fpsString = _FPSLabel->getString();
         drawBatchString = _drawnBatchesLabel->getString();
         drawVerticesString = _drawnVerticesLabel->getString();
+        frameArenaString = _frameArenaLabel->getString();
+        freedObjectsString = _freedObjectsLabel->getString();
         
         CC_SAFE_RELEASE_NULL(_FPSLabel);
         CC_SAFE_RELEASE_NULL(_drawnBatchesLabel);
         CC_SAFE_RELEASE_NULL(_drawnVerticesLabel);
+        CC_SAFE_RELEASE_NULL(_frameArenaLabel);
+        CC_SAFE_RELEASE_NULL(_freedObjectsLabel);
         _textureCache->removeTextureForKey("/cc_fps_images");
         FileUtils::getInstance()->purgeCachedEntries();
     }
@@ -1376,10 +1426,23 @@ void Director::createStatsLabel()
     _drawnVerticesLabel->initWithString(drawVerticesString, texture, 12, 32, '.');
     _drawnVerticesLabel->setScale(scaleFactor);
 
+    _frameArenaLabel = LabelAtlas::create();
+    _frameArenaLabel->retain();
+    _frameArenaLabel->setIgnoreContentScaleFactor(true);
+    _frameArenaLabel->initWithString(frameArenaString, texture, 12, 32, '.');
+    _frameArenaLabel->setScale(scaleFactor);
+
+    _freedObjectsLabel = LabelAtlas::create();
+    _freedObjectsLabel->retain();
+    _freedObjectsLabel->setIgnoreContentScaleFactor(true);
+    _freedObjectsLabel->initWithString(freedObjectsString, texture, 12, 32, '.');
+    _freedObjectsLabel->setScale(scaleFactor);
 
     Texture2D::setDefaultAlphaPixelFormat(currentFormat);
 
     const int height_spacing = 22 / CC_CONTENT_SCALE_FACTOR();
+    _freedObjectsLabel->setPosition(Vec2(0, height_spacing*4) + CC_DIRECTOR_STATS_POSITION);
+    _frameArenaLabel->setPosition(Vec2(0, height_spacing*3) + CC_DIRECTOR_STATS_POSITION);
     _drawnVerticesLabel->setPosition(Vec2(0, height_spacing*2) + CC_DIRECTOR_STATS_POSITION);
     _drawnBatchesLabel->setPosition(Vec2(0, height_spacing*1) + CC_DIRECTOR_STATS_POSITION);
     _FPSLabel->setPosition(Vec2(0, height_spacing*0)+CC_DIRECTOR_STATS_POSITION);
@@ -1434,6 +1497,26 @@ void Director::setActionManager(ActionManager* actionManager)
     }    
 }
 
+void Director::setTweenManager(TweenManager* tweenManager)
+{
+    if (_tweenManager != tweenManager)
+    {
+        CC_SAFE_RETAIN(tweenManager);
+        CC_SAFE_RELEASE(_tweenManager);
+        _tweenManager = tweenManager;
+    }
+}
+
+void Director::setParticleManager(ParticleManager* particleManager)
+{
+    if (_particleManager != particleManager)
+    {
+        CC_SAFE_RETAIN(particleManager);
+        CC_SAFE_RELEASE(_particleManager);
+        _particleManager = particleManager;
+    }
+}
+
 void Director::setEventDispatcher(EventDispatcher* dispatcher)
 {
     if (_eventDispatcher != dispatcher)
@@ -1476,6 +1559,7 @@ void Director::mainLoop()
      
         // release the objects
         PoolManager::getInstance()->getCurrentPool()->clear();
+        PoolManager::getInstance()->destroyDeferredObjects();
     }
 }
 
@@ -55,7 +55,10 @@ class DirectorDelegate;
 class Node;
 class Scheduler;
 class ActionManager;
+class TweenManager;
+class ParticleManager;
 class EventDispatcher;
+class FrameArena;
 class EventCustom;
 class EventListenerCustom;
 class TextureCache;
@@ -441,6 +444,27 @@ public:
      * @since v2.0
      */
     void setActionManager(ActionManager* actionManager);
+
+    /** Gets the TweenManager associated with this director.
+     */
+    TweenManager* getTweenManager() const { return _tweenManager; }
+
+    /** Sets the TweenManager associated with this director.
+     */
+    void setTweenManager(TweenManager* tweenManager);
+
+    /** Gets the ParticleManager associated with this director.
+     */
+    ParticleManager* getParticleManager() const { return _particleManager; }
+
+    /** Sets the ParticleManager associated with this director.
+     */
+    void setParticleManager(ParticleManager* particleManager);
+
+    /** Gets the FrameArena of this director, which is reset after each frame has been rendered.
+     * Memory allocated from it is only valid until the end of the current frame.
+     */
+    FrameArena* getFrameArena() const { return _frameArena; }
     
     /** Gets the EventDispatcher associated with this director.
      * @since v3.0
@@ -632,6 +656,18 @@ protected:
      @since v2.0
      */
     ActionManager *_actionManager = nullptr;
+
+    /** TweenManager associated with this director
+     */
+    TweenManager *_tweenManager = nullptr;
+
+    /** ParticleManager associated with this director
+     */
+    ParticleManager *_particleManager = nullptr;
+
+    /** Scratch memory for the current frame
+     */
+    FrameArena *_frameArena = nullptr;
     
     /** EventDispatcher associated with this director
      @since v3.0
@@ -668,6 +704,8 @@ protected:
     LabelAtlas *_FPSLabel = nullptr;
     LabelAtlas *_drawnBatchesLabel = nullptr;
     LabelAtlas *_drawnVerticesLabel = nullptr;
+    LabelAtlas *_frameArenaLabel = nullptr;
+    LabelAtlas *_freedObjectsLabel = nullptr;
     
     /** Whether or not the Director is paused */
     bool _paused = false;
@@ -28,6 +28,8 @@
 
 NS_CC_BEGIN
 
+CC_DEFINE_ALLOCATOR_POOL(EventCustom, 16)
+
 EventCustom::EventCustom(const std::string& eventName)
 : Event(Type::CUSTOM)
 , _userData(nullptr)
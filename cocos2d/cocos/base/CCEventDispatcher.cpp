@@ -38,6 +38,7 @@
 #include "2d/CCScene.h"
 #include "base/CCDirector.h"
 #include "base/CCEventType.h"
+#include "base/CCFrameArena.h"
 #include "2d/CCCamera.h"
 
 #define DUMP_LISTENER_ITEM_PRIORITY_INFO 0
@@ -202,7 +203,8 @@ void EventDispatcher::EventListenerVector::clear()
 EventDispatcher::EventDispatcher()
 : _inDispatch(0)
 , _isEnabled(false)
-, _nodePriorityIndex(0)
+, _hitTestVersion(1)
+, _unindexedTouchListenersVersion(0)
 {
     _toAddedListeners.reserve(50);
     _toRemovedListeners.reserve(50);
@@ -220,75 +222,42 @@ EventDispatcher::~EventDispatcher()
     // so removeAllEventListeners would clean internal custom listeners.
     _internalCustomListenerIDs.clear();
     removeAllEventListeners();
+    clearUnindexedTouchListeners();
 }
 
-void EventDispatcher::visitTarget(Node* node, bool isRootNode)
+bool EventDispatcher::NodeOrderKey::dispatchesBefore(const NodeOrderKey& other) const
 {
-    node->sortAllChildren();
-    
-    int i = 0;
-    auto& children = node->getChildren();
-    
-    auto childrenCount = children.size();
-    
-    if(childrenCount > 0)
-    {
-        Node* child = nullptr;
-        // visit children zOrder < 0
-        for( ; i < childrenCount; i++ )
-        {
-            child = children.at(i);
-            
-            if ( child && child->getLocalZOrder() < 0 )
-                visitTarget(child, false);
-            else
-                break;
-        }
-        
-        if (_nodeListenersMap.find(node) != _nodeListenersMap.end())
-        {
-            _globalZOrderNodeMap[node->getGlobalZOrder()].push_back(node);
-        }
-        
-        for( ; i < childrenCount; i++ )
-        {
-            child = children.at(i);
-            if (child)
-                visitTarget(child, false);
-        }
-    }
-    else
-    {
-        if (_nodeListenersMap.find(node) != _nodeListenersMap.end())
-        {
-            _globalZOrderNodeMap[node->getGlobalZOrder()].push_back(node);
-        }
-    }
-    
-    if (isRootNode)
+    if (inScene != other.inScene)
+        return inScene;
+    if (!inScene)
+        return false;
+
+    if (globalZOrder != other.globalZOrder)
+        return globalZOrder > other.globalZOrder;
+
+    // nodes visited later are drawn on top
+    return std::lexicographical_compare(other.path.begin(), other.path.end(), path.begin(), path.end());
+}
+
+void EventDispatcher::updateNodeOrderKey(Node* node, Node* rootNode)
+{
+    NodeOrderKey& key = _nodeOrderKeys[node];
+    key.globalZOrder = node->getGlobalZOrder();
+    key.path.clear();
+
+    // A node is visited after its children with negative local Z order and before the others.
+    // Children are sorted by local Z order then order of arrival, which is never 0,
+    // so 0 stands for the node itself.
+    key.path.push_back(0);
+
+    Node* current = node;
+    for (; current != rootNode && current->getParent() != nullptr; current = current->getParent())
     {
-        std::vector<float> globalZOrders;
-        globalZOrders.reserve(_globalZOrderNodeMap.size());
-        
-        for (const auto& e : _globalZOrderNodeMap)
-        {
-            globalZOrders.push_back(e.first);
-        }
-        
-        std::stable_sort(globalZOrders.begin(), globalZOrders.end(), [](const float a, const float b){
-            return a < b;
-        });
-        
-        for (const auto& globalZ : globalZOrders)
-        {
-            for (const auto& n : _globalZOrderNodeMap[globalZ])
-            {
-                _nodePriorityMap[n] = ++_nodePriorityIndex;
-            }
-        }
-        
-        _globalZOrderNodeMap.clear();
+        key.path.push_back(static_cast<std::int64_t>(current->_localZOrder) * (static_cast<std::int64_t>(1) << 32) + current->_orderOfArrival);
     }
+    std::reverse(key.path.begin(), key.path.end());
+
+    key.inScene = (current == rootNode);
 }
 
 void EventDispatcher::pauseEventListenersForTarget(Node* target, bool recursive/* = false */)
@@ -357,7 +326,7 @@ void EventDispatcher::removeEventListenersForTarget(Node* target, bool recursive
 {
     // Ensure the node is removed from these immediately also.
     // Don't want any dangling pointers or the possibility of dealing with deleted objects..
-    _nodePriorityMap.erase(target);
+    _nodeOrderKeys.erase(target);
     _dirtyNodes.erase(target);
 
     auto listenerIter = _nodeListenersMap.find(target);
@@ -436,6 +405,7 @@ void EventDispatcher::dissociateNodeAndEventListener(Node* node, EventListener*
         if (listeners->empty())
         {
             _nodeListenersMap.erase(found);
+            _nodeOrderKeys.erase(node);
             delete listeners;
         }
     }
@@ -481,7 +451,9 @@ void EventDispatcher::forceAddEventListener(EventListener* listener)
     
     if (listener->getFixedPriority() == 0)
     {
+        listener->_isSceneGraphOrderDirty = true;
         setDirty(listenerID, DirtyFlag::SCENE_GRAPH_PRIORITY);
+        ++_hitTestVersion;
         
         auto node = listener->getAssociatedNode();
         CCASSERT(node != nullptr, "Invalid scene graph priority!");
@@ -552,8 +524,8 @@ void EventDispatcher::debugCheckNodeHasNoEventListenersOnDestruction(Node* node)
         }
     }
     
-    // Check the node priority map
-    for (const auto & keyValuePair : _nodePriorityMap)
+    // Check the node order key map
+    for (const auto & keyValuePair : _nodeOrderKeys)
     {
         CCASSERT(keyValuePair.first != node,
                  "Node should have no event listeners registered for it upon destruction!");
@@ -656,6 +628,10 @@ void EventDispatcher::removeEventListener(EventListener* listener)
         {
             // fixed #4160: Dirty flag need to be updated after listeners were removed.
             setDirty(listener->getListenerID(), DirtyFlag::SCENE_GRAPH_PRIORITY);
+            if (listener->getListenerID() == EventListenerTouchOneByOne::LISTENER_ID)
+            {
+                clearUnindexedTouchListeners();
+            }
         }
         else
         {
@@ -801,7 +777,7 @@ void EventDispatcher::dispatchEventToListeners(EventListenerVector* listeners, c
     }
 }
 
-void EventDispatcher::dispatchTouchEventToListeners(EventListenerVector* listeners, const std::function<bool(EventListener*)>& onEvent)
+void EventDispatcher::dispatchTouchEventToListeners(EventListenerVector* listeners, const std::function<bool(EventListener*)>& onEvent, const Vec2* hitTestLocation)
 {
     bool shouldStopPropagation = false;
     auto fixedPriorityListeners = listeners->getFixedPriorityListeners();
@@ -827,7 +803,8 @@ void EventDispatcher::dispatchTouchEventToListeners(EventListenerVector* listene
         }
     }
     
-    auto scene = Director::getInstance()->getRunningScene();
+    auto director = Director::getInstance();
+    auto scene = director->getRunningScene();
     if (scene && sceneGraphPriorityListeners)
     {
         if (!shouldStopPropagation)
@@ -835,12 +812,20 @@ void EventDispatcher::dispatchTouchEventToListeners(EventListenerVector* listene
             // priority == 0, scene graph priority
             
             // first, get all enabled, unPaused and registered listeners
-            std::vector<EventListener*> sceneListeners;
-            for (auto& l : *sceneGraphPriorityListeners)
+            FrameVector<EventListener*> sceneListeners(FrameArenaAllocator<EventListener*>(director->getFrameArena()));
+            if (hitTestLocation && !_hitTestIndex.empty())
+            {
+                getHitTestedTouchListeners(*hitTestLocation, sceneListeners);
+            }
+            else
             {
-                if (l->isEnabled() && !l->isPaused() && l->isRegistered())
+                sceneListeners.reserve(sceneGraphPriorityListeners->size());
+                for (auto& l : *sceneGraphPriorityListeners)
                 {
-                    sceneListeners.push_back(l);
+                    if (l->isEnabled() && !l->isPaused() && l->isRegistered())
+                    {
+                        sceneListeners.push_back(l);
+                    }
                 }
             }
             // second, for all camera call all listeners
@@ -898,6 +883,100 @@ void EventDispatcher::dispatchTouchEventToListeners(EventListenerVector* listene
     }
 }
 
+void EventDispatcher::setHitTestBounds(Node* node, const Rect& worldBounds)
+{
+    CCASSERT(node, "Invalid parameters.");
+    if (_hitTestIndex.update(node, worldBounds))
+    {
+        ++_hitTestVersion;
+    }
+}
+
+void EventDispatcher::removeHitTestBounds(Node* node)
+{
+    if (_hitTestIndex.remove(node))
+    {
+        ++_hitTestVersion;
+    }
+}
+
+template <typename Container>
+void EventDispatcher::getHitTestedTouchListeners(const Vec2& location, Container& result)
+{
+    auto listeners = getListeners(EventListenerTouchOneByOne::LISTENER_ID);
+    auto sceneGraphListeners = listeners ? listeners->getSceneGraphPriorityListeners() : nullptr;
+    if (sceneGraphListeners == nullptr)
+        return;
+
+    // The listeners of nodes without bounds get every touch, they are only collected again
+    // when a node gets or loses its bounds or the listeners change.
+    if (_unindexedTouchListenersVersion != _hitTestVersion)
+    {
+        clearUnindexedTouchListeners();
+
+        for (auto l : *sceneGraphListeners)
+        {
+            if (!_hitTestIndex.contains(l->getAssociatedNode()))
+            {
+                l->retain();
+                _unindexedTouchListeners.push_back(l);
+            }
+        }
+        _unindexedTouchListenersVersion = _hitTestVersion;
+    }
+
+    // the listeners of the nodes under the touch
+    FrameArenaAllocator<Node*> allocator(Director::getInstance()->getFrameArena());
+    FrameVector<Node*> nodes(allocator);
+    _hitTestIndex.query(location, nodes);
+
+    FrameVector<EventListener*> hits(allocator);
+    for (auto node : nodes)
+    {
+        auto found = _nodeListenersMap.find(node);
+        if (found == _nodeListenersMap.end())
+            continue;
+
+        for (auto l : *found->second)
+        {
+            if (l->isEnabled() && !l->isPaused() && l->isRegistered() && l->getListenerID() == EventListenerTouchOneByOne::LISTENER_ID)
+            {
+                hits.push_back(l);
+            }
+        }
+    }
+
+    auto dispatchesBefore = [this](const EventListener* l1, const EventListener* l2) {
+        return _nodeOrderKeys.find(l1->getAssociatedNode())->second.dispatchesBefore(_nodeOrderKeys.find(l2->getAssociatedNode())->second);
+    };
+    std::stable_sort(hits.begin(), hits.end(), dispatchesBefore);
+
+    // both lists are in dispatch order, merge them
+    auto hit = hits.begin();
+    for (auto l : _unindexedTouchListeners)
+    {
+        if (!l->isEnabled() || l->isPaused() || !l->isRegistered())
+            continue;
+
+        while (hit != hits.end() && dispatchesBefore(*hit, l))
+        {
+            result.push_back(*hit++);
+        }
+        result.push_back(l);
+    }
+    result.insert(result.end(), hit, hits.end());
+}
+
+void EventDispatcher::clearUnindexedTouchListeners()
+{
+    for (auto l : _unindexedTouchListeners)
+    {
+        l->release();
+    }
+    _unindexedTouchListeners.clear();
+    ++_hitTestVersion;
+}
+
 void EventDispatcher::dispatchEvent(Event* event)
 {
     if (!_isEnabled)
@@ -918,10 +997,6 @@ void EventDispatcher::dispatchEvent(Event* event)
     
     sortEventListeners(listenerID);
     
-    auto pfnDispatchEventToListeners = &EventDispatcher::dispatchEventToListeners;
-    if (event->getType() == Event::Type::MOUSE) {
-        pfnDispatchEventToListeners = &EventDispatcher::dispatchTouchEventToListeners;
-    }
     auto iter = _listenerMap.find(listenerID);
     if (iter != _listenerMap.end())
     {
@@ -933,7 +1008,14 @@ void EventDispatcher::dispatchEvent(Event* event)
             return event->isStopped();
         };
         
-        (this->*pfnDispatchEventToListeners)(listeners, onEvent);
+        if (event->getType() == Event::Type::MOUSE)
+        {
+            dispatchTouchEventToListeners(listeners, onEvent);
+        }
+        else
+        {
+            dispatchEventToListeners(listeners, onEvent);
+        }
     }
     
     updateListeners(event);
@@ -1067,8 +1149,10 @@ void EventDispatcher::dispatchTouchEvent(EventTouch* event)
                 return false;
             };
             
-            //
-            dispatchTouchEventToListeners(oneByOneListeners, onTouchEvent);
+            // only the listeners under the touch can claim it, the location is only needed with an index
+            const bool isHitTested = (event->getEventCode() == EventTouch::EventCode::BEGAN && !_hitTestIndex.empty());
+            const Vec2 location = isHitTested ? touches->getLocation() : Vec2::ZERO;
+            dispatchTouchEventToListeners(oneByOneListeners, onTouchEvent, isHitTested ? &location : nullptr);
             if (event->isStopped())
             {
                 return;
@@ -1267,6 +1351,7 @@ void EventDispatcher::updateDirtyFlagForSceneGraph()
             {
                 for (auto& l : *iter->second)
                 {
+                    l->_isSceneGraphOrderDirty = true;
                     setDirty(l->getListenerID(), DirtyFlag::SCENE_GRAPH_PRIORITY);
                 }
             }
@@ -1322,22 +1407,71 @@ void EventDispatcher::sortEventListenersOfSceneGraphPriority(const EventListener
     if (sceneGraphListeners == nullptr)
         return;
 
-    // Reset priority index
-    _nodePriorityIndex = 0;
-    _nodePriorityMap.clear();
+    // Take out the listeners that were added or whose node moved since the last sort,
+    // the others are still in order.
+    FrameArenaAllocator<EventListener*> allocator(Director::getInstance()->getFrameArena());
+    FrameVector<EventListener*> movedListeners(allocator);
+    auto last = sceneGraphListeners->begin();
+    for (auto l : *sceneGraphListeners)
+    {
+        if (l->_isSceneGraphOrderDirty || _nodeOrderKeys.find(l->getAssociatedNode()) == _nodeOrderKeys.end())
+        {
+            l->_isSceneGraphOrderDirty = false;
+            updateNodeOrderKey(l->getAssociatedNode(), rootNode);
+            movedListeners.push_back(l);
+        }
+        else
+        {
+            *last++ = l;
+        }
+    }
+
+    if (movedListeners.empty())
+        return;
+
+    sceneGraphListeners->erase(last, sceneGraphListeners->end());
+    ++_hitTestVersion;
+
+    auto dispatchesBefore = [this](const EventListener* l1, const EventListener* l2) {
+        return _nodeOrderKeys.find(l1->getAssociatedNode())->second.dispatchesBefore(_nodeOrderKeys.find(l2->getAssociatedNode())->second);
+    };
 
-    visitTarget(rootNode, true);
-    
     // After sort: priority < 0, > 0
-    std::stable_sort(sceneGraphListeners->begin(), sceneGraphListeners->end(), [this](const EventListener* l1, const EventListener* l2) {
-        return _nodePriorityMap[l1->getAssociatedNode()] > _nodePriorityMap[l2->getAssociatedNode()];
-    });
+    if (movedListeners.size() * 16 <= sceneGraphListeners->size())
+    {
+        // A few nodes moved, insert their listeners at their new place
+        std::stable_sort(movedListeners.begin(), movedListeners.end(), dispatchesBefore);
+        for (auto l : movedListeners)
+        {
+            sceneGraphListeners->insert(std::upper_bound(sceneGraphListeners->begin(), sceneGraphListeners->end(), l, dispatchesBefore), l);
+        }
+    }
+    else
+    {
+        sceneGraphListeners->insert(sceneGraphListeners->end(), movedListeners.begin(), movedListeners.end());
+
+        // look the keys up once instead of for each comparison
+        typedef std::pair<const NodeOrderKey*, EventListener*> KeyAndListener;
+        FrameVector<KeyAndListener> sorted(allocator);
+        sorted.reserve(sceneGraphListeners->size());
+        for (auto l : *sceneGraphListeners)
+        {
+            sorted.push_back(KeyAndListener(&_nodeOrderKeys.find(l->getAssociatedNode())->second, l));
+        }
+        std::stable_sort(sorted.begin(), sorted.end(), [](const KeyAndListener& a, const KeyAndListener& b) {
+            return a.first->dispatchesBefore(*b.first);
+        });
+        for (size_t i = 0, count = sorted.size(); i < count; ++i)
+        {
+            (*sceneGraphListeners)[i] = sorted[i].second;
+        }
+    }
     
 #if DUMP_LISTENER_ITEM_PRIORITY_INFO
     log("-----------------------------------");
     for (auto& l : *sceneGraphListeners)
     {
-        log("listener priority: node ([%s]%p), priority (%d)", typeid(*l->_node).name(), l->_node, _nodePriorityMap[l->_node]);
+        log("listener priority: node ([%s]%p), global z order (%f)", typeid(*l->_node).name(), l->_node, _nodeOrderKeys[l->_node].globalZOrder);
     }
 #endif
 }
@@ -1427,6 +1561,10 @@ void EventDispatcher::removeEventListenersForListenerID(const EventListener::Lis
         
         removeAllListenersInVector(sceneGraphPriorityListeners);
         removeAllListenersInVector(fixedPriorityListeners);
+        if (listenerID == EventListenerTouchOneByOne::LISTENER_ID)
+        {
+            clearUnindexedTouchListeners();
+        }
         
         // Remove the dirty flag according the 'listenerID'.
         // No need to check whether the dispatcher is dispatching event.
@@ -31,10 +31,12 @@
 #include <unordered_map>
 #include <vector>
 #include <set>
+#include <cstdint>
 
 #include "platform/CCPlatformMacros.h"
 #include "base/CCEventListener.h"
 #include "base/CCEvent.h"
+#include "base/CCHitTestIndex.h"
 #include "platform/CCStdC.h"
 
 /**
@@ -161,6 +163,31 @@ public:
      */
     bool isEnabled() const;
 
+    /////////////////////////////////////////////
+
+    /** Sets the world space bounds of a node for hit testing.
+     *  Touch began events are only dispatched to the one by one touch listeners of the nodes whose bounds
+     *  contain the touch location, found through a grid instead of asking every listener.
+     *  Other touch events still go to the listeners which claimed the touch, and listeners of nodes
+     *  without bounds get every event.
+     *  The bounds must be in the coordinates of the default camera, Node::setHitTestIndexEnabled keeps
+     *  them up to date from the node transform.
+     *
+     * @param node The node whose listeners are hit tested.
+     * @param worldBounds The bounds of the node in world space.
+     */
+    void setHitTestBounds(Node* node, const Rect& worldBounds);
+
+    /** Removes the hit test bounds of a node, its listeners get every touch event again.
+     *
+     * @param node The node whose listeners are hit tested.
+     */
+    void removeHitTestBounds(Node* node);
+
+    /** Gets the bounds used to hit test touches.
+     */
+    const HitTestIndex& getHitTestIndex() const { return _hitTestIndex; }
+
     /////////////////////////////////////////////
     
     /** Dispatches the event.
@@ -293,7 +320,14 @@ protected:
      *      to 3D world space is different by different camera.
      *  When listener process touch event, can get current camera by Camera::getVisitingCamera().
      */
-    void dispatchTouchEventToListeners(EventListenerVector* listeners, const std::function<bool(EventListener*)>& onEvent);
+    void dispatchTouchEventToListeners(EventListenerVector* listeners, const std::function<bool(EventListener*)>& onEvent, const Vec2* hitTestLocation = nullptr);
+
+    /** Appends the scene graph priority touch listeners which may claim a touch at location to result, in dispatch order */
+    template <typename Container>
+    void getHitTestedTouchListeners(const Vec2& location, Container& result);
+
+    /** Releases the cached unindexed touch listeners, so that removed listeners aren't kept alive until the next touch */
+    void clearUnindexedTouchListeners();
     
     void releaseListener(EventListener* listener);
     
@@ -309,8 +343,19 @@ protected:
     /** Sets the dirty flag for a specified listener ID */
     void setDirty(const EventListener::ListenerID& listenerID, DirtyFlag flag);
     
-    /** Walks though scene graph to get the draw order for each node, it's called before sorting event listener with scene graph priority */
-    void visitTarget(Node* node, bool isRootNode);
+    /** The position of a node in the draw order, scene graph priority listeners are sorted by the key of their node */
+    struct NodeOrderKey
+    {
+        /** Whether the node is dispatched before the other one, i.e. it's drawn after it */
+        bool dispatchesBefore(const NodeOrderKey& other) const;
+
+        bool inScene;                   ///< false if the node isn't in the scene, those nodes are dispatched last
+        float globalZOrder;
+        std::vector<std::int64_t> path; ///< sort key of each node from the root down, 0 for the node itself
+    };
+
+    /** Computes the draw order key of a node from its ancestors, it's called before sorting event listener with scene graph priority */
+    void updateNodeOrderKey(Node* node, Node* rootNode);
 
     /** Remove all listeners in _toRemoveListeners list and cleanup */
     void cleanToRemovedListeners();
@@ -324,11 +369,8 @@ protected:
     /** The map of node and event listeners */
     std::unordered_map<Node*, std::vector<EventListener*>*> _nodeListenersMap;
     
-    /** The map of node and its event priority */
-    std::unordered_map<Node*, int> _nodePriorityMap;
-    
-    /** key: Global Z Order, value: Sorted Nodes */
-    std::unordered_map<float, std::vector<Node*>> _globalZOrderNodeMap;
+    /** The map of node and its draw order key, kept between sorts so that only the listeners of moved nodes are sorted again */
+    std::unordered_map<Node*, NodeOrderKey> _nodeOrderKeys;
     
     /** The listeners to be added after dispatching event */
     std::vector<EventListener*> _toAddedListeners;
@@ -345,9 +387,17 @@ protected:
     /** Whether to enable dispatching event */
     bool _isEnabled;
     
-    int _nodePriorityIndex;
-    
     std::set<std::string> _internalCustomListenerIDs;
+
+    /** Bounds of the nodes whose one by one touch listeners are hit tested */
+    HitTestIndex _hitTestIndex;
+
+    /** One by one touch listeners of the nodes without bounds, in dispatch order, they are retained */
+    std::vector<EventListener*> _unindexedTouchListeners;
+
+    /** Bumped when the hit tested nodes or the one by one touch listeners or their order change */
+    unsigned int _hitTestVersion;
+    unsigned int _unindexedTouchListenersVersion;
 };
 
 
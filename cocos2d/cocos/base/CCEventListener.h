@@ -174,6 +174,7 @@ protected:
     Node* _node;            // scene graph based priority
     bool _paused;           // Whether the listener is paused
     bool _isEnabled;        // Whether the listener is enabled
+    bool _isSceneGraphOrderDirty; // Whether the node moved since the listener was sorted by scene graph priority
     friend class EventDispatcher;
 };
 
@@ -28,6 +28,8 @@
 
 NS_CC_BEGIN
 
+CC_DEFINE_ALLOCATOR_POOL(EventTouch, 8)
+
 EventTouch::EventTouch()
 : Event(Type::TOUCH)
 {
@@ -28,6 +28,7 @@
 
 #include "base/CCEvent.h"
 #include <vector>
+#include "base/allocator/CCAllocatorStrategyPool.h"
 
 /**
  * @addtogroup base
@@ -46,6 +47,8 @@ class Touch;
 class CC_DLL EventTouch : public Event
 {
 public:
+    CC_DECLARE_ALLOCATOR_POOL(EventTouch)
+
     static const int MAX_TOUCHES = 15;
     
     /** EventCode Touch event code.*/
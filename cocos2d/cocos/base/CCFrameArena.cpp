@@ -0,0 +1,170 @@
+/****************************************************************************
+Copyright (c) 2019 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#include "base/CCFrameArena.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+#include "base/ccMacros.h"
+
+NS_CC_BEGIN
+
+namespace {
+    // weight of the last frame in the average usage
+    const float AVERAGE_USAGE_FILTER = 0.05f;
+
+    inline size_t alignUp(size_t value, size_t alignment)
+    {
+        return (value + alignment - 1) & ~(alignment - 1);
+    }
+}
+
+FrameArena::FrameArena(size_t blockSize)
+: _blockSize(blockSize)
+, _currentBlock(0)
+, _offset(0)
+, _usedBytes(0)
+, _lastFrameUsage(0)
+, _peakUsage(0)
+, _averageUsage(0)
+#if COCOS2D_DEBUG > 0
+, _ownerThread(std::this_thread::get_id())
+#endif
+{
+    Block block = { static_cast<unsigned char*>(malloc(blockSize)), blockSize };
+    _blocks.push_back(block);
+}
+
+FrameArena::~FrameArena()
+{
+    for (auto& block : _blocks)
+    {
+        free(block.data);
+    }
+}
+
+void* FrameArena::allocate(size_t size, size_t alignment)
+{
+    CCASSERT(std::this_thread::get_id() == _ownerThread, "FrameArena must only be used on the cocos thread");
+    CCASSERT(alignment != 0 && (alignment & (alignment - 1)) == 0, "alignment must be a power of two");
+
+    const Block* block = &_blocks[_currentBlock];
+    // align the address, malloc only guarantees the alignment of the fundamental types
+    size_t start = alignUp(reinterpret_cast<size_t>(block->data) + _offset, alignment) - reinterpret_cast<size_t>(block->data);
+    if (start + size > block->size)
+    {
+        if (!useNextBlock(size, alignment))
+            return nullptr;
+        block = &_blocks[_currentBlock];
+        start = alignUp(reinterpret_cast<size_t>(block->data), alignment) - reinterpret_cast<size_t>(block->data);
+    }
+
+    _usedBytes += start + size - _offset;
+    _offset = start + size;
+    return block->data + start;
+}
+
+bool FrameArena::useNextBlock(size_t size, size_t alignment)
+{
+    // the rest of the current block is wasted for this frame
+    _usedBytes += _blocks[_currentBlock].size - _offset;
+
+    // blocks after the current one are left over from before the last merge
+    while (++_currentBlock < _blocks.size())
+    {
+        _offset = 0;
+        if (size + alignment <= _blocks[_currentBlock].size)
+            return true;
+        _usedBytes += _blocks[_currentBlock].size;
+    }
+
+    const size_t blockSize = std::max(_blockSize, size + alignment);
+    Block block = { static_cast<unsigned char*>(malloc(blockSize)), blockSize };
+    if (block.data == nullptr)
+    {
+        CCLOGERROR("FrameArena: failed to allocate %d bytes", static_cast<int>(blockSize));
+        _currentBlock = _blocks.size() - 1;
+        _offset = _blocks.back().size;
+        return false;
+    }
+    _blocks.push_back(block);
+    _currentBlock = _blocks.size() - 1;
+    _offset = 0;
+    return true;
+}
+
+void FrameArena::deallocate(void* pointer, size_t size)
+{
+    unsigned char* address = static_cast<unsigned char*>(pointer);
+    const Block& block = _blocks[_currentBlock];
+    if (address != nullptr && address + size == block.data + _offset && address >= block.data)
+    {
+        const size_t start = address - block.data;
+        _usedBytes -= _offset - start;
+        _offset = start;
+    }
+}
+
+void FrameArena::reset()
+{
+    _lastFrameUsage = _usedBytes;
+    _peakUsage = std::max(_peakUsage, _usedBytes);
+    _averageUsage += (static_cast<float>(_usedBytes) - _averageUsage) * AVERAGE_USAGE_FILTER;
+
+    // merge the blocks, next frames are likely to need as much memory as this one
+    if (_blocks.size() > 1)
+    {
+        const size_t capacity = getCapacity();
+        for (auto& block : _blocks)
+        {
+            free(block.data);
+        }
+        _blocks.clear();
+
+        Block block = { static_cast<unsigned char*>(malloc(capacity)), capacity };
+        if (block.data == nullptr)
+        {
+            block.data = static_cast<unsigned char*>(malloc(_blockSize));
+            block.size = _blockSize;
+        }
+        _blocks.push_back(block);
+    }
+
+    _currentBlock = 0;
+    _offset = 0;
+    _usedBytes = 0;
+}
+
+size_t FrameArena::getCapacity() const
+{
+    size_t capacity = 0;
+    for (const auto& block : _blocks)
+    {
+        capacity += block.size;
+    }
+    return capacity;
+}
+
+NS_CC_END
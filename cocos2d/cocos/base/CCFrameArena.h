@@ -0,0 +1,170 @@
+/****************************************************************************
+Copyright (c) 2019 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#ifndef __cocos2dx__CCFrameArena__
+#define __cocos2dx__CCFrameArena__
+
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+#include "platform/CCPlatformMacros.h"
+
+/**
+ * @addtogroup base
+ * @{
+ */
+
+NS_CC_BEGIN
+
+/**
+ * Bump allocator for data that only lives during one frame.
+ *
+ * Director owns one instance and resets it once the frame has been rendered, so memory returned
+ * by allocate() stays valid for the rest of the update, visit and render of the current frame and
+ * must not be used after that. deallocate() only gives memory back if it was the most recent
+ * allocation, everything else is reclaimed by reset(). Nothing is destructed, use FrameArenaAllocator
+ * or FrameVector for objects that need it.
+ *
+ * The arena grows by blocks when a frame needs more than it has, on reset() the blocks are merged
+ * into one so that the following frames are served from a single block again.
+ * It is not thread safe, only use it on the cocos thread.
+ */
+class CC_DLL FrameArena
+{
+public:
+    /** The size of the first block. */
+    static const size_t DEFAULT_BLOCK_SIZE = 64 * 1024;
+
+    explicit FrameArena(size_t blockSize = DEFAULT_BLOCK_SIZE);
+    ~FrameArena();
+
+    /** Returns size bytes of uninitialized memory aligned to alignment, which must be a power of two. */
+    void* allocate(size_t size, size_t alignment = sizeof(double));
+
+    /** Gives the memory back if it was returned by the last call to allocate(), otherwise does nothing. */
+    void deallocate(void* pointer, size_t size);
+
+    /** Returns uninitialized memory for count objects of T. */
+    template <typename T>
+    T* allocateArray(size_t count)
+    {
+        return static_cast<T*>(allocate(count * sizeof(T), alignof(T)));
+    }
+
+    /** Releases everything allocated since the last reset and updates the usage statistics. */
+    void reset();
+
+    /** Returns the number of bytes allocated since the last reset, including alignment padding. */
+    size_t getUsedBytes() const { return _usedBytes; }
+
+    /** Returns the total size of the blocks. */
+    size_t getCapacity() const;
+
+    /** Returns the number of bytes used by the last frame. */
+    size_t getLastFrameUsage() const { return _lastFrameUsage; }
+
+    /** Returns the highest number of bytes used by a frame. */
+    size_t getPeakUsage() const { return _peakUsage; }
+
+    /** Returns the number of bytes used per frame, averaged over the recent frames. */
+    size_t getAverageUsage() const { return static_cast<size_t>(_averageUsage); }
+
+private:
+    struct Block
+    {
+        unsigned char* data;
+        size_t size;
+    };
+
+    bool useNextBlock(size_t size, size_t alignment);
+
+    std::vector<Block> _blocks;
+    size_t _blockSize;
+    size_t _currentBlock;
+    size_t _offset;
+    size_t _usedBytes;
+    size_t _lastFrameUsage;
+    size_t _peakUsage;
+    float _averageUsage;
+#if COCOS2D_DEBUG > 0
+    std::thread::id _ownerThread;
+#endif
+
+    CC_DISALLOW_COPY_AND_ASSIGN(FrameArena);
+};
+
+/**
+ * STL allocator that takes its memory from a FrameArena, so that subsystems can use standard
+ * containers for per frame scratch data. Containers using it must not outlive the frame.
+ */
+template <typename T>
+class FrameArenaAllocator
+{
+public:
+    typedef T value_type;
+
+    template <typename U>
+    struct rebind
+    {
+        typedef FrameArenaAllocator<U> other;
+    };
+
+    explicit FrameArenaAllocator(FrameArena* arena) : _arena(arena) {}
+
+    template <typename U>
+    FrameArenaAllocator(const FrameArenaAllocator<U>& other) : _arena(other.getArena()) {}
+
+    T* allocate(size_t count) { return _arena->allocateArray<T>(count); }
+
+    void deallocate(T* pointer, size_t count) { _arena->deallocate(pointer, count * sizeof(T)); }
+
+    FrameArena* getArena() const { return _arena; }
+
+private:
+    FrameArena* _arena;
+};
+
+template <typename T, typename U>
+inline bool operator==(const FrameArenaAllocator<T>& a, const FrameArenaAllocator<U>& b)
+{
+    return a.getArena() == b.getArena();
+}
+
+template <typename T, typename U>
+inline bool operator!=(const FrameArenaAllocator<T>& a, const FrameArenaAllocator<U>& b)
+{
+    return a.getArena() != b.getArena();
+}
+
+/** std::vector whose storage lives in a FrameArena, e.g. FrameVector<Touch*> touches{FrameArenaAllocator<Touch*>(arena)}. */
+template <typename T>
+using FrameVector = std::vector<T, FrameArenaAllocator<T>>;
+
+NS_CC_END
+
+// end of base group
+/** @} */
+
+#endif // __cocos2dx__CCFrameArena__
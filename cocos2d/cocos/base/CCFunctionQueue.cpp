@@ -0,0 +1,291 @@
+/****************************************************************************
+Copyright (c) 2019 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#include "base/CCFunctionQueue.h"
+
+#include <chrono>
+
+NS_CC_BEGIN
+
+namespace {
+    // the pool grows by chunks of 256 nodes up to 64k nodes, beyond that nodes are heap allocated
+    const uint32_t NODE_CHUNK_SHIFT = 8;
+    const uint32_t NODE_CHUNK_SIZE = 1u << NODE_CHUNK_SHIFT;
+    const uint32_t NODE_MAX_CHUNKS = 256;
+    const uint32_t NO_INDEX = 0xffffffffu;
+
+    inline uint64_t makeFreeHead(uint64_t previous, uint32_t index)
+    {
+        return (((previous >> 32) + 1) << 32) | index;
+    }
+}
+
+FunctionQueue::FunctionQueue()
+: _head(&_stub)
+, _tail(&_stub)
+, _markerQueued(false)
+, _markerIsStale(false)
+, _pendingClears(0)
+, _freeHead(NO_INDEX)
+, _chunks(new std::atomic<Node*>[NODE_MAX_CHUNKS])
+, _chunkCount(0)
+{
+    _stub.next.store(nullptr, std::memory_order_relaxed);
+    _stub.index = NO_INDEX;
+    _stub.invoke = nullptr;
+    _stub.destroy = nullptr;
+    _marker.next.store(nullptr, std::memory_order_relaxed);
+    _marker.index = NO_INDEX;
+    _marker.invoke = nullptr;
+    _marker.destroy = nullptr;
+    for (uint32_t i = 0; i < NODE_MAX_CHUNKS; ++i)
+    {
+        _chunks[i].store(nullptr, std::memory_order_relaxed);
+    }
+}
+
+FunctionQueue::~FunctionQueue()
+{
+    while (Node* node = dequeue())
+    {
+        discardNode(node);
+    }
+    for (uint32_t i = 0; i < _chunkCount; ++i)
+    {
+        delete [] _chunks[i].load(std::memory_order_relaxed);
+    }
+    delete [] _chunks;
+}
+
+FunctionQueue::Node* FunctionQueue::nodeAt(uint32_t index) const
+{
+    return _chunks[index >> NODE_CHUNK_SHIFT].load(std::memory_order_acquire) + (index & (NODE_CHUNK_SIZE - 1));
+}
+
+FunctionQueue::Node* FunctionQueue::allocateNode()
+{
+    uint64_t head = _freeHead.load(std::memory_order_acquire);
+    while (true)
+    {
+        uint32_t index = static_cast<uint32_t>(head);
+        if (index == NO_INDEX)
+        {
+            if (!growPool())
+            {
+                Node* node = new Node;
+                node->index = NO_INDEX;
+                return node;
+            }
+            head = _freeHead.load(std::memory_order_acquire);
+            continue;
+        }
+
+        // nextFree may be stale if another producer popped the node meanwhile, the tag makes the CAS fail then
+        Node* node = nodeAt(index);
+        uint32_t next = node->nextFree.load(std::memory_order_relaxed);
+        if (_freeHead.compare_exchange_weak(head, makeFreeHead(head, next), std::memory_order_acquire, std::memory_order_acquire))
+        {
+            return node;
+        }
+    }
+}
+
+void FunctionQueue::freeNode(Node* node)
+{
+    if (node->index == NO_INDEX)
+    {
+        delete node;
+        return;
+    }
+
+    uint64_t head = _freeHead.load(std::memory_order_relaxed);
+    do
+    {
+        node->nextFree.store(static_cast<uint32_t>(head), std::memory_order_relaxed);
+    } while (!_freeHead.compare_exchange_weak(head, makeFreeHead(head, node->index), std::memory_order_release, std::memory_order_relaxed));
+}
+
+bool FunctionQueue::growPool()
+{
+    std::lock_guard<std::mutex> lock(_growMutex);
+
+    // another producer may have grown the pool while we were waiting
+    if (static_cast<uint32_t>(_freeHead.load(std::memory_order_acquire)) != NO_INDEX)
+        return true;
+    if (_chunkCount == NODE_MAX_CHUNKS)
+        return false;
+
+    uint32_t first = _chunkCount << NODE_CHUNK_SHIFT;
+    Node* chunk = new Node[NODE_CHUNK_SIZE];
+    for (uint32_t i = 0; i < NODE_CHUNK_SIZE; ++i)
+    {
+        chunk[i].index = first + i;
+        chunk[i].nextFree.store(first + i + 1, std::memory_order_relaxed);
+    }
+    _chunks[_chunkCount].store(chunk, std::memory_order_release);
+    ++_chunkCount;
+
+    Node* last = chunk + NODE_CHUNK_SIZE - 1;
+    uint64_t head = _freeHead.load(std::memory_order_relaxed);
+    do
+    {
+        last->nextFree.store(static_cast<uint32_t>(head), std::memory_order_relaxed);
+    } while (!_freeHead.compare_exchange_weak(head, makeFreeHead(head, first), std::memory_order_release, std::memory_order_relaxed));
+    return true;
+}
+
+void FunctionQueue::enqueue(Node* node)
+{
+    node->next.store(nullptr, std::memory_order_relaxed);
+    Node* previous = _head.exchange(node, std::memory_order_acq_rel);
+    previous->next.store(node, std::memory_order_release);
+}
+
+FunctionQueue::Node* FunctionQueue::dequeue()
+{
+    Node* tail = _tail;
+    Node* next = tail->next.load(std::memory_order_acquire);
+    if (tail == &_stub)
+    {
+        if (next == nullptr)
+            return nullptr;
+        _tail = next;
+        tail = next;
+        next = next->next.load(std::memory_order_acquire);
+    }
+    if (next)
+    {
+        _tail = next;
+        return tail;
+    }
+
+    // a producer has exchanged the head but not linked its node yet, try again later
+    if (tail != _head.load(std::memory_order_acquire))
+        return nullptr;
+
+    // tail is the last node, put the stub behind it so that it can be handed out
+    enqueue(&_stub);
+    next = tail->next.load(std::memory_order_acquire);
+    if (next)
+    {
+        _tail = next;
+        return tail;
+    }
+    return nullptr;
+}
+
+void FunctionQueue::discardNode(Node* node)
+{
+    if (node == &_marker)
+    {
+        _markerQueued = false;
+        return;
+    }
+    if (node->invoke)
+    {
+        node->destroy(&node->storage);
+    }
+    else
+    {
+        _pendingClears.fetch_sub(1, std::memory_order_relaxed);
+    }
+    freeNode(node);
+}
+
+void FunctionQueue::clear()
+{
+    Node* node = allocateNode();
+    node->invoke = nullptr;
+    node->destroy = nullptr;
+    // counted before it is linked, the cocos thread may discard it as soon as it is enqueued
+    _pendingClears.fetch_add(1, std::memory_order_release);
+    enqueue(node);
+}
+
+bool FunctionQueue::empty() const
+{
+    Node* tail = _tail;
+    return (tail == &_stub || tail == &_marker) && tail == _head.load(std::memory_order_acquire);
+}
+
+size_t FunctionQueue::performAll(float timeBudget)
+{
+    // everything in front of a clear node is dropped, if one is not linked yet retry on the next call
+    while (_pendingClears.load(std::memory_order_acquire) > 0)
+    {
+        Node* node = dequeue();
+        if (!node)
+            return 0;
+        discardNode(node);
+    }
+
+    if (empty())
+        return 0;
+
+    if (_markerQueued)
+    {
+        // left behind by a call that ran out of budget, what follows it was queued before this call
+        _markerIsStale = true;
+    }
+    else
+    {
+        enqueue(&_marker);
+        _markerQueued = true;
+        _markerIsStale = false;
+    }
+
+    typedef std::chrono::steady_clock Clock;
+    const auto start = timeBudget > 0 ? Clock::now() : Clock::time_point();
+    size_t count = 0;
+    while (Node* node = dequeue())
+    {
+        if (node == &_marker)
+        {
+            _markerQueued = false;
+            if (!_markerIsStale)
+                break;
+            enqueue(&_marker);
+            _markerQueued = true;
+            _markerIsStale = false;
+            continue;
+        }
+        if (!node->invoke)
+        {
+            // a clear() that raced with this loop, everything in front of it is consumed already
+            discardNode(node);
+            continue;
+        }
+
+        node->invoke(&node->storage);
+        node->destroy(&node->storage);
+        freeNode(node);
+        ++count;
+
+        if (timeBudget > 0 && std::chrono::duration<float>(Clock::now() - start).count() >= timeBudget)
+            break;
+    }
+    return count;
+}
+
+NS_CC_END
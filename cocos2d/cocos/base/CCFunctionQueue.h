@@ -0,0 +1,152 @@
+/****************************************************************************
+Copyright (c) 2019 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#ifndef __cocos2dx__CCFunctionQueue__
+#define __cocos2dx__CCFunctionQueue__
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "platform/CCPlatformMacros.h"
+
+/**
+ * @addtogroup base
+ * @{
+ */
+
+NS_CC_BEGIN
+
+/**
+ * @cond DO_NOT_SHOW
+ * Multi-producer, single-consumer queue of `void()` callables, used by
+ * Scheduler::performFunctionInCocosThread.
+ *
+ * push() may be called from any thread and never takes a lock: nodes come from a pool
+ * guarded by a tagged free list and are linked with a single atomic exchange. Callables
+ * up to INLINE_STORAGE_SIZE bytes (which includes a moved-in std::function) are constructed
+ * inside the node, bigger ones are moved to the heap.
+ *
+ * performAll() and the destructor must only be called from the consumer thread. clear() may
+ * be called from any thread, the discarded callables are destroyed by the next performAll().
+ */
+class CC_DLL FunctionQueue
+{
+public:
+    FunctionQueue();
+    ~FunctionQueue();
+
+    /** Queues a callable, thread safe. */
+    template <typename F>
+    void push(F&& function)
+    {
+        typedef typename std::decay<F>::type Callable;
+        Node* node = allocateNode();
+        storeCallable<Callable>(node, std::forward<F>(function),
+            std::integral_constant<bool, sizeof(Callable) <= INLINE_STORAGE_SIZE
+                                      && alignof(Callable) <= alignof(Storage)>());
+        enqueue(node);
+    }
+
+    /**
+     * Runs the queued callables in order. Callables queued while running are left for the next call.
+     * @param timeBudget If greater than 0, stops once this many seconds have been spent. At least one callable runs.
+     * @return The number of callables that were run.
+     */
+    size_t performAll(float timeBudget = 0);
+
+    /** Discards all callables queued before this call without running them, thread safe. They are destroyed by the next performAll(). */
+    void clear();
+
+    /** Returns true if nothing is queued. Only exact on the consumer thread. */
+    bool empty() const;
+
+private:
+    static const size_t INLINE_STORAGE_SIZE = 64;
+    typedef std::aligned_storage<INLINE_STORAGE_SIZE>::type Storage;
+
+    struct Node
+    {
+        std::atomic<Node*> next;
+        std::atomic<uint32_t> nextFree;
+        uint32_t index;
+        void (*invoke)(void* storage);
+        void (*destroy)(void* storage);
+        Storage storage;
+    };
+
+    template <typename Callable, typename F>
+    static void storeCallable(Node* node, F&& function, std::true_type /*inline*/)
+    {
+        new (&node->storage) Callable(std::forward<F>(function));
+        node->invoke = [](void* storage) { (*static_cast<Callable*>(storage))(); };
+        node->destroy = [](void* storage) { static_cast<Callable*>(storage)->~Callable(); };
+    }
+
+    template <typename Callable, typename F>
+    static void storeCallable(Node* node, F&& function, std::false_type /*inline*/)
+    {
+        new (&node->storage) Callable*(new Callable(std::forward<F>(function)));
+        node->invoke = [](void* storage) { (**static_cast<Callable**>(storage))(); };
+        node->destroy = [](void* storage) { delete *static_cast<Callable**>(storage); };
+    }
+
+    Node* allocateNode();
+    void freeNode(Node* node);
+    Node* nodeAt(uint32_t index) const;
+    bool growPool();
+    void enqueue(Node* node);
+    Node* dequeue();
+    void discardNode(Node* node);
+
+    // producers exchange _head, the consumer owns _tail
+    std::atomic<Node*> _head;
+    Node* _tail;
+    Node _stub;
+    // enqueued by performAll() so that callables queued while running are deferred
+    Node _marker;
+    bool _markerQueued;
+    bool _markerIsStale;
+    // clear() enqueues a node without callable and bumps this counter
+    std::atomic<uint32_t> _pendingClears;
+
+    // free list head, the low 32 bits are the node index, the high 32 bits a tag against ABA
+    std::atomic<uint64_t> _freeHead;
+    std::atomic<Node*>* _chunks;
+    uint32_t _chunkCount;
+    std::mutex _growMutex;
+
+    CC_DISALLOW_COPY_AND_ASSIGN(FunctionQueue);
+};
+/** @endcond */
+
+NS_CC_END
+
+// end of base group
+/** @} */
+
+#endif // __cocos2dx__CCFunctionQueue__
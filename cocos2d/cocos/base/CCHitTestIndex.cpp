@@ -0,0 +1,152 @@
+/****************************************************************************
+Copyright (c) 2019 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#include "base/CCHitTestIndex.h"
+
+#include <algorithm>
+#include <cmath>
+
+NS_CC_BEGIN
+
+const float HitTestIndex::DEFAULT_CELL_SIZE = 128.0f;
+
+HitTestIndex::HitTestIndex(float cellSize)
+: _cellSize(cellSize)
+{
+}
+
+int HitTestIndex::cellCoordinate(float value) const
+{
+    // clamp so that huge or infinite bounds don't overflow the cell coordinates
+    float cell = std::floor(value / _cellSize);
+    return static_cast<int>(std::max(-1e9f, std::min(cell, 1e9f)));
+}
+
+bool HitTestIndex::update(Node* node, const Rect& bounds)
+{
+    Entry entry;
+    entry.bounds = bounds;
+    entry.minX = cellCoordinate(bounds.getMinX());
+    entry.minY = cellCoordinate(bounds.getMinY());
+    entry.maxX = cellCoordinate(bounds.getMaxX());
+    entry.maxY = cellCoordinate(bounds.getMaxY());
+    entry.large = (static_cast<std::int64_t>(entry.maxX - entry.minX + 1) * (entry.maxY - entry.minY + 1) > MAX_CELLS_PER_NODE);
+
+    auto iter = _entries.find(node);
+    if (iter == _entries.end())
+    {
+        insertCells(node, entry);
+        _entries.emplace(node, entry);
+        return true;
+    }
+
+    Entry& current = iter->second;
+    // moving inside the same cells is the common case, only the bounds change
+    if (current.minX != entry.minX || current.minY != entry.minY || current.maxX != entry.maxX || current.maxY != entry.maxY)
+    {
+        removeCells(node, current);
+        insertCells(node, entry);
+    }
+    current = entry;
+    return false;
+}
+
+bool HitTestIndex::remove(Node* node)
+{
+    auto iter = _entries.find(node);
+    if (iter == _entries.end())
+        return false;
+
+    removeCells(node, iter->second);
+    _entries.erase(iter);
+    return true;
+}
+
+void HitTestIndex::clear()
+{
+    _entries.clear();
+    _cells.clear();
+    _largeNodes.clear();
+}
+
+const Rect* HitTestIndex::getBounds(Node* node) const
+{
+    auto iter = _entries.find(node);
+    return iter != _entries.end() ? &iter->second.bounds : nullptr;
+}
+
+void HitTestIndex::insertCells(Node* node, const Entry& entry)
+{
+    if (entry.large)
+    {
+        _largeNodes.push_back(node);
+        return;
+    }
+
+    for (int x = entry.minX; x <= entry.maxX; ++x)
+    {
+        for (int y = entry.minY; y <= entry.maxY; ++y)
+        {
+            _cells[cellKey(x, y)].push_back(node);
+        }
+    }
+}
+
+void HitTestIndex::removeCells(Node* node, const Entry& entry)
+{
+    if (entry.large)
+    {
+        auto iter = std::find(_largeNodes.begin(), _largeNodes.end(), node);
+        if (iter != _largeNodes.end())
+        {
+            *iter = _largeNodes.back();
+            _largeNodes.pop_back();
+        }
+        return;
+    }
+
+    for (int x = entry.minX; x <= entry.maxX; ++x)
+    {
+        for (int y = entry.minY; y <= entry.maxY; ++y)
+        {
+            auto cell = _cells.find(cellKey(x, y));
+            if (cell == _cells.end())
+                continue;
+
+            auto& nodes = cell->second;
+            auto iter = std::find(nodes.begin(), nodes.end(), node);
+            if (iter != nodes.end())
+            {
+                *iter = nodes.back();
+                nodes.pop_back();
+            }
+            if (nodes.empty())
+            {
+                _cells.erase(cell);
+            }
+        }
+    }
+}
+
+NS_CC_END
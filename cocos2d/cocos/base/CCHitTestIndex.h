@@ -0,0 +1,136 @@
+/****************************************************************************
+Copyright (c) 2019 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#ifndef __cocos2dx__CCHitTestIndex__
+#define __cocos2dx__CCHitTestIndex__
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "platform/CCPlatformMacros.h"
+#include "math/CCGeometry.h"
+
+/**
+ * @addtogroup base
+ * @{
+ */
+
+NS_CC_BEGIN
+
+class Node;
+
+/**
+ * Uniform grid of node bounds in world space, used by EventDispatcher to find the nodes under a touch
+ * without asking every listener.
+ *
+ * A node is stored in every cell its bounds overlap. Nodes overlapping more than MAX_CELLS_PER_NODE
+ * cells, like full screen layers, are kept in a separate list which every query checks.
+ */
+class CC_DLL HitTestIndex
+{
+public:
+    /** The default size of a grid cell, in points. */
+    static const float DEFAULT_CELL_SIZE;
+
+    /** Nodes overlapping more cells than this are not stored in the grid. */
+    static const int MAX_CELLS_PER_NODE = 64;
+
+    explicit HitTestIndex(float cellSize = DEFAULT_CELL_SIZE);
+
+    /** Sets the bounds of a node, adding it if needed.
+     * @return true if the node was added.
+     */
+    bool update(Node* node, const Rect& bounds);
+
+    /** Removes a node.
+     * @return true if the node was in the index.
+     */
+    bool remove(Node* node);
+
+    /** Removes all the nodes. */
+    void clear();
+
+    /** Whether the node is in the index. */
+    bool contains(Node* node) const { return _entries.find(node) != _entries.end(); }
+
+    /** Gets the bounds of a node, nullptr if it isn't in the index. */
+    const Rect* getBounds(Node* node) const;
+
+    /** Appends the nodes whose bounds contain the point to result, in no particular order. */
+    template <typename Container>
+    void query(const Vec2& point, Container& result) const
+    {
+        auto cell = _cells.find(cellKey(cellCoordinate(point.x), cellCoordinate(point.y)));
+        if (cell != _cells.end())
+        {
+            for (auto node : cell->second)
+            {
+                if (_entries.find(node)->second.bounds.containsPoint(point))
+                    result.push_back(node);
+            }
+        }
+        for (auto node : _largeNodes)
+        {
+            if (_entries.find(node)->second.bounds.containsPoint(point))
+                result.push_back(node);
+        }
+    }
+
+    /** Returns the number of nodes. */
+    size_t size() const { return _entries.size(); }
+
+    bool empty() const { return _entries.empty(); }
+
+private:
+    struct Entry
+    {
+        Rect bounds;
+        int minX;
+        int minY;
+        int maxX;
+        int maxY;
+        bool large;
+    };
+
+    int cellCoordinate(float value) const;
+    static std::int64_t cellKey(int x, int y) { return (static_cast<std::int64_t>(x) << 32) | static_cast<std::uint32_t>(y); }
+
+    void insertCells(Node* node, const Entry& entry);
+    void removeCells(Node* node, const Entry& entry);
+
+    std::unordered_map<Node*, Entry> _entries;
+    std::unordered_map<std::int64_t, std::vector<Node*>> _cells;
+    std::vector<Node*> _largeNodes;
+    float _cellSize;
+
+    CC_DISALLOW_COPY_AND_ASSIGN(HitTestIndex);
+};
+
+NS_CC_END
+
+// end of base group
+/** @} */
+
+#endif // __cocos2dx__CCHitTestIndex__
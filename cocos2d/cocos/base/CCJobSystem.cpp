@@ -0,0 +1,129 @@
+/****************************************************************************
+Copyright (c) 2019 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#include "base/CCJobSystem.h"
+
+NS_CC_BEGIN
+
+JobSystem* JobSystem::s_sharedJobSystem = nullptr;
+
+JobSystem* JobSystem::getInstance()
+{
+    if (s_sharedJobSystem == nullptr)
+    {
+        unsigned int cores = std::thread::hardware_concurrency();
+        s_sharedJobSystem = new (std::nothrow) JobSystem(cores > 1 ? cores - 1 : 0);
+    }
+    return s_sharedJobSystem;
+}
+
+void JobSystem::destroyInstance()
+{
+    delete s_sharedJobSystem;
+    s_sharedJobSystem = nullptr;
+}
+
+JobSystem::JobSystem(unsigned int workerCount)
+: _job(nullptr)
+, _jobCount(0)
+, _nextJob(0)
+, _busyWorkers(0)
+, _generation(0)
+, _stop(false)
+{
+    for (unsigned int i = 0; i < workerCount; ++i)
+        _workers.emplace_back(&JobSystem::workerLoop, this);
+}
+
+JobSystem::~JobSystem()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stop = true;
+    }
+    _workAvailable.notify_all();
+    for (auto& worker : _workers)
+        worker.join();
+}
+
+void JobSystem::parallelFor(int count, const std::function<void(int)>& job)
+{
+    if (count <= 0)
+        return;
+
+    // a call made from a job finds the lock taken by the call that is running the job
+    std::unique_lock<std::mutex> callLock(_callMutex, std::defer_lock);
+    if (_workers.empty() || count == 1 || !callLock.try_lock())
+    {
+        for (int i = 0; i < count; ++i)
+            job(i);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _job = &job;
+        _jobCount = count;
+        _nextJob = 0;
+        _busyWorkers = static_cast<int>(_workers.size());
+        ++_generation;
+    }
+    _workAvailable.notify_all();
+
+    runJobs();
+
+    // the workers may still be running the last jobs they took
+    std::unique_lock<std::mutex> lock(_mutex);
+    _workDone.wait(lock, [this] { return _busyWorkers == 0; });
+    _job = nullptr;
+}
+
+void JobSystem::workerLoop()
+{
+    unsigned int generation = 0;
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _workAvailable.wait(lock, [&] { return _stop || _generation != generation; });
+            if (_stop)
+                return;
+            generation = _generation;
+        }
+
+        runJobs();
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (--_busyWorkers == 0)
+            _workDone.notify_one();
+    }
+}
+
+void JobSystem::runJobs()
+{
+    for (int i = _nextJob++; i < _jobCount; i = _nextJob++)
+        (*_job)(i);
+}
+
+NS_CC_END
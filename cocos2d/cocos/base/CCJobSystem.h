@@ -0,0 +1,100 @@
+/****************************************************************************
+Copyright (c) 2019 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#ifndef __cocos2dx__CCJobSystem__
+#define __cocos2dx__CCJobSystem__
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "platform/CCPlatformMacros.h"
+
+/**
+ * @addtogroup base
+ * @{
+ */
+
+NS_CC_BEGIN
+
+/**
+ * Fork/join pool of worker threads for per frame work that can be split into independent jobs.
+ *
+ * parallelFor() hands the jobs out to the workers and to the calling thread and only returns once
+ * all of them have run, so the caller can use the results right away. Unlike AsyncTaskPool nothing
+ * is queued past the call and no callback is posted to the cocos thread.
+ * A pool without workers, e.g. on a single core device, runs every job on the calling thread.
+ */
+class CC_DLL JobSystem
+{
+public:
+    /** Returns the shared pool, which has one worker less than the number of cores. */
+    static JobSystem* getInstance();
+
+    /** Stops the workers of the shared pool and deletes it. */
+    static void destroyInstance();
+
+    explicit JobSystem(unsigned int workerCount);
+    ~JobSystem();
+
+    /** Returns the number of worker threads, the calling thread of parallelFor() is not counted. */
+    unsigned int getWorkerCount() const { return static_cast<unsigned int>(_workers.size()); }
+
+    /**
+     * Calls job(i) for every i in [0, count) and returns when all the calls have returned.
+     * Jobs must not touch anything shared with the other jobs of the same call. Calls made
+     * from inside a job, or while another thread is in parallelFor(), run on the calling thread.
+     */
+    void parallelFor(int count, const std::function<void(int)>& job);
+
+private:
+    void workerLoop();
+    void runJobs();
+
+    static JobSystem* s_sharedJobSystem;
+
+    std::vector<std::thread> _workers;
+    std::mutex _mutex;
+    std::mutex _callMutex;
+    std::condition_variable _workAvailable;
+    std::condition_variable _workDone;
+    const std::function<void(int)>* _job;
+    int _jobCount;
+    std::atomic<int> _nextJob;
+    int _busyWorkers;
+    unsigned int _generation;
+    bool _stop;
+
+    CC_DISALLOW_COPY_AND_ASSIGN(JobSystem);
+};
+
+NS_CC_END
+
+// end of base group
+/** @} */
+
+#endif // __cocos2dx__CCJobSystem__
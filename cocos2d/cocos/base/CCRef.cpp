@@ -147,6 +147,9 @@ void Ref::release()
 #if CC_REF_LEAK_DETECTION
         untrackRef(this);
 #endif
+        if (PoolManager::deferDestruction(this))
+            return;
+
         delete this;
     }
 }
@@ -62,12 +62,18 @@ typedef struct _hashSelectorEntry
 {
     ccArray             *timers;
     void                *target;
-    int                 timerIndex;
-    Timer               *currentTimer;
+    double              pausedAt;   // scheduler clock when the target got paused
     bool                paused;
     UT_hash_handle      hh;
 } tHashTimerEntry;
 
+// Timer::_queueIndex values for timers that are not in the scheduler timer queue
+namespace
+{
+    const int TIMER_NOT_QUEUED = -1;    // unscheduled, or its target is paused
+    const int TIMER_DUE = -2;           // taken from the queue, will be updated in this frame
+}
+
 // implementation Timer
 
 Timer::Timer()
@@ -80,6 +86,10 @@ Timer::Timer()
 , _delay(0.0f)
 , _interval(0.0f)
 , _aborted(false)
+, _lastUpdate(0.0)
+, _deadline(0.0)
+, _sequence(0)
+, _queueIndex(TIMER_NOT_QUEUED)
 {
 }
 
@@ -151,6 +161,17 @@ bool Timer::isExhausted() const
     return !_runForever && _timesExecuted > _repeat;
 }
 
+float Timer::getTimeToNextTrigger() const
+{
+    if (_elapsed == -1)
+    {
+        return 0.0f;
+    }
+
+    float remaining = (_useDelay ? _delay : _interval) - _elapsed;
+    return (remaining > 0.0f) ? remaining : 0.0f;
+}
+
 // TimerTargetSelector
 
 TimerTargetSelector::TimerTargetSelector()
@@ -257,15 +278,14 @@ Scheduler::Scheduler(void)
 , _updatesPosList(nullptr)
 , _hashForUpdates(nullptr)
 , _hashForTimers(nullptr)
-, _currentTarget(nullptr)
-, _currentTargetSalvaged(false)
+, _timerClock(0.0)
+, _timerSequence(0)
 , _updateHashLocked(false)
 #if CC_ENABLE_SCRIPT_BINDING
 , _scriptHandlerEntries(20)
 #endif
+, _performFunctionTimeBudget(0.0f)
 {
-    // I don't expect to have more than 30 functions to all per frame
-    _functionsToPerform.reserve(30);
 }
 
 Scheduler::~Scheduler(void)
@@ -280,6 +300,152 @@ void Scheduler::removeHashElement(_hashSelectorEntry *element)
     free(element);
 }
 
+void Scheduler::enqueueTimer(_hashSelectorEntry *element, Timer *timer)
+{
+    // a timer that is (re)started is updated on the next frame of its target
+    if (element->paused)
+    {
+        timer->_lastUpdate = element->pausedAt;
+        return;
+    }
+
+    timer->_lastUpdate = _timerClock;
+    if (timer->_queueIndex >= 0)
+    {
+        removeTimer(timer);
+    }
+    if (timer->_queueIndex != TIMER_DUE)
+    {
+        pushTimer(timer);
+    }
+}
+
+void Scheduler::dequeueTimer(Timer *timer)
+{
+    if (timer->_queueIndex >= 0)
+    {
+        removeTimer(timer);
+    }
+    timer->_queueIndex = TIMER_NOT_QUEUED;
+}
+
+void Scheduler::pauseTimers(_hashSelectorEntry *element)
+{
+    if (element->paused)
+    {
+        return;
+    }
+
+    element->paused = true;
+    element->pausedAt = _timerClock;
+    if (element->timers)
+    {
+        for (int i = 0; i < element->timers->num; ++i)
+        {
+            dequeueTimer(static_cast<Timer*>(element->timers->arr[i]));
+        }
+    }
+}
+
+void Scheduler::resumeTimers(_hashSelectorEntry *element)
+{
+    if (!element->paused)
+    {
+        return;
+    }
+
+    element->paused = false;
+    // the time spent paused does not count for the timers of the target
+    double pausedTime = _timerClock - element->pausedAt;
+    if (element->timers)
+    {
+        for (int i = 0; i < element->timers->num; ++i)
+        {
+            Timer *timer = static_cast<Timer*>(element->timers->arr[i]);
+            if (timer->_queueIndex == TIMER_NOT_QUEUED && !timer->isAborted())
+            {
+                timer->_lastUpdate += pausedTime;
+                pushTimer(timer);
+            }
+        }
+    }
+}
+
+void Scheduler::pushTimer(Timer *timer)
+{
+    timer->_deadline = timer->_lastUpdate + timer->getTimeToNextTrigger();
+    timer->_sequence = _timerSequence++;
+    timer->_queueIndex = static_cast<int>(_timerQueue.size());
+    _timerQueue.push_back(timer);
+    siftTimerUp(_timerQueue.size() - 1);
+}
+
+void Scheduler::removeTimer(Timer *timer)
+{
+    size_t index = static_cast<size_t>(timer->_queueIndex);
+    Timer *last = _timerQueue.back();
+    _timerQueue.pop_back();
+    timer->_queueIndex = TIMER_NOT_QUEUED;
+
+    if (last != timer)
+    {
+        _timerQueue[index] = last;
+        last->_queueIndex = static_cast<int>(index);
+        siftTimerUp(index);
+        siftTimerDown(static_cast<size_t>(last->_queueIndex));
+    }
+}
+
+// true if timer 'a' has to be updated before timer 'b'
+#define TIMER_DUE_BEFORE(a, b) ((a)->_deadline < (b)->_deadline || ((a)->_deadline == (b)->_deadline && (a)->_sequence < (b)->_sequence))
+
+void Scheduler::siftTimerUp(size_t index)
+{
+    Timer *timer = _timerQueue[index];
+    while (index > 0)
+    {
+        size_t parent = (index - 1) / 2;
+        if (!TIMER_DUE_BEFORE(timer, _timerQueue[parent]))
+        {
+            break;
+        }
+        _timerQueue[index] = _timerQueue[parent];
+        _timerQueue[index]->_queueIndex = static_cast<int>(index);
+        index = parent;
+    }
+    _timerQueue[index] = timer;
+    timer->_queueIndex = static_cast<int>(index);
+}
+
+void Scheduler::siftTimerDown(size_t index)
+{
+    const size_t count = _timerQueue.size();
+    Timer *timer = _timerQueue[index];
+    while (true)
+    {
+        size_t child = index * 2 + 1;
+        if (child >= count)
+        {
+            break;
+        }
+        if (child + 1 < count && TIMER_DUE_BEFORE(_timerQueue[child + 1], _timerQueue[child]))
+        {
+            ++child;
+        }
+        if (!TIMER_DUE_BEFORE(_timerQueue[child], timer))
+        {
+            break;
+        }
+        _timerQueue[index] = _timerQueue[child];
+        _timerQueue[index]->_queueIndex = static_cast<int>(index);
+        index = child;
+    }
+    _timerQueue[index] = timer;
+    timer->_queueIndex = static_cast<int>(index);
+}
+
+#undef TIMER_DUE_BEFORE
+
 void Scheduler::schedule(const ccSchedulerFunc& callback, void *target, float interval, bool paused, const std::string& key)
 {
     this->schedule(callback, target, interval, CC_REPEAT_FOREVER, 0.0f, paused, key);
@@ -302,6 +468,7 @@ void Scheduler::schedule(const ccSchedulerFunc& callback, void *target, float in
 
         // Is this the 1st element ? Then set the pause level to all the selectors of this target
         element->paused = paused;
+        element->pausedAt = _timerClock;
     }
     else
     {
@@ -322,6 +489,7 @@ void Scheduler::schedule(const ccSchedulerFunc& callback, void *target, float in
             {
                 CCLOG("CCScheduler#schedule. Reiniting timer with interval %.4f, repeat %u, delay %.4f", interval, repeat, delay);
                 timer->setupTimerWithInterval(interval, repeat, delay);
+                enqueueTimer(element, timer);
                 return;
             }
         }
@@ -331,6 +499,7 @@ void Scheduler::schedule(const ccSchedulerFunc& callback, void *target, float in
     TimerTargetCallback *timer = new (std::nothrow) TimerTargetCallback();
     timer->initWithCallback(this, callback, target, key, interval, repeat, delay);
     ccArrayAppendObject(element->timers, timer);
+    enqueueTimer(element, timer);
     timer->release();
 }
 
@@ -356,30 +525,15 @@ void Scheduler::unschedule(const std::string &key, void *target)
 
             if (timer && key == timer->getKey())
             {
-                if (timer == element->currentTimer && (! timer->isAborted()))
-                {
-                    timer->retain();
-                    timer->setAborted();
-                }
-
+                // aborting stops the catch-up loop of a timer unscheduled from its own callback,
+                // Scheduler::update retains due timers until their callback returns
+                timer->setAborted();
+                dequeueTimer(timer);
                 ccArrayRemoveObjectAtIndex(element->timers, i, true);
 
-                // update timerIndex in case we are in tick:, looping over the actions
-                if (element->timerIndex >= i)
-                {
-                    element->timerIndex--;
-                }
-
                 if (element->timers->num == 0)
                 {
-                    if (_currentTarget == element)
-                    {
-                        _currentTargetSalvaged = true;
-                    }
-                    else
-                    {
-                        removeHashElement(element);
-                    }
+                    removeHashElement(element);
                 }
 
                 return;
@@ -636,22 +790,13 @@ void Scheduler::unscheduleAllForTarget(void *target)
 
     if (element)
     {
-        if (ccArrayContainsObject(element->timers, element->currentTimer)
-            && (! element->currentTimer->isAborted()))
-        {
-            element->currentTimer->retain();
-            element->currentTimer->setAborted();
-        }
-        ccArrayRemoveAllObjects(element->timers);
-
-        if (_currentTarget == element)
-        {
-            _currentTargetSalvaged = true;
-        }
-        else
+        for (int i = 0; i < element->timers->num; ++i)
         {
-            removeHashElement(element);
+            Timer *timer = static_cast<Timer*>(element->timers->arr[i]);
+            timer->setAborted();
+            dequeueTimer(timer);
         }
+        removeHashElement(element);
     }
 
     // update selector
@@ -690,7 +835,7 @@ void Scheduler::resumeTarget(void *target)
     HASH_FIND_PTR(_hashForTimers, &target, element);
     if (element)
     {
-        element->paused = false;
+        resumeTimers(element);
     }
 
     // update selector
@@ -712,7 +857,7 @@ void Scheduler::pauseTarget(void *target)
     HASH_FIND_PTR(_hashForTimers, &target, element);
     if (element)
     {
-        element->paused = true;
+        pauseTimers(element);
     }
 
     // update selector
@@ -761,7 +906,7 @@ std::set<void*> Scheduler::pauseAllTargetsWithMinPriority(int minPriority)
     for(tHashTimerEntry *element = _hashForTimers; element != nullptr;
         element = (tHashTimerEntry*)element->hh.next)
     {
-        element->paused = true;
+        pauseTimers(element);
         idsWithSelectors.insert(element->target);
     }
 
@@ -809,13 +954,11 @@ void Scheduler::resumeTargets(const std::set<void*>& targetsToResume)
 
 void Scheduler::performFunctionInCocosThread(std::function<void ()> function)
 {
-    std::lock_guard<std::mutex> lock(_performMutex);
-    _functionsToPerform.push_back(std::move(function));
+    _functionsToPerform.push(std::move(function));
 }
 
 void Scheduler::removeAllFunctionsToBePerformedInCocosThread()
 {
-    std::unique_lock<std::mutex> lock(_performMutex);
     _functionsToPerform.clear();
 }
 
@@ -863,46 +1006,46 @@ void Scheduler::update(float dt)
         }
     }
 
-    // Iterate over all the custom selectors
-    for (tHashTimerEntry *elt = _hashForTimers; elt != nullptr; )
+    // Update the custom selectors that are due. Timers of running targets wait in a
+    // min-heap ordered by deadline, so the cost depends on the number of due timers
+    // and not on the number of scheduled timers.
+    _timerClock += dt;
+    while (!_timerQueue.empty() && _timerQueue.front()->_deadline <= _timerClock)
     {
-        _currentTarget = elt;
-        _currentTargetSalvaged = false;
+        Timer *timer = _timerQueue.front();
+        removeTimer(timer);
+        timer->_queueIndex = TIMER_DUE;
+        // keep the timer alive while callbacks unschedule it
+        timer->retain();
+        _dueTimers.push_back(timer);
+    }
 
-        if (! _currentTarget->paused)
+    for (auto timer : _dueTimers)
+    {
+        // skip timers unscheduled or paused by a previous callback of this frame
+        if (timer->_queueIndex == TIMER_DUE && !timer->isAborted())
         {
-            // The 'timers' array may change while inside this loop
-            for (elt->timerIndex = 0; elt->timerIndex < elt->timers->num; ++(elt->timerIndex))
-            {
-                elt->currentTimer = (Timer*)(elt->timers->arr[elt->timerIndex]);
-                CCASSERT
-                  ( !elt->currentTimer->isAborted(),
-                    "An aborted timer should not be updated" );
-
-                elt->currentTimer->update(dt);
+            float elapsed = static_cast<float>(_timerClock - timer->_lastUpdate);
+            timer->_lastUpdate = _timerClock;
+            timer->update(elapsed);
 
-                if (elt->currentTimer->isAborted())
+            if (!timer->isAborted())
+            {
+                if (timer->_queueIndex == TIMER_DUE)
                 {
-                    // The currentTimer told the remove itself. To prevent the timer from
-                    // accidentally deallocating itself before finishing its step, we retained
-                    // it. Now that step is done, it's safe to release it.
-                    elt->currentTimer->release();
+                    pushTimer(timer);
+                }
+                else if (timer->_queueIndex >= 0)
+                {
+                    // the target was paused and resumed by the callback, refresh the deadline
+                    removeTimer(timer);
+                    pushTimer(timer);
                 }
-
-                elt->currentTimer = nullptr;
             }
         }
-
-        // elt, at this moment, is still valid
-        // so it is safe to ask this here (issue #490)
-        elt = (tHashTimerEntry *)elt->hh.next;
-
-        // only delete currentTarget if no actions were scheduled during the cycle (issue #481)
-        if (_currentTargetSalvaged && _currentTarget->timers->num == 0)
-        {
-            removeHashElement(_currentTarget);
-        }
+        timer->release();
     }
+    _dueTimers.clear();
  
     // delete all updates that are removed in update
     for (auto &e : _updateDeleteVector)
@@ -911,7 +1054,6 @@ void Scheduler::update(float dt)
     _updateDeleteVector.clear();
 
     _updateHashLocked = false;
-    _currentTarget = nullptr;
 
 #if CC_ENABLE_SCRIPT_BINDING
     //
@@ -939,18 +1081,8 @@ void Scheduler::update(float dt)
     // Functions allocated from another thread
     //
 
-    // Testing size is faster than locking / unlocking.
-    // And almost never there will be functions scheduled to be called.
-    if( !_functionsToPerform.empty() ) {
-        _performMutex.lock();
-        // fixed #4123: Save the callback functions, they must be invoked after '_performMutex.unlock()', otherwise if new functions are added in callback, it will cause thread deadlock.
-        auto temp = std::move(_functionsToPerform);
-        _performMutex.unlock();
-        
-        for (const auto &function : temp) {
-            function();
-        }
-    }
+    // Functions added by a callback are run in the next frame, like they were when the queue was swapped out under a mutex (#4123).
+    _functionsToPerform.performAll(_performFunctionTimeBudget);
 }
 
 void Scheduler::schedule(SEL_SCHEDULE selector, Ref *target, float interval, unsigned int repeat, float delay, bool paused)
@@ -969,6 +1101,7 @@ void Scheduler::schedule(SEL_SCHEDULE selector, Ref *target, float interval, uns
         
         // Is this the 1st element ? Then set the pause level to all the selectors of this target
         element->paused = paused;
+        element->pausedAt = _timerClock;
     }
     else
     {
@@ -989,6 +1122,7 @@ void Scheduler::schedule(SEL_SCHEDULE selector, Ref *target, float interval, uns
             {
                 CCLOG("CCScheduler#schedule. Reiniting timer with interval %.4f, repeat %u, delay %.4f", interval, repeat, delay);
                 timer->setupTimerWithInterval(interval, repeat, delay);
+                enqueueTimer(element, timer);
                 return;
             }
         }
@@ -998,6 +1132,7 @@ void Scheduler::schedule(SEL_SCHEDULE selector, Ref *target, float interval, uns
     TimerTargetSelector *timer = new (std::nothrow) TimerTargetSelector();
     timer->initWithSelector(this, selector, target, interval, repeat, delay);
     ccArrayAppendObject(element->timers, timer);
+    enqueueTimer(element, timer);
     timer->release();
 }
 
@@ -1056,30 +1191,13 @@ void Scheduler::unschedule(SEL_SCHEDULE selector, Ref *target)
             
             if (timer && selector == timer->getSelector())
             {
-                if (timer == element->currentTimer && !timer->isAborted())
-                {
-                    timer->retain();
-                    timer->setAborted();
-                }
-                
+                timer->setAborted();
+                dequeueTimer(timer);
                 ccArrayRemoveObjectAtIndex(element->timers, i, true);
                 
-                // update timerIndex in case we are in tick:, looping over the actions
-                if (element->timerIndex >= i)
-                {
-                    element->timerIndex--;
-                }
-                
                 if (element->timers->num == 0)
                 {
-                    if (_currentTarget == element)
-                    {
-                        _currentTargetSalvaged = true;
-                    }
-                    else
-                    {
-                        removeHashElement(element);
-                    }
+                    removeHashElement(element);
                 }
                 
                 return;
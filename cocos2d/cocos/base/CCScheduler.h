@@ -35,6 +35,7 @@ THE SOFTWARE.
 
 #include "base/CCRef.h"
 #include "base/CCVector.h"
+#include "base/CCFunctionQueue.h"
 #include "base/uthash.h"
 
 NS_CC_BEGIN
@@ -55,6 +56,8 @@ public:
     void setAborted() { _aborted = true; }
     bool isAborted() const { return _aborted; }
     bool isExhausted() const;
+    /** Time left before the timer triggers, 0 if it has to be updated on the next frame. */
+    float getTimeToNextTrigger() const;
     
     virtual void trigger(float dt) = 0;
     virtual void cancel() = 0;
@@ -63,6 +66,8 @@ public:
     void update(float dt);
     
 protected:
+    friend class Scheduler;
+
     Scheduler* _scheduler; // weak ref
     float _elapsed;
     bool _runForever;
@@ -72,6 +77,12 @@ protected:
     float _delay;
     float _interval;
     bool _aborted;
+
+    // Scheduler timer queue bookkeeping
+    double _lastUpdate;     // scheduler clock of the last update, shifted while the target is paused
+    double _deadline;       // scheduler clock at which the timer is due
+    uint64_t _sequence;     // keeps timers due at the same time in scheduling order
+    int _queueIndex;        // slot in the scheduler timer queue, or a negative queue state
 };
 
 
@@ -422,21 +433,49 @@ public:
     void resumeTargets(const std::set<void*>& targetsToResume);
 
     /** Calls a function on the cocos2d thread. Useful when you need to call a cocos2d function from another thread.
-     This function is thread safe.
+     This function is thread safe and lock free.
      @param function The function to be run in cocos2d thread.
      @since v3.0
      @js NA
      */
     void performFunctionInCocosThread(std::function<void()> function);
+
+    /** Calls a callable on the cocos2d thread without wrapping it into a std::function first,
+     so a lambda with small captures is queued without any heap allocation.
+     This function is thread safe and lock free.
+     @param function The callable to be run in cocos2d thread.
+     @js NA
+     @lua NA
+     */
+    template <typename F>
+    void performFunctionInCocosThread(F&& function)
+    {
+        _functionsToPerform.push(std::forward<F>(function));
+    }
     
     /**
      * Remove all pending functions queued to be performed with Scheduler::performFunctionInCocosThread
      * Functions unscheduled in this manner will not be executed
      * This function is thread safe
+     * @note The removal is asynchronous: the functions are dropped by the cocos thread on its next update,
+     * so one that is already running when this is called still finishes, and destructors of the dropped
+     * functions run on the cocos thread.
      * @since v3.14
      * @js NA
      */
     void removeAllFunctionsToBePerformedInCocosThread();
+
+    /** Sets how many seconds per frame may be spent running the functions queued with performFunctionInCocosThread.
+     Functions that don't fit are run in the next frames, at least one function runs per frame.
+     @param seconds The time budget, 0 (the default) means no limit.
+     @js NA
+     */
+    void setPerformFunctionTimeBudget(float seconds) { _performFunctionTimeBudget = seconds; }
+
+    /** Gets the per frame time budget for the functions queued with performFunctionInCocosThread.
+     @js NA
+     */
+    float getPerformFunctionTimeBudget() const { return _performFunctionTimeBudget; }
     
     /////////////////////////////////////
     
@@ -510,6 +549,17 @@ protected:
     void removeHashElement(struct _hashSelectorEntry *element);
     void removeUpdateFromHash(struct _listEntry *entry);
 
+    // timer queue specific
+
+    void enqueueTimer(struct _hashSelectorEntry *element, Timer *timer);
+    void dequeueTimer(Timer *timer);
+    void pauseTimers(struct _hashSelectorEntry *element);
+    void resumeTimers(struct _hashSelectorEntry *element);
+    void pushTimer(Timer *timer);
+    void removeTimer(Timer *timer);
+    void siftTimerUp(size_t index);
+    void siftTimerDown(size_t index);
+
     // update specific
 
     void priorityIn(struct _listEntry **list, const ccSchedulerFunc& callback, void *target, int priority, bool paused);
@@ -529,8 +579,11 @@ protected:
 
     // Used for "selectors with interval"
     struct _hashSelectorEntry *_hashForTimers;
-    struct _hashSelectorEntry *_currentTarget;
-    bool _currentTargetSalvaged;
+    // Min-heap of the timers of running targets ordered by deadline, only due timers are updated each frame
+    std::vector<Timer*> _timerQueue;
+    std::vector<Timer*> _dueTimers;
+    double _timerClock;
+    uint64_t _timerSequence;
     // If true unschedule will not remove anything from a hash. Elements will only be marked for deletion.
     bool _updateHashLocked;
     
@@ -539,8 +592,8 @@ protected:
 #endif
     
     // Used for "perform Function"
-    std::vector<std::function<void()>> _functionsToPerform;
-    std::mutex _performMutex;
+    FunctionQueue _functionsToPerform;
+    float _performFunctionTimeBudget;
 };
 
 // end of base group
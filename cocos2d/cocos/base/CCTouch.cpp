@@ -29,6 +29,8 @@
 
 NS_CC_BEGIN
 
+CC_DEFINE_ALLOCATOR_POOL(Touch, 16)
+
 // returns the current touch location in screen coordinates
 Vec2 Touch::getLocationInView() const 
 { 
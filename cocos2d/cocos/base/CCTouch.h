@@ -29,6 +29,7 @@ THE SOFTWARE.
 
 #include "base/CCRef.h"
 #include "math/CCGeometry.h"
+#include "base/allocator/CCAllocatorStrategyPool.h"
 
 NS_CC_BEGIN
 
@@ -44,6 +45,8 @@ NS_CC_BEGIN
 class CC_DLL Touch : public Ref
 {
 public:
+    CC_DECLARE_ALLOCATOR_POOL(Touch)
+
     /** 
      * Dispatch mode, how the touches are dispatched.
      * @js NA
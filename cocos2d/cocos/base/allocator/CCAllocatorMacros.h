@@ -28,6 +28,8 @@
 #define CC_ALLOCATOR_MACROS_H
 /// @cond DO_NOT_SHOW
 
+#include <new>
+
 #include "base/ccConfig.h"
 #include "platform/CCPlatformMacros.h"
 
@@ -78,14 +80,49 @@
 
     // @brief helper macro for overriding new/delete operators for a class.
     // This correctly passes the size in the deallocate method which is needed.
+    // The nothrow and placement forms are declared as well since a class scope operator new
+    // hides all global ones, and the engine creates objects with new (std::nothrow).
     #define CC_USE_ALLOCATOR_POOL(T, A) \
         CC_ALLOCATOR_INLINE void* operator new (size_t size) \
         { \
-            return (void*)A.allocate(size); \
+            return A.allocateStorage(size); \
+        } \
+        CC_ALLOCATOR_INLINE void* operator new (size_t size, const std::nothrow_t&) \
+        { \
+            return A.allocateStorage(size); \
+        } \
+        CC_ALLOCATOR_INLINE void* operator new (size_t, void* address) \
+        { \
+            return address; \
         } \
         CC_ALLOCATOR_INLINE void operator delete (void* object, size_t size) \
         { \
-            A.deallocate((T*)object, size); \
+            A.deallocateStorage(object, size); \
+        } \
+        CC_ALLOCATOR_INLINE void operator delete (void* object, const std::nothrow_t&) \
+        { \
+            A.deallocateStorage(object, 0); \
+        } \
+        CC_ALLOCATOR_INLINE void operator delete (void*, void*) \
+        { \
+        }
+
+    // @brief declares a pool for objects of exactly class T and routes new/delete of T through it.
+    // Subclasses inherit the operators, objects of a different size fall back to the global allocator.
+    // The pool takes a spin lock, so objects of T may be created and destroyed on any thread.
+    // Must be placed in a public section, pair it with CC_DEFINE_ALLOCATOR_POOL in the source file.
+    #define CC_DECLARE_ALLOCATOR_POOL(T) \
+        static NS_CC_ALLOCATOR::AllocatorStrategyPool<T, NS_CC_ALLOCATOR::ObjectTraits<T>, NS_CC_ALLOCATOR::spinlock_semantics>& getAllocatorPool(); \
+        CC_USE_ALLOCATOR_POOL(T, getAllocatorPool())
+
+    // @brief defines the pool declared with CC_DECLARE_ALLOCATOR_POOL, tagged with the class name.
+    // It is created on first use and never destroyed, objects may still be released by static destructors.
+    // The page size can be overridden with a Configuration value named like the class.
+    #define CC_DEFINE_ALLOCATOR_POOL(T, pageSize) \
+        NS_CC_ALLOCATOR::AllocatorStrategyPool<T, NS_CC_ALLOCATOR::ObjectTraits<T>, NS_CC_ALLOCATOR::spinlock_semantics>& T::getAllocatorPool() \
+        { \
+            static auto pool = new NS_CC_ALLOCATOR::AllocatorStrategyPool<T, NS_CC_ALLOCATOR::ObjectTraits<T>, NS_CC_ALLOCATOR::spinlock_semantics>(#T, pageSize); \
+            return *pool; \
         }
 
 #else
@@ -105,6 +142,8 @@
 
     // throw these away if not enabled
     #define CC_USE_ALLOCATOR_POOL(...)
+    #define CC_DECLARE_ALLOCATOR_POOL(...)
+    #define CC_DEFINE_ALLOCATOR_POOL(...)
     #define CC_OVERRIDE_GLOBAL_NEWDELETE_WITH_ALLOCATOR(...)
 
 #endif
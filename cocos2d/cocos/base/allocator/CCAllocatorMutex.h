@@ -29,6 +29,8 @@
 /// @cond DO_NOT_SHOW
 
 #include "platform/CCPlatformMacros.h"
+#include <atomic>
+#include <thread>
 
 #if CC_TARGET_PLATFORM == CC_PLATFORM_TIZEN || CC_TARGET_PLATFORM == CC_PLATFORM_IOS || CC_TARGET_PLATFORM == CC_PLATFORM_MAC || CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID || CC_TARGET_PLATFORM == CC_PLATFORM_LINUX
 #include "pthread.h"
@@ -112,6 +114,24 @@ struct locking_semantics
     }
 };
 
+// @param implementation that provides a spin lock, for allocators whose critical sections are a few instructions
+// long so that a thread rarely waits and never needs a kernel object. Not recursive.
+struct spinlock_semantics
+{
+    std::atomic_flag _flag = ATOMIC_FLAG_INIT;
+    CC_ALLOCATOR_INLINE void lock()
+    {
+        while (_flag.test_and_set(std::memory_order_acquire))
+        {
+            std::this_thread::yield();
+        }
+    }
+    CC_ALLOCATOR_INLINE void unlock()
+    {
+        _flag.clear(std::memory_order_release);
+    }
+};
+
 // @param implementation that provides lockless semantics that should optimize away.
 struct lockless_semantics
 {
@@ -93,8 +93,8 @@ public:
         while (_pages)
         {
             intptr_t* page = (intptr_t*)_pages;
-            intptr_t* next = (intptr_t*)*page;
-            ccAllocatorGlobal.deallocate(page);
+            intptr_t* next = (intptr_t*)page[0];
+            ccAllocatorGlobal.deallocate((void*)page[1]);
             _pages = (void*)next;
         }
     }
@@ -138,21 +138,9 @@ public:
         return true; // since everything uses the global allocator, we can just lie and say we own this address.
 #else
         lock_traits::lock();
-        
-        const uint8_t* const a = (const uint8_t* const)address;
-        const uint8_t* p = (uint8_t*)_pages;
-        const size_t pSize = pageSize();
-        while (p)
-        {
-            if (a >= p && a < (p + pSize))
-            {
-                lock_traits::unlock();
-                return true;
-            }
-            p = (uint8_t*)(*(uintptr_t*)p);
-        }
+        bool result = ownsUnlocked(address);
         lock_traits::unlock();
-        return false;
+        return result;
 #endif
     }
     
@@ -168,6 +156,21 @@ public:
     
 protected:
     
+    // @brief owns() without taking the lock, for callers that already hold it.
+    CC_ALLOCATOR_INLINE bool ownsUnlocked(const void* const address) const
+    {
+        const uint8_t* const a = (const uint8_t* const)address;
+        const uint8_t* p = (uint8_t*)_pages;
+        const size_t pSize = pageSize();
+        while (p)
+        {
+            if (a >= p && a < (p + pSize))
+                return true;
+            p = (uint8_t*)(*(uintptr_t*)p);
+        }
+        return false;
+    }
+    
     // @brief Method to push an allocated block onto the free list.
     // No check is made that the block hasn't been already added to this allocator.
     CC_ALLOCATOR_INLINE void push_front(void* block)
@@ -177,7 +180,7 @@ protected:
 
 #if COCOS2D_DEBUG
         // additional debug build checks
-        CC_ASSERT(true == owns(block));
+        CC_ASSERT(true == ownsUnlocked(block));
 #endif
         
         if (nullptr == _list)
@@ -221,33 +224,39 @@ protected:
     
 protected:
         
+    // @brief Returns the distance between two blocks. Small blocks are rounded to the next power of two,
+    // larger ones only to kDefaultAlignment so that pools of big objects don't waste up to half of their memory.
+    size_t blockStride() const
+    {
+        return block_size < AllocatorBase::kDefaultAlignment
+            ? AllocatorBase::nextPow2BlockSize(block_size)
+            : (block_size + AllocatorBase::kDefaultAlignment - 1) & ~(size_t)(AllocatorBase::kDefaultAlignment - 1);
+    }
+
     // @brief Returns the size of a page in bytes + overhead.
     size_t pageSize() const
     {
-        return AllocatorBase::kDefaultAlignment + AllocatorBase::nextPow2BlockSize(block_size) * _pageSize;
+        return AllocatorBase::kDefaultAlignment + blockStride() * _pageSize;
     }
     
     // @brief Allocates a new page from the global allocator,
     // and adds all the blocks to the free list.
     CC_ALLOCATOR_INLINE void allocatePage()
     {
-        uint8_t* p = (uint8_t*)AllocatorBase::aligned(ccAllocatorGlobal.allocate(pageSize()));
+        static_assert(2 * sizeof(intptr_t) <= AllocatorBase::kDefaultAlignment, "page header must fit in the default alignment");
+        // the global allocator may only align to 8 bytes, allocate enough to align the page ourselves
+        // and keep the original address behind the link to the next page so it can be freed.
+        void* memory = ccAllocatorGlobal.allocate(pageSize() + AllocatorBase::kDefaultAlignment);
+        uint8_t* p = (uint8_t*)AllocatorBase::aligned(memory);
         intptr_t* page = (intptr_t*)p;
-        if (nullptr == _pages)
-        {
-            _pages = page;
-            *page = 0;
-        }
-        else
-        {
-            *page = (intptr_t)_pages;
-            _pages = page;
-        }
+        page[0] = (intptr_t)_pages;
+        page[1] = (intptr_t)memory;
+        _pages = page;
         
         p += AllocatorBase::kDefaultAlignment; // step past the linked list node
         
         _allocated += _pageSize;
-        size_t aligned_size = AllocatorBase::nextPow2BlockSize(block_size);
+        size_t aligned_size = blockStride();
         uint8_t* block = (uint8_t*)p;
         for (unsigned int i = 0; i < _pageSize; ++i, block += aligned_size)
         {
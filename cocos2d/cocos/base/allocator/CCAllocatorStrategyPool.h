@@ -28,6 +28,7 @@
 #define CC_ALLOCATOR_STRATEGY_POOL_H
 /// @cond DO_NOT_SHOW
 
+#include <atomic>
 #include <vector>
 #include <typeinfo>
 #include <sstream>
@@ -36,11 +37,17 @@
 #include "base/allocator/CCAllocatorGlobal.h"
 #include "base/allocator/CCAllocatorStrategyFixedBlock.h"
 #include "base/allocator/CCAllocatorDiagnostics.h"
-#include "base/CCConfiguration.h"
 
 NS_CC_BEGIN
 NS_CC_ALLOCATOR_BEGIN
 
+/**
+ * Returns the number of objects per page configured for a pool in Configuration, or defaultSize.
+ * Lives in a translation unit so that this header doesn't need CCConfiguration.h, which would
+ * make it impossible to use in the headers of the pooled classes.
+ */
+CC_DLL size_t poolSizeFromConfiguration(const char* tag, size_t defaultSize);
+
 /**
  * ObjectTraits describes an allocatable object.
  *
@@ -108,9 +115,12 @@ public:
     
     AllocatorStrategyPool(const char* tag = nullptr, size_t poolSize = 100)
         : tParentStrategy(tag)
+#if CC_ENABLE_ALLOCATOR_DIAGNOSTICS
+        , _allocations(0)
+        , _fallbackAllocations(0)
+#endif
     {
-        poolSize = Configuration::getInstance()->getValue(tag, Value((int)poolSize)).asInt();
-        tParentStrategy::_pageSize = poolSize;
+        tParentStrategy::_pageSize = tag ? poolSizeFromConfiguration(tag, poolSize) : poolSize;
     }
     
     /**
@@ -156,13 +166,61 @@ public:
         }
     }
     
+    /**
+     * Allocate storage for an object of type T without constructing it, used by the new operator.
+     *
+     * If size does not match sizeof(T), e.g. for a subclass of T, then the global allocator is called instead.
+     * @see CC_USE_ALLOCATOR_POOL
+     */
+    CC_ALLOCATOR_INLINE void* allocateStorage(size_t size)
+    {
+#if CC_ENABLE_ALLOCATOR_DIAGNOSTICS
+        ++_allocations;
+#endif
+        if (sizeof(T) == size)
+        {
+            return tParentStrategy::allocate(sizeof(T));
+        }
+#if CC_ENABLE_ALLOCATOR_DIAGNOSTICS
+        ++_fallbackAllocations;
+#endif
+        return ccAllocatorGlobal.allocate(size);
+    }
+
+    /**
+     * Deallocate storage returned by allocateStorage without destroying the object, used by the delete operator.
+     *
+     * A size of 0 means unknown, the pages of the pool are searched then.
+     * @see CC_USE_ALLOCATOR_POOL
+     */
+    CC_ALLOCATOR_INLINE void deallocateStorage(void* address, size_t size)
+    {
+        if (nullptr == address)
+            return;
+
+        if (sizeof(T) == size || (0 == size && tParentStrategy::owns(address)))
+        {
+            tParentStrategy::deallocate(address, sizeof(T));
+        }
+        else
+        {
+            ccAllocatorGlobal.deallocate(address, size);
+        }
+    }
+    
 #if CC_ENABLE_ALLOCATOR_DIAGNOSTICS
     std::string diagnostics() const
     {
         std::stringstream s;
-        s << AllocatorBase::tag() << " initial:" << tParentStrategy::_pageSize << " count:" << tParentStrategy::_allocated << " highest:" << tParentStrategy::_highestCount << "\n";
+        s << AllocatorBase::tag() << " size:" << sizeof(T) << " initial:" << tParentStrategy::_pageSize << " count:" << tParentStrategy::_allocated << " highest:" << tParentStrategy::_highestCount
+          << " allocations:" << _allocations.load() << " fallback:" << _fallbackAllocations.load() << "\n";
         return s.str();
-    }    
+    }
+
+protected:
+    // total number of allocateStorage calls, and those that didn't match sizeof(T), counted outside the lock
+    std::atomic<size_t> _allocations;
+    std::atomic<size_t> _fallbackAllocations;
 #endif
 };
 
@@ -363,6 +363,12 @@ THE SOFTWARE.
 /** @def CC_ENABLE_ALLOCATOR
  * Turn on creation of global allocator and pool allocators
  * as specified by CC_ALLOCATOR_GLOBAL below.
+ * The most frequently created classes (common actions, Sprite, Label, EventCustom,
+ * EventTouch and Touch) get their memory from per class pools then.
+ * These pools take a spin lock, so such objects may also be created and released
+ * on other threads, e.g. EventCustom dispatched by a loader thread.
+ * Off by default, with the lock the pools are only about as fast as a modern malloc,
+ * measure with tests/engine-tests/AllocatorPoolTest before turning them on.
  */
 #ifndef CC_ENABLE_ALLOCATOR
 # define CC_ENABLE_ALLOCATOR 0
@@ -371,9 +377,14 @@ THE SOFTWARE.
 /** @def CC_ENABLE_ALLOCATOR_DIAGNOSTICS
  * Turn on debugging of allocators. This is slower, uses
  * more memory, and should not be used for production builds.
+ * Enabled for debug builds, the "allocator" console command prints the diagnostics.
  */
 #ifndef CC_ENABLE_ALLOCATOR_DIAGNOSTICS
-# define CC_ENABLE_ALLOCATOR_DIAGNOSTICS CC_ENABLE_ALLOCATOR
+# if defined(COCOS2D_DEBUG) && COCOS2D_DEBUG > 0
+#  define CC_ENABLE_ALLOCATOR_DIAGNOSTICS CC_ENABLE_ALLOCATOR
+# else
+#  define CC_ENABLE_ALLOCATOR_DIAGNOSTICS 0
+# endif
 #endif
 
 /** @def CC_ENABLE_ALLOCATOR_GLOBAL_NEW_DELETE
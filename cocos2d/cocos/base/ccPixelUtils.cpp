@@ -0,0 +1,373 @@
+/****************************************************************************
+Copyright (c) 2019 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#include "base/ccPixelUtils.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#include "math/MathUtil.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CC_PIXEL_USE_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+#define CC_PIXEL_USE_NEON
+#include <arm_neon.h>
+#endif
+
+NS_CC_BEGIN
+
+namespace PixelUtils {
+
+namespace Scalar {
+
+void premultiplyAlpha(unsigned char* data, ssize_t pixelCount)
+{
+    for (ssize_t i = 0; i < pixelCount; ++i, data += 4)
+    {
+        unsigned int a = data[3] + 1;
+        data[0] = (unsigned char)((data[0] * a) >> 8);
+        data[1] = (unsigned char)((data[1] * a) >> 8);
+        data[2] = (unsigned char)((data[2] * a) >> 8);
+    }
+}
+
+void convertRGBA8888ToRGBA4444(const unsigned char* data, ssize_t pixelCount, unsigned char* outData)
+{
+    unsigned short* out16 = (unsigned short*)outData;
+    for (ssize_t i = 0; i < pixelCount; ++i, data += 4)
+    {
+        *out16++ = (data[0] & 0x00F0) << 8    //R
+        | (data[1] & 0x00F0) << 4             //G
+        | (data[2] & 0xF0)                    //B
+        |  (data[3] & 0xF0) >> 4;             //A
+    }
+}
+
+void convertRGBA8888ToRGB565(const unsigned char* data, ssize_t pixelCount, unsigned char* outData)
+{
+    unsigned short* out16 = (unsigned short*)outData;
+    for (ssize_t i = 0; i < pixelCount; ++i, data += 4)
+    {
+        *out16++ = (data[0] & 0x00F8) << 8    //R
+            | (data[1] & 0x00FC) << 3         //G
+            | (data[2] & 0x00F8) >> 3;        //B
+    }
+}
+
+void convertRGBA8888ToRGB5A1(const unsigned char* data, ssize_t pixelCount, unsigned char* outData)
+{
+    unsigned short* out16 = (unsigned short*)outData;
+    for (ssize_t i = 0; i < pixelCount; ++i, data += 4)
+    {
+        *out16++ = (data[0] & 0x00F8) << 8    //R
+            | (data[1] & 0x00F8) << 3         //G
+            | (data[2] & 0x00F8) >> 2         //B
+            |  (data[3] & 0x0080) >> 7;       //A
+    }
+}
+
+void convertRGBA8888ToA8(const unsigned char* data, ssize_t pixelCount, unsigned char* outData)
+{
+    for (ssize_t i = 0; i < pixelCount; ++i, data += 4)
+    {
+        *outData++ = data[3]; //A
+    }
+}
+
+} // namespace Scalar
+
+namespace {
+
+#if defined(CC_PIXEL_USE_SSE2)
+
+// Each 32 bit lane holds one little endian pixel: R | G << 8 | B << 16 | A << 24.
+
+// Packs the low 16 bits of each 32 bit lane, _mm_packs_epi32 saturates so sign extend first.
+inline __m128i pack16(__m128i lo, __m128i hi)
+{
+    lo = _mm_srai_epi32(_mm_slli_epi32(lo, 16), 16);
+    hi = _mm_srai_epi32(_mm_slli_epi32(hi, 16), 16);
+    return _mm_packs_epi32(lo, hi);
+}
+
+inline __m128i toRGBA4444(__m128i p)
+{
+    return _mm_or_si128(_mm_or_si128(_mm_and_si128(_mm_slli_epi32(p, 8), _mm_set1_epi32(0xF000)),
+                                     _mm_and_si128(_mm_srli_epi32(p, 4), _mm_set1_epi32(0x0F00))),
+                        _mm_or_si128(_mm_and_si128(_mm_srli_epi32(p, 16), _mm_set1_epi32(0x00F0)),
+                                     _mm_srli_epi32(p, 28)));
+}
+
+inline __m128i toRGB565(__m128i p)
+{
+    return _mm_or_si128(_mm_or_si128(_mm_and_si128(_mm_slli_epi32(p, 8), _mm_set1_epi32(0xF800)),
+                                     _mm_and_si128(_mm_srli_epi32(p, 5), _mm_set1_epi32(0x07E0))),
+                        _mm_and_si128(_mm_srli_epi32(p, 19), _mm_set1_epi32(0x001F)));
+}
+
+inline __m128i toRGB5A1(__m128i p)
+{
+    return _mm_or_si128(_mm_or_si128(_mm_and_si128(_mm_slli_epi32(p, 8), _mm_set1_epi32(0xF800)),
+                                     _mm_and_si128(_mm_srli_epi32(p, 5), _mm_set1_epi32(0x07C0))),
+                        _mm_or_si128(_mm_and_si128(_mm_srli_epi32(p, 18), _mm_set1_epi32(0x003E)),
+                                     _mm_srli_epi32(p, 31)));
+}
+
+template <__m128i (*Convert)(__m128i)>
+ssize_t convertTo16SSE2(const unsigned char* data, ssize_t pixelCount, unsigned char* outData)
+{
+    ssize_t i = 0;
+    for (; i + 8 <= pixelCount; i += 8)
+    {
+        __m128i lo = _mm_loadu_si128((const __m128i*)(data + i * 4));
+        __m128i hi = _mm_loadu_si128((const __m128i*)(data + i * 4 + 16));
+        _mm_storeu_si128((__m128i*)(outData + i * 2), pack16(Convert(lo), Convert(hi)));
+    }
+    return i;
+}
+
+ssize_t premultiplyAlphaSSE2(unsigned char* data, ssize_t pixelCount)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i one = _mm_set1_epi16(1);
+    // 16 bit lanes 3 and 7 hold alpha, multiplying them by 256 keeps alpha unchanged after >> 8
+    const __m128i alphaMask = _mm_set_epi16(-1, 0, 0, 0, -1, 0, 0, 0);
+    const __m128i alphaScale = _mm_and_si128(alphaMask, _mm_set1_epi16(256));
+
+    ssize_t i = 0;
+    for (; i + 4 <= pixelCount; i += 4)
+    {
+        __m128i p = _mm_loadu_si128((const __m128i*)(data + i * 4));
+        __m128i lo = _mm_unpacklo_epi8(p, zero);
+        __m128i hi = _mm_unpackhi_epi8(p, zero);
+
+        __m128i alo = _mm_add_epi16(_mm_shufflehi_epi16(_mm_shufflelo_epi16(lo, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3)), one);
+        __m128i ahi = _mm_add_epi16(_mm_shufflehi_epi16(_mm_shufflelo_epi16(hi, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3)), one);
+        alo = _mm_or_si128(_mm_andnot_si128(alphaMask, alo), alphaScale);
+        ahi = _mm_or_si128(_mm_andnot_si128(alphaMask, ahi), alphaScale);
+
+        // c * (a + 1) <= 255 * 256, fits in 16 bits
+        lo = _mm_srli_epi16(_mm_mullo_epi16(lo, alo), 8);
+        hi = _mm_srli_epi16(_mm_mullo_epi16(hi, ahi), 8);
+        _mm_storeu_si128((__m128i*)(data + i * 4), _mm_packus_epi16(lo, hi));
+    }
+    return i;
+}
+
+ssize_t convertRGBA8888ToA8SSE2(const unsigned char* data, ssize_t pixelCount, unsigned char* outData)
+{
+    ssize_t i = 0;
+    for (; i + 16 <= pixelCount; i += 16)
+    {
+        const __m128i* in = (const __m128i*)(data + i * 4);
+        __m128i a0 = _mm_srli_epi32(_mm_loadu_si128(in), 24);
+        __m128i a1 = _mm_srli_epi32(_mm_loadu_si128(in + 1), 24);
+        __m128i a2 = _mm_srli_epi32(_mm_loadu_si128(in + 2), 24);
+        __m128i a3 = _mm_srli_epi32(_mm_loadu_si128(in + 3), 24);
+        __m128i a = _mm_packus_epi16(_mm_packs_epi32(a0, a1), _mm_packs_epi32(a2, a3));
+        _mm_storeu_si128((__m128i*)(outData + i), a);
+    }
+    return i;
+}
+
+#elif defined(CC_PIXEL_USE_NEON)
+
+ssize_t premultiplyAlphaNEON(unsigned char* data, ssize_t pixelCount)
+{
+    ssize_t i = 0;
+    for (; i + 8 <= pixelCount; i += 8)
+    {
+        uint8x8x4_t p = vld4_u8(data + i * 4);
+        uint16x8_t a = vaddw_u8(vdupq_n_u16(1), p.val[3]);
+        p.val[0] = vshrn_n_u16(vmulq_u16(vmovl_u8(p.val[0]), a), 8);
+        p.val[1] = vshrn_n_u16(vmulq_u16(vmovl_u8(p.val[1]), a), 8);
+        p.val[2] = vshrn_n_u16(vmulq_u16(vmovl_u8(p.val[2]), a), 8);
+        vst4_u8(data + i * 4, p);
+    }
+    return i;
+}
+
+ssize_t convertRGBA8888ToRGBA4444NEON(const unsigned char* data, ssize_t pixelCount, unsigned char* outData)
+{
+    const uint8x8_t mask = vdup_n_u8(0xF0);
+    ssize_t i = 0;
+    for (; i + 8 <= pixelCount; i += 8)
+    {
+        uint8x8x4_t p = vld4_u8(data + i * 4);
+        uint16x8_t out = vorrq_u16(vorrq_u16(vshll_n_u8(vand_u8(p.val[0], mask), 8), vshll_n_u8(vand_u8(p.val[1], mask), 4)),
+                                   vorrq_u16(vmovl_u8(vand_u8(p.val[2], mask)), vmovl_u8(vshr_n_u8(p.val[3], 4))));
+        vst1q_u16((uint16_t*)(outData + i * 2), out);
+    }
+    return i;
+}
+
+ssize_t convertRGBA8888ToRGB565NEON(const unsigned char* data, ssize_t pixelCount, unsigned char* outData)
+{
+    ssize_t i = 0;
+    for (; i + 8 <= pixelCount; i += 8)
+    {
+        uint8x8x4_t p = vld4_u8(data + i * 4);
+        uint16x8_t out = vorrq_u16(vorrq_u16(vshll_n_u8(vand_u8(p.val[0], vdup_n_u8(0xF8)), 8), vshll_n_u8(vand_u8(p.val[1], vdup_n_u8(0xFC)), 3)),
+                                   vmovl_u8(vshr_n_u8(p.val[2], 3)));
+        vst1q_u16((uint16_t*)(outData + i * 2), out);
+    }
+    return i;
+}
+
+ssize_t convertRGBA8888ToRGB5A1NEON(const unsigned char* data, ssize_t pixelCount, unsigned char* outData)
+{
+    const uint8x8_t mask = vdup_n_u8(0xF8);
+    ssize_t i = 0;
+    for (; i + 8 <= pixelCount; i += 8)
+    {
+        uint8x8x4_t p = vld4_u8(data + i * 4);
+        uint16x8_t out = vorrq_u16(vorrq_u16(vshll_n_u8(vand_u8(p.val[0], mask), 8), vshll_n_u8(vand_u8(p.val[1], mask), 3)),
+                                   vorrq_u16(vmovl_u8(vshr_n_u8(vand_u8(p.val[2], mask), 2)), vmovl_u8(vshr_n_u8(p.val[3], 7))));
+        vst1q_u16((uint16_t*)(outData + i * 2), out);
+    }
+    return i;
+}
+
+ssize_t convertRGBA8888ToA8NEON(const unsigned char* data, ssize_t pixelCount, unsigned char* outData)
+{
+    ssize_t i = 0;
+    for (; i + 8 <= pixelCount; i += 8)
+    {
+        uint8x8x4_t p = vld4_u8(data + i * 4);
+        vst1_u8(outData + i, p.val[3]);
+    }
+    return i;
+}
+
+#endif
+
+bool detectSIMD()
+{
+#if defined(CC_PIXEL_USE_SSE2)
+    return true;
+#elif defined(CC_PIXEL_USE_NEON)
+    return MathUtil::isNeon64Enabled() || MathUtil::isNeon32Enabled()
+        || (CC_TARGET_PLATFORM != CC_PLATFORM_ANDROID);
+#else
+    return false;
+#endif
+}
+
+bool s_simdEnabled = detectSIMD();
+
+} // anonymous namespace
+
+bool isSIMDSupported()
+{
+    static const bool supported = detectSIMD();
+    return supported;
+}
+
+bool isSIMDEnabled()
+{
+    return s_simdEnabled;
+}
+
+void setSIMDEnabled(bool enabled)
+{
+    s_simdEnabled = enabled && isSIMDSupported();
+}
+
+// The SIMD kernels process whole blocks and return how many pixels they did, the scalar code finishes the tail.
+
+void premultiplyAlpha(unsigned char* data, ssize_t pixelCount)
+{
+    ssize_t done = 0;
+    if (s_simdEnabled)
+    {
+#if defined(CC_PIXEL_USE_SSE2)
+        done = premultiplyAlphaSSE2(data, pixelCount);
+#elif defined(CC_PIXEL_USE_NEON)
+        done = premultiplyAlphaNEON(data, pixelCount);
+#endif
+    }
+    Scalar::premultiplyAlpha(data + done * 4, pixelCount - done);
+}
+
+void convertRGBA8888ToRGBA4444(const unsigned char* data, ssize_t pixelCount, unsigned char* outData)
+{
+    ssize_t done = 0;
+    if (s_simdEnabled)
+    {
+#if defined(CC_PIXEL_USE_SSE2)
+        done = convertTo16SSE2<toRGBA4444>(data, pixelCount, outData);
+#elif defined(CC_PIXEL_USE_NEON)
+        done = convertRGBA8888ToRGBA4444NEON(data, pixelCount, outData);
+#endif
+    }
+    Scalar::convertRGBA8888ToRGBA4444(data + done * 4, pixelCount - done, outData + done * 2);
+}
+
+void convertRGBA8888ToRGB565(const unsigned char* data, ssize_t pixelCount, unsigned char* outData)
+{
+    ssize_t done = 0;
+    if (s_simdEnabled)
+    {
+#if defined(CC_PIXEL_USE_SSE2)
+        done = convertTo16SSE2<toRGB565>(data, pixelCount, outData);
+#elif defined(CC_PIXEL_USE_NEON)
+        done = convertRGBA8888ToRGB565NEON(data, pixelCount, outData);
+#endif
+    }
+    Scalar::convertRGBA8888ToRGB565(data + done * 4, pixelCount - done, outData + done * 2);
+}
+
+void convertRGBA8888ToRGB5A1(const unsigned char* data, ssize_t pixelCount, unsigned char* outData)
+{
+    ssize_t done = 0;
+    if (s_simdEnabled)
+    {
+#if defined(CC_PIXEL_USE_SSE2)
+        done = convertTo16SSE2<toRGB5A1>(data, pixelCount, outData);
+#elif defined(CC_PIXEL_USE_NEON)
+        done = convertRGBA8888ToRGB5A1NEON(data, pixelCount, outData);
+#endif
+    }
+    Scalar::convertRGBA8888ToRGB5A1(data + done * 4, pixelCount - done, outData + done * 2);
+}
+
+void convertRGBA8888ToA8(const unsigned char* data, ssize_t pixelCount, unsigned char* outData)
+{
+    ssize_t done = 0;
+    if (s_simdEnabled)
+    {
+#if defined(CC_PIXEL_USE_SSE2)
+        done = convertRGBA8888ToA8SSE2(data, pixelCount, outData);
+#elif defined(CC_PIXEL_USE_NEON)
+        done = convertRGBA8888ToA8NEON(data, pixelCount, outData);
+#endif
+    }
+    Scalar::convertRGBA8888ToA8(data + done * 4, pixelCount - done, outData + done);
+}
+
+} // namespace PixelUtils
+
+NS_CC_END
@@ -0,0 +1,90 @@
+/****************************************************************************
+Copyright (c) 2019 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#ifndef __cocos2dx__ccPixelUtils__
+#define __cocos2dx__ccPixelUtils__
+
+#include "platform/CCPlatformMacros.h"
+#include "platform/CCStdC.h" // for ssize_t
+
+/**
+ * @addtogroup base
+ * @{
+ */
+
+NS_CC_BEGIN
+
+/**
+ * Pixel post-processing used by Image and Texture2D while loading textures.
+ *
+ * Every function has a scalar reference implementation and, where the target supports it,
+ * an SSE2 or NEON one which produces bit-exact the same output. The implementation is chosen
+ * once at runtime (NEON needs a CPU check on 32-bit Android), setSIMDEnabled(false) forces the
+ * scalar path, e.g. to compare results or measure the speedup.
+ *
+ * All functions take the number of pixels, the buffers must not overlap unless stated otherwise.
+ */
+namespace PixelUtils {
+
+/** Returns true if an SSE2 or NEON implementation is compiled in and the CPU supports it. */
+CC_DLL bool isSIMDSupported();
+
+/** Returns true if the SIMD implementations are used. */
+CC_DLL bool isSIMDEnabled();
+
+/** Enables or disables the SIMD implementations, it has no effect if isSIMDSupported() is false. */
+CC_DLL void setSIMDEnabled(bool enabled);
+
+/** Premultiplies RGBA8888 pixels in place, each color becomes (c * (a + 1)) >> 8, see CC_RGB_PREMULTIPLY_ALPHA. */
+CC_DLL void premultiplyAlpha(unsigned char* data, ssize_t pixelCount);
+
+/** RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA -> RRRRGGGGBBBBAAAA */
+CC_DLL void convertRGBA8888ToRGBA4444(const unsigned char* data, ssize_t pixelCount, unsigned char* outData);
+
+/** RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA -> RRRRRGGGGGGBBBBB */
+CC_DLL void convertRGBA8888ToRGB565(const unsigned char* data, ssize_t pixelCount, unsigned char* outData);
+
+/** RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA -> RRRRRGGGGGBBBBBA */
+CC_DLL void convertRGBA8888ToRGB5A1(const unsigned char* data, ssize_t pixelCount, unsigned char* outData);
+
+/** RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA -> AAAAAAAA */
+CC_DLL void convertRGBA8888ToA8(const unsigned char* data, ssize_t pixelCount, unsigned char* outData);
+
+/** Scalar reference implementations, always available. */
+namespace Scalar {
+CC_DLL void premultiplyAlpha(unsigned char* data, ssize_t pixelCount);
+CC_DLL void convertRGBA8888ToRGBA4444(const unsigned char* data, ssize_t pixelCount, unsigned char* outData);
+CC_DLL void convertRGBA8888ToRGB565(const unsigned char* data, ssize_t pixelCount, unsigned char* outData);
+CC_DLL void convertRGBA8888ToRGB5A1(const unsigned char* data, ssize_t pixelCount, unsigned char* outData);
+CC_DLL void convertRGBA8888ToA8(const unsigned char* data, ssize_t pixelCount, unsigned char* outData);
+} // namespace Scalar
+
+} // namespace PixelUtils
+
+NS_CC_END
+
+// end of base group
+/** @} */
+
+#endif /** defined(__cocos2dx__ccPixelUtils__) */
@@ -0,0 +1,413 @@
+/****************************************************************************
+Copyright (c) 2019 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#include "base/etc2.h"
+
+#include <string.h>
+
+/* ETC2 is specified in the OpenGL ES 3.0 specification, appendix C.1.
+
+ An ETC2 RGB block is 64 bits stored big-endian in bytes q0..q7. The
+ high 32 bits select the mode and hold the base colors, the low 32 bits
+ hold a 2-bit index per pixel, most significant bits first. The index of
+ pixel (x, y) is at bit (x * 4 + y) of each 16-bit half.
+
+ If the differential bit is 0 the block is an ETC1 "individual" block.
+ Otherwise the 5-bit base color plus the 3-bit signed delta of each channel
+ is evaluated; an overflow of R selects the T mode, of G the H mode and of
+ B the planar mode. Without an overflow the block is an ETC1
+ "differential" block.
+
+ In RGB8A1 the differential bit is the opaque bit and the individual mode
+ does not exist. In a non-opaque block pixel index 2 is transparent black
+ for every mode but planar.
+
+ An RGBA8 block is a 64-bit EAC alpha block followed by an RGB8 block.
+ */
+
+namespace
+{
+    const char kMagic[] = { 'P', 'K', 'M', ' ', '2', '0' };
+
+    const uint32_t PKM_FORMAT_OFFSET = 6;
+    const uint32_t PKM_ENCODED_WIDTH_OFFSET = 8;
+    const uint32_t PKM_ENCODED_HEIGHT_OFFSET = 10;
+    const uint32_t PKM_WIDTH_OFFSET = 12;
+    const uint32_t PKM_HEIGHT_OFFSET = 14;
+
+    const int kModifierTable[8][4] =
+    {
+        { 2, 8, -2, -8 },
+        { 5, 17, -5, -17 },
+        { 9, 29, -9, -29 },
+        { 13, 42, -13, -42 },
+        { 18, 60, -18, -60 },
+        { 24, 80, -24, -80 },
+        { 33, 106, -33, -106 },
+        { 47, 183, -47, -183 },
+    };
+
+    // non-opaque RGB8A1 blocks drop the small modifiers
+    const int kModifierTableNonOpaque[8][4] =
+    {
+        { 0, 8, 0, -8 },
+        { 0, 17, 0, -17 },
+        { 0, 29, 0, -29 },
+        { 0, 42, 0, -42 },
+        { 0, 60, 0, -60 },
+        { 0, 80, 0, -80 },
+        { 0, 106, 0, -106 },
+        { 0, 183, 0, -183 },
+    };
+
+    const int kDistanceTable[8] = { 3, 6, 11, 16, 23, 32, 41, 64 };
+
+    const int kAlphaModifierTable[16][8] =
+    {
+        { -3, -6, -9, -15, 2, 5, 8, 14 },
+        { -3, -7, -10, -13, 2, 6, 9, 12 },
+        { -2, -5, -8, -13, 1, 4, 7, 12 },
+        { -2, -4, -6, -13, 1, 3, 5, 12 },
+        { -3, -6, -8, -12, 2, 5, 7, 11 },
+        { -3, -7, -9, -11, 2, 6, 8, 10 },
+        { -4, -7, -8, -11, 3, 6, 7, 10 },
+        { -3, -5, -8, -11, 2, 4, 7, 10 },
+        { -2, -6, -8, -10, 1, 5, 7, 9 },
+        { -2, -5, -8, -10, 1, 4, 7, 9 },
+        { -2, -4, -8, -10, 1, 3, 7, 9 },
+        { -2, -5, -7, -10, 1, 4, 6, 9 },
+        { -3, -4, -7, -10, 2, 3, 6, 9 },
+        { -1, -2, -3, -10, 0, 1, 2, 9 },
+        { -4, -6, -8, -9, 3, 5, 7, 8 },
+        { -3, -5, -7, -9, 2, 4, 6, 8 },
+    };
+
+    inline uint32_t readBEUint16(const uint8_t *in)
+    {
+        return (in[0] << 8) | in[1];
+    }
+
+    inline uint8_t clamp255(int x)
+    {
+        return (uint8_t) (x >= 0 ? (x < 255 ? x : 255) : 0);
+    }
+
+    inline int extend4To8(int c)
+    {
+        return (c << 4) | c;
+    }
+
+    inline int extend5To8(int c)
+    {
+        return (c << 3) | (c >> 2);
+    }
+
+    inline int extend6To8(int c)
+    {
+        return (c << 2) | (c >> 4);
+    }
+
+    inline int extend7To8(int c)
+    {
+        return (c << 1) | (c >> 6);
+    }
+
+    // 5-bit base value plus 3-bit signed delta, may be out of [0, 31]
+    inline int differentialValue(uint8_t q)
+    {
+        return (q >> 3) + ((int) ((q & 0x7) ^ 0x4) - 4);
+    }
+
+    // Decode a 4x4 ETC2 RGB block to RGBA8888, alpha is 255 unless the block
+    // is a non-opaque RGB8A1 block.
+    void etc2_decode_rgb_block(const uint8_t *in, uint8_t *out, bool punchthrough)
+    {
+        const uint32_t indices = (in[4] << 24) | (in[5] << 16) | (in[6] << 8) | in[7];
+        const bool diff = (in[3] & 0x2) != 0;
+        const bool opaque = !punchthrough || diff;
+
+        int r = 0, g = 0, b = 0;
+        if (diff || punchthrough)
+        {
+            r = differentialValue(in[0]);
+            g = differentialValue(in[1]);
+            b = differentialValue(in[2]);
+        }
+
+        if ((diff || punchthrough) && (r < 0 || r > 31 || g < 0 || g > 31))
+        {
+            // T and H modes: four paint colors picked directly by the pixel index
+            int paint[4][3];
+            int distance;
+            if (r < 0 || r > 31)
+            {
+                int base1[3] = {
+                    extend4To8(((in[0] >> 1) & 0xc) | (in[0] & 0x3)),
+                    extend4To8(in[1] >> 4),
+                    extend4To8(in[1] & 0xf) };
+                int base2[3] = {
+                    extend4To8(in[2] >> 4),
+                    extend4To8(in[2] & 0xf),
+                    extend4To8(in[3] >> 4) };
+                distance = kDistanceTable[((in[3] >> 1) & 0x6) | (in[3] & 0x1)];
+                for (int c = 0; c < 3; ++c)
+                {
+                    paint[0][c] = base1[c];
+                    paint[1][c] = clamp255(base2[c] + distance);
+                    paint[2][c] = base2[c];
+                    paint[3][c] = clamp255(base2[c] - distance);
+                }
+            }
+            else
+            {
+                int r1 = (in[0] >> 3) & 0xf;
+                int g1 = ((in[0] & 0x7) << 1) | ((in[1] >> 4) & 0x1);
+                int b1 = (in[1] & 0x8) | ((in[1] & 0x3) << 1) | (in[2] >> 7);
+                int r2 = (in[2] >> 3) & 0xf;
+                int g2 = ((in[2] & 0x7) << 1) | (in[3] >> 7);
+                int b2 = (in[3] >> 3) & 0xf;
+                int order = ((r1 << 8) | (g1 << 4) | b1) >= ((r2 << 8) | (g2 << 4) | b2) ? 1 : 0;
+                distance = kDistanceTable[(in[3] & 0x4) | ((in[3] & 0x1) << 1) | order];
+                int base1[3] = { extend4To8(r1), extend4To8(g1), extend4To8(b1) };
+                int base2[3] = { extend4To8(r2), extend4To8(g2), extend4To8(b2) };
+                for (int c = 0; c < 3; ++c)
+                {
+                    paint[0][c] = clamp255(base1[c] + distance);
+                    paint[1][c] = clamp255(base1[c] - distance);
+                    paint[2][c] = clamp255(base2[c] + distance);
+                    paint[3][c] = clamp255(base2[c] - distance);
+                }
+            }
+
+            for (int y = 0; y < 4; ++y)
+            {
+                for (int x = 0; x < 4; ++x)
+                {
+                    int bit = x * 4 + y;
+                    int index = ((indices >> (15 + bit)) & 0x2) | ((indices >> bit) & 0x1);
+                    uint8_t *p = out + (y * 4 + x) * 4;
+                    if (!opaque && index == 2)
+                    {
+                        p[0] = p[1] = p[2] = p[3] = 0;
+                        continue;
+                    }
+                    p[0] = (uint8_t) paint[index][0];
+                    p[1] = (uint8_t) paint[index][1];
+                    p[2] = (uint8_t) paint[index][2];
+                    p[3] = 255;
+                }
+            }
+        }
+        else if ((diff || punchthrough) && (b < 0 || b > 31))
+        {
+            // planar mode: the color is interpolated from three corner colors
+            int ro = extend6To8((in[0] >> 1) & 0x3f);
+            int go = extend7To8(((in[0] & 0x1) << 6) | ((in[1] >> 1) & 0x3f));
+            int bo = extend6To8(((in[1] & 0x1) << 5) | (in[2] & 0x18) | ((in[2] & 0x3) << 1) | (in[3] >> 7));
+            int rh = extend6To8(((in[3] & 0x7c) >> 1) | (in[3] & 0x1));
+            int gh = extend7To8(in[4] >> 1);
+            int bh = extend6To8(((in[4] & 0x1) << 5) | (in[5] >> 3));
+            int rv = extend6To8(((in[5] & 0x7) << 3) | (in[6] >> 5));
+            int gv = extend7To8(((in[6] & 0x1f) << 2) | (in[7] >> 6));
+            int bv = extend6To8(in[7] & 0x3f);
+
+            for (int y = 0; y < 4; ++y)
+            {
+                for (int x = 0; x < 4; ++x)
+                {
+                    uint8_t *p = out + (y * 4 + x) * 4;
+                    p[0] = clamp255((x * (rh - ro) + y * (rv - ro) + 4 * ro + 2) >> 2);
+                    p[1] = clamp255((x * (gh - go) + y * (gv - go) + 4 * go + 2) >> 2);
+                    p[2] = clamp255((x * (bh - bo) + y * (bv - bo) + 4 * bo + 2) >> 2);
+                    p[3] = 255;
+                }
+            }
+        }
+        else
+        {
+            // ETC1 compatible individual and differential modes
+            int base[2][3];
+            if (diff || punchthrough)
+            {
+                base[0][0] = extend5To8(in[0] >> 3);
+                base[0][1] = extend5To8(in[1] >> 3);
+                base[0][2] = extend5To8(in[2] >> 3);
+                base[1][0] = extend5To8(r);
+                base[1][1] = extend5To8(g);
+                base[1][2] = extend5To8(b);
+            }
+            else
+            {
+                base[0][0] = extend4To8(in[0] >> 4);
+                base[0][1] = extend4To8(in[1] >> 4);
+                base[0][2] = extend4To8(in[2] >> 4);
+                base[1][0] = extend4To8(in[0] & 0xf);
+                base[1][1] = extend4To8(in[1] & 0xf);
+                base[1][2] = extend4To8(in[2] & 0xf);
+            }
+            const int (*table)[4] = opaque ? kModifierTable : kModifierTableNonOpaque;
+            const int *modifiers[2] = { table[(in[3] >> 5) & 0x7], table[(in[3] >> 2) & 0x7] };
+            const bool flip = (in[3] & 0x1) != 0;
+
+            for (int y = 0; y < 4; ++y)
+            {
+                for (int x = 0; x < 4; ++x)
+                {
+                    int bit = x * 4 + y;
+                    int index = ((indices >> (15 + bit)) & 0x2) | ((indices >> bit) & 0x1);
+                    uint8_t *p = out + (y * 4 + x) * 4;
+                    if (!opaque && index == 2)
+                    {
+                        p[0] = p[1] = p[2] = p[3] = 0;
+                        continue;
+                    }
+                    int subblock = flip ? (y >= 2) : (x >= 2);
+                    int modifier = modifiers[subblock][index];
+                    p[0] = clamp255(base[subblock][0] + modifier);
+                    p[1] = clamp255(base[subblock][1] + modifier);
+                    p[2] = clamp255(base[subblock][2] + modifier);
+                    p[3] = 255;
+                }
+            }
+        }
+    }
+
+    // Decode a 4x4 EAC alpha block into the alpha bytes of RGBA8888 pixels.
+    void etc2_decode_alpha_block(const uint8_t *in, uint8_t *out)
+    {
+        const int base = in[0];
+        const int multiplier = in[1] >> 4;
+        const int *modifiers = kAlphaModifierTable[in[1] & 0xf];
+        const uint64_t indices = ((uint64_t) in[2] << 40) | ((uint64_t) in[3] << 32) |
+                                 ((uint64_t) in[4] << 24) | ((uint64_t) in[5] << 16) |
+                                 ((uint64_t) in[6] << 8) | (uint64_t) in[7];
+
+        for (int y = 0; y < 4; ++y)
+        {
+            for (int x = 0; x < 4; ++x)
+            {
+                int index = (int) (indices >> (45 - 3 * (x * 4 + y))) & 0x7;
+                out[(y * 4 + x) * 4 + 3] = clamp255(base + modifiers[index] * multiplier);
+            }
+        }
+    }
+}
+
+bool etc2_pkm_is_valid(const uint8_t *header)
+{
+    if (memcmp(header, kMagic, sizeof(kMagic)) != 0)
+    {
+        return false;
+    }
+    uint32_t format = readBEUint16(header + PKM_FORMAT_OFFSET);
+    uint32_t encodedWidth = readBEUint16(header + PKM_ENCODED_WIDTH_OFFSET);
+    uint32_t encodedHeight = readBEUint16(header + PKM_ENCODED_HEIGHT_OFFSET);
+    uint32_t width = readBEUint16(header + PKM_WIDTH_OFFSET);
+    uint32_t height = readBEUint16(header + PKM_HEIGHT_OFFSET);
+    return (format == (uint32_t) ETC2Format::RGB8 ||
+            format == (uint32_t) ETC2Format::RGBA8 ||
+            format == (uint32_t) ETC2Format::RGB8A1) &&
+           encodedWidth >= width && encodedWidth - width < 4 &&
+           encodedHeight >= height && encodedHeight - height < 4;
+}
+
+ETC2Format etc2_pkm_get_format(const uint8_t *header)
+{
+    return (ETC2Format) readBEUint16(header + PKM_FORMAT_OFFSET);
+}
+
+uint32_t etc2_pkm_get_width(const uint8_t *header)
+{
+    return readBEUint16(header + PKM_WIDTH_OFFSET);
+}
+
+uint32_t etc2_pkm_get_height(const uint8_t *header)
+{
+    return readBEUint16(header + PKM_HEIGHT_OFFSET);
+}
+
+uint32_t etc2_get_encoded_data_size(uint32_t width, uint32_t height, ETC2Format format)
+{
+    uint32_t blockSize = (format == ETC2Format::RGBA8) ? 16 : 8;
+    return ((width + 3) >> 2) * ((height + 3) >> 2) * blockSize;
+}
+
+bool etc2_decode_image(const uint8_t *encodeData,
+                       ssize_t encodeDataLen,
+                       uint8_t *decodeData,
+                       int pixelsWidth,
+                       int pixelsHeight,
+                       ETC2Format format)
+{
+    if (pixelsWidth <= 0 || pixelsHeight <= 0 ||
+        encodeDataLen < (ssize_t) etc2_get_encoded_data_size(pixelsWidth, pixelsHeight, format))
+    {
+        return false;
+    }
+
+    const int bytesPerPixel = (format == ETC2Format::RGB8) ? 3 : 4;
+    const int stride = pixelsWidth * bytesPerPixel;
+    uint8_t block[4 * 4 * 4];
+
+    for (int y = 0; y < pixelsHeight; y += 4)
+    {
+        const int yEnd = pixelsHeight - y < 4 ? pixelsHeight - y : 4;
+        for (int x = 0; x < pixelsWidth; x += 4)
+        {
+            const int xEnd = pixelsWidth - x < 4 ? pixelsWidth - x : 4;
+
+            if (format == ETC2Format::RGBA8)
+            {
+                etc2_decode_rgb_block(encodeData + 8, block, false);
+                etc2_decode_alpha_block(encodeData, block);
+                encodeData += 16;
+            }
+            else
+            {
+                etc2_decode_rgb_block(encodeData, block, format == ETC2Format::RGB8A1);
+                encodeData += 8;
+            }
+
+            for (int cy = 0; cy < yEnd; ++cy)
+            {
+                const uint8_t *q = block + cy * 16;
+                uint8_t *p = decodeData + stride * (y + cy) + x * bytesPerPixel;
+                if (bytesPerPixel == 4)
+                {
+                    memcpy(p, q, xEnd * 4);
+                }
+                else
+                {
+                    for (int cx = 0; cx < xEnd; ++cx, q += 4)
+                    {
+                        *p++ = q[0];
+                        *p++ = q[1];
+                        *p++ = q[2];
+                    }
+                }
+            }
+        }
+    }
+    return true;
+}
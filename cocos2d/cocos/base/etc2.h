@@ -0,0 +1,63 @@
+/****************************************************************************
+Copyright (c) 2019 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#ifndef COCOS2DX_PLATFORM_THIRDPARTY_ETC2_
+#define COCOS2DX_PLATFORM_THIRDPARTY_ETC2_
+/// @cond DO_NOT_SHOW
+
+#include "platform/CCStdC.h"
+
+// Size of a PKM 2.0 header, in bytes.
+#define ETC2_PKM_HEADER_SIZE 16
+
+// ETC2 block layouts, valued as the format field of a PKM 2.0 header.
+enum class ETC2Format
+{
+    RGB8 = 1,           // 8 bytes per block, GL_COMPRESSED_RGB8_ETC2
+    RGBA8 = 3,          // 16 bytes per block, GL_COMPRESSED_RGBA8_ETC2_EAC
+    RGB8A1 = 4,         // 8 bytes per block, GL_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2
+};
+
+// Check if a PKM 2.0 header is correctly formatted and holds an ETC2 format.
+bool etc2_pkm_is_valid(const uint8_t *header);
+
+// Read the format, image width and image height from a PKM 2.0 header.
+ETC2Format etc2_pkm_get_format(const uint8_t *header);
+uint32_t etc2_pkm_get_width(const uint8_t *header);
+uint32_t etc2_pkm_get_height(const uint8_t *header);
+
+// Return the size of the encoded image data (does not include size of PKM header).
+uint32_t etc2_get_encoded_data_size(uint32_t width, uint32_t height, ETC2Format format);
+
+// Decode ETC2 encode data. RGB8 is decoded to RGB888, RGBA8 and RGB8A1 to RGBA8888
+// (not premultiplied). Returns false if encodeDataLen is too small for the image.
+bool etc2_decode_image(const uint8_t *encodeData,
+                       ssize_t encodeDataLen,
+                       uint8_t *decodeData,
+                       int pixelsWidth,
+                       int pixelsHeight,
+                       ETC2Format format);
+
+/// @endcond
+#endif /* defined(COCOS2DX_PLATFORM_THIRDPARTY_ETC2_) */
@@ -63,12 +63,16 @@ THE SOFTWARE.
 #include "base/ccMacros.h"
 #include "base/ccTypes.h"
 #include "base/ccUTF8.h"
+#include "base/ccPixelUtils.h"
 #include "base/ccUtils.h"
 
 // EventDispatcher
 #include "base/CCEventAcceleration.h"
 #include "base/CCEventCustom.h"
 #include "base/CCEventDispatcher.h"
+#include "base/CCFrameArena.h"
+#include "base/CCJobSystem.h"
+#include "base/CCHitTestIndex.h"
 #include "base/CCEventFocus.h"
 #include "base/CCEventKeyboard.h"
 #include "base/CCEventListenerAcceleration.h"
@@ -110,6 +114,7 @@ THE SOFTWARE.
 #include "2d/CCActionTiledGrid.h"
 #include "2d/CCActionTween.h"
 #include "2d/CCTweenFunction.h"
+#include "2d/CCTweenManager.h"
 
 // 2d nodes
 #include "2d/CCAtlasNode.h"
@@ -130,6 +135,8 @@ THE SOFTWARE.
 #include "2d/CCNodeGrid.h"
 #include "2d/CCParticleBatchNode.h"
 #include "2d/CCParticleExamples.h"
+#include "2d/CCParticleKernels.h"
+#include "2d/CCParticleManager.h"
 #include "2d/CCParticleSystem.h"
 #include "2d/CCParticleSystemQuad.h"
 #include "2d/CCProgressTimer.h"
@@ -189,6 +196,7 @@ THE SOFTWARE.
 #include "platform/CCCommon.h"
 #include "platform/CCDevice.h"
 #include "platform/CCFileUtils.h"
+#include "platform/CCAssetPack.h"
 #include "platform/CCImage.h"
 #include "platform/CCPlatformConfig.h"
 #include "platform/CCPlatformMacros.h"
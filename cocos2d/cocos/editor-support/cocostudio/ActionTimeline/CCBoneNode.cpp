@@ -430,6 +430,7 @@ void BoneNode::updateVertices()
             _squareVertices[i] += _anchorPointInPoints;
         }
         _transformUpdated = _transformDirty = _inverseDirty = _contentSizeDirty = true;
+        markWorldTransformDirty();
     }
 }
 
@@ -440,6 +441,7 @@ void BoneNode::updateColor()
         _squareColors[i] = _rackColor;
     }
     _transformUpdated = _transformDirty = _inverseDirty = _contentSizeDirty = true;
+    markWorldTransformDirty();
 }
 
 void BoneNode::updateDisplayedColor(const cocos2d::Color3B& /*parentColor*/)
@@ -138,6 +138,7 @@ void SkeletonNode::updateVertices()
         }
 
         _transformUpdated = _transformDirty = _inverseDirty = _contentSizeDirty = true;
+        markWorldTransformDirty();
     }
 }
 
@@ -148,6 +149,7 @@ void SkeletonNode::updateColor()
         _squareColors[i] = _rackColor;
     }
     _transformUpdated = _transformDirty = _inverseDirty = _contentSizeDirty = true;
+    markWorldTransformDirty();
 }
 
 void SkeletonNode::visit(cocos2d::Renderer *renderer, const cocos2d::Mat4& parentTransform, uint32_t parentFlags)
@@ -0,0 +1,286 @@
+/****************************************************************************
+Copyright (c) 2019 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#include "platform/CCAssetPack.h"
+
+#include <zlib.h>
+
+#include "base/ccMacros.h"
+
+NS_CC_BEGIN
+
+namespace
+{
+    const uint32_t ZIP_LOCAL_HEADER_SIGNATURE = 0x04034b50;
+    const uint32_t ZIP_CENTRAL_HEADER_SIGNATURE = 0x02014b50;
+    const uint32_t ZIP_END_OF_CENTRAL_DIR_SIGNATURE = 0x06054b50;
+
+    const size_t ZIP_LOCAL_HEADER_SIZE = 30;
+    const size_t ZIP_CENTRAL_HEADER_SIZE = 46;
+    const size_t ZIP_END_OF_CENTRAL_DIR_SIZE = 22;
+    const size_t ZIP_MAX_COMMENT_SIZE = 0xffff;
+
+    const uint16_t ZIP_METHOD_STORED = 0;
+    const uint16_t ZIP_METHOD_DEFLATED = 8;
+
+    inline uint16_t readUInt16(const unsigned char* p)
+    {
+        return static_cast<uint16_t>(p[0] | (p[1] << 8));
+    }
+
+    inline uint32_t readUInt32(const unsigned char* p)
+    {
+        return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8)
+            | (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+    }
+}
+
+std::shared_ptr<AssetPack> AssetPack::create(const std::string& packPath)
+{
+    std::shared_ptr<AssetPack> ret(new (std::nothrow) AssetPack());
+    if (ret && ret->init(packPath))
+    {
+        return ret;
+    }
+    return nullptr;
+}
+
+AssetPack::AssetPack()
+{
+}
+
+AssetPack::~AssetPack()
+{
+}
+
+bool AssetPack::init(const std::string& packPath)
+{
+    _path = FileUtils::getInstance()->fullPathForFilename(packPath);
+    if (_path.empty())
+    {
+        CCLOG("cocos2d: AssetPack: %s not found", packPath.c_str());
+        return false;
+    }
+
+    _archive = std::make_shared<MappedData>(FileUtils::getInstance()->getMappedDataFromFile(_path, MappedData::Advice::RANDOM));
+    const unsigned char* bytes = _archive->getBytes();
+    size_t size = static_cast<size_t>(_archive->getSize());
+    if (_archive->isNull() || size < ZIP_END_OF_CENTRAL_DIR_SIZE)
+    {
+        CCLOG("cocos2d: AssetPack: failed to read %s", _path.c_str());
+        return false;
+    }
+
+    // The end of central directory record is followed by a comment of at most 64k.
+    const unsigned char* eocd = nullptr;
+    size_t searchEnd = size > ZIP_END_OF_CENTRAL_DIR_SIZE + ZIP_MAX_COMMENT_SIZE ? size - ZIP_END_OF_CENTRAL_DIR_SIZE - ZIP_MAX_COMMENT_SIZE : 0;
+    for (size_t pos = size - ZIP_END_OF_CENTRAL_DIR_SIZE + 1; pos-- > searchEnd;)
+    {
+        if (readUInt32(bytes + pos) == ZIP_END_OF_CENTRAL_DIR_SIGNATURE)
+        {
+            eocd = bytes + pos;
+            break;
+        }
+    }
+    if (!eocd)
+    {
+        CCLOG("cocos2d: AssetPack: %s is not a zip archive", _path.c_str());
+        return false;
+    }
+
+    uint16_t entryCount = readUInt16(eocd + 10);
+    uint32_t directorySize = readUInt32(eocd + 12);
+    uint32_t directoryOffset = readUInt32(eocd + 16);
+    if (entryCount == 0xffff || directoryOffset == 0xffffffff)
+    {
+        CCLOG("cocos2d: AssetPack: %s is a zip64 archive, which is not supported", _path.c_str());
+        return false;
+    }
+    if (static_cast<size_t>(directoryOffset) + directorySize > size)
+    {
+        CCLOG("cocos2d: AssetPack: %s has a broken central directory", _path.c_str());
+        return false;
+    }
+
+    _entries.reserve(entryCount);
+
+    const unsigned char* p = bytes + directoryOffset;
+    const unsigned char* end = p + directorySize;
+    for (uint16_t i = 0; i < entryCount; ++i)
+    {
+        if (p + ZIP_CENTRAL_HEADER_SIZE > end || readUInt32(p) != ZIP_CENTRAL_HEADER_SIGNATURE)
+        {
+            CCLOG("cocos2d: AssetPack: %s has a broken central directory", _path.c_str());
+            _entries.clear();
+            _directories.clear();
+            return false;
+        }
+
+        uint16_t nameLength = readUInt16(p + 28);
+        uint16_t extraLength = readUInt16(p + 30);
+        uint16_t commentLength = readUInt16(p + 32);
+        const unsigned char* next = p + ZIP_CENTRAL_HEADER_SIZE + nameLength + extraLength + commentLength;
+        if (next > end)
+        {
+            CCLOG("cocos2d: AssetPack: %s has a broken central directory", _path.c_str());
+            _entries.clear();
+            _directories.clear();
+            return false;
+        }
+
+        std::string name(reinterpret_cast<const char*>(p + ZIP_CENTRAL_HEADER_SIZE), nameLength);
+        for (size_t slash = name.find('/'); slash != std::string::npos; slash = name.find('/', slash + 1))
+            _directories.insert(name.substr(0, slash + 1));
+        // skip directories
+        if (!name.empty() && name.back() != '/')
+        {
+            Entry entry;
+            entry.method = readUInt16(p + 10);
+            entry.compressedSize = readUInt32(p + 20);
+            entry.size = readUInt32(p + 24);
+            entry.headerOffset = readUInt32(p + 42);
+            _entries.emplace(std::move(name), entry);
+        }
+        p = next;
+    }
+
+    return true;
+}
+
+bool AssetPack::isFileExist(const std::string& name) const
+{
+    return _entries.find(name) != _entries.end();
+}
+
+bool AssetPack::isDirectoryExist(const std::string& name) const
+{
+    if (name.empty())
+        return true;
+    if (name.back() == '/')
+        return _directories.find(name) != _directories.end();
+    return _directories.find(name + '/') != _directories.end();
+}
+
+long AssetPack::getFileSize(const std::string& name) const
+{
+    auto iter = _entries.find(name);
+    if (iter == _entries.end())
+        return -1;
+    return static_cast<long>(iter->second.size);
+}
+
+const unsigned char* AssetPack::getEntryData(const Entry& entry) const
+{
+    // The local header may carry a different extra field than the central one, so read its own lengths.
+    size_t size = static_cast<size_t>(_archive->getSize());
+    if (static_cast<size_t>(entry.headerOffset) + ZIP_LOCAL_HEADER_SIZE > size)
+        return nullptr;
+
+    const unsigned char* header = _archive->getBytes() + entry.headerOffset;
+    if (readUInt32(header) != ZIP_LOCAL_HEADER_SIGNATURE)
+        return nullptr;
+
+    size_t dataOffset = entry.headerOffset + ZIP_LOCAL_HEADER_SIZE + readUInt16(header + 26) + readUInt16(header + 28);
+    if (dataOffset + entry.compressedSize > size)
+        return nullptr;
+
+    return _archive->getBytes() + dataOffset;
+}
+
+bool AssetPack::inflateEntry(const Entry& entry, const unsigned char* data, unsigned char* out) const
+{
+    z_stream stream;
+    memset(&stream, 0, sizeof(stream));
+    // negative window bits: raw deflate stream without zlib header, as stored in zip archives
+    if (inflateInit2(&stream, -MAX_WBITS) != Z_OK)
+        return false;
+
+    stream.next_in = const_cast<Bytef*>(data);
+    stream.avail_in = entry.compressedSize;
+    stream.next_out = out;
+    stream.avail_out = entry.size;
+
+    int err = inflate(&stream, Z_FINISH);
+    inflateEnd(&stream);
+    return err == Z_STREAM_END && stream.total_out == entry.size;
+}
+
+FileUtils::Status AssetPack::getContents(const std::string& name, ResizableBuffer* buffer) const
+{
+    auto iter = _entries.find(name);
+    if (iter == _entries.end())
+        return FileUtils::Status::NotExists;
+
+    const Entry& entry = iter->second;
+    const unsigned char* data = getEntryData(entry);
+    if (!data)
+        return FileUtils::Status::ReadFailed;
+
+    buffer->resize(entry.size);
+    if (entry.size == 0)
+        return FileUtils::Status::OK;
+
+    if (entry.method == ZIP_METHOD_STORED)
+    {
+        memcpy(buffer->buffer(), data, entry.size);
+        return FileUtils::Status::OK;
+    }
+
+    if (entry.method == ZIP_METHOD_DEFLATED && inflateEntry(entry, data, static_cast<unsigned char*>(buffer->buffer())))
+        return FileUtils::Status::OK;
+
+    CCLOG("cocos2d: AssetPack: failed to read %s from %s", name.c_str(), _path.c_str());
+    return FileUtils::Status::ReadFailed;
+}
+
+MappedData AssetPack::getMappedData(const std::string& name) const
+{
+    MappedData ret;
+    auto iter = _entries.find(name);
+    if (iter == _entries.end())
+        return ret;
+
+    const Entry& entry = iter->second;
+    if (entry.method == ZIP_METHOD_STORED)
+    {
+        const unsigned char* data = getEntryData(entry);
+        if (data)
+        {
+            // the view shares the ownership of the archive mapping
+            auto archive = _archive;
+            ret.setMapping(const_cast<unsigned char*>(data), entry.size, [archive]() {});
+        }
+        return ret;
+    }
+
+    Data data;
+    ResizableBufferAdapter<Data> buffer(&data);
+    if (getContents(name, &buffer) == FileUtils::Status::OK)
+    {
+        ret.setData(std::move(data));
+    }
+    return ret;
+}
+
+NS_CC_END
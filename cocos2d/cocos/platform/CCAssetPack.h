@@ -0,0 +1,118 @@
+/****************************************************************************
+Copyright (c) 2019 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#ifndef __CC_ASSETPACK_H__
+#define __CC_ASSETPACK_H__
+
+#include <string>
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "platform/CCFileUtils.h"
+
+NS_CC_BEGIN
+
+/**
+ * @addtogroup platform
+ * @{
+ */
+
+/**
+ * Read-only archive of resources, mounted into FileUtils with FileUtils::mountAssetPack.
+ *
+ * A pack is a plain zip archive. The central directory is parsed once into a hash index,
+ * the archive itself is mapped with FileUtils::getMappedDataFromFile, so looking up and reading
+ * an entry costs no system call. Entries should be stored uncompressed (tools/asset-pack/pack-assets.py
+ * does that), they are then returned as views into the mapping. Deflated entries are supported
+ * but inflated into a heap buffer on every read.
+ *
+ * Zip64 archives are not supported.
+ */
+class CC_DLL AssetPack
+{
+public:
+    /**
+     * Opens a pack.
+     * @param packPath The path of the zip archive, it could be a relative or absolute path.
+     * @return The pack, or nullptr if it can't be read or isn't a valid archive.
+     */
+    static std::shared_ptr<AssetPack> create(const std::string& packPath);
+
+    ~AssetPack();
+
+    /** Returns the full path of the archive. */
+    const std::string& getPath() const { return _path; }
+
+    /** Returns the number of files in the pack. */
+    size_t getFileCount() const { return _entries.size(); }
+
+    /** Checks whether the pack contains a file, the name is relative to the root of the archive. */
+    bool isFileExist(const std::string& name) const;
+
+    /** Checks whether the pack contains a directory, an empty name is the root of the archive. */
+    bool isDirectoryExist(const std::string& name) const;
+
+    /** Returns the uncompressed size of a file, or -1 if it doesn't exist. */
+    long getFileSize(const std::string& name) const;
+
+    /** Copies a file into buffer, same semantics as FileUtils::getContents. */
+    FileUtils::Status getContents(const std::string& name, ResizableBuffer* buffer) const;
+
+    /**
+     * Returns a file without copying it if it is stored uncompressed.
+     * The returned data keeps the archive mapped, even after the pack is unmounted.
+     */
+    MappedData getMappedData(const std::string& name) const;
+
+private:
+    struct Entry
+    {
+        uint32_t headerOffset;
+        uint32_t compressedSize;
+        uint32_t size;
+        uint16_t method;
+    };
+
+    AssetPack();
+    bool init(const std::string& packPath);
+
+    /** Returns the first byte of the entry data, or nullptr if the local header is broken. */
+    const unsigned char* getEntryData(const Entry& entry) const;
+
+    bool inflateEntry(const Entry& entry, const unsigned char* data, unsigned char* out) const;
+
+    std::string _path;
+    std::shared_ptr<MappedData> _archive;
+    std::unordered_map<std::string, Entry> _entries;
+    // every directory containing an entry, with a trailing slash
+    std::unordered_set<std::string> _directories;
+};
+
+// end of platform group
+/** @} */
+
+NS_CC_END
+
+#endif // __CC_ASSETPACK_H__
@@ -25,6 +25,7 @@ THE SOFTWARE.
 ****************************************************************************/
 
 #include "platform/CCFileUtils.h"
+#include "platform/CCAssetPack.h"
 
 #include <stack>
 
@@ -41,6 +42,11 @@ THE SOFTWARE.
 #include "unzip.h"
 #endif
 #include <sys/stat.h>
+#if (CC_TARGET_PLATFORM != CC_PLATFORM_WIN32) && (CC_TARGET_PLATFORM != CC_PLATFORM_WINRT)
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#endif
 
 #define DECLARE_GUARD std::lock_guard<std::recursive_mutex> mutexGuard(_mutex)
 
@@ -538,6 +544,87 @@ bool FileUtils::writeToFile(const ValueMap& /*dict*/, const std::string &/*fullP
 #endif /* (CC_TARGET_PLATFORM != CC_PLATFORM_IOS) && (CC_TARGET_PLATFORM != CC_PLATFORM_MAC) */
 
 // Implement FileUtils
+// Implement FullPathCache
+
+FullPathCache::Shard& FullPathCache::getShard(const std::string& key) const
+{
+    return _shards[std::hash<std::string>()(key) % SHARD_COUNT];
+}
+
+bool FullPathCache::find(const std::string& key, std::string* value) const
+{
+    auto& shard = getShard(key);
+    std::lock_guard<std::mutex> guard(shard.mutex);
+    auto iter = shard.map.find(key);
+    if (iter == shard.map.end())
+        return false;
+
+    *value = iter->second;
+    return true;
+}
+
+void FullPathCache::insert(const std::string& key, const std::string& value)
+{
+    auto& shard = getShard(key);
+    std::lock_guard<std::mutex> guard(shard.mutex);
+    shard.map[key] = value;
+}
+
+void FullPathCache::clear()
+{
+    for (auto& shard : _shards)
+    {
+        std::lock_guard<std::mutex> guard(shard.mutex);
+        shard.map.clear();
+    }
+}
+
+void FullPathCache::clearNotFound()
+{
+    for (auto& shard : _shards)
+    {
+        std::lock_guard<std::mutex> guard(shard.mutex);
+        for (auto iter = shard.map.begin(); iter != shard.map.end();)
+        {
+            if (iter->second.empty())
+                iter = shard.map.erase(iter);
+            else
+                ++iter;
+        }
+    }
+}
+
+void FullPathCache::eraseFullPath(const std::string& fullPath)
+{
+    // keys are the names passed to fullPathForFilename, so every shard has to be checked
+    for (auto& shard : _shards)
+    {
+        std::lock_guard<std::mutex> guard(shard.mutex);
+        for (auto iter = shard.map.begin(); iter != shard.map.end();)
+        {
+            if (iter->second == fullPath)
+                iter = shard.map.erase(iter);
+            else
+                ++iter;
+        }
+    }
+}
+
+std::unordered_map<std::string, std::string> FullPathCache::toMap() const
+{
+    std::unordered_map<std::string, std::string> ret;
+    for (auto& shard : _shards)
+    {
+        std::lock_guard<std::mutex> guard(shard.mutex);
+        for (const auto& item : shard.map)
+        {
+            if (!item.second.empty())
+                ret.emplace(item.first, item.second);
+        }
+    }
+    return ret;
+}
+
 FileUtils* FileUtils::s_sharedFileUtils = nullptr;
 
 void FileUtils::destroyInstance()
@@ -554,7 +641,8 @@ void FileUtils::setDelegate(FileUtils *delegate)
 }
 
 FileUtils::FileUtils()
-    : _writablePath("")
+    : _notFoundCacheEnabled(false)
+    , _writablePath("")
 {
 }
 
@@ -599,6 +687,7 @@ bool FileUtils::writeDataToFile(const Data& data, const std::string& fullPath) c
 
         fclose(fp);
 
+        onFileCreated(fullPath);
         return true;
     } while (0);
 
@@ -627,6 +716,181 @@ void FileUtils::purgeCachedEntries()
     _fullPathCacheDir.clear();
 }
 
+void FileUtils::buildResourceManifest()
+{
+    DECLARE_GUARD;
+    _manifestRoots.clear();
+    _manifestFiles.clear();
+
+    for (const auto& searchPath : _searchPathArray)
+    {
+        std::vector<std::string> files;
+        listFilesRecursively(searchPath, &files);
+        // Can't be listed (e.g. apk assets) or empty, keep using the file system for it.
+        if (files.empty())
+            continue;
+
+        for (auto& file : files)
+        {
+            if (file.back() != '/')
+                _manifestFiles.insert(std::move(file));
+        }
+        _manifestRoots.push_back(searchPath);
+    }
+
+    _fullPathCache.clear();
+    CCLOG("cocos2d: FileUtils: resource manifest indexed %d files in %d search paths",
+          (int)_manifestFiles.size(), (int)_manifestRoots.size());
+}
+
+void FileUtils::clearResourceManifest()
+{
+    DECLARE_GUARD;
+    _manifestRoots.clear();
+    _manifestFiles.clear();
+    _fullPathCache.clear();
+}
+
+bool FileUtils::isResourceManifestEnabled() const
+{
+    DECLARE_GUARD;
+    return !_manifestRoots.empty();
+}
+
+bool FileUtils::findInResourceManifest(const std::string& fullPath, bool* found) const
+{
+    DECLARE_GUARD;
+    if (_manifestRoots.empty())
+        return false;
+
+    // The manifest stores normalized paths, let the file system resolve "./", "../" and "//".
+    if (fullPath.find("./") != std::string::npos || fullPath.find("//") != std::string::npos)
+        return false;
+
+    for (const auto& root : _manifestRoots)
+    {
+        if (fullPath.compare(0, root.length(), root) == 0)
+        {
+            *found = _manifestFiles.find(fullPath) != _manifestFiles.end();
+            return true;
+        }
+    }
+    return false;
+}
+
+bool FileUtils::mountAssetPack(const std::string& packPath, const std::string& mountPoint)
+{
+    auto pack = AssetPack::create(packPath);
+    if (!pack)
+        return false;
+
+    DECLARE_GUARD;
+    MountedAssetPack mounted;
+    mounted.mountPath = isAbsolutePath(mountPoint) ? mountPoint : _defaultResRootPath + mountPoint;
+    if (!mounted.mountPath.empty() && mounted.mountPath[mounted.mountPath.length()-1] != '/')
+    {
+        mounted.mountPath += '/';
+    }
+    mounted.pack = pack;
+
+    // a mounted file may shadow a cached one
+    unmountAssetPack(packPath);
+    _assetPacks.push_back(std::move(mounted));
+    _fullPathCache.clear();
+    _fullPathCacheDir.clear();
+
+    CCLOG("cocos2d: FileUtils: mounted %s with %d files at %s",
+          pack->getPath().c_str(), (int)pack->getFileCount(), _assetPacks.back().mountPath.c_str());
+    return true;
+}
+
+bool FileUtils::unmountAssetPack(const std::string& packPath)
+{
+    DECLARE_GUARD;
+    const std::string fullPath = fullPathForFilename(packPath);
+    for (auto iter = _assetPacks.begin(); iter != _assetPacks.end(); ++iter)
+    {
+        if (iter->pack->getPath() == fullPath)
+        {
+            _assetPacks.erase(iter);
+            _fullPathCache.clear();
+            _fullPathCacheDir.clear();
+            return true;
+        }
+    }
+    return false;
+}
+
+std::shared_ptr<AssetPack> FileUtils::findInAssetPacks(const std::string& fullPath, std::string* entryName) const
+{
+    DECLARE_GUARD;
+    for (auto iter = _assetPacks.rbegin(); iter != _assetPacks.rend(); ++iter)
+    {
+        const std::string& mountPath = iter->mountPath;
+        if (fullPath.compare(0, mountPath.length(), mountPath) == 0)
+        {
+            std::string name = fullPath.substr(mountPath.length());
+            if (iter->pack->isFileExist(name))
+            {
+                *entryName = std::move(name);
+                return iter->pack;
+            }
+        }
+    }
+    return nullptr;
+}
+
+bool FileUtils::isDirectoryInAssetPacks(const std::string& fullPath) const
+{
+    DECLARE_GUARD;
+    if (_assetPacks.empty())
+        return false;
+
+    std::string dirPath = fullPath;
+    if (!dirPath.empty() && dirPath[dirPath.length()-1] != '/')
+        dirPath += '/';
+    for (const auto& mounted : _assetPacks)
+    {
+        const std::string& mountPath = mounted.mountPath;
+        // the mount point and its parents
+        if (mountPath.compare(0, dirPath.length(), dirPath) == 0)
+            return true;
+        if (dirPath.compare(0, mountPath.length(), mountPath) == 0
+            && mounted.pack->isDirectoryExist(dirPath.substr(mountPath.length())))
+            return true;
+    }
+    return false;
+}
+
+void FileUtils::onFileCreated(const std::string& fullPath) const
+{
+    DECLARE_GUARD;
+    if (!_manifestRoots.empty())
+        _manifestFiles.insert(fullPath);
+    _fullPathCache.clearNotFound();
+}
+
+void FileUtils::onFileRemoved(const std::string& fullPath) const
+{
+    DECLARE_GUARD;
+    _manifestFiles.erase(fullPath);
+    _fullPathCache.eraseFullPath(fullPath);
+}
+
+void FileUtils::setNotFoundCacheEnabled(bool enabled)
+{
+    DECLARE_GUARD;
+    _notFoundCacheEnabled = enabled;
+    if (!enabled)
+        _fullPathCache.clearNotFound();
+}
+
+bool FileUtils::isNotFoundCacheEnabled() const
+{
+    DECLARE_GUARD;
+    return _notFoundCacheEnabled;
+}
+
 std::string FileUtils::getStringFromFile(const std::string& filename) const
 {
     std::string s;
@@ -659,6 +923,166 @@ void FileUtils::getDataFromFile(const std::string& filename, std::function<void(
     }, std::move(callback));
 }
 
+// Implement MappedData
+
+MappedData::MappedData()
+: _bytes(nullptr)
+, _size(0)
+{
+}
+
+MappedData::MappedData(MappedData&& other)
+: _bytes(nullptr)
+, _size(0)
+{
+    move(other);
+}
+
+MappedData::~MappedData()
+{
+    clear();
+}
+
+MappedData& MappedData::operator= (MappedData&& other)
+{
+    if (this != &other)
+    {
+        move(other);
+    }
+    return *this;
+}
+
+void MappedData::move(MappedData& other)
+{
+    clear();
+
+    _bytes = other._bytes;
+    _size = other._size;
+    _release = std::move(other._release);
+    _data = std::move(other._data);
+
+    other._bytes = nullptr;
+    other._size = 0;
+    other._release = nullptr;
+}
+
+unsigned char* MappedData::getBytes() const
+{
+    return _release ? _bytes : _data.getBytes();
+}
+
+ssize_t MappedData::getSize() const
+{
+    return _release ? _size : _data.getSize();
+}
+
+bool MappedData::isNull() const
+{
+    return getBytes() == nullptr || getSize() == 0;
+}
+
+bool MappedData::isMapped() const
+{
+    return _release != nullptr;
+}
+
+void MappedData::setMapping(unsigned char* bytes, ssize_t size, const std::function<void()>& release)
+{
+    clear();
+    _bytes = bytes;
+    _size = size;
+    _release = release;
+}
+
+void MappedData::setData(Data&& data)
+{
+    clear();
+    _data = std::move(data);
+}
+
+void MappedData::clear()
+{
+    if (_release)
+    {
+        _release();
+        _release = nullptr;
+    }
+    _bytes = nullptr;
+    _size = 0;
+    _data.clear();
+}
+
+#if (CC_TARGET_PLATFORM != CC_PLATFORM_WIN32) && (CC_TARGET_PLATFORM != CC_PLATFORM_WINRT)
+// Below this size a single read is cheaper than setting up and tearing down a mapping.
+static const off_t MAPPED_DATA_MIN_SIZE = 16 * 1024;
+
+static int madviseFlag(MappedData::Advice advice)
+{
+    switch (advice)
+    {
+    case MappedData::Advice::SEQUENTIAL:
+        return MADV_SEQUENTIAL;
+    case MappedData::Advice::RANDOM:
+        return MADV_RANDOM;
+    case MappedData::Advice::WILLNEED:
+        return MADV_WILLNEED;
+    default:
+        return MADV_NORMAL;
+    }
+}
+#endif
+
+MappedData FileUtils::getMappedDataFromFile(const std::string& filename, MappedData::Advice advice) const
+{
+    MappedData ret;
+    if (filename.empty())
+        return ret;
+
+    std::string fullPath = fullPathForFilename(filename);
+    std::string entryName;
+    if (auto pack = findInAssetPacks(fullPath, &entryName))
+        return pack->getMappedData(entryName);
+
+#if (CC_TARGET_PLATFORM != CC_PLATFORM_WIN32) && (CC_TARGET_PLATFORM != CC_PLATFORM_WINRT)
+    // relative full paths are resolved by platform code (e.g. android assets), let getContents handle them
+    if (!fullPath.empty() && fullPath[0] == '/')
+    {
+        int fd = open(getSuitableFOpen(fullPath).c_str(), O_RDONLY);
+        if (fd != -1)
+        {
+            struct stat statBuf;
+            void* address = MAP_FAILED;
+            if (fstat(fd, &statBuf) == 0 && S_ISREG(statBuf.st_mode) && statBuf.st_size >= MAPPED_DATA_MIN_SIZE)
+            {
+                // private mapping, the file on disk is never modified
+                address = mmap(nullptr, statBuf.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+            }
+            // the mapping keeps its own reference to the file
+            close(fd);
+
+            if (address != MAP_FAILED)
+            {
+                size_t length = static_cast<size_t>(statBuf.st_size);
+                madvise(address, length, madviseFlag(advice));
+                ret.setMapping(static_cast<unsigned char*>(address), static_cast<ssize_t>(length), [address, length]() {
+                    munmap(address, length);
+                });
+                return ret;
+            }
+        }
+    }
+#else
+    CC_UNUSED_PARAM(advice);
+#endif
+
+    Data data;
+    if (getContents(filename, &data) == Status::OK)
+    {
+        ret.setData(std::move(data));
+    }
+    return ret;
+}
+
 FileUtils::Status FileUtils::getContents(const std::string& filename, ResizableBuffer* buffer) const
 {
     if (filename.empty())
@@ -670,6 +1094,10 @@ FileUtils::Status FileUtils::getContents(const std::string& filename, ResizableB
     if (fullPath.empty())
         return Status::NotExists;
 
+    std::string entryName;
+    if (auto pack = fs->findInAssetPacks(fullPath, &entryName))
+        return pack->getContents(entryName, buffer);
+
     std::string suitableFullPath = fs->getSuitableFOpen(fullPath);
 
     struct stat statBuf;
@@ -809,6 +1237,25 @@ std::string FileUtils::getPathForFilename(const std::string& filename, const std
     path += file_path;
     path += resolutionDirectory;
 
+    std::string candidate = path;
+    if (!candidate.empty() && candidate[candidate.size()-1] != '/')
+    {
+        candidate += '/';
+    }
+    candidate += file;
+
+    std::string entryName;
+    if (findInAssetPacks(candidate, &entryName))
+    {
+        return candidate;
+    }
+
+    bool found = false;
+    if (findInResourceManifest(candidate, &found))
+    {
+        return found ? candidate : "";
+    }
+
     path = getFullPathForFilenameWithinDirectory(path, file);
 
     return path;
@@ -816,9 +1263,6 @@ std::string FileUtils::getPathForFilename(const std::string& filename, const std
 
 std::string FileUtils::fullPathForFilename(const std::string &filename) const
 {
-    
-    DECLARE_GUARD;
-
     if (filename.empty())
     {
         return "";
@@ -829,18 +1273,18 @@ std::string FileUtils::fullPathForFilename(const std::string &filename) const
         return filename;
     }
 
-    // Already Cached ?
-    auto cacheIter = _fullPathCache.find(filename);
-    if(cacheIter != _fullPathCache.end())
+    // Already Cached ? The cache has its own locks, hits don't contend on _mutex.
+    std::string fullpath;
+    if (_fullPathCache.find(filename, &fullpath))
     {
-        return cacheIter->second;
+        return fullpath;
     }
 
+    DECLARE_GUARD;
+
     // Get the new file name.
     const std::string newFilename( getNewFilename(filename) );
 
-    std::string fullpath;
-
     for (const auto& searchIt : _searchPathArray)
     {
         for (const auto& resolutionIt : _searchResolutionsOrderArray)
@@ -850,7 +1294,7 @@ std::string FileUtils::fullPathForFilename(const std::string &filename) const
             if (!fullpath.empty())
             {
                 // Using the filename passed in as key.
-                _fullPathCache.emplace(filename, fullpath);
+                _fullPathCache.insert(filename, fullpath);
                 return fullpath;
             }
 
@@ -861,7 +1305,9 @@ std::string FileUtils::fullPathForFilename(const std::string &filename) const
         CCLOG("cocos2d: fullPathForFilename: No file found at %s. Possible missing file.", filename.c_str());
     }
 
-    // The file wasn't found, return empty string.
+    // The file wasn't found, remember it if asked to and return empty string.
+    if (_notFoundCacheEnabled)
+        _fullPathCache.insert(filename, "");
     return "";
 }
 
@@ -970,8 +1416,10 @@ void FileUtils::addSearchResolutionsOrder(const std::string &order,const bool fr
         resOrder.append("/");
 
     if (front) {
+        _fullPathCache.clear();
         _searchResolutionsOrderArray.insert(_searchResolutionsOrderArray.begin(), resOrder);
     } else {
+        _fullPathCache.clearNotFound();
         _searchResolutionsOrderArray.push_back(resOrder);
     }
 }
@@ -1076,9 +1524,11 @@ void FileUtils::addSearchPath(const std::string &searchpath,const bool front)
     }
 
     if (front) {
+        _fullPathCache.clear();
         _originalSearchPaths.insert(_originalSearchPaths.begin(), searchpath);
         _searchPathArray.insert(_searchPathArray.begin(), path);
     } else {
+        _fullPathCache.clearNotFound();
         _originalSearchPaths.push_back(searchpath);
         _searchPathArray.push_back(path);
     }
@@ -1131,6 +1581,13 @@ bool FileUtils::isFileExist(const std::string& filename) const
 {
     if (isAbsolutePath(filename))
     {
+        std::string entryName;
+        if (findInAssetPacks(filename, &entryName))
+            return true;
+
+        bool found = false;
+        if (findInResourceManifest(filename, &found))
+            return found;
         return isFileExistInternal(filename);
     }
     else
@@ -1164,14 +1621,14 @@ bool FileUtils::isDirectoryExist(const std::string& dirPath) const
 
     if (isAbsolutePath(dirPath))
     {
-        return isDirectoryExistInternal(dirPath);
+        return isDirectoryInAssetPacks(dirPath) || isDirectoryExistInternal(dirPath);
     }
 
     // Already Cached ?
     auto cacheIter = _fullPathCacheDir.find(dirPath);
     if( cacheIter != _fullPathCacheDir.end() )
     {
-        return isDirectoryExistInternal(cacheIter->second);
+        return isDirectoryInAssetPacks(cacheIter->second) || isDirectoryExistInternal(cacheIter->second);
     }
 
     std::string fullpath;
@@ -1181,7 +1638,7 @@ bool FileUtils::isDirectoryExist(const std::string& dirPath) const
         {
             // searchPath + file_path + resourceDirectory
             fullpath = fullPathForDirectory(searchIt + dirPath + resolutionIt);
-            if (isDirectoryExistInternal(fullpath))
+            if (isDirectoryInAssetPacks(fullpath) || isDirectoryExistInternal(fullpath))
             {
                 _fullPathCacheDir.emplace(dirPath, fullpath);
                 return true;
@@ -1453,6 +1910,7 @@ bool FileUtils::removeFile(const std::string &path) const
     if (remove(path.c_str())) {
         return false;
     } else {
+        onFileRemoved(path);
         return true;
     }
 }
@@ -1469,6 +1927,8 @@ bool FileUtils::renameFile(const std::string &oldfullpath, const std::string &ne
         CCLOGERROR("Fail to rename file %s to %s !Error code is %d", oldfullpath.c_str(), newfullpath.c_str(), errorCode);
         return false;
     }
+    onFileRemoved(oldfullpath);
+    onFileCreated(newfullpath);
     return true;
 }
 
@@ -1498,6 +1958,12 @@ long FileUtils::getFileSize(const std::string &filepath) const
             return 0;
     }
 
+    std::string entryName;
+    if (auto pack = findInAssetPacks(fullpath, &entryName))
+    {
+        return pack->getFileSize(entryName);
+    }
+
     struct stat info;
     // Get data associated with "crt_stat.c":
     int result = stat(fullpath.c_str(), &info);
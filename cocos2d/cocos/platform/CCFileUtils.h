@@ -29,6 +29,7 @@ THE SOFTWARE.
 #include <string>
 #include <vector>
 #include <unordered_map>
+#include <unordered_set>
 #include <type_traits>
 #include <mutex>
 
@@ -48,6 +49,8 @@ NS_CC_BEGIN
  */
 
 
+class AssetPack;
+
 class ResizableBuffer {
 public:
     virtual ~ResizableBuffer() {}
@@ -118,6 +121,119 @@ public:
     }
 };
 
+/**
+ * Read-only view of a whole file, returned by FileUtils::getMappedDataFromFile.
+ *
+ * When the platform supports it the bytes are a private memory mapping of the file,
+ * so no heap copy is made and pages are faulted in on demand by the decoder.
+ * Otherwise it owns a heap copy read through FileUtils::getContents.
+ * Treat the bytes as read-only: buffers of Android apk assets are mapped without write access.
+ *
+ * MappedData is movable but not copyable, the mapping is released in the destructor.
+ */
+class CC_DLL MappedData
+{
+public:
+    /** Access pattern hint passed to madvise when the file is mapped. */
+    enum class Advice
+    {
+        NORMAL,
+        SEQUENTIAL,
+        RANDOM,
+        WILLNEED
+    };
+
+    MappedData();
+    MappedData(MappedData&& other);
+    ~MappedData();
+
+    MappedData& operator= (MappedData&& other);
+
+    /** Gets the bytes of the file. Don't free it, the memory is owned by MappedData. */
+    unsigned char* getBytes() const;
+
+    /** Gets the size of the file. */
+    ssize_t getSize() const;
+
+    /** Returns true if there is no content. */
+    bool isNull() const;
+
+    /** Returns true if the bytes are a memory mapping, false if they are a heap copy. */
+    bool isMapped() const;
+
+    /**
+     * Sets a mapping owned by this object.
+     * @param bytes Start of the mapped region.
+     * @param size Size of the mapped region.
+     * @param release Called exactly once when the mapping is no longer needed (e.g. munmap).
+     */
+    void setMapping(unsigned char* bytes, ssize_t size, const std::function<void()>& release);
+
+    /** Takes the ownership of a heap buffer, used by the fallback path. */
+    void setData(Data&& data);
+
+    /** Releases the mapping or the heap copy. */
+    void clear();
+
+private:
+    MappedData(const MappedData&) = delete;
+    MappedData& operator= (const MappedData&) = delete;
+
+    void move(MappedData& other);
+
+    unsigned char* _bytes;
+    ssize_t _size;
+    std::function<void()> _release;
+    Data _data;
+};
+
+/**
+ * Thread-safe map from a file name to its resolved full path, used by FileUtils.
+ *
+ * Keys are spread over independently locked shards, so worker threads resolving paths
+ * (e.g. TextureCache::loadImage) don't serialize with the main thread on cache hits.
+ * A key mapped to an empty string records a file which was not found, FileUtils only stores
+ * those when FileUtils::setNotFoundCacheEnabled() is on.
+ */
+class CC_DLL FullPathCache
+{
+public:
+    /**
+     * Looks up a key.
+     * @param value Filled with the cached full path, empty if the file is known to be missing.
+     * @return True if the key is cached.
+     */
+    bool find(const std::string& key, std::string* value) const;
+
+    /** Caches a full path, pass an empty string to record a missing file. */
+    void insert(const std::string& key, const std::string& value);
+
+    /** Drops all entries. */
+    void clear();
+
+    /** Drops the entries of missing files only, call it when files may have been added. */
+    void clearNotFound();
+
+    /** Drops the entries resolved to a full path, call it when that file is removed. */
+    void eraseFullPath(const std::string& fullPath);
+
+    /** Returns a copy of the entries of found files. */
+    std::unordered_map<std::string, std::string> toMap() const;
+
+private:
+    static const size_t SHARD_COUNT = 16;
+
+    struct Shard
+    {
+        std::mutex mutex;
+        std::unordered_map<std::string, std::string> map;
+    };
+
+    Shard& getShard(const std::string& key) const;
+
+    mutable Shard _shards[SHARD_COUNT];
+};
+
 /** Helper class to handle file operations. */
 class CC_DLL FileUtils
 {
@@ -195,6 +311,23 @@ public:
      */
     virtual void getDataFromFile(const std::string& filename, std::function<void(Data)> callback) const;
 
+    /**
+     *  Maps a file into memory instead of copying it into a heap buffer.
+     *
+     *  On POSIX platforms regular files larger than a few pages are mapped with mmap and the advice is
+     *  forwarded to madvise. Small files, files inside the Android apk/obb and platforms without mmap
+     *  fall back to getContents, so the result is always usable the same way as getDataFromFile.
+     *
+     *  @note If you override getContents to transform resources (e.g. decryption), override this
+     *        method as well, otherwise the raw file contents are returned.
+     *  @param filename The resource file name, it could be a relative or absolute path.
+     *  @param advice How the caller is going to read the bytes.
+     *  @return The file contents, isNull() is true on failure.
+     *  @js NA
+     *  @lua NA
+     */
+    virtual MappedData getMappedDataFromFile(const std::string& filename, MappedData::Advice advice = MappedData::Advice::SEQUENTIAL) const;
+
     enum class Status
     {
         OK = 0,
@@ -845,7 +978,69 @@ public:
     virtual void listFilesRecursivelyAsync(const std::string& dirPath, std::function<void(std::vector<std::string>)> callback) const;
 
     /** Returns the full path cache. */
-    const std::unordered_map<std::string, std::string> getFullPathCache() const { return _fullPathCache; }
+    const std::unordered_map<std::string, std::string> getFullPathCache() const { return _fullPathCache.toMap(); }
+
+    /**
+     *  Sets whether fullPathForFilename remembers the files it did not find, off by default.
+     *
+     *  It saves the search path walk for names which are looked up often but don't exist. The
+     *  entries are dropped when search paths or resolution orders are added and when FileUtils
+     *  writes or renames a file, but a file created by other means (e.g. a third party downloader
+     *  writing into the writable path) stays missing until purgeCachedEntries() is called.
+     */
+    void setNotFoundCacheEnabled(bool enabled);
+    bool isNotFoundCacheEnabled() const;
+
+    /**
+     *  Indexes every file under the current search paths, so fullPathForFilename and isFileExist
+     *  resolve relative names without touching the file system.
+     *
+     *  Call it once at startup after the search paths are set. Search paths which can't be listed
+     *  (e.g. inside the Android apk) or are added later keep using the file system.
+     *  Files written or renamed through FileUtils are added to the manifest.
+     */
+    virtual void buildResourceManifest();
+
+    /** Drops the manifest built by buildResourceManifest. */
+    virtual void clearResourceManifest();
+
+    /** Returns true if buildResourceManifest indexed at least one search path. */
+    bool isResourceManifestEnabled() const;
+
+    /**
+     *  Mounts an asset pack, see AssetPack.
+     *
+     *  The files of the pack appear under mountPoint as if they were on disk: fullPathForFilename,
+     *  isFileExist, getContents, getDataFromFile and getMappedDataFromFile find them through the
+     *  usual search paths and resolution orders, without touching the file system, and
+     *  isDirectoryExist sees the directories of the pack.
+     *
+     *  A relative name still resolves to the first search path and resolution order which has the
+     *  file, whether it is on disk or in a pack. A pack only wins over the disk, and a later pack over
+     *  an earlier one, when they provide the same full path.
+     *
+     *  listFiles and listFilesRecursively only list files on disk. A directory that only exists in a
+     *  pack is reported by isDirectoryExist but can't be written to.
+     *
+     *  @code
+     *  // res/cards.pack contains "res/card_general.png"
+     *  FileUtils::getInstance()->mountAssetPack("res/cards.pack");
+     *  auto sprite = Sprite::create("res/card_general.png");
+     *  @endcode
+     *
+     *  @param packPath The path of the pack, it could be a relative or absolute path.
+     *  @param mountPoint The directory the files are mounted in. A relative directory is relative to
+     *         the default resource root path, the default mounts the files at the resource root.
+     *  @return True if the pack was mounted.
+     */
+    virtual bool mountAssetPack(const std::string& packPath, const std::string& mountPoint = "");
+
+    /**
+     *  Unmounts an asset pack mounted by mountAssetPack.
+     *  Data already returned by getMappedDataFromFile stays valid.
+     *  @return True if the pack was mounted.
+     */
+    virtual bool unmountAssetPack(const std::string& packPath);
 
     /**
      *  Gets the new filename from the filename lookup dictionary.
@@ -958,9 +1153,12 @@ protected:
 
     /**
      *  The full path cache for normal files. When a file is found, it will be added into this cache.
-     *  This variable is used for improving the performance of file search.
+     *  Files which were not found are cached too if _notFoundCacheEnabled is set, until the search paths
+     *  change or a file is written.
+     *  This variable is used for improving the performance of file search and is safe to use without _mutex.
      */
-    mutable std::unordered_map<std::string, std::string> _fullPathCache;
+    mutable FullPathCache _fullPathCache;
+    bool _notFoundCacheEnabled;
 
     /**
      *  The full path cache for directories. When a diretory is found, it will be added into this cache.
@@ -968,6 +1166,46 @@ protected:
      */
     mutable std::unordered_map<std::string, std::string> _fullPathCacheDir;
 
+    /**
+     *  Search paths indexed by buildResourceManifest, and the full paths of every file found under them.
+     *  Guarded by _mutex.
+     */
+    std::vector<std::string> _manifestRoots;
+    mutable std::unordered_set<std::string> _manifestFiles;
+
+    /**
+     *  Checks the manifest for a full path.
+     *  @param found Set to whether the file exists, only valid when returning true.
+     *  @return True if the path is under an indexed search path.
+     */
+    bool findInResourceManifest(const std::string& fullPath, bool* found) const;
+
+    /** A pack mounted by mountAssetPack, mountPath is a directory with a trailing slash. */
+    struct MountedAssetPack
+    {
+        std::string mountPath;
+        std::shared_ptr<AssetPack> pack;
+    };
+
+    /**
+     *  Mounted asset packs, the last one has the highest priority. Guarded by _mutex.
+     */
+    std::vector<MountedAssetPack> _assetPacks;
+
+    /**
+     *  Finds the asset pack containing a full path.
+     *  @param entryName Filled with the name of the file inside the pack.
+     *  @return The pack, or nullptr if no mounted pack contains the path.
+     */
+    std::shared_ptr<AssetPack> findInAssetPacks(const std::string& fullPath, std::string* entryName) const;
+
+    /** Checks whether a mounted pack contains a directory, or is mounted inside it. */
+    bool isDirectoryInAssetPacks(const std::string& fullPath) const;
+
+    /** Keeps the manifest and the full path cache in sync when a file is created or removed. */
+    void onFileCreated(const std::string& fullPath) const;
+    void onFileRemoved(const std::string& fullPath) const;
+
     /**
      * Writable path.
      */
@@ -87,6 +87,7 @@ extern "C"
 #endif //CC_USE_TIFF
 
 #include "base/etc1.h"
+#include "base/etc2.h"
     
 #if CC_USE_JPEG
 #include "jpeglib.h"
@@ -103,6 +104,7 @@ extern "C"
 #endif // CC_USE_WEBP
 
 #include "base/ccMacros.h"
+#include "base/ccPixelUtils.h"
 #include "platform/CCCommon.h"
 #include "platform/CCStdC.h"
 #include "platform/CCFileUtils.h"
@@ -256,6 +258,9 @@ namespace
         _pixel3_formathash::value_type(PVR3TexturePixelFormat::PVRTC4BPP_RGBA,      Texture2D::PixelFormat::PVRTC4A),
 
         _pixel3_formathash::value_type(PVR3TexturePixelFormat::ETC1,        Texture2D::PixelFormat::ETC),
+        _pixel3_formathash::value_type(PVR3TexturePixelFormat::ETC2_RGB,    Texture2D::PixelFormat::ETC2_RGB8),
+        _pixel3_formathash::value_type(PVR3TexturePixelFormat::ETC2_RGBA,   Texture2D::PixelFormat::ETC2_RGBA8),
+        _pixel3_formathash::value_type(PVR3TexturePixelFormat::ETC2_RGBA1,  Texture2D::PixelFormat::ETC2_RGB8A1),
     };
         
     static const int PVR3_MAX_TABLE_ELEMENTS = sizeof(v3_pixel_formathash_value) / sizeof(v3_pixel_formathash_value[0]);
@@ -428,6 +433,31 @@ namespace
 
 //////////////////////////////////////////////////////////////////////////
 
+//struct and data for astc struct
+namespace
+{
+    static const unsigned char gASTCIdentifier[4] = {0x13, 0xAB, 0xA1, 0x5C};
+
+    struct ASTCTexHeader
+    {
+        unsigned char magic[4];
+        unsigned char blockDimX;
+        unsigned char blockDimY;
+        unsigned char blockDimZ;
+        unsigned char xsize[3];     // 24-bit little endian
+        unsigned char ysize[3];
+        unsigned char zsize[3];
+    };
+
+    int readASTCSize(const unsigned char size[3])
+    {
+        return size[0] | (size[1] << 8) | (size[2] << 16);
+    }
+}
+//astc struct end
+
+//////////////////////////////////////////////////////////////////////////
+
 namespace
 {
     typedef struct 
@@ -471,6 +501,17 @@ Texture2D::PixelFormat getDevicePixelFormat(Texture2D::PixelFormat format)
                 return format;
             else
                 return Texture2D::PixelFormat::RGB888;
+        case Texture2D::PixelFormat::ETC2_RGB8:
+            if(Configuration::getInstance()->supportsETC2())
+                return format;
+            else
+                return Texture2D::PixelFormat::RGB888;
+        case Texture2D::PixelFormat::ETC2_RGBA8:
+        case Texture2D::PixelFormat::ETC2_RGB8A1:
+            if(Configuration::getInstance()->supportsETC2())
+                return format;
+            else
+                return Texture2D::PixelFormat::RGBA8888;
         default:
             return format;
     }
@@ -511,7 +552,7 @@ bool Image::initWithImageFile(const std::string& path)
     bool ret = false;
     _filePath = FileUtils::getInstance()->fullPathForFilename(path);
 
-    Data data = FileUtils::getInstance()->getDataFromFile(_filePath);
+    MappedData data = FileUtils::getInstance()->getMappedDataFromFile(_filePath);
 
     if (!data.isNull())
     {
@@ -526,7 +567,7 @@ bool Image::initWithImageFileThreadSafe(const std::string& fullpath)
     bool ret = false;
     _filePath = fullpath;
 
-    Data data = FileUtils::getInstance()->getDataFromFile(fullpath);
+    MappedData data = FileUtils::getInstance()->getMappedDataFromFile(fullpath);
 
     if (!data.isNull())
     {
@@ -590,6 +631,12 @@ bool Image::initWithImageData(const unsigned char * data, ssize_t dataLen)
         case Format::ATITC:
             ret = initWithATITCData(unpackedData, unpackedLen);
             break;
+        case Format::ETC2:
+            ret = initWithETC2Data(unpackedData, unpackedLen);
+            break;
+        case Format::ASTC:
+            ret = initWithASTCData(unpackedData, unpackedLen);
+            break;
         default:
             {
                 // load and detect image format
@@ -660,6 +707,26 @@ bool Image::isATITC(const unsigned char *data, ssize_t /*dataLen*/)
     return true;
 }
 
+bool Image::isEtc2(const unsigned char *data, ssize_t dataLen)
+{
+    if (dataLen < ETC2_PKM_HEADER_SIZE)
+    {
+        return false;
+    }
+
+    return etc2_pkm_is_valid(data);
+}
+
+bool Image::isASTC(const unsigned char *data, ssize_t dataLen)
+{
+    if (static_cast<size_t>(dataLen) < sizeof(ASTCTexHeader))
+    {
+        return false;
+    }
+
+    return memcmp(data, gASTCIdentifier, sizeof(gASTCIdentifier)) == 0;
+}
+
 bool Image::isJpg(const unsigned char * data, ssize_t dataLen)
 {
     if (dataLen <= 4)
@@ -747,6 +814,14 @@ Image::Format Image::detectFormat(const unsigned char * data, ssize_t dataLen)
     {
         return Format::ATITC;
     }
+    else if (isEtc2(data, dataLen))
+    {
+        return Format::ETC2;
+    }
+    else if (isASTC(data, dataLen))
+    {
+        return Format::ASTC;
+    }
     else
     {
         return Format::UNKNOWN;
@@ -1371,6 +1446,9 @@ namespace
             case PVR3TexturePixelFormat::PVRTC4BPP_RGB:
             case PVR3TexturePixelFormat::PVRTC4BPP_RGBA:
             case PVR3TexturePixelFormat::ETC1:
+            case PVR3TexturePixelFormat::ETC2_RGB:
+            case PVR3TexturePixelFormat::ETC2_RGBA:
+            case PVR3TexturePixelFormat::ETC2_RGBA1:
             case PVR3TexturePixelFormat::RGBA8888:
             case PVR3TexturePixelFormat::RGBA4444:
             case PVR3TexturePixelFormat::RGBA5551:
@@ -1666,6 +1744,40 @@ bool Image::initWithPVRv3Data(const unsigned char * data, ssize_t dataLen)
                 widthBlocks = width / 4;
                 heightBlocks = height / 4;
                 break;
+            case PVR3TexturePixelFormat::ETC2_RGB:
+            case PVR3TexturePixelFormat::ETC2_RGBA:
+            case PVR3TexturePixelFormat::ETC2_RGBA1:
+            {
+                ETC2Format etc2Format = ETC2Format::RGB8;
+                bpp = 4;
+                if ((PVR3TexturePixelFormat)pixelFormat == PVR3TexturePixelFormat::ETC2_RGBA)
+                {
+                    etc2Format = ETC2Format::RGBA8;
+                    bpp = 8;
+                }
+                else if ((PVR3TexturePixelFormat)pixelFormat == PVR3TexturePixelFormat::ETC2_RGBA1)
+                {
+                    etc2Format = ETC2Format::RGB8A1;
+                }
+
+                if (!Configuration::getInstance()->supportsETC2())
+                {
+                    CCLOG("cocos2d: Hardware ETC2 decoder not present. Using software decoder");
+                    int bytePerPixel = etc2Format == ETC2Format::RGB8 ? 3 : 4;
+                    _unpack = true;
+                    _mipmaps[i].len = width*height*bytePerPixel;
+                    _mipmaps[i].address = new (std::nothrow) unsigned char[width*height*bytePerPixel];
+                    if (!etc2_decode_image(_data+dataOffset, _dataLen-dataOffset, _mipmaps[i].address, width, height, etc2Format))
+                    {
+                        return false;
+                    }
+                }
+                // ETC2 blocks are 4x4 texels, partial blocks are padded
+                blockSize = 4 * 4;
+                widthBlocks = (width + 3) / 4;
+                heightBlocks = (height + 3) / 4;
+                break;
+            }
             case PVR3TexturePixelFormat::BGRA8888:
                 if (! Configuration::getInstance()->supportsBGRA8888())
                 {
@@ -1679,12 +1791,15 @@ bool Image::initWithPVRv3Data(const unsigned char * data, ssize_t dataLen)
                 break;
         }
         
-        // Clamp to minimum number of blocks
-        if (widthBlocks < 2)
+        // Clamp to minimum number of blocks, ETC2 mipmaps are not padded
+        bool isETC2 = (PVR3TexturePixelFormat)pixelFormat == PVR3TexturePixelFormat::ETC2_RGB
+                   || (PVR3TexturePixelFormat)pixelFormat == PVR3TexturePixelFormat::ETC2_RGBA
+                   || (PVR3TexturePixelFormat)pixelFormat == PVR3TexturePixelFormat::ETC2_RGBA1;
+        if (widthBlocks < 2 && !isETC2)
         {
             widthBlocks = 2;
         }
-        if (heightBlocks < 2)
+        if (heightBlocks < 2 && !isETC2)
         {
             heightBlocks = 2;
         }
@@ -1774,6 +1889,156 @@ bool Image::initWithETCData(const unsigned char * data, ssize_t dataLen)
     return false;
 }
 
+bool Image::initWithETC2Data(const unsigned char *data, ssize_t dataLen)
+{
+    //check the data
+    if (! etc2_pkm_is_valid(data))
+    {
+        return false;
+    }
+
+    _width = etc2_pkm_get_width(data);
+    _height = etc2_pkm_get_height(data);
+
+    if (0 == _width || 0 == _height)
+    {
+        return false;
+    }
+
+    ETC2Format format = etc2_pkm_get_format(data);
+    const unsigned char* pixelData = data + ETC2_PKM_HEADER_SIZE;
+    ssize_t pixelDataLen = dataLen - ETC2_PKM_HEADER_SIZE;
+
+    if (pixelDataLen < static_cast<ssize_t>(etc2_get_encoded_data_size(_width, _height, format)))
+    {
+        CCLOG("cocos2d: WARNING: ETC2 data is truncated");
+        return false;
+    }
+
+    // ETC2_RGBA8 carries its own alpha channel, no separate alpha texture is needed
+    if (Configuration::getInstance()->supportsETC2())
+    {
+        switch (format)
+        {
+            case ETC2Format::RGBA8:
+                _renderFormat = Texture2D::PixelFormat::ETC2_RGBA8;
+                break;
+            case ETC2Format::RGB8A1:
+                _renderFormat = Texture2D::PixelFormat::ETC2_RGB8A1;
+                break;
+            default:
+                _renderFormat = Texture2D::PixelFormat::ETC2_RGB8;
+                break;
+        }
+        _dataLen = pixelDataLen;
+        _data = static_cast<unsigned char*>(malloc(_dataLen * sizeof(unsigned char)));
+        memcpy(_data, pixelData, _dataLen);
+        return true;
+    }
+
+    CCLOG("cocos2d: Hardware ETC2 decoder not present. Using software decoder");
+
+    //if the device does not support ETC2, decode texture by software
+    int bytePerPixel = 3;
+    _renderFormat = Texture2D::PixelFormat::RGB888;
+    if (format != ETC2Format::RGB8)
+    {
+        bytePerPixel = 4;
+        _renderFormat = Texture2D::PixelFormat::RGBA8888;
+    }
+
+    _dataLen = _width * _height * bytePerPixel;
+    _data = static_cast<unsigned char*>(malloc(_dataLen * sizeof(unsigned char)));
+
+    if (!etc2_decode_image(pixelData, pixelDataLen, _data, _width, _height, format))
+    {
+        _dataLen = 0;
+        CC_SAFE_FREE(_data);
+        return false;
+    }
+
+    return true;
+}
+
+bool Image::initWithASTCData(const unsigned char *data, ssize_t dataLen)
+{
+    const ASTCTexHeader *header = static_cast<const ASTCTexHeader *>(static_cast<const void*>(data));
+
+    _width = readASTCSize(header->xsize);
+    _height = readASTCSize(header->ysize);
+    int depth = readASTCSize(header->zsize);
+
+    if (0 == _width || 0 == _height)
+    {
+        return false;
+    }
+
+    if (depth != 1 || header->blockDimZ != 1)
+    {
+        CCLOG("cocos2d: WARNING: 3D ASTC textures are not supported");
+        return false;
+    }
+
+    Texture2D::PixelFormat pixelFormat = Texture2D::PixelFormat::NONE;
+    if (header->blockDimX == header->blockDimY)
+    {
+        switch (header->blockDimX)
+        {
+            case 4:
+                pixelFormat = Texture2D::PixelFormat::ASTC_4x4;
+                break;
+            case 5:
+                pixelFormat = Texture2D::PixelFormat::ASTC_5x5;
+                break;
+            case 6:
+                pixelFormat = Texture2D::PixelFormat::ASTC_6x6;
+                break;
+            case 8:
+                pixelFormat = Texture2D::PixelFormat::ASTC_8x8;
+                break;
+            case 10:
+                pixelFormat = Texture2D::PixelFormat::ASTC_10x10;
+                break;
+            case 12:
+                pixelFormat = Texture2D::PixelFormat::ASTC_12x12;
+                break;
+            default:
+                break;
+        }
+    }
+
+    if (pixelFormat == Texture2D::PixelFormat::NONE)
+    {
+        CCLOG("cocos2d: WARNING: Unsupported ASTC block footprint %dx%d", header->blockDimX, header->blockDimY);
+        return false;
+    }
+
+    // every ASTC block is 128 bits whatever its footprint
+    ssize_t blocksWide = (_width + header->blockDimX - 1) / header->blockDimX;
+    ssize_t blocksHigh = (_height + header->blockDimY - 1) / header->blockDimY;
+    ssize_t pixelDataLen = blocksWide * blocksHigh * 16;
+
+    if (dataLen - static_cast<ssize_t>(sizeof(ASTCTexHeader)) < pixelDataLen)
+    {
+        CCLOG("cocos2d: WARNING: ASTC data is truncated");
+        return false;
+    }
+
+    if (!Configuration::getInstance()->supportsASTC())
+    {
+        // decoding ASTC in software is too slow to be useful at load time, ship an ETC2 variant for these devices
+        CCLOG("cocos2d: WARNING: Hardware ASTC decoder not present. Use an ETC2 or PNG fallback for this texture");
+        return false;
+    }
+
+    _renderFormat = pixelFormat;
+    _dataLen = pixelDataLen;
+    _data = static_cast<unsigned char*>(malloc(_dataLen * sizeof(unsigned char)));
+    memcpy(_data, data + sizeof(ASTCTexHeader), _dataLen);
+
+    return true;
+}
+
 bool Image::initWithTGAData(tImageTGA* tgaData)
 {
     bool ret = false;
@@ -2462,12 +2727,7 @@ void Image::premultipliedAlpha()
 #else
     CCASSERT(_renderFormat == Texture2D::PixelFormat::RGBA8888, "The pixel format should be RGBA8888!");
     
-    unsigned int* fourBytes = (unsigned int*)_data;
-    for(int i = 0; i < _width * _height; i++)
-    {
-        unsigned char* p = _data + i * 4;
-        fourBytes[i] = CC_RGB_PREMULTIPLY_ALPHA(p[0], p[1], p[2], p[3]);
-    }
+    PixelUtils::premultiplyAlpha(_data, (ssize_t)_width * _height);
     
     _hasPremultipliedAlpha = true;
 #endif
@@ -93,6 +93,10 @@ public:
         S3TC,
         //! ATITC
         ATITC,
+        //! ETC2 (PKM 2.0 container)
+        ETC2,
+        //! ASTC
+        ASTC,
         //! TGA
         TGA,
         //! Raw Data
@@ -176,6 +180,8 @@ protected:
     bool initWithETCData(const unsigned char * data, ssize_t dataLen);
     bool initWithS3TCData(const unsigned char * data, ssize_t dataLen);
     bool initWithATITCData(const unsigned char *data, ssize_t dataLen);
+    bool initWithETC2Data(const unsigned char *data, ssize_t dataLen);
+    bool initWithASTCData(const unsigned char *data, ssize_t dataLen);
     typedef struct sImageTGA tImageTGA;
     bool initWithTGAData(tImageTGA* tgaData);
 
@@ -231,6 +237,8 @@ protected:
     bool isEtc(const unsigned char * data, ssize_t dataLen);
     bool isS3TC(const unsigned char * data,ssize_t dataLen);
     bool isATITC(const unsigned char *data, ssize_t dataLen);
+    bool isEtc2(const unsigned char *data, ssize_t dataLen);
+    bool isASTC(const unsigned char *data, ssize_t dataLen);
 };
 
 // end of platform group
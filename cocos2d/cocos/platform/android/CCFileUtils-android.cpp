@@ -352,7 +352,8 @@ FileUtils::Status FileUtilsAndroid::getContents(const std::string& filename, Res
 
     string fullPath = fullPathForFilename(filename);
 
-    if (fullPath[0] == '/')
+    string entryName;
+    if (fullPath[0] == '/' || findInAssetPacks(fullPath, &entryName))
         return FileUtils::getContents(fullPath, buffer);
 
     string relativePath = string();
@@ -396,6 +397,47 @@ FileUtils::Status FileUtilsAndroid::getContents(const std::string& filename, Res
     return FileUtils::Status::OK;
 }
 
+MappedData FileUtilsAndroid::getMappedDataFromFile(const std::string& filename, MappedData::Advice advice) const
+{
+    static const std::string apkprefix("assets/");
+    if (filename.empty())
+        return MappedData();
+
+    string fullPath = fullPathForFilename(filename);
+
+    string entryName;
+    if (fullPath[0] == '/' || obbfile || nullptr == assetmanager || findInAssetPacks(fullPath, &entryName))
+        return FileUtils::getMappedDataFromFile(fullPath, advice);
+
+    string relativePath = string();
+    size_t position = fullPath.find(apkprefix);
+    if (0 == position) {
+        // "assets/" is at the beginning of the path and we don't want it
+        relativePath += fullPath.substr(apkprefix.size());
+    } else {
+        relativePath = fullPath;
+    }
+
+    // AASSET_MODE_RANDOM/STREAMING map stored (uncompressed) assets directly out of the apk,
+    // compressed ones are inflated once into a buffer owned by the asset.
+    int mode = (advice == MappedData::Advice::RANDOM) ? AASSET_MODE_RANDOM : AASSET_MODE_STREAMING;
+    AAsset* asset = AAssetManager_open(assetmanager, relativePath.data(), mode);
+    if (nullptr == asset)
+        return FileUtils::getMappedDataFromFile(fullPath, advice);
+
+    const void* buffer = AAsset_getBuffer(asset);
+    if (nullptr == buffer) {
+        AAsset_close(asset);
+        return FileUtils::getMappedDataFromFile(fullPath, advice);
+    }
+
+    MappedData ret;
+    ret.setMapping((unsigned char*)buffer, AAsset_getLength(asset), [asset]() {
+        AAsset_close(asset);
+    });
+    return ret;
+}
+
 string FileUtilsAndroid::getWritablePath() const
 {
     // Fix for Nexus 10 (Android 4.2 multi-user environment)
@@ -71,6 +71,8 @@ public:
 
     virtual FileUtils::Status getContents(const std::string& filename, ResizableBuffer* buffer) const override;
 
+    virtual MappedData getMappedDataFromFile(const std::string& filename, MappedData::Advice advice) const override;
+
     virtual std::string getWritablePath() const override;
     virtual bool isAbsolutePath(const std::string& strPath) const override;
     
@@ -206,6 +206,8 @@ public:
     static const char* SHADER_NAME_POSITION_U_COLOR;
     /**Built in shader for draw a sector with 90 degrees with center at bottom left point.*/
     static const char* SHADER_NAME_POSITION_LENGTH_TEXTURE_COLOR;
+    /**Built in shader for the draw nodes batched through TrianglesCommand, the vertices are in world space and the opacity is in the vertex colors.*/
+    static const char* SHADER_NAME_POSITION_LENGTH_TEXTURE_COLOR_NO_MVP;
 
     /**Built in shader for ui effects */
     static const char* SHADER_NAME_POSITION_GRAYSCALE;
@@ -216,6 +218,14 @@ public:
     static const char* SHADER_NAME_LABEL_OUTLINE;
     static const char* SHADER_NAME_LABEL_DISTANCEFIELD_NORMAL;
     static const char* SHADER_NAME_LABEL_DISTANCEFIELD_GLOW;
+    /** @} */
+    /** @{
+        Built in shader for label without effects, the vertices are in world space and the text color is in the vertex colors.
+        The labels sharing a font atlas are batched with them.
+    */
+    static const char* SHADER_NAME_LABEL_NORMAL_NO_MVP;
+    static const char* SHADER_NAME_LABEL_DISTANCEFIELD_NORMAL_NO_MVP;
+    /** @} */
 
     /**Built in shader used for 3D, support Position vertex attribute, with color specified by a uniform.*/
     static const char* SHADER_3D_POSITION;
@@ -271,6 +281,11 @@ public:
      Built in shader for LayerRadialGradient
      */
     static const char* SHADER_LAYER_RADIAL_GRADIENT;
+
+    /**
+     Built in shader for ParticleSystemQuad, integrates ballistic particles from their emission state
+     */
+    static const char* SHADER_PARTICLE_GPU;
     
     /**
      Built in shader for camera clear
@@ -52,11 +52,14 @@ enum {
     kShaderType_PositionTextureA8Color,
     kShaderType_Position_uColor,
     kShaderType_PositionLengthTextureColor,
+    kShaderType_PositionLengthTextureColor_noMVP,
     kShaderType_LabelDistanceFieldNormal,
     kShaderType_LabelDistanceFieldGlow,
     kShaderType_UIGrayScale,
     kShaderType_LabelNormal,
     kShaderType_LabelOutline,
+    kShaderType_LabelNormal_noMVP,
+    kShaderType_LabelDistanceFieldNormal_noMVP,
     kShaderType_3DPosition,
     kShaderType_3DPositionTex,
     kShaderType_3DSkinPositionTex,
@@ -77,6 +80,7 @@ enum {
     kShaderType_ETC1ASPositionTextureGray,
     kShaderType_ETC1ASPositionTextureGray_noMVP,
     kShaderType_LayerRadialGradient,
+    kShaderType_ParticleGPU,
     kShaderType_MAX,
 };
 
@@ -219,6 +223,10 @@ void GLProgramCache::loadDefaultGLPrograms()
     loadDefaultGLProgram(p, kShaderType_PositionLengthTextureColor);
     _programs.emplace(GLProgram::SHADER_NAME_POSITION_LENGTH_TEXTURE_COLOR, p);
 
+    p = new (std::nothrow) GLProgram();
+    loadDefaultGLProgram(p, kShaderType_PositionLengthTextureColor_noMVP);
+    _programs.emplace(GLProgram::SHADER_NAME_POSITION_LENGTH_TEXTURE_COLOR_NO_MVP, p);
+
     p = new (std::nothrow) GLProgram();
     loadDefaultGLProgram(p, kShaderType_LabelDistanceFieldNormal);
     _programs.emplace(GLProgram::SHADER_NAME_LABEL_DISTANCEFIELD_NORMAL, p);
@@ -239,6 +247,14 @@ void GLProgramCache::loadDefaultGLPrograms()
     loadDefaultGLProgram(p, kShaderType_LabelOutline);
     _programs.emplace(GLProgram::SHADER_NAME_LABEL_OUTLINE, p);
 
+    p = new (std::nothrow) GLProgram();
+    loadDefaultGLProgram(p, kShaderType_LabelNormal_noMVP);
+    _programs.emplace(GLProgram::SHADER_NAME_LABEL_NORMAL_NO_MVP, p);
+
+    p = new (std::nothrow) GLProgram();
+    loadDefaultGLProgram(p, kShaderType_LabelDistanceFieldNormal_noMVP);
+    _programs.emplace(GLProgram::SHADER_NAME_LABEL_DISTANCEFIELD_NORMAL_NO_MVP, p);
+
     p = new (std::nothrow) GLProgram();
     loadDefaultGLProgram(p, kShaderType_3DPosition);
     _programs.emplace(GLProgram::SHADER_3D_POSITION, p);
@@ -312,6 +328,10 @@ void GLProgramCache::loadDefaultGLPrograms()
     p = new(std::nothrow) GLProgram();
     loadDefaultGLProgram(p, kShaderType_LayerRadialGradient);
     _programs.emplace(GLProgram::SHADER_LAYER_RADIAL_GRADIENT, p);
+
+    p = new(std::nothrow) GLProgram();
+    loadDefaultGLProgram(p, kShaderType_ParticleGPU);
+    _programs.emplace(GLProgram::SHADER_PARTICLE_GPU, p);
 }
 
 void GLProgramCache::reloadDefaultGLPrograms()
@@ -390,6 +410,10 @@ void GLProgramCache::reloadDefaultGLPrograms()
     p->reset();
     loadDefaultGLProgram(p, kShaderType_PositionLengthTextureColor);
 
+    p = getGLProgram(GLProgram::SHADER_NAME_POSITION_LENGTH_TEXTURE_COLOR_NO_MVP);
+    p->reset();
+    loadDefaultGLProgram(p, kShaderType_PositionLengthTextureColor_noMVP);
+
     p = getGLProgram(GLProgram::SHADER_NAME_LABEL_DISTANCEFIELD_NORMAL);
     p->reset();
     loadDefaultGLProgram(p, kShaderType_LabelDistanceFieldNormal);
@@ -410,6 +434,14 @@ void GLProgramCache::reloadDefaultGLPrograms()
     p->reset();
     loadDefaultGLProgram(p, kShaderType_LabelOutline);
 
+    p = getGLProgram(GLProgram::SHADER_NAME_LABEL_NORMAL_NO_MVP);
+    p->reset();
+    loadDefaultGLProgram(p, kShaderType_LabelNormal_noMVP);
+
+    p = getGLProgram(GLProgram::SHADER_NAME_LABEL_DISTANCEFIELD_NORMAL_NO_MVP);
+    p->reset();
+    loadDefaultGLProgram(p, kShaderType_LabelDistanceFieldNormal_noMVP);
+
     p = getGLProgram(GLProgram::SHADER_3D_POSITION);
     p->reset();
     loadDefaultGLProgram(p, kShaderType_3DPosition);
@@ -483,6 +515,10 @@ void GLProgramCache::reloadDefaultGLPrograms()
     p = getGLProgram(GLProgram::SHADER_LAYER_RADIAL_GRADIENT);
     loadDefaultGLProgram(p, kShaderType_LayerRadialGradient);
     _programs.emplace(GLProgram::SHADER_LAYER_RADIAL_GRADIENT, p);
+
+    p = getGLProgram(GLProgram::SHADER_PARTICLE_GPU);
+    p->reset();
+    loadDefaultGLProgram(p, kShaderType_ParticleGPU);
 }
 
 void GLProgramCache::reloadDefaultGLProgramsRelativeToLights()
@@ -548,6 +584,9 @@ void GLProgramCache::loadDefaultGLProgram(GLProgram *p, int type)
         case kShaderType_PositionLengthTextureColor:
             p->initWithByteArrays(ccPositionColorLengthTexture_vert, ccPositionColorLengthTexture_frag);
             break;
+        case kShaderType_PositionLengthTextureColor_noMVP:
+            p->initWithByteArrays(ccPositionColorLengthTexture_noMVP_vert, ccPositionColorLengthTexture_frag);
+            break;
         case kShaderType_LabelDistanceFieldNormal:
             p->initWithByteArrays(ccLabel_vert, ccLabelDistanceFieldNormal_frag);
             break;
@@ -564,6 +603,12 @@ void GLProgramCache::loadDefaultGLProgram(GLProgram *p, int type)
         case kShaderType_LabelOutline:
             p->initWithByteArrays(ccLabel_vert, ccLabelOutline_frag);
             break;
+        case kShaderType_LabelNormal_noMVP:
+            p->initWithByteArrays(ccPositionTextureColor_noMVP_vert, ccPositionTextureA8Color_frag);
+            break;
+        case kShaderType_LabelDistanceFieldNormal_noMVP:
+            p->initWithByteArrays(ccPositionTextureColor_noMVP_vert, ccLabelDistanceFieldNormal_noMVP_frag);
+            break;
         case kShaderType_3DPosition:
             p->initWithByteArrays(cc3D_PositionTex_vert, cc3D_Color_frag);
             break;
@@ -639,6 +684,9 @@ void GLProgramCache::loadDefaultGLProgram(GLProgram *p, int type)
         case kShaderType_LayerRadialGradient:
             p->initWithByteArrays(ccPosition_vert, ccShader_LayerRadialGradient_frag);
             break;
+        case kShaderType_ParticleGPU:
+            p->initWithByteArrays(ccParticleGPU_vert, ccPositionTextureColor_noMVP_frag);
+            break;
         default:
             CCLOG("cocos2d: %s:%d, error shader type", __FUNCTION__, __LINE__);
             return;
@@ -37,6 +37,7 @@ RenderCommand::RenderCommand()
 , _skipBatching(false)
 , _is3D(false)
 , _depth(0)
+, _isClipped(false)
 {
 }
 
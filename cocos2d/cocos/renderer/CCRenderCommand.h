@@ -98,6 +98,14 @@ public:
     void set3D(bool value) { _is3D = value; }
     /**Get the depth by current model view matrix.*/
     float getDepth() const { return _depth; }
+    /**Whether the command is clipped by a rectangle, it is set by the Renderer when the command is added.*/
+    bool isClipped() const { return _isClipped; }
+    /**Get the world space rectangle the command is clipped to, only valid when isClipped() returns true.*/
+    const Rect& getClipRect() const { return _clipRect; }
+    /**Clip the command to a world space rectangle, see Renderer::pushClipRect().*/
+    void setClipRect(const Rect& rect) { _clipRect = rect; _isClipped = true; }
+    /**Stop clipping the command.*/
+    void resetClipRect() { _isClipped = false; }
     
 protected:
     /**Constructor.*/
@@ -127,6 +135,12 @@ protected:
     
     /** Depth from the model view matrix.*/
     float _depth;
+    
+    /** Is the command clipped by _clipRect. */
+    bool _isClipped;
+    
+    /** World space clipping rectangle. */
+    Rect _clipRect;
 };
 
 NS_CC_END
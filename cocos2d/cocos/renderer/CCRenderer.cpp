@@ -45,6 +45,8 @@
 #include "base/CCEventDispatcher.h"
 #include "base/CCEventListenerCustom.h"
 #include "base/CCEventType.h"
+#include "math/CCAffineTransform.h"
+#include "platform/CCGLView.h"
 #include "2d/CCCamera.h"
 #include "2d/CCScene.h"
 
@@ -61,6 +63,67 @@ static bool compare3DCommand(RenderCommand* a, RenderCommand* b)
     return  a->getDepth() > b->getDepth();
 }
 
+static Rect intersectRect(const Rect& a, const Rect& b)
+{
+    float minX = std::max(a.getMinX(), b.getMinX());
+    float minY = std::max(a.getMinY(), b.getMinY());
+    float maxX = std::min(a.getMaxX(), b.getMaxX());
+    float maxY = std::min(a.getMaxY(), b.getMaxY());
+    return Rect(minX, minY, std::max(maxX - minX, 0.0f), std::max(maxY - minY, 0.0f));
+}
+
+static V3F_C4B_T2F lerpVertex(const V3F_C4B_T2F& a, const V3F_C4B_T2F& b, float t)
+{
+    V3F_C4B_T2F v;
+    v.vertices = a.vertices + (b.vertices - a.vertices) * t;
+    v.colors.r = (GLubyte)(a.colors.r + (b.colors.r - a.colors.r) * t + 0.5f);
+    v.colors.g = (GLubyte)(a.colors.g + (b.colors.g - a.colors.g) * t + 0.5f);
+    v.colors.b = (GLubyte)(a.colors.b + (b.colors.b - a.colors.b) * t + 0.5f);
+    v.colors.a = (GLubyte)(a.colors.a + (b.colors.a - a.colors.a) * t + 0.5f);
+    v.texCoords.u = a.texCoords.u + (b.texCoords.u - a.texCoords.u) * t;
+    v.texCoords.v = a.texCoords.v + (b.texCoords.v - a.texCoords.v) * t;
+    return v;
+}
+
+// Sutherland-Hodgman step, keeps the part of the convex polygon on one side of a vertical (axis 0) or horizontal (axis 1) line
+static int clipPolygon(const V3F_C4B_T2F* in, int count, V3F_C4B_T2F* out, int axis, float value, bool keepGreater)
+{
+    int outCount = 0;
+    for (int i = 0; i < count; ++i)
+    {
+        const V3F_C4B_T2F& a = in[i];
+        const V3F_C4B_T2F& b = in[(i + 1) % count];
+        float da = (axis == 0 ? a.vertices.x : a.vertices.y) - value;
+        float db = (axis == 0 ? b.vertices.x : b.vertices.y) - value;
+        if (!keepGreater)
+        {
+            da = -da;
+            db = -db;
+        }
+
+        if (da >= 0)
+            out[outCount++] = a;
+        if ((da >= 0) != (db >= 0))
+        {
+            V3F_C4B_T2F v = lerpVertex(a, b, da / (da - db));
+            (axis == 0 ? v.vertices.x : v.vertices.y) = value;
+            out[outCount++] = v;
+        }
+    }
+    return outCount;
+}
+
+static bool isQuadIndices(const unsigned short* indices, ssize_t indexCount)
+{
+    for (ssize_t i = 0, v = 0; i < indexCount; i += 6, v += 4)
+    {
+        if (indices[i] != v || indices[i+1] != v+1 || indices[i+2] != v+2 ||
+            indices[i+3] != v+3 || indices[i+4] != v+2 || indices[i+5] != v+1)
+            return false;
+    }
+    return true;
+}
+
 // queue
 RenderQueue::RenderQueue()
 {
@@ -206,6 +269,7 @@ Renderer::Renderer()
 ,_glViewAssigned(false)
 ,_isRendering(false)
 ,_isDepthTestFor2D(false)
+,_clipScissorOldState(false)
 #if CC_ENABLE_CACHE_TEXTURE_DATA
 ,_cacheTextureListener(nullptr)
 #endif
@@ -358,9 +422,40 @@ void Renderer::addCommand(RenderCommand* command, int renderQueueID)
     CCASSERT(renderQueueID >=0, "Invalid render queue");
     CCASSERT(command->getType() != RenderCommand::Type::UNKNOWN_COMMAND, "Invalid Command Type");
 
+    if (_clipRectStack.empty())
+        command->resetClipRect();
+    else
+        command->setClipRect(_clipRectStack.back());
+
     _renderGroups[renderQueueID].push_back(command);
 }
 
+void Renderer::pushClipRect(const Rect& rect)
+{
+    CCASSERT(!_isRendering, "Cannot change the clipping rectangle while rendering");
+    if (_clipRectStack.empty())
+        _clipRectStack.push_back(rect);
+    else
+        _clipRectStack.push_back(intersectRect(_clipRectStack.back(), rect));
+}
+
+bool Renderer::pushClipRect(const Rect& rect, const Mat4& transform)
+{
+    // the rectangle has to stay in the z = 0 plane with its edges parallel to the axes
+    const float* m = transform.m;
+    if (m[1] != 0 || m[4] != 0 || m[2] != 0 || m[6] != 0 || m[3] != 0 || m[7] != 0 || m[15] != 1)
+        return false;
+
+    pushClipRect(RectApplyTransform(rect, transform));
+    return true;
+}
+
+void Renderer::popClipRect()
+{
+    CCASSERT(!_clipRectStack.empty(), "popClipRect() without pushClipRect()");
+    _clipRectStack.pop_back();
+}
+
 void Renderer::pushGroup(int renderQueueID)
 {
     CCASSERT(!_isRendering, "Cannot change render queue while rendering");
@@ -389,24 +484,40 @@ void Renderer::processRenderCommand(RenderCommand* command)
         flush3D();
 
         auto cmd = static_cast<TrianglesCommand*>(command);
+        ssize_t vertexCount = cmd->getVertexCount();
+        ssize_t indexCount = cmd->getIndexCount();
+
+        // clip it on the CPU, it keeps batching with the other commands
+        ClippedTriangles clipped;
+        if (cmd->isClipped())
+        {
+            if (!clipTriangles(cmd, clipped))
+                return;
+            vertexCount = clipped.vertexCount;
+            indexCount = clipped.indexCount;
+        }
         
         // flush own queue when buffer is full
-        if(_filledVertex + cmd->getVertexCount() > VBO_SIZE || _filledIndex + cmd->getIndexCount() > INDEX_VBO_SIZE)
+        if(_filledVertex + vertexCount > VBO_SIZE || _filledIndex + indexCount > INDEX_VBO_SIZE)
         {
-            CCASSERT(cmd->getVertexCount()>= 0 && cmd->getVertexCount() < VBO_SIZE, "VBO for vertex is not big enough, please break the data down or use customized render command");
-            CCASSERT(cmd->getIndexCount()>= 0 && cmd->getIndexCount() < INDEX_VBO_SIZE, "VBO for index is not big enough, please break the data down or use customized render command");
+            CCASSERT(vertexCount>= 0 && vertexCount < VBO_SIZE, "VBO for vertex is not big enough, please break the data down or use customized render command");
+            CCASSERT(indexCount>= 0 && indexCount < INDEX_VBO_SIZE, "VBO for index is not big enough, please break the data down or use customized render command");
             drawBatchedTriangles();
         }
         
         // queue it
         _queuedTriangleCommands.push_back(cmd);
-        _filledIndex += cmd->getIndexCount();
-        _filledVertex += cmd->getVertexCount();
+        if (cmd->isClipped())
+            _queuedClippedTriangles.push_back(clipped);
+        _filledIndex += indexCount;
+        _filledVertex += vertexCount;
     }
     else if (RenderCommand::Type::MESH_COMMAND == commandType)
     {
         flush2D();
         auto cmd = static_cast<MeshCommand*>(command);
+        if (cmd->isClipped())
+            beginClipScissor(cmd);
         
         if (cmd->isSkipBatching() || _lastBatchedMeshCommand == nullptr || _lastBatchedMeshCommand->getMaterialID() != cmd->getMaterialID())
         {
@@ -433,6 +544,9 @@ void Renderer::processRenderCommand(RenderCommand* command)
             CCGL_DEBUG_INSERT_EVENT_MARKER("RENDERER_MESH_COMMAND");
             cmd->batchDraw();
         }
+
+        if (cmd->isClipped())
+            endClipScissor();
     }
     else if(RenderCommand::Type::GROUP_COMMAND == commandType)
     {
@@ -447,21 +561,48 @@ void Renderer::processRenderCommand(RenderCommand* command)
         flush();
         auto cmd = static_cast<CustomCommand*>(command);
         CCGL_DEBUG_INSERT_EVENT_MARKER("RENDERER_CUSTOM_COMMAND");
-        cmd->execute();
+        if (cmd->isClipped())
+        {
+            beginClipScissor(cmd);
+            cmd->execute();
+            endClipScissor();
+        }
+        else
+        {
+            cmd->execute();
+        }
     }
     else if(RenderCommand::Type::BATCH_COMMAND == commandType)
     {
         flush();
         auto cmd = static_cast<BatchCommand*>(command);
         CCGL_DEBUG_INSERT_EVENT_MARKER("RENDERER_BATCH_COMMAND");
-        cmd->execute();
+        if (cmd->isClipped())
+        {
+            beginClipScissor(cmd);
+            cmd->execute();
+            endClipScissor();
+        }
+        else
+        {
+            cmd->execute();
+        }
     }
     else if(RenderCommand::Type::PRIMITIVE_COMMAND == commandType)
     {
         flush();
         auto cmd = static_cast<PrimitiveCommand*>(command);
         CCGL_DEBUG_INSERT_EVENT_MARKER("RENDERER_PRIMITIVE_COMMAND");
-        cmd->execute();
+        if (cmd->isClipped())
+        {
+            beginClipScissor(cmd);
+            cmd->execute();
+            endClipScissor();
+        }
+        else
+        {
+            cmd->execute();
+        }
     }
     else
     {
@@ -666,6 +807,9 @@ void Renderer::clean()
 
     // Clear batch commands
     _queuedTriangleCommands.clear();
+    _queuedClippedTriangles.clear();
+    _clippedVerts.clear();
+    _clippedIndices.clear();
     _filledVertex = 0;
     _filledIndex = 0;
     _lastBatchedMeshCommand = nullptr;
@@ -728,6 +872,189 @@ void Renderer::fillVerticesAndIndices(const TrianglesCommand* cmd)
     _filledIndex += cmd->getIndexCount();
 }
 
+bool Renderer::clipTriangles(const TrianglesCommand* cmd, ClippedTriangles& clipped)
+{
+    // the geometry of the commands already drawn is not needed anymore
+    if (_queuedClippedTriangles.empty())
+    {
+        _clippedVerts.clear();
+        _clippedIndices.clear();
+    }
+
+    const Rect& clipRect = cmd->getClipRect();
+    const float minX = clipRect.getMinX();
+    const float maxX = clipRect.getMaxX();
+    const float minY = clipRect.getMinY();
+    const float maxY = clipRect.getMaxY();
+
+    const ssize_t vertexCount = cmd->getVertexCount();
+    const ssize_t indexCount = cmd->getIndexCount();
+    clipped.vertexOffset = _clippedVerts.size();
+    clipped.indexOffset = _clippedIndices.size();
+
+    // clipping is done in world coordinates, the vertices are transformed here instead of in fillVerticesAndIndices()
+    _clippedVerts.resize(clipped.vertexOffset + vertexCount);
+    memcpy(&_clippedVerts[clipped.vertexOffset], cmd->getVertices(), sizeof(V3F_C4B_T2F) * vertexCount);
+    const Mat4& modelView = cmd->getModelView();
+    for (ssize_t i = 0; i < vertexCount; ++i)
+    {
+        modelView.transformPoint(&(_clippedVerts[clipped.vertexOffset + i].vertices));
+    }
+
+    const unsigned short* indices = cmd->getIndices();
+    if (indexCount % 6 == 0 && vertexCount == indexCount / 6 * 4 && isQuadIndices(indices, indexCount))
+    {
+        // quads: the axis aligned ones are trimmed in place, so that they keep their 4 vertices
+        for (ssize_t i = 0; i < vertexCount; i += 4)
+        {
+            const unsigned short v = (unsigned short)i;
+            // tl, bl, tr, br
+            V3F_C4B_T2F* quad = &_clippedVerts[clipped.vertexOffset + v];
+            if (quad[0].vertices.x == quad[1].vertices.x && quad[2].vertices.x == quad[3].vertices.x &&
+                quad[0].vertices.y == quad[2].vertices.y && quad[1].vertices.y == quad[3].vertices.y)
+            {
+                const float x0 = quad[0].vertices.x;
+                const float x1 = quad[2].vertices.x;
+                const float y0 = quad[0].vertices.y;
+                const float y1 = quad[1].vertices.y;
+                const float left = std::min(x0, x1);
+                const float right = std::max(x0, x1);
+                const float bottom = std::min(y0, y1);
+                const float top = std::max(y0, y1);
+
+                if (left >= maxX || right <= minX || bottom >= maxY || top <= minY)
+                    continue;
+
+                if (left < minX || right > maxX || bottom < minY || top > maxY)
+                {
+                    const V3F_C4B_T2F corners[4] = { quad[0], quad[1], quad[2], quad[3] };
+                    for (int k = 0; k < 4; ++k)
+                    {
+                        const float x = clampf(corners[k].vertices.x, minX, maxX);
+                        const float y = clampf(corners[k].vertices.y, minY, maxY);
+                        const float s = x0 != x1 ? (x - x0) / (x1 - x0) : 0;
+                        const float t = y0 != y1 ? (y - y0) / (y1 - y0) : 0;
+                        quad[k] = lerpVertex(lerpVertex(corners[0], corners[2], s), lerpVertex(corners[1], corners[3], s), t);
+                        quad[k].vertices.x = x;
+                        quad[k].vertices.y = y;
+                    }
+                }
+
+                const unsigned short quadIndices[6] = { v, (unsigned short)(v+1), (unsigned short)(v+2), (unsigned short)(v+3), (unsigned short)(v+2), (unsigned short)(v+1) };
+                _clippedIndices.insert(_clippedIndices.end(), quadIndices, quadIndices + 6);
+            }
+            else
+            {
+                clipTriangle(clipped.vertexOffset, v, v+1, v+2, clipRect);
+                clipTriangle(clipped.vertexOffset, v+3, v+2, v+1, clipRect);
+            }
+        }
+    }
+    else
+    {
+        for (ssize_t i = 0; i < indexCount; i += 3)
+        {
+            clipTriangle(clipped.vertexOffset, indices[i], indices[i+1], indices[i+2], clipRect);
+        }
+    }
+
+    clipped.vertexCount = _clippedVerts.size() - clipped.vertexOffset;
+    clipped.indexCount = _clippedIndices.size() - clipped.indexOffset;
+    if (clipped.indexCount == 0)
+    {
+        _clippedVerts.resize(clipped.vertexOffset);
+        return false;
+    }
+    return true;
+}
+
+void Renderer::clipTriangle(ssize_t vertexOffset, unsigned short a, unsigned short b, unsigned short c, const Rect& clipRect)
+{
+    // a triangle clipped by the 4 edges has at most 7 vertices
+    V3F_C4B_T2F polygon[8];
+    V3F_C4B_T2F clippedPolygon[8];
+    polygon[0] = _clippedVerts[vertexOffset + a];
+    polygon[1] = _clippedVerts[vertexOffset + b];
+    polygon[2] = _clippedVerts[vertexOffset + c];
+
+    const float left = std::min(std::min(polygon[0].vertices.x, polygon[1].vertices.x), polygon[2].vertices.x);
+    const float right = std::max(std::max(polygon[0].vertices.x, polygon[1].vertices.x), polygon[2].vertices.x);
+    const float bottom = std::min(std::min(polygon[0].vertices.y, polygon[1].vertices.y), polygon[2].vertices.y);
+    const float top = std::max(std::max(polygon[0].vertices.y, polygon[1].vertices.y), polygon[2].vertices.y);
+
+    if (left >= clipRect.getMaxX() || right <= clipRect.getMinX() || bottom >= clipRect.getMaxY() || top <= clipRect.getMinY())
+        return;
+
+    if (left >= clipRect.getMinX() && right <= clipRect.getMaxX() && bottom >= clipRect.getMinY() && top <= clipRect.getMaxY())
+    {
+        const unsigned short triangle[3] = { a, b, c };
+        _clippedIndices.insert(_clippedIndices.end(), triangle, triangle + 3);
+        return;
+    }
+
+    int count = clipPolygon(polygon, 3, clippedPolygon, 0, clipRect.getMinX(), true);
+    count = clipPolygon(clippedPolygon, count, polygon, 0, clipRect.getMaxX(), false);
+    count = clipPolygon(polygon, count, clippedPolygon, 1, clipRect.getMinY(), true);
+    count = clipPolygon(clippedPolygon, count, polygon, 1, clipRect.getMaxY(), false);
+    if (count < 3)
+        return;
+
+    const unsigned short first = (unsigned short)(_clippedVerts.size() - vertexOffset);
+    _clippedVerts.insert(_clippedVerts.end(), polygon, polygon + count);
+    for (int i = 1; i < count - 1; ++i)
+    {
+        const unsigned short triangle[3] = { first, (unsigned short)(first + i), (unsigned short)(first + i + 1) };
+        _clippedIndices.insert(_clippedIndices.end(), triangle, triangle + 3);
+    }
+}
+
+void Renderer::fillClippedVerticesAndIndices(const ClippedTriangles& clipped)
+{
+    // already in world coordinates
+    memcpy(&_verts[_filledVertex], &_clippedVerts[clipped.vertexOffset], sizeof(V3F_C4B_T2F) * clipped.vertexCount);
+
+    const unsigned short* indices = &_clippedIndices[clipped.indexOffset];
+    for(ssize_t i=0; i< clipped.indexCount; ++i)
+    {
+        _indices[_filledIndex + i] = _filledVertex + indices[i];
+    }
+
+    _filledVertex += clipped.vertexCount;
+    _filledIndex += clipped.indexCount;
+}
+
+void Renderer::beginClipScissor(const RenderCommand* command)
+{
+    auto glview = Director::getInstance()->getOpenGLView();
+    Rect rect = command->getClipRect();
+
+    _clipScissorOldState = glview->isScissorEnabled();
+    if (_clipScissorOldState)
+    {
+        _clipScissorOldRect = glview->getScissorRect();
+        rect = intersectRect(rect, _clipScissorOldRect);
+    }
+    else
+    {
+        glEnable(GL_SCISSOR_TEST);
+    }
+    glview->setScissorInPoints(rect.origin.x, rect.origin.y, rect.size.width, rect.size.height);
+}
+
+void Renderer::endClipScissor()
+{
+    if (_clipScissorOldState)
+    {
+        auto glview = Director::getInstance()->getOpenGLView();
+        glview->setScissorInPoints(_clipScissorOldRect.origin.x, _clipScissorOldRect.origin.y,
+                                   _clipScissorOldRect.size.width, _clipScissorOldRect.size.height);
+    }
+    else
+    {
+        glDisable(GL_SCISSOR_TEST);
+    }
+}
+
 void Renderer::drawBatchedTriangles()
 {
     if(_queuedTriangleCommands.empty())
@@ -748,18 +1075,29 @@ void Renderer::drawBatchedTriangles()
     int prevMaterialID = -1;
     bool firstCommand = true;
 
+    size_t clippedCommand = 0;
     for(const auto& cmd : _queuedTriangleCommands)
     {
         auto currentMaterialID = cmd->getMaterialID();
         const bool batchable = !cmd->isSkipBatching();
 
-        fillVerticesAndIndices(cmd);
+        ssize_t indexCount = cmd->getIndexCount();
+        if (cmd->isClipped())
+        {
+            const auto& clipped = _queuedClippedTriangles[clippedCommand++];
+            fillClippedVerticesAndIndices(clipped);
+            indexCount = clipped.indexCount;
+        }
+        else
+        {
+            fillVerticesAndIndices(cmd);
+        }
 
         // in the same batch ?
         if (batchable && (prevMaterialID == currentMaterialID || firstCommand))
         {
             CC_ASSERT((firstCommand || _triBatchesToDraw[batchesTotal].cmd->getMaterialID() == cmd->getMaterialID()) && "argh... error in logic");
-            _triBatchesToDraw[batchesTotal].indicesToDraw += cmd->getIndexCount();
+            _triBatchesToDraw[batchesTotal].indicesToDraw += indexCount;
             _triBatchesToDraw[batchesTotal].cmd = cmd;
         }
         else
@@ -771,7 +1109,7 @@ void Renderer::drawBatchedTriangles()
             }
 
             _triBatchesToDraw[batchesTotal].cmd = cmd;
-            _triBatchesToDraw[batchesTotal].indicesToDraw = (int) cmd->getIndexCount();
+            _triBatchesToDraw[batchesTotal].indicesToDraw = (int) indexCount;
 
             // is this a single batch ? Prevent creating a batch group then
             if (!batchable)
@@ -864,6 +1202,7 @@ void Renderer::drawBatchedTriangles()
     }
 
     _queuedTriangleCommands.clear();
+    _queuedClippedTriangles.clear();
     _filledVertex = 0;
     _filledIndex = 0;
 }
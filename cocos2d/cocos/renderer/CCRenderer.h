@@ -169,6 +169,19 @@ public:
     /** Pops a group from the render queue */
     void popGroup();
 
+    /** Pushes a world space rectangle, intersected with the current one, that the commands added until popClipRect() is called are clipped to.
+     `TrianglesCommand`s are clipped on the CPU, so they keep batching with the unclipped ones, the other commands are drawn with the scissor test.
+     */
+    void pushClipRect(const Rect& rect);
+
+    /** Pushes `rect` transformed by `transform` if it stays an axis aligned rectangle in world space.
+     @return false, and nothing is pushed, if the transform rotates, skews or projects the rectangle.
+     */
+    bool pushClipRect(const Rect& rect, const Mat4& transform);
+
+    /** Pops the rectangle pushed by the last pushClipRect() */
+    void popClipRect();
+
     /** Creates a render queue and returns its Id */
     int createRenderQueue();
 
@@ -232,6 +245,22 @@ protected:
 
     void fillVerticesAndIndices(const TrianglesCommand* cmd);
 
+    // The part of a clipped TrianglesCommand inside its clipping rectangle, in _clippedVerts and _clippedIndices
+    struct ClippedTriangles {
+        ssize_t vertexOffset;
+        ssize_t vertexCount;
+        ssize_t indexOffset;
+        ssize_t indexCount;
+    };
+    // returns false if nothing of the command is inside its clipping rectangle
+    bool clipTriangles(const TrianglesCommand* cmd, ClippedTriangles& clipped);
+    void clipTriangle(ssize_t vertexOffset, unsigned short a, unsigned short b, unsigned short c, const Rect& clipRect);
+    void fillClippedVerticesAndIndices(const ClippedTriangles& clipped);
+
+    // scissor test for the clipped commands which are not clipped on the CPU
+    void beginClipScissor(const RenderCommand* command);
+    void endClipScissor();
+
 
     /* clear color set outside be used in setGLDefaultValues() */
     Color4F _clearColor;
@@ -243,6 +272,14 @@ protected:
     MeshCommand* _lastBatchedMeshCommand;
     std::vector<TrianglesCommand*> _queuedTriangleCommands;
 
+    std::vector<Rect> _clipRectStack;
+    // world space geometry of the queued clipped commands, in the order they are queued
+    std::vector<V3F_C4B_T2F> _clippedVerts;
+    std::vector<unsigned short> _clippedIndices;
+    std::vector<ClippedTriangles> _queuedClippedTriangles;
+    bool _clipScissorOldState;
+    Rect _clipScissorOldRect;
+
     //for TrianglesCommand
     V3F_C4B_T2F _verts[VBO_SIZE];
     GLushort _indices[INDEX_VBO_SIZE];
@@ -41,6 +41,7 @@ THE SOFTWARE.
 #include "base/ccConfig.h"
 #include "base/ccMacros.h"
 #include "base/ccUTF8.h"
+#include "base/ccPixelUtils.h"
 #include "base/CCConfiguration.h"
 #include "platform/CCPlatformMacros.h"
 #include "base/CCDirector.h"
@@ -53,6 +54,25 @@ THE SOFTWARE.
     #include "renderer/CCTextureCache.h"
 #endif
 
+// ETC2 and ASTC tokens are missing from OpenGL ES 2.0 and older desktop headers
+#ifndef GL_COMPRESSED_RGB8_ETC2
+#define GL_COMPRESSED_RGB8_ETC2                         0x9274
+#endif
+#ifndef GL_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2
+#define GL_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2     0x9276
+#endif
+#ifndef GL_COMPRESSED_RGBA8_ETC2_EAC
+#define GL_COMPRESSED_RGBA8_ETC2_EAC                    0x9278
+#endif
+#ifndef GL_COMPRESSED_RGBA_ASTC_4x4_KHR
+#define GL_COMPRESSED_RGBA_ASTC_4x4_KHR                 0x93B0
+#define GL_COMPRESSED_RGBA_ASTC_5x5_KHR                 0x93B2
+#define GL_COMPRESSED_RGBA_ASTC_6x6_KHR                 0x93B4
+#define GL_COMPRESSED_RGBA_ASTC_8x8_KHR                 0x93B7
+#define GL_COMPRESSED_RGBA_ASTC_10x10_KHR               0x93BB
+#define GL_COMPRESSED_RGBA_ASTC_12x12_KHR               0x93BD
+#endif
+
 NS_CC_BEGIN
 
 
@@ -108,6 +128,18 @@ namespace {
         PixelFormatInfoMapValue(Texture2D::PixelFormat::ATC_INTERPOLATED_ALPHA, Texture2D::PixelFormatInfo(GL_ATC_RGBA_INTERPOLATED_ALPHA_AMD,
             0xFFFFFFFF, 0xFFFFFFFF, 8, true, false)),
 #endif
+
+        PixelFormatInfoMapValue(Texture2D::PixelFormat::ETC2_RGB8, Texture2D::PixelFormatInfo(GL_COMPRESSED_RGB8_ETC2, 0xFFFFFFFF, 0xFFFFFFFF, 4, true, false)),
+        PixelFormatInfoMapValue(Texture2D::PixelFormat::ETC2_RGBA8, Texture2D::PixelFormatInfo(GL_COMPRESSED_RGBA8_ETC2_EAC, 0xFFFFFFFF, 0xFFFFFFFF, 8, true, true)),
+        PixelFormatInfoMapValue(Texture2D::PixelFormat::ETC2_RGB8A1, Texture2D::PixelFormatInfo(GL_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2, 0xFFFFFFFF, 0xFFFFFFFF, 4, true, true)),
+
+        // ASTC blocks are always 128 bits, bpp is rounded up for footprints that do not divide it
+        PixelFormatInfoMapValue(Texture2D::PixelFormat::ASTC_4x4, Texture2D::PixelFormatInfo(GL_COMPRESSED_RGBA_ASTC_4x4_KHR, 0xFFFFFFFF, 0xFFFFFFFF, 8, true, true)),
+        PixelFormatInfoMapValue(Texture2D::PixelFormat::ASTC_5x5, Texture2D::PixelFormatInfo(GL_COMPRESSED_RGBA_ASTC_5x5_KHR, 0xFFFFFFFF, 0xFFFFFFFF, 6, true, true)),
+        PixelFormatInfoMapValue(Texture2D::PixelFormat::ASTC_6x6, Texture2D::PixelFormatInfo(GL_COMPRESSED_RGBA_ASTC_6x6_KHR, 0xFFFFFFFF, 0xFFFFFFFF, 4, true, true)),
+        PixelFormatInfoMapValue(Texture2D::PixelFormat::ASTC_8x8, Texture2D::PixelFormatInfo(GL_COMPRESSED_RGBA_ASTC_8x8_KHR, 0xFFFFFFFF, 0xFFFFFFFF, 2, true, true)),
+        PixelFormatInfoMapValue(Texture2D::PixelFormat::ASTC_10x10, Texture2D::PixelFormatInfo(GL_COMPRESSED_RGBA_ASTC_10x10_KHR, 0xFFFFFFFF, 0xFFFFFFFF, 2, true, true)),
+        PixelFormatInfoMapValue(Texture2D::PixelFormat::ASTC_12x12, Texture2D::PixelFormatInfo(GL_COMPRESSED_RGBA_ASTC_12x12_KHR, 0xFFFFFFFF, 0xFFFFFFFF, 1, true, true)),
     };
 }
 
@@ -313,13 +345,7 @@ void Texture2D::convertRGB888ToRGB565(const unsigned char* data, ssize_t dataLen
 // RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA -> RRRRRGGGGGGBBBBB
 void Texture2D::convertRGBA8888ToRGB565(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
 {
-    unsigned short* out16 = (unsigned short*)outData;
-    for (ssize_t i = 0, l = dataLen - 3; i < l; i += 4)
-    {
-        *out16++ = (data[i] & 0x00F8) << 8    //R
-            | (data[i + 1] & 0x00FC) << 3     //G
-            | (data[i + 2] & 0x00F8) >> 3;    //B
-    }
+    PixelUtils::convertRGBA8888ToRGB565(data, dataLen / 4, outData);
 }
 
 // RRRRRRRRGGGGGGGGBBBBBBBB -> AAAAAAAA
@@ -352,10 +378,7 @@ void Texture2D::convertRGBA8888ToI8(const unsigned char* data, ssize_t dataLen,
 // RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA -> AAAAAAAA
 void Texture2D::convertRGBA8888ToA8(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
 {
-    for (ssize_t i = 0, l = dataLen -3; i < l; i += 4)
-    {
-        *outData++ = data[i + 3]; //A
-    }
+    PixelUtils::convertRGBA8888ToA8(data, dataLen / 4, outData);
 }
 
 // RRRRRRRRGGGGGGGGBBBBBBBB -> IIIIIIIIAAAAAAAA
@@ -395,14 +418,7 @@ void Texture2D::convertRGB888ToRGBA4444(const unsigned char* data, ssize_t dataL
 // RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA -> RRRRGGGGBBBBAAAA
 void Texture2D::convertRGBA8888ToRGBA4444(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
 {
-    unsigned short* out16 = (unsigned short*)outData;
-    for (ssize_t i = 0, l = dataLen - 3; i < l; i += 4)
-    {
-        *out16++ = (data[i] & 0x00F0) << 8    //R
-        | (data[i + 1] & 0x00F0) << 4         //G
-        | (data[i + 2] & 0xF0)                //B
-        |  (data[i + 3] & 0xF0) >> 4;         //A
-    }
+    PixelUtils::convertRGBA8888ToRGBA4444(data, dataLen / 4, outData);
 }
 
 // RRRRRRRRGGGGGGGGBBBBBBBB -> RRRRRGGGGGBBBBBA
@@ -421,14 +437,7 @@ void Texture2D::convertRGB888ToRGB5A1(const unsigned char* data, ssize_t dataLen
 // RRRRRRRRGGGGGGGGBBBBBBBB -> RRRRRGGGGGBBBBBA
 void Texture2D::convertRGBA8888ToRGB5A1(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
 {
-    unsigned short* out16 = (unsigned short*)outData;
-    for (ssize_t i = 0, l = dataLen - 2; i < l; i += 4)
-    {
-        *out16++ = (data[i] & 0x00F8) << 8    //R
-            | (data[i + 1] & 0x00F8) << 3     //G
-            | (data[i + 2] & 0x00F8) >> 2     //B
-            |  (data[i + 3] & 0x0080) >> 7;   //A
-    }
+    PixelUtils::convertRGBA8888ToRGB5A1(data, dataLen / 4, outData);
 }
 // converter function end
 //////////////////////////////////////////////////////////////////////////
@@ -592,7 +601,9 @@ bool Texture2D::initWithMipmaps(MipmapInfo* mipmaps, int mipmapsNum, PixelFormat
     if (info.compressed && !Configuration::getInstance()->supportsPVRTC()
                         && !Configuration::getInstance()->supportsETC()
                         && !Configuration::getInstance()->supportsS3TC()
-                        && !Configuration::getInstance()->supportsATITC())
+                        && !Configuration::getInstance()->supportsATITC()
+                        && !Configuration::getInstance()->supportsETC2()
+                        && !Configuration::getInstance()->supportsASTC())
     {
         CCLOG("cocos2d: WARNING: PVRTC/ETC images are not supported");
         return false;
@@ -1395,6 +1406,33 @@ const char* Texture2D::getStringForFormat() const
 
         case Texture2D::PixelFormat::ATC_INTERPOLATED_ALPHA:
             return "ATC_INTERPOLATED_ALPHA";
+
+        case Texture2D::PixelFormat::ETC2_RGB8:
+            return "ETC2_RGB8";
+
+        case Texture2D::PixelFormat::ETC2_RGBA8:
+            return "ETC2_RGBA8";
+
+        case Texture2D::PixelFormat::ETC2_RGB8A1:
+            return "ETC2_RGB8A1";
+
+        case Texture2D::PixelFormat::ASTC_4x4:
+            return "ASTC_4x4";
+
+        case Texture2D::PixelFormat::ASTC_5x5:
+            return "ASTC_5x5";
+
+        case Texture2D::PixelFormat::ASTC_6x6:
+            return "ASTC_6x6";
+
+        case Texture2D::PixelFormat::ASTC_8x8:
+            return "ASTC_8x8";
+
+        case Texture2D::PixelFormat::ASTC_10x10:
+            return "ASTC_10x10";
+
+        case Texture2D::PixelFormat::ASTC_12x12:
+            return "ASTC_12x12";
             
         default:
             CCASSERT(false , "unrecognized pixel format");
@@ -115,6 +115,24 @@ public:
         ATC_EXPLICIT_ALPHA,
         //! ATITC-compressed texture: ATC_INTERPOLATED_ALPHA
         ATC_INTERPOLATED_ALPHA,
+        //! ETC2-compressed texture: ETC2_RGB8
+        ETC2_RGB8,
+        //! ETC2-compressed texture: ETC2_RGBA8 (EAC alpha channel)
+        ETC2_RGBA8,
+        //! ETC2-compressed texture: ETC2_RGB8A1 (1-bit alpha channel)
+        ETC2_RGB8A1,
+        //! ASTC-compressed texture: ASTC_4x4
+        ASTC_4x4,
+        //! ASTC-compressed texture: ASTC_5x5
+        ASTC_5x5,
+        //! ASTC-compressed texture: ASTC_6x6
+        ASTC_6x6,
+        //! ASTC-compressed texture: ASTC_8x8
+        ASTC_8x8,
+        //! ASTC-compressed texture: ASTC_10x10
+        ASTC_10x10,
+        //! ASTC-compressed texture: ASTC_12x12
+        ASTC_12x12,
         //! Default texture format: AUTO
         DEFAULT = AUTO,
         
@@ -359,9 +359,9 @@ void TextureAtlas::insertQuads(V3F_C4B_T2F_Quad* quads, ssize_t index, ssize_t a
     CCASSERT( _totalQuads <= _capacity, "invalid totalQuads");
 
     // issue #575. index can be > totalQuads
-    auto remaining = (_totalQuads-1) - index - amount;
+    auto remaining = _totalQuads - index - amount;
 
-    // last object doesn't need to be moved
+    // the quads from index on are moved behind the inserted ones
     if( remaining > 0)
     {
         // tex coordinates
@@ -0,0 +1,77 @@
+/****************************************************************************
+ Copyright (c) 2019 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+const char* ccParticleGPU_vert = R"(
+// Each particle is stored as it was emitted and integrated here, see ParticleSystemQuad::setGPUSimulationEnabled()
+attribute vec4 a_spawn;         // emitter origin, emission time, life
+attribute vec4 a_motion;        // position, velocity
+attribute vec4 a_color;
+attribute vec4 a_deltaColor;
+attribute vec4 a_shape;         // size, delta size, rotation, delta rotation
+attribute vec4 a_corner;        // corner of the quad, texture coordinates
+
+uniform float u_time;
+uniform vec2 u_gravity;
+uniform float u_yCoordFlipped;
+uniform mat4 u_originTransform;
+uniform vec2 u_origin;
+uniform float u_opacityModifyRGB;
+
+#ifdef GL_ES
+varying lowp vec4 v_fragmentColor;
+varying mediump vec2 v_texCoord;
+#else
+varying vec4 v_fragmentColor;
+varying vec2 v_texCoord;
+#endif
+
+void main()
+{
+    float age = u_time - a_spawn.z;
+    if (age >= a_spawn.w)
+    {
+        // dead particles are left in the buffer until their slot is reused, outside of the clip volume
+        gl_Position = vec4(0.0, 0.0, 2.0, 1.0);
+        v_fragmentColor = vec4(0.0);
+        v_texCoord = vec2(0.0);
+        return;
+    }
+
+    vec2 position = a_motion.xy + (a_motion.zw + 0.5 * u_gravity * age) * age * u_yCoordFlipped;
+    position += (u_originTransform * vec4(a_spawn.xy, 0.0, 1.0)).xy - u_origin;
+
+    float size = max(a_shape.x + a_shape.y * age, 0.0);
+    float angle = -radians(a_shape.z + a_shape.w * age);
+    vec2 corner = a_corner.xy * size;
+    float c = cos(angle);
+    float s = sin(angle);
+    position += vec2(corner.x * c - corner.y * s, corner.x * s + corner.y * c);
+    gl_Position = CC_MVPMatrix * vec4(position, 0.0, 1.0);
+
+    vec4 color = clamp(a_color + a_deltaColor * age, 0.0, 1.0);
+    color.rgb *= mix(1.0, color.a, u_opacityModifyRGB);
+    v_fragmentColor = color;
+    v_texCoord = a_corner.zw;
+}
+)";
@@ -68,6 +68,7 @@ NS_CC_BEGIN
 
 #include "renderer/ccShader_PositionColorLengthTexture.frag"
 #include "renderer/ccShader_PositionColorLengthTexture.vert"
+#include "renderer/ccShader_PositionColorLengthTexture_noMVP.vert"
 
 #include "renderer/ccShader_UI_Gray.frag"
 //
@@ -76,6 +77,7 @@ NS_CC_BEGIN
 #include "renderer/ccShader_Label_df_glow.frag"
 #include "renderer/ccShader_Label_normal.frag"
 #include "renderer/ccShader_Label_outline.frag"
+#include "renderer/ccShader_Label_df_noMVP.frag"
 
 //
 #include "renderer/ccShader_3D_PositionTex.vert"
@@ -100,4 +102,6 @@ NS_CC_BEGIN
 #include "renderer/ccShader_Position.vert"
 #include "renderer/ccShader_LayerRadialGradient.frag"
 
+#include "renderer/ccShader_ParticleGPU.vert"
+
 NS_CC_END
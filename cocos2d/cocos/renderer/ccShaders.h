@@ -66,6 +66,7 @@ extern CC_DLL const GLchar * ccPositionTexture_uColor_vert;
 
 extern CC_DLL const GLchar * ccPositionColorLengthTexture_frag;
 extern CC_DLL const GLchar * ccPositionColorLengthTexture_vert;
+extern CC_DLL const GLchar * ccPositionColorLengthTexture_noMVP_vert;
 
 extern CC_DLL const GLchar * ccPositionTexture_GrayScale_frag;
 
@@ -73,6 +74,7 @@ extern CC_DLL const GLchar * ccLabelDistanceFieldNormal_frag;
 extern CC_DLL const GLchar * ccLabelDistanceFieldGlow_frag;
 extern CC_DLL const GLchar * ccLabelNormal_frag;
 extern CC_DLL const GLchar * ccLabelOutline_frag;
+extern CC_DLL const GLchar * ccLabelDistanceFieldNormal_noMVP_frag;
 
 extern CC_DLL const GLchar * ccLabel_vert;
 
@@ -100,6 +102,8 @@ extern CC_DLL const GLchar* ccETC1ASPositionTextureGray_frag;
 extern CC_DLL const GLchar* ccPosition_vert;
 extern CC_DLL const GLchar* ccShader_LayerRadialGradient_frag;
 
+extern CC_DLL const GLchar* ccParticleGPU_vert;
+
 NS_CC_END
 /**
  end of support group
@@ -232,7 +232,17 @@ void Layout::visit(Renderer *renderer, const Mat4 &parentTransform, uint32_t par
         switch (_clippingType)
         {
             case ClippingType::STENCIL:
-                stencilClippingVisit(renderer, parentTransform, parentFlags);
+                // the stencil is the content rectangle, while it stays axis aligned the renderer clips it without stencil
+                processParentFlags(parentTransform, parentFlags);
+                if (renderer->pushClipRect(Rect(Vec2::ZERO, _contentSize), _modelViewTransform))
+                {
+                    ProtectedNode::visit(renderer, parentTransform, parentFlags);
+                    renderer->popClipRect();
+                }
+                else
+                {
+                    stencilClippingVisit(renderer, parentTransform, parentFlags);
+                }
                 break;
             case ClippingType::SCISSOR:
                 scissorClippingVisit(renderer, parentTransform, parentFlags);
@@ -331,64 +341,17 @@ void Layout::stencilClippingVisit(Renderer *renderer, const Mat4& parentTransfor
     director->popMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
 }
     
-void Layout::onBeforeVisitScissor()
-{
-    auto glview = Director::getInstance()->getOpenGLView();
-    // apply scissor test
-    _scissorOldState = glview->isScissorEnabled();
-    if (false == _scissorOldState)
-    {
-        glEnable(GL_SCISSOR_TEST);
-    }
-
-    // apply scissor box
-    Rect clippingRect = getClippingRect();
-    _clippingOldRect = glview->getScissorRect();
-    if (false == _clippingOldRect.equals(clippingRect))
-    {
-        glview->setScissorInPoints(clippingRect.origin.x,
-                                   clippingRect.origin.y,
-                                   clippingRect.size.width,
-                                   clippingRect.size.height);
-    }
-}
-
-void Layout::onAfterVisitScissor()
-{
-    if (_scissorOldState)
-    {
-        // revert scissor box
-        if (false == _clippingOldRect.equals(_clippingRect))
-        {
-            auto glview = Director::getInstance()->getOpenGLView();
-            glview->setScissorInPoints(_clippingOldRect.origin.x,
-                                       _clippingOldRect.origin.y,
-                                       _clippingOldRect.size.width,
-                                       _clippingOldRect.size.height);
-        }
-    }
-    else
-    {
-        // revert scissor test
-        glDisable(GL_SCISSOR_TEST);
-    }
-}
-    
 void Layout::scissorClippingVisit(Renderer *renderer, const Mat4& parentTransform, uint32_t parentFlags)
 {
     if (parentFlags & FLAGS_DIRTY_MASK)
     {
         _clippingRectDirty = true;
     }
-    _beforeVisitCmdScissor.init(_globalZOrder);
-    _beforeVisitCmdScissor.func = CC_CALLBACK_0(Layout::onBeforeVisitScissor, this);
-    renderer->addCommand(&_beforeVisitCmdScissor);
+    renderer->pushClipRect(getClippingRect());
 
     ProtectedNode::visit(renderer, parentTransform, parentFlags);
     
-    _afterVisitCmdScissor.init(_globalZOrder);
-    _afterVisitCmdScissor.func = CC_CALLBACK_0(Layout::onAfterVisitScissor, this);
-    renderer->addCommand(&_afterVisitCmdScissor);
+    renderer->popClipRect();
 }
 
 void Layout::setClippingEnabled(bool able)
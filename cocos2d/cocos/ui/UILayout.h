@@ -490,11 +490,6 @@ protected:
     virtual LayoutManager* createLayoutManager()override;
     virtual Size getLayoutContentSize()const override;
     virtual const Vector<Node*>& getLayoutElements()const override;
-    
-    //clipping
-    
-    void onBeforeVisitScissor();
-    void onAfterVisitScissor();
     void updateBackGroundImageColor();
     void updateBackGroundImageOpacity();
     void updateBackGroundImageRGBA();
@@ -628,8 +623,6 @@ protected:
     Type _layoutType;
     ClippingType _clippingType;
     DrawNode* _clippingStencil;
-    bool _scissorOldState;
-    Rect _clippingOldRect;
     Rect _clippingRect;
     Layout* _clippingParent;
     bool _clippingRectDirty;
@@ -641,8 +634,6 @@ protected:
     CustomCommand _beforeVisitCmdStencil;
     CustomCommand _afterDrawStencilCmd;
     CustomCommand _afterVisitCmdStencil;
-    CustomCommand _beforeVisitCmdScissor;
-    CustomCommand _afterVisitCmdScissor;
     
     bool _doLayoutDirty;
     bool _isInterceptTouch;
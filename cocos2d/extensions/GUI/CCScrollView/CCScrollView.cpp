@@ -63,7 +63,7 @@ ScrollView::ScrollView()
 , _touchLength(0.0f)
 , _minScale(0.0f)
 , _maxScale(0.0f)
-, _scissorRestored(false)
+, _clipRectPushed(false)
 , _touchListener(nullptr)
 , _animatedScrollAction(nullptr)
 {
@@ -565,70 +565,28 @@ void ScrollView::addChild(Node * child, int zOrder, const std::string &name)
     }
 }
 
-void ScrollView::beforeDraw()
-{
-    //ScrollView don't support drawing in 3D space
-    _beforeDrawCommand.init(_globalZOrder);
-    _beforeDrawCommand.func = CC_CALLBACK_0(ScrollView::onBeforeDraw, this);
-    Director::getInstance()->getRenderer()->addCommand(&_beforeDrawCommand);
-}
-
 /**
  * clip this view so that outside of the visible bounds can be hidden.
+ * The renderer clips the children, so that they keep batching with the rest of the scene.
  */
-void ScrollView::onBeforeDraw()
-{
-    if (_clippingToBounds)
-    {
-		_scissorRestored = false;
-        Rect frame = getViewRect();
-        auto glview = Director::getInstance()->getOpenGLView();
-
-        if (glview->getVR() == nullptr) {
-            if (glview->isScissorEnabled()) {
-                _scissorRestored = true;
-                _parentScissorRect = glview->getScissorRect();
-                //set the intersection of _parentScissorRect and frame as the new scissor rect
-                if (frame.intersectsRect(_parentScissorRect)) {
-                    float x = MAX(frame.origin.x, _parentScissorRect.origin.x);
-                    float y = MAX(frame.origin.y, _parentScissorRect.origin.y);
-                    float xx = MIN(frame.origin.x + frame.size.width, _parentScissorRect.origin.x + _parentScissorRect.size.width);
-                    float yy = MIN(frame.origin.y + frame.size.height, _parentScissorRect.origin.y + _parentScissorRect.size.height);
-                    glview->setScissorInPoints(x, y, xx - x, yy - y);
-                }
-            }
-            else {
-                glEnable(GL_SCISSOR_TEST);
-                glview->setScissorInPoints(frame.origin.x, frame.origin.y, frame.size.width, frame.size.height);
-            }
-        }
-    }
-}
-
-void ScrollView::afterDraw()
+void ScrollView::beforeDraw()
 {
-    _afterDrawCommand.init(_globalZOrder);
-    _afterDrawCommand.func = CC_CALLBACK_0(ScrollView::onAfterDraw, this);
-    Director::getInstance()->getRenderer()->addCommand(&_afterDrawCommand);
+    _clipRectPushed = _clippingToBounds && Director::getInstance()->getOpenGLView()->getVR() == nullptr;
+    if (_clipRectPushed)
+    {
+        Director::getInstance()->getRenderer()->pushClipRect(getViewRect());
+    }
 }
 
 /**
  * retract what's done in beforeDraw so that there's no side effect to
  * other nodes.
  */
-void ScrollView::onAfterDraw()
+void ScrollView::afterDraw()
 {
-    if (_clippingToBounds)
+    if (_clipRectPushed)
     {
-        auto glview = Director::getInstance()->getOpenGLView();
-        if (glview->getVR() == nullptr) {
-            if (_scissorRestored) {//restore the parent's scissor rect
-                glview->setScissorInPoints(_parentScissorRect.origin.x, _parentScissorRect.origin.y, _parentScissorRect.size.width, _parentScissorRect.size.height);
-            }
-            else {
-                glDisable(GL_SCISSOR_TEST);
-            }
-        }
+        Director::getInstance()->getRenderer()->popClipRect();
     }
 }
 
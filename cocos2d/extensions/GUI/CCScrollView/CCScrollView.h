@@ -294,13 +294,11 @@ protected:
      * clip this view so that outside of the visible bounds can be hidden.
      */
     void beforeDraw();
-    void onBeforeDraw();
     /**
      * retract what's done in beforeDraw so that there's no side effect to
      * other nodes.
      */
     void afterDraw();
-    void onAfterDraw();
     /**
      * Zoom handling
      */
@@ -374,16 +372,12 @@ protected:
      */
     float _minScale, _maxScale;
     /**
-     * scissor rect for parent, just for restoring GL_SCISSOR_BOX
+     * whether beforeDraw pushed a clipping rectangle to the renderer
      */
-    Rect _parentScissorRect;
-    bool _scissorRestored;
+    bool _clipRectPushed;
     
     /** Touch listener */
     EventListenerTouchOneByOne* _touchListener;
-    
-    CustomCommand _beforeDrawCommand;
-    CustomCommand _afterDrawCommand;
 
     /**
      * Action created with setContentOffsetInDuration(), saved so it can be halted
@@ -0,0 +1,148 @@
+/****************************************************************************
+Copyright (c) 2019 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+// Churns pooled classes the way a busy frame does and compares against the same objects taken from the
+// global allocator, then creates and destroys pooled objects from several threads at once.
+
+#include <thread>
+#include <vector>
+
+#include "cocos2d.h"
+#include "EngineTest.h"
+
+USING_NS_CC;
+
+namespace {
+
+// Subclasses that open up the protected constructors. With NoPadding they have the size of the pooled class and
+// come from its pool, with Padding they are bigger and fall back to the global allocator.
+struct NoPadding {};
+struct Padding { void* padding = nullptr; };
+
+template <typename P>
+class ChurnMoveTo : public MoveTo, private P
+{
+public:
+    ChurnMoveTo(int x, int y) { initWithDuration(1.0f, Vec2(x, y)); }
+};
+
+template <typename P>
+class ChurnCallFunc : public CallFunc, private P
+{
+public:
+    ChurnCallFunc() { initWithFunction(nullptr); }
+};
+
+template <typename P>
+class ChurnEventCustom : public EventCustom, private P
+{
+public:
+    ChurnEventCustom() : EventCustom("churn") {}
+};
+
+const int FRAMES = 600;
+const int ACTIONS_PER_FRAME = 2000;
+const int EVENTS_PER_FRAME = 500;
+
+template <typename P>
+double churn()
+{
+    std::vector<Ref*> objects;
+    objects.reserve(ACTIONS_PER_FRAME * 2 + EVENTS_PER_FRAME);
+    enginetest::Stopwatch stopwatch;
+    for (int frame = 0; frame < FRAMES; ++frame)
+    {
+        for (int i = 0; i < ACTIONS_PER_FRAME; ++i)
+        {
+            objects.push_back(new (std::nothrow) ChurnMoveTo<P>(i, frame));
+            objects.push_back(new (std::nothrow) ChurnCallFunc<P>());
+        }
+        for (int i = 0; i < EVENTS_PER_FRAME; ++i)
+            objects.push_back(new (std::nothrow) ChurnEventCustom<P>());
+        for (auto object : objects)
+            object->release();
+        objects.clear();
+    }
+    return stopwatch.getMilliseconds();
+}
+
+// every thread checks that nobody else was handed its objects while it held them
+void testThreads()
+{
+    const int THREAD_COUNT = 4;
+    std::atomic<int> corrupted(0);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < THREAD_COUNT; ++t)
+    {
+        threads.emplace_back([t, &corrupted]() {
+            std::vector<EventCustom*> events;
+            for (int round = 0; round < 20000; ++round)
+            {
+                for (int i = 0; i < 64; ++i)
+                {
+                    auto event = new (std::nothrow) EventCustom("thread");
+                    event->setUserData(reinterpret_cast<void*>(static_cast<intptr_t>(t * 100000 + i)));
+                    events.push_back(event);
+                }
+                for (int i = 0; i < 64; ++i)
+                {
+                    if (events[i]->getUserData() != reinterpret_cast<void*>(static_cast<intptr_t>(t * 100000 + i)))
+                        ++corrupted;
+                    events[i]->release();
+                }
+                events.clear();
+            }
+        });
+    }
+    for (auto& thread : threads)
+        thread.join();
+    printf("%d threads creating EventCustom: %d corrupted objects\n", THREAD_COUNT, corrupted.load());
+    ENGINE_CHECK(corrupted.load() == 0);
+}
+
+}
+
+int main()
+{
+#if CC_ENABLE_ALLOCATOR
+    printf("CC_ENABLE_ALLOCATOR is on\n");
+#else
+    printf("CC_ENABLE_ALLOCATOR is off, both runs use the global allocator\n");
+#endif
+    // the pooled variants only use the pools if the compiler didn't pad them
+    bool samePoolSize = sizeof(ChurnMoveTo<NoPadding>) == sizeof(MoveTo) && sizeof(ChurnCallFunc<NoPadding>) == sizeof(CallFunc)
+        && sizeof(ChurnEventCustom<NoPadding>) == sizeof(EventCustom);
+    if (!samePoolSize)
+        printf("the subclasses are bigger than the pooled classes, both runs use the global allocator\n");
+
+    // warm up, the pools keep their pages
+    churn<NoPadding>();
+
+    printf("%d frames of %d MoveTo + %d CallFunc + %d EventCustom\n", FRAMES, ACTIONS_PER_FRAME, ACTIONS_PER_FRAME, EVENTS_PER_FRAME);
+    printf("  global allocator: %.1f ms\n", churn<Padding>());
+    printf("  class pools:      %.1f ms\n", churn<NoPadding>());
+
+    testThreads();
+    return enginetest::result("AllocatorPoolTest");
+}
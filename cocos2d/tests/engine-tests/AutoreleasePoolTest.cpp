@@ -0,0 +1,106 @@
+/****************************************************************************
+Copyright (c) 2019 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+// Clears the autorelease pool with its scratch copy in the frame arena and on the heap, checks that objects
+// autoreleased by destructors survive until the next clear and that the arena gets its memory back.
+
+#include "cocos2d.h"
+#include "EngineTest.h"
+
+USING_NS_CC;
+
+namespace {
+
+int s_alive = 0;
+
+class Tracked : public Ref
+{
+public:
+    explicit Tracked(bool spawnOnDestruction) : _spawnOnDestruction(spawnOnDestruction) { ++s_alive; }
+
+    virtual ~Tracked()
+    {
+        --s_alive;
+        if (_spawnOnDestruction)
+            (new Tracked(false))->autorelease();
+    }
+
+private:
+    bool _spawnOnDestruction;
+};
+
+void testClear(const char* name)
+{
+    auto pool = PoolManager::getInstance()->getCurrentPool();
+    auto arena = Director::getInstance()->getFrameArena();
+    pool->clear();
+    size_t usedBefore = arena->getUsedBytes();
+
+    for (int i = 0; i < 1000; ++i)
+        (new Tracked(i % 2 == 0))->autorelease();
+    ENGINE_CHECK(s_alive == 1000);
+
+    pool->clear();
+    // the 500 objects autoreleased by the destructors wait for the next clear
+    ENGINE_CHECK(s_alive == 500);
+    ENGINE_CHECK(arena->getUsedBytes() == usedBefore);
+
+    pool->clear();
+    ENGINE_CHECK(s_alive == 0);
+    printf("%s: clear checks done\n", name);
+}
+
+double benchmark()
+{
+    const int FRAMES = 600;
+    const int OBJECTS_PER_FRAME = 5000;
+    auto pool = PoolManager::getInstance()->getCurrentPool();
+    enginetest::Stopwatch stopwatch;
+    for (int frame = 0; frame < FRAMES; ++frame)
+    {
+        for (int i = 0; i < OBJECTS_PER_FRAME; ++i)
+            (new Tracked(false))->autorelease();
+        pool->clear();
+    }
+    return stopwatch.getMilliseconds();
+}
+
+}
+
+int main()
+{
+    auto director = Director::getInstance();
+    auto poolManager = PoolManager::getInstance();
+
+    testClear("frame arena");
+    double arenaTime = benchmark();
+
+    poolManager->setFrameArena(nullptr);
+    testClear("heap");
+    double heapTime = benchmark();
+    poolManager->setFrameArena(director->getFrameArena());
+
+    printf("600 frames of 5000 autoreleased objects: heap copy %.1f ms, arena copy %.1f ms\n", heapTime, arenaTime);
+    return enginetest::result("AutoreleasePoolTest");
+}
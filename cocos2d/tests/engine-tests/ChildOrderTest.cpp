@@ -0,0 +1,199 @@
+/****************************************************************************
+Copyright (c) 2019 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+// Applies random adds, removals, z order changes and renames to the children of a node and compares the
+// order kept by sortAllChildren() against a full sortNodes(), and the indexed child lookups against a scan.
+// Then times a 5000 child node where a few children change their z order every frame.
+
+#include <random>
+#include <string>
+
+#include "cocos2d.h"
+#include "EngineTest.h"
+
+USING_NS_CC;
+
+namespace {
+
+std::mt19937 s_random(5);
+
+int randomZOrder()
+{
+    return static_cast<int>(s_random() % 9) - 4;
+}
+
+std::string randomName()
+{
+    return "n" + std::to_string(s_random() % 300);
+}
+
+Node* scanByName(Node* parent, const std::string& name)
+{
+    for (auto child : parent->getChildren())
+    {
+        if (child->getName() == name)
+            return child;
+    }
+    return nullptr;
+}
+
+Node* scanByTag(Node* parent, int tag)
+{
+    for (auto child : parent->getChildren())
+    {
+        if (child->getTag() == tag)
+            return child;
+    }
+    return nullptr;
+}
+
+void testRandomEdits()
+{
+    auto parent = Node::create();
+    parent->retain();
+    std::vector<Node*> nodes;
+    for (int i = 0; i < 400; ++i)
+    {
+        nodes.push_back(Node::create());
+        nodes.back()->retain();
+    }
+
+    int sorts = 0;
+    int orderErrors = 0;
+    int lookups = 0;
+    int lookupErrors = 0;
+    for (int round = 0; round < 200000; ++round)
+    {
+        auto node = nodes[s_random() % nodes.size()];
+        bool attached = node->getParent() != nullptr;
+        switch (s_random() % 16)
+        {
+        case 0:
+        case 1:
+            if (!attached)
+            {
+                if (s_random() % 2)
+                    parent->addChild(node, randomZOrder(), randomName());
+                else
+                    parent->addChild(node, randomZOrder(), static_cast<int>(s_random() % 300));
+            }
+            break;
+        case 2: if (attached) node->removeFromParent(); break;
+        case 3:
+        case 4:
+        case 5:
+        case 6: if (attached) node->setLocalZOrder(randomZOrder()); break;
+        case 7: if (attached) parent->reorderChild(node, randomZOrder()); break;
+        case 8: if (attached) node->setName(randomName()); break;
+        case 9: if (attached) node->setTag(static_cast<int>(s_random() % 300)); break;
+        case 10:
+            if (s_random() % 50 == 0)
+                parent->setChildLookupIndexEnabled(!parent->isChildLookupIndexEnabled());
+            break;
+        case 11:
+            if (s_random() % 200 == 0)
+                parent->removeAllChildren();
+            break;
+        case 12:
+        case 13:
+        {
+            parent->sortAllChildren();
+            ++sorts;
+            Vector<Node*> expected = parent->getChildren();
+            Node::sortNodes(expected);
+            if (expected.size() != parent->getChildren().size()
+                || !std::equal(expected.begin(), expected.end(), parent->getChildren().begin()))
+                ++orderErrors;
+            break;
+        }
+        default:
+        {
+            ++lookups;
+            std::string name = randomName();
+            if (parent->getChildByName(name) != scanByName(parent, name))
+                ++lookupErrors;
+            int tag = static_cast<int>(s_random() % 300);
+            if (parent->getChildByTag(tag) != scanByTag(parent, tag))
+                ++lookupErrors;
+        }
+        }
+    }
+    printf("%d sorts, %d order errors, %d lookups, %d lookup errors\n", sorts, orderErrors, lookups, lookupErrors);
+    ENGINE_CHECK(orderErrors == 0);
+    ENGINE_CHECK(lookupErrors == 0);
+
+    parent->removeAllChildren();
+    parent->release();
+    for (auto node : nodes)
+        node->release();
+}
+
+void benchmarkLargeParent()
+{
+    auto table = Node::create();
+    table->retain();
+    for (int i = 0; i < 5000; ++i)
+        table->addChild(Node::create(), static_cast<int>(s_random() % 64), "card" + std::to_string(i));
+    table->sortAllChildren();
+
+    enginetest::Stopwatch stopwatch;
+    for (int frame = 0; frame < 2000; ++frame)
+    {
+        table->getChildren().at(s_random() % 5000)->setLocalZOrder(static_cast<int>(s_random() % 64));
+        table->sortAllChildren();
+    }
+    printf("one setLocalZOrder + sortAllChildren: %.2f us per frame\n", stopwatch.getMilliseconds() * 1000 / 2000);
+
+    stopwatch.restart();
+    for (int frame = 0; frame < 200; ++frame)
+    {
+        for (int i = 0; i < 100; ++i)
+            table->getChildren().at(s_random() % 5000)->setLocalZOrder(static_cast<int>(s_random() % 64));
+        table->sortAllChildren();
+    }
+    printf("100 setLocalZOrder + sortAllChildren: %.2f us per frame\n", stopwatch.getMilliseconds() * 1000 / 200);
+
+    auto lookup = [&](const char* label) {
+        size_t found = 0;
+        enginetest::Stopwatch lookupStopwatch;
+        for (int i = 0; i < 20000; ++i)
+            found += table->getChildByName("card" + std::to_string(s_random() % 5000)) != nullptr;
+        printf("%s: %.3f us per getChildByName\n", label, lookupStopwatch.getMilliseconds() * 1000 / 20000);
+        ENGINE_CHECK(found == 20000);
+    };
+    lookup("scan");
+    table->setChildLookupIndexEnabled(true);
+    lookup("index");
+
+    table->release();
+}
+
+}
+
+int main()
+{
+    testRandomEdits();
+    benchmarkLargeParent();
+    return enginetest::result("ChildOrderTest");
+}
@@ -0,0 +1,126 @@
+/****************************************************************************
+Copyright (c) 2019 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+// Tears down a 50k node graph right away and through the deferred destruction queue of PoolManager,
+// and checks that every node is freed and the per frame budget is kept.
+
+#include "cocos2d.h"
+#include "EngineTest.h"
+
+USING_NS_CC;
+
+namespace {
+
+const int GROUP_COUNT = 500;
+const int NODES_PER_GROUP = 100;
+const unsigned int NODE_COUNT = 1 + GROUP_COUNT * (1 + NODES_PER_GROUP);
+
+Node* buildGraph()
+{
+    auto root = Node::create();
+    root->retain();
+    for (int i = 0; i < GROUP_COUNT; ++i)
+    {
+        auto group = Node::create();
+        for (int j = 0; j < NODES_PER_GROUP; ++j)
+            group->addChild(Node::create());
+        root->addChild(group);
+    }
+    // only the parents hold the nodes from here on
+    PoolManager::getInstance()->getCurrentPool()->clear();
+    return root;
+}
+
+}
+
+int main()
+{
+    Director::getInstance();
+    auto poolManager = PoolManager::getInstance();
+
+#if defined(COCOS2D_DEBUG) && (COCOS2D_DEBUG > 0)
+    {
+        // Ref::release() checks the pools for every object freed outside of them
+        for (int i = 0; i < 20000; ++i)
+            Node::create();
+        std::vector<Node*> nodes;
+        for (int i = 0; i < 5000; ++i)
+        {
+            nodes.push_back(Node::create());
+            nodes.back()->retain();
+        }
+        poolManager->getCurrentPool()->clear();
+        for (int i = 0; i < 20000; ++i)
+            Node::create();
+
+        enginetest::Stopwatch stopwatch;
+        for (auto node : nodes)
+            node->release();
+        printf("debug release of 5000 nodes with 20000 pooled: %.2f ms\n", stopwatch.getMilliseconds());
+        poolManager->getCurrentPool()->clear();
+    }
+#endif
+
+    auto root = buildGraph();
+    auto freedBefore = poolManager->getFreedObjectCount();
+    enginetest::Stopwatch stopwatch;
+    root->release();
+    printf("immediate teardown of %u nodes: %.2f ms\n", NODE_COUNT, stopwatch.getMilliseconds());
+    ENGINE_CHECK(poolManager->getFreedObjectCount() - freedBefore == NODE_COUNT);
+
+    const float budget = 0.002f;
+    poolManager->setDeferredDestructionBudget(budget);
+    root = buildGraph();
+    freedBefore = poolManager->getFreedObjectCount();
+    stopwatch.restart();
+    root->release();
+    printf("deferred release: %.3f ms, %u queued\n", stopwatch.getMilliseconds(), (unsigned int)poolManager->getDeferredObjectCount());
+    ENGINE_CHECK(poolManager->getDeferredObjectCount() == 1);
+
+    int frames = 0;
+    double worst = 0;
+    double total = 0;
+    while (poolManager->getDeferredObjectCount() != 0 && frames < 100000)
+    {
+        stopwatch.restart();
+        poolManager->destroyDeferredObjects();
+        double milliseconds = stopwatch.getMilliseconds();
+        worst = std::max(worst, milliseconds);
+        total += milliseconds;
+        ++frames;
+    }
+    printf("deferred teardown: %d frames, worst frame %.2f ms, total %.2f ms\n", frames, worst, total);
+    ENGINE_CHECK(poolManager->getFreedObjectCount() - freedBefore == NODE_COUNT);
+    ENGINE_CHECK(frames > 1);
+
+    // a budget of 0 flushes whatever is still queued
+    root = buildGraph();
+    freedBefore = poolManager->getFreedObjectCount();
+    root->release();
+    poolManager->setDeferredDestructionBudget(0);
+    ENGINE_CHECK(poolManager->getDeferredObjectCount() == 0);
+    ENGINE_CHECK(poolManager->getFreedObjectCount() - freedBefore == NODE_COUNT);
+
+    return enginetest::result("DeferredDestructionTest");
+}
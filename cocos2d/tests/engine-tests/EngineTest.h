@@ -0,0 +1,80 @@
+/****************************************************************************
+Copyright (c) 2019 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#ifndef __ENGINE_TEST_H__
+#define __ENGINE_TEST_H__
+
+#include <chrono>
+#include <cstdio>
+
+/**
+ * Helpers shared by the engine tests. Every test is a console program: failed checks are printed and
+ * make it exit with 1, timings are printed for comparing builds.
+ */
+namespace enginetest {
+
+inline int& failureCount()
+{
+    static int failures = 0;
+    return failures;
+}
+
+inline bool check(bool condition, const char* expression, const char* file, int line)
+{
+    if (!condition)
+    {
+        printf("%s:%d: check failed: %s\n", file, line, expression);
+        ++failureCount();
+    }
+    return condition;
+}
+
+/** Exit code of a test, prints a summary. */
+inline int result(const char* name)
+{
+    printf("%s: %s\n", name, failureCount() == 0 ? "passed" : "FAILED");
+    return failureCount() == 0 ? 0 : 1;
+}
+
+class Stopwatch
+{
+public:
+    Stopwatch() : _start(std::chrono::steady_clock::now()) {}
+
+    void restart() { _start = std::chrono::steady_clock::now(); }
+
+    double getMilliseconds() const
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - _start).count();
+    }
+
+private:
+    std::chrono::steady_clock::time_point _start;
+};
+
+} // namespace enginetest
+
+#define ENGINE_CHECK(condition) enginetest::check((condition), #condition, __FILE__, __LINE__)
+
+#endif // __ENGINE_TEST_H__
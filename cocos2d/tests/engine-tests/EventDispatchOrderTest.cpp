@@ -0,0 +1,211 @@
+/****************************************************************************
+Copyright (c) 2019 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+// Moves, reorders and reparents 5000 nodes with touch listeners at random and checks after every step that
+// the touch reaches the listeners in the order computed from the scene graph: visit order, grouped by global
+// Z order, last drawn first. Then times a dispatch after a single z order change.
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "cocos2d.h"
+#include "EngineTest.h"
+
+USING_NS_CC;
+
+namespace {
+
+const int GROUP_COUNT = 50;
+const int CARD_COUNT = 5000;
+
+std::mt19937 s_random(42);
+std::vector<Node*> s_received;
+
+// Director only runs the pushed scene on its next frame, which needs a GL view
+struct DirectorAccess : public Director
+{
+    static void runNextScene(Director* director)
+    {
+        (director->*(&DirectorAccess::setNextScene))();
+    }
+};
+
+void visitOrder(Node* node, std::vector<Node*>& result)
+{
+    node->sortAllChildren();
+    auto& children = node->getChildren();
+    ssize_t i = 0;
+    for (; i < children.size() && children.at(i)->getLocalZOrder() < 0; ++i)
+        visitOrder(children.at(i), result);
+    result.push_back(node);
+    for (; i < children.size(); ++i)
+        visitOrder(children.at(i), result);
+}
+
+std::vector<Node*> expectedOrder(Scene* scene, const std::vector<Node*>& listenerNodes)
+{
+    std::vector<Node*> visited;
+    visitOrder(scene, visited);
+    std::vector<Node*> nodes;
+    for (auto node : visited)
+    {
+        if (std::find(listenerNodes.begin(), listenerNodes.end(), node) != listenerNodes.end())
+            nodes.push_back(node);
+    }
+    std::stable_sort(nodes.begin(), nodes.end(), [](Node* a, Node* b) {
+        return a->getGlobalZOrder() < b->getGlobalZOrder();
+    });
+    std::reverse(nodes.begin(), nodes.end());
+    return nodes;
+}
+
+void addListener(EventDispatcher* dispatcher, Node* node)
+{
+    auto listener = EventListenerTouchOneByOne::create();
+    listener->onTouchBegan = [node](Touch*, Event*) {
+        s_received.push_back(node);
+        return false;
+    };
+    dispatcher->addEventListenerWithSceneGraphPriority(listener, node);
+}
+
+int randomZOrder(int range)
+{
+    return static_cast<int>(s_random() % range) - range / 2;
+}
+
+}
+
+int main()
+{
+    auto director = Director::getInstance();
+    auto scene = Scene::create();
+    director->pushScene(scene);
+    DirectorAccess::runNextScene(director);
+    auto dispatcher = director->getEventDispatcher();
+    dispatcher->setEnabled(true);
+
+    auto hand = Node::create();
+    scene->addChild(hand);
+    std::vector<Node*> groups;
+    std::vector<Node*> cards;
+    std::vector<Node*> listenerNodes;
+    for (int g = 0; g < GROUP_COUNT; ++g)
+    {
+        groups.push_back(Node::create());
+        hand->addChild(groups.back(), g % 7 - 3);
+    }
+    for (int i = 0; i < CARD_COUNT; ++i)
+    {
+        cards.push_back(Node::create());
+        groups[i % GROUP_COUNT]->addChild(cards.back(), i % 11 - 5);
+        addListener(dispatcher, cards.back());
+        listenerNodes.push_back(cards.back());
+    }
+    for (int g = 0; g < GROUP_COUNT; g += 5)
+    {
+        addListener(dispatcher, groups[g]);
+        listenerNodes.push_back(groups[g]);
+    }
+    std::sort(listenerNodes.begin(), listenerNodes.end());
+
+    Touch touch;
+    touch.setTouchInfo(0, 5, 5);
+    std::vector<Touch*> touches{&touch};
+    EventTouch event;
+    event.setEventCode(EventTouch::EventCode::BEGAN);
+    event.setTouches(touches);
+
+    auto dispatch = [&]() {
+        s_received.clear();
+        dispatcher->dispatchEvent(&event);
+        director->getFrameArena()->reset();
+    };
+
+    std::vector<Node*> sortedListenerNodes = listenerNodes;
+    int mismatches = 0;
+    for (int step = 0; step < 300; ++step)
+    {
+        int operations = (step % 10 == 0) ? 500 : 1 + s_random() % 5;
+        for (int o = 0; o < operations; ++o)
+        {
+            auto card = cards[s_random() % cards.size()];
+            auto group = groups[s_random() % groups.size()];
+            switch (s_random() % 6)
+            {
+            case 0:
+                card->setLocalZOrder(randomZOrder(11));
+                break;
+            case 1:
+                card->setGlobalZOrder(static_cast<float>(s_random() % 3));
+                break;
+            case 2:
+                group->setLocalZOrder(randomZOrder(7));
+                break;
+            case 3:
+                card->retain();
+                card->removeFromParentAndCleanup(false);
+                group->addChild(card, randomZOrder(11));
+                card->release();
+                break;
+            case 4:
+                card->getParent()->reorderChild(card, randomZOrder(11));
+                break;
+            case 5:
+                group->setGlobalZOrder(static_cast<float>(s_random() % 2));
+                break;
+            }
+        }
+        dispatch();
+        if (s_received != expectedOrder(scene, sortedListenerNodes))
+            ++mismatches;
+    }
+    printf("300 steps of random changes: %d dispatch order mismatches\n", mismatches);
+    ENGINE_CHECK(mismatches == 0);
+
+    const int ROUNDS = 200;
+    double total = 0;
+    enginetest::Stopwatch stopwatch;
+    for (int round = 0; round < ROUNDS; ++round)
+    {
+        cards[(round * 7919) % cards.size()]->setLocalZOrder(round % 11 - 5);
+        stopwatch.restart();
+        dispatch();
+        total += stopwatch.getMilliseconds();
+    }
+    printf("touch dispatch after one setLocalZOrder, %d listeners: %.1f us\n", (int)listenerNodes.size(), total * 1000 / ROUNDS);
+
+    total = 0;
+    for (int round = 0; round < ROUNDS; ++round)
+    {
+        stopwatch.restart();
+        dispatch();
+        total += stopwatch.getMilliseconds();
+    }
+    printf("touch dispatch without changes: %.1f us\n", total * 1000 / ROUNDS);
+    ENGINE_CHECK(s_received.size() == listenerNodes.size());
+
+    return enginetest::result("EventDispatchOrderTest");
+}
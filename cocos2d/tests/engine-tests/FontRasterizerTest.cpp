@@ -0,0 +1,149 @@
+/****************************************************************************
+Copyright (c) 2019 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+// Rasterizes the glyphs of a font with the face of the font and with thread faces on the JobSystem workers,
+// the way the asynchronous rasterization of FontAtlas does, and checks that they give the same pixels.
+// Then times the rasterization of the glyphs on one thread and in parallel.
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "cocos2d.h"
+#include "2d/CCFontAtlas.h"
+#include "2d/CCFontFreeType.h"
+#include "EngineTest.h"
+
+USING_NS_CC;
+
+namespace {
+
+const char32_t FIRST_CHAR = 0x20;
+const char32_t LAST_CHAR = 0x24f;
+
+bool sameGlyph(const FontGlyphBitmap& a, const FontGlyphBitmap& b)
+{
+    return a.pixelsWidth == b.pixelsWidth && a.pixelsHeight == b.pixelsHeight
+        && a.bitmapWidth == b.bitmapWidth && a.bitmapHeight == b.bitmapHeight
+        && a.rect.equals(b.rect) && a.xAdvance == b.xAdvance && a.pixels == b.pixels;
+}
+
+// one thread face per thread which runs a job, like FontAtlas::AsyncRasterizer
+class ThreadFaces
+{
+public:
+    explicit ThreadFaces(const FontFreeType* font) : _font(font) {}
+
+    ~ThreadFaces()
+    {
+        for (auto& face : _faces)
+            FontFreeType::destroyThreadFace(face.second);
+    }
+
+    const FontFreeType::ThreadFace* get()
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto it = _faces.find(std::this_thread::get_id());
+        if (it == _faces.end())
+        {
+            FontFreeType::ThreadFace face;
+            if (!_font->createThreadFace(face))
+                return nullptr;
+            it = _faces.emplace(std::this_thread::get_id(), face).first;
+        }
+        return &it->second;
+    }
+
+    size_t size() const { return _faces.size(); }
+
+private:
+    const FontFreeType* _font;
+    std::mutex _mutex;
+    std::unordered_map<std::thread::id, FontFreeType::ThreadFace> _faces;
+};
+
+void testFont(const std::string& fontFile, float fontSize, bool distanceField, float outline)
+{
+    auto font = FontFreeType::create(fontFile, fontSize, GlyphCollection::DYNAMIC, nullptr, distanceField, outline);
+    if (!ENGINE_CHECK(font != nullptr))
+        return;
+    font->retain();
+
+    const int count = static_cast<int>(LAST_CHAR - FIRST_CHAR + 1);
+    std::vector<FontGlyphBitmap> expected(count);
+    enginetest::Stopwatch stopwatch;
+    int rasterized = 0;
+    for (int i = 0; i < count; ++i)
+        rasterized += font->rasterizeGlyph(FIRST_CHAR + i, expected[i]);
+    double serialMilliseconds = stopwatch.getMilliseconds();
+
+    auto jobSystem = JobSystem::getInstance();
+    std::vector<FontGlyphBitmap> glyphs(count);
+    std::atomic<int> faceErrors(0);
+    {
+        ThreadFaces faces(font);
+        stopwatch.restart();
+        jobSystem->parallelFor(count, [&](int i) {
+            auto face = faces.get();
+            if (face)
+                font->rasterizeGlyph(FIRST_CHAR + i, glyphs[i], face);
+            else
+                ++faceErrors;
+        });
+        double parallelMilliseconds = stopwatch.getMilliseconds();
+
+        printf("size %g%s%s: %d glyphs, %.2f ms with the font face, %.2f ms on %u threads\n", fontSize,
+            distanceField ? " distance field" : "", outline > 0 ? " outline" : "", rasterized, serialMilliseconds,
+            parallelMilliseconds, static_cast<unsigned int>(faces.size()));
+    }
+    ENGINE_CHECK(faceErrors == 0);
+
+    int mismatches = 0;
+    for (int i = 0; i < count; ++i)
+        mismatches += !sameGlyph(expected[i], glyphs[i]);
+    ENGINE_CHECK(mismatches == 0);
+    ENGINE_CHECK(rasterized > count / 2);
+
+    font->release();
+}
+
+}
+
+int main(int argc, char** argv)
+{
+    std::string fontFile = argc > 1 ? argv[1] : ENGINE_TEST_FONT;
+    if (!FileUtils::getInstance()->isFileExist(fontFile))
+    {
+        printf("%s not found, skipped\n", fontFile.c_str());
+        return enginetest::result("FontRasterizerTest");
+    }
+
+    testFont(fontFile, 24, false, 0);
+    testFont(fontFile, 48, false, 0);
+    testFont(fontFile, 24, true, 0);
+    testFont(fontFile, 24, false, 2);
+    return enginetest::result("FontRasterizerTest");
+}
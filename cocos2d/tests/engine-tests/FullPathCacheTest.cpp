@@ -0,0 +1,117 @@
+/****************************************************************************
+Copyright (c) 2019 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+// Checks that fullPathForFilename() sees files created after a failed lookup, forgets files removed through
+// FileUtils, and only remembers missing files when the not-found cache is enabled. Then times cached hits
+// and repeated misses.
+
+#include <cstdio>
+
+#include "cocos2d.h"
+#include "EngineTest.h"
+
+USING_NS_CC;
+
+namespace {
+
+// creates a file behind the back of FileUtils, like a third party downloader would
+void createFileDirectly(const std::string& fullPath)
+{
+    FILE* file = fopen(fullPath.c_str(), "wb");
+    if (ENGINE_CHECK(file != nullptr))
+    {
+        fputs("engine test", file);
+        fclose(file);
+    }
+}
+
+}
+
+int main()
+{
+    auto fileUtils = FileUtils::getInstance();
+    const auto searchPaths = fileUtils->getSearchPaths();
+    const std::string root = fileUtils->getWritablePath() + "engine-tests-full-path-cache/";
+    fileUtils->removeDirectory(root);
+    ENGINE_CHECK(fileUtils->createDirectory(root));
+    fileUtils->addSearchPath(root, true);
+
+    ENGINE_CHECK(!fileUtils->isNotFoundCacheEnabled());
+
+    // a miss is not remembered by default
+    ENGINE_CHECK(fileUtils->fullPathForFilename("late.txt").empty());
+    createFileDirectly(root + "late.txt");
+    ENGINE_CHECK(fileUtils->fullPathForFilename("late.txt") == root + "late.txt");
+
+    // a removed file is forgotten
+    ENGINE_CHECK(fileUtils->removeFile(root + "late.txt"));
+    ENGINE_CHECK(fileUtils->fullPathForFilename("late.txt").empty());
+
+    // a renamed file is found under its new name and forgotten under the old one
+    createFileDirectly(root + "before.txt");
+    ENGINE_CHECK(fileUtils->fullPathForFilename("before.txt") == root + "before.txt");
+    ENGINE_CHECK(fileUtils->renameFile(root + "before.txt", root + "after.txt"));
+    ENGINE_CHECK(fileUtils->fullPathForFilename("before.txt").empty());
+    ENGINE_CHECK(fileUtils->fullPathForFilename("after.txt") == root + "after.txt");
+
+    // with the not-found cache a file created behind FileUtils stays missing until the cache is purged,
+    // a file written through FileUtils is found right away
+    fileUtils->setNotFoundCacheEnabled(true);
+    ENGINE_CHECK(fileUtils->fullPathForFilename("cached.txt").empty());
+    createFileDirectly(root + "cached.txt");
+    ENGINE_CHECK(fileUtils->fullPathForFilename("cached.txt").empty());
+    fileUtils->purgeCachedEntries();
+    ENGINE_CHECK(fileUtils->fullPathForFilename("cached.txt") == root + "cached.txt");
+    ENGINE_CHECK(fileUtils->fullPathForFilename("written.txt").empty());
+    ENGINE_CHECK(fileUtils->writeStringToFile("engine test", root + "written.txt"));
+    ENGINE_CHECK(fileUtils->fullPathForFilename("written.txt") == root + "written.txt");
+    fileUtils->setNotFoundCacheEnabled(false);
+
+    const int LOOKUPS = 100000;
+    enginetest::Stopwatch stopwatch;
+    size_t found = 0;
+    for (int i = 0; i < LOOKUPS; ++i)
+        found += !fileUtils->fullPathForFilename("after.txt").empty();
+    printf("cached hit: %.3f us per lookup\n", stopwatch.getMilliseconds() * 1000 / LOOKUPS);
+    ENGINE_CHECK(found == LOOKUPS);
+
+    // misses walk the search paths, report a few thousand only
+    const int MISSES = 5000;
+    stopwatch.restart();
+    for (int i = 0; i < MISSES; ++i)
+        found += !fileUtils->fullPathForFilename("missing.txt").empty();
+    printf("miss, not-found cache off: %.3f us per lookup\n", stopwatch.getMilliseconds() * 1000 / MISSES);
+    fileUtils->setNotFoundCacheEnabled(true);
+    stopwatch.restart();
+    for (int i = 0; i < MISSES; ++i)
+        found += !fileUtils->fullPathForFilename("missing.txt").empty();
+    printf("miss, not-found cache on: %.3f us per lookup\n", stopwatch.getMilliseconds() * 1000 / MISSES);
+    fileUtils->setNotFoundCacheEnabled(false);
+    ENGINE_CHECK(found == LOOKUPS);
+
+    fileUtils->setSearchPaths(searchPaths);
+    fileUtils->removeDirectory(root);
+
+    return enginetest::result("FullPathCacheTest");
+}
@@ -0,0 +1,105 @@
+/****************************************************************************
+Copyright (c) 2019 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+// Pushes and clears from several threads while the consumer runs the queue, every callable has to be either
+// run or discarded exactly once, and the queue has to keep working after the producers are done.
+
+#include <thread>
+#include <vector>
+
+#include "base/CCFunctionQueue.h"
+#include "EngineTest.h"
+
+USING_NS_CC;
+
+namespace {
+
+const int PRODUCER_COUNT = 4;
+const int PUSHES_PER_PRODUCER = 200000;
+
+std::atomic<int> s_ran(0);
+std::atomic<int> s_destroyed(0);
+
+// counts its destruction once, however often it is moved
+struct Task
+{
+    bool armed = true;
+
+    Task() {}
+    Task(Task&& other) : armed(other.armed) { other.armed = false; }
+    ~Task()
+    {
+        if (armed)
+            s_destroyed.fetch_add(1, std::memory_order_relaxed);
+    }
+    void operator()() { s_ran.fetch_add(1, std::memory_order_relaxed); }
+};
+
+}
+
+int main()
+{
+    {
+        FunctionQueue queue;
+        std::atomic<int> finishedProducers(0);
+        std::vector<std::thread> producers;
+        enginetest::Stopwatch stopwatch;
+        for (int i = 0; i < PRODUCER_COUNT; ++i)
+        {
+            producers.emplace_back([&queue, &finishedProducers, i]() {
+                for (int j = 0; j < PUSHES_PER_PRODUCER; ++j)
+                {
+                    queue.push(Task());
+                    if (i == 0 && j % 1000 == 999)
+                        queue.clear();
+                }
+                finishedProducers.fetch_add(1);
+            });
+        }
+        while (finishedProducers.load() != PRODUCER_COUNT)
+            queue.performAll();
+        for (auto& producer : producers)
+            producer.join();
+        queue.performAll();
+        double milliseconds = stopwatch.getMilliseconds();
+
+        ENGINE_CHECK(queue.empty());
+        ENGINE_CHECK(s_destroyed.load() == PRODUCER_COUNT * PUSHES_PER_PRODUCER);
+        ENGINE_CHECK(s_ran.load() <= s_destroyed.load());
+        printf("%d producers, %d pushes with clears: %.2f ms, %d run\n",
+            PRODUCER_COUNT, PRODUCER_COUNT * PUSHES_PER_PRODUCER, milliseconds, s_ran.load());
+
+        // a clear counted and linked after the producers are gone must not drop later callables
+        queue.clear();
+        queue.performAll();
+        int ranBefore = s_ran.load();
+        queue.push(Task());
+        queue.performAll();
+        ENGINE_CHECK(s_ran.load() == ranBefore + 1);
+        ENGINE_CHECK(queue.empty());
+    }
+    ENGINE_CHECK(s_destroyed.load() == PRODUCER_COUNT * PUSHES_PER_PRODUCER + 1);
+
+    return enginetest::result("FunctionQueueTest");
+}
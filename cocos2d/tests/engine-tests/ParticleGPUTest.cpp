@@ -0,0 +1,280 @@
+/****************************************************************************
+Copyright (c) 2019 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+// Runs the same emitters simulated on the CPU and packed for the vertex shader of the GPU simulation, evaluates the
+// shader math on the packed particles and checks it against the CPU particles, then checks the recycling of the
+// slots, resetSystem(), auto removal and the CPU fallback. Then times the CPU side of both modes.
+
+#include <cmath>
+#include <vector>
+
+#include "cocos2d.h"
+#include "EngineTest.h"
+
+USING_NS_CC;
+
+namespace {
+
+const float FRAME_TIME = 1.0f / 60;
+const float GRAVITY = -90;
+
+// initialized without a GL context, the GPU simulation is forced on and the vertex shader is evaluated here
+class Emitter : public ParticleSystemQuad
+{
+public:
+    Emitter(int totalParticles, PositionType positionType, bool gpu)
+    {
+        ParticleSystem::initWithTotalParticles(totalParticles);
+        allocMemory();
+        initIndices();
+        setEmitterMode(Mode::GRAVITY);
+        setPositionType(positionType);
+        setDuration(DURATION_INFINITY);
+        setLife(2.0f);
+        setLifeVar(0);
+        setEmissionRate(totalParticles / 2.0f);
+        setPosVar(Vec2(20, 20));
+        setAngle(90);
+        setAngleVar(180);
+        setStartSize(16);
+        setStartSizeVar(8);
+        setEndSize(4);
+        setStartSpinVar(90);
+        setEndSpin(180);
+        setStartColor(Color4F(1.0f, 0.5f, 0.2f, 1.0f));
+        setEndColor(Color4F(0.2f, 0.2f, 1.0f, 0.0f));
+        setGravity(Vec2(0, GRAVITY));
+        setSpeed(120);
+        setSpeedVar(40);
+        setRandomSeed(17);
+        _gpuSimulationSupported = gpu;
+        _gpuSimulationEnabled = gpu;
+    }
+
+    // the vertex buffer is never uploaded
+    virtual void postStep() override {}
+
+    int getSlotCount() const { return _gpuSlotCount; }
+    int getLivingCount() const
+    {
+        int living = 0;
+        for (int slot = 0; slot < _gpuSlotCount; ++slot)
+        {
+            const Vec4& spawn = _gpuVertices[slot * 4].spawn;
+            living += _gpuTime - spawn.z < spawn.w;
+        }
+        return living;
+    }
+
+    // ccShader_ParticleGPU.vert with the uniforms of onDrawGPU(), the center of the particle in node space
+    Vec2 shaderCenter(int slot, float& size, Color4F& color) const
+    {
+        const GPUVertex& vertex = _gpuVertices[slot * 4];
+        float age = _gpuTime - vertex.spawn.z;
+        Vec2 velocity(vertex.motion.z + 0.5f * modeA.gravity.x * age, vertex.motion.w + 0.5f * modeA.gravity.y * age);
+        Vec2 position = Vec2(vertex.motion.x, vertex.motion.y) + velocity * age * _yCoordFlipped;
+        Vec3 start(vertex.spawn.x, vertex.spawn.y, 0);
+        if (_positionType == PositionType::FREE)
+            getWorldToNodeTransform().transformPoint(&start);
+        else if (_positionType == PositionType::RELATIVE)
+            start -= Vec3(_position.x, _position.y, 0);
+        if (_positionType != PositionType::GROUPED)
+            position += Vec2(start.x, start.y);
+        size = std::max(vertex.shape.x + vertex.shape.y * age, 0.0f);
+        color = Color4F(vertex.color.r + vertex.deltaColor.r * age, vertex.color.g + vertex.deltaColor.g * age,
+                        vertex.color.b + vertex.deltaColor.b * age, vertex.color.a + vertex.deltaColor.a * age);
+        return position;
+    }
+
+    // the center of a particle simulated on the CPU, its quad is rotated around it
+    Vec2 cpuCenter(int index, float& size, Color4F& color) const
+    {
+        const V3F_C4B_T2F_Quad& quad = _quads[index];
+        size = _particleData.size[index];
+        color = Color4F(_particleData.colorR[index], _particleData.colorG[index], _particleData.colorB[index], _particleData.colorA[index]);
+        return Vec2(quad.bl.vertices.x + quad.tr.vertices.x, quad.bl.vertices.y + quad.tr.vertices.y) / 2;
+    }
+
+    float getAge(int slot) const { return _gpuTime - _gpuVertices[slot * 4].spawn.z; }
+};
+
+void testAgainstCPU(ParticleSystem::PositionType positionType)
+{
+    srand(5);
+    auto parent = Node::create();
+    parent->setPosition(Vec2(300, 200));
+    parent->setRotation(30);
+    auto cpu = new (std::nothrow) Emitter(500, positionType, false);
+    auto gpu = new (std::nothrow) Emitter(500, positionType, true);
+    parent->addChild(cpu);
+    parent->addChild(gpu);
+
+    int compared = 0;
+    int errors = 0;
+    float worst = 0;
+    // both are compared before the first particle dies
+    for (int frame = 1; frame < 110; ++frame)
+    {
+        Vec2 position(frame * 2.0f, std::sin(frame * 0.1f) * 50);
+        cpu->setPosition(position);
+        gpu->setPosition(position);
+        cpu->update(FRAME_TIME);
+        gpu->update(FRAME_TIME);
+        ENGINE_CHECK(gpu->isGPUSimulationActive() && !cpu->isGPUSimulationActive());
+        ENGINE_CHECK(cpu->getParticleCount() == gpu->getParticleCount());
+        if (frame % 10)
+            continue;
+
+        for (int i = 0; i < (int)gpu->getParticleCount(); ++i)
+        {
+            float cpuSize, gpuSize;
+            Color4F cpuColor, gpuColor;
+            Vec2 cpuPosition = cpu->cpuCenter(i, cpuSize, cpuColor);
+            Vec2 gpuPosition = gpu->shaderCenter(i, gpuSize, gpuColor);
+            // the CPU integrates the gravity one frame at a time, the shader exactly
+            float age = gpu->getAge(i);
+            float tolerance = 0.5f * std::abs(GRAVITY) * FRAME_TIME * age + 0.05f;
+            float distance = cpuPosition.distance(gpuPosition);
+            worst = std::max(worst, distance - 0.5f * std::abs(GRAVITY) * FRAME_TIME * age);
+            errors += distance > tolerance;
+            errors += std::abs(cpuSize - gpuSize) > 0.01f;
+            errors += std::abs(cpuColor.r - gpuColor.r) > 0.001f || std::abs(cpuColor.a - gpuColor.a) > 0.001f;
+            ++compared;
+        }
+    }
+    printf("position type %d: %d particles compared, %d differ, worst difference beyond the integration error %.4f\n",
+           (int)positionType, compared, errors, worst);
+    ENGINE_CHECK(compared > 0);
+    ENGINE_CHECK(errors == 0);
+
+    cpu->release();
+    gpu->release();
+}
+
+void testRecycling()
+{
+    auto parent = Node::create();
+    auto cpu = new (std::nothrow) Emitter(300, ParticleSystem::PositionType::GROUPED, false);
+    auto gpu = new (std::nothrow) Emitter(300, ParticleSystem::PositionType::GROUPED, true);
+    // about 200 particles live at once, they die in another order than they were emitted in
+    for (auto emitter : { cpu, gpu })
+    {
+        emitter->setLifeVar(0.8f);
+        emitter->setEmissionRate(100);
+    }
+    parent->addChild(cpu);
+    parent->addChild(gpu);
+
+    // the death of a particle may fall on another frame on both sides, from there their random numbers differ
+    int errors = 0;
+    for (int frame = 0; frame < 900; ++frame)
+    {
+        cpu->update(FRAME_TIME);
+        gpu->update(FRAME_TIME);
+        errors += gpu->getSlotCount() > 290;
+        errors += gpu->getLivingCount() != (int)gpu->getParticleCount();
+        errors += std::abs(gpu->getLivingCount() - (int)cpu->getParticleCount()) > 6;
+    }
+    printf("recycling: %d slots drawn, %d living, %u on the CPU\n", gpu->getSlotCount(), gpu->getLivingCount(), cpu->getParticleCount());
+    ENGINE_CHECK(errors == 0);
+
+    gpu->resetSystem();
+    ENGINE_CHECK(gpu->getLivingCount() == 0);
+    gpu->update(FRAME_TIME);
+    ENGINE_CHECK(gpu->getParticleCount() == gpu->getLivingCount() && gpu->getLivingCount() > 0);
+
+    // a radial acceleration needs the position of the particle, the system goes back to the CPU
+    gpu->setRadialAccel(10);
+    gpu->update(FRAME_TIME);
+    ENGINE_CHECK(!gpu->isGPUSimulationActive() && gpu->isGPUSimulationEnabled());
+    gpu->setRadialAccel(0);
+    gpu->update(FRAME_TIME);
+    ENGINE_CHECK(gpu->isGPUSimulationActive());
+
+    cpu->release();
+    gpu->release();
+}
+
+void testAutoRemove()
+{
+    auto parent = Node::create();
+    parent->retain();
+    auto gpu = new (std::nothrow) Emitter(200, ParticleSystem::PositionType::FREE, true);
+    gpu->setDuration(0.5f);
+    gpu->setAutoRemoveOnFinish(true);
+    parent->addChild(gpu);
+    gpu->release();
+
+    int frames = 0;
+    while (parent->getChildrenCount() > 0 && frames < 1000)
+    {
+        gpu->update(FRAME_TIME);
+        ++frames;
+    }
+    printf("auto removed after %d frames\n", frames);
+    ENGINE_CHECK(parent->getChildrenCount() == 0);
+    ENGINE_CHECK(frames > 0.5f / FRAME_TIME && frames < 3.0f / FRAME_TIME);
+    parent->release();
+}
+
+double benchmark(bool gpu)
+{
+    srand(9);
+    std::vector<Emitter*> emitters;
+    for (int i = 0; i < 50; ++i)
+        emitters.push_back(new (std::nothrow) Emitter(2000, ParticleSystem::PositionType::FREE, gpu));
+
+    // warm up until the systems are full
+    for (int frame = 0; frame < 150; ++frame)
+        for (auto emitter : emitters)
+            emitter->update(FRAME_TIME);
+
+    enginetest::Stopwatch stopwatch;
+    for (int frame = 0; frame < 300; ++frame)
+        for (auto emitter : emitters)
+            emitter->update(FRAME_TIME);
+    double milliseconds = stopwatch.getMilliseconds() / 300;
+
+    for (auto emitter : emitters)
+        emitter->release();
+    return milliseconds;
+}
+
+}
+
+int main()
+{
+    Director::getInstance();
+    testAgainstCPU(ParticleSystem::PositionType::FREE);
+    testAgainstCPU(ParticleSystem::PositionType::RELATIVE);
+    testAgainstCPU(ParticleSystem::PositionType::GROUPED);
+    testRecycling();
+    testAutoRemove();
+
+    double cpu = benchmark(false);
+    double gpu = benchmark(true);
+    printf("50 systems, 100k particles, update on the cocos thread: CPU %.2f ms, GPU %.2f ms per frame\n", cpu, gpu);
+
+    return enginetest::result("ParticleGPUTest");
+}
@@ -0,0 +1,242 @@
+/****************************************************************************
+Copyright (c) 2019 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+// Compares the SIMD particle kernels bit for bit against the scalar reference on lengths around the block size
+// and on positions the gravity mode treats specially, then runs 50 emitters with 100k particles in total through
+// ParticleSystem::update with both paths, checks that every particle ends up the same and times them.
+
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "cocos2d.h"
+#include "EngineTest.h"
+
+USING_NS_CC;
+
+namespace {
+
+const int EMITTER_COUNT = 50;
+const int PARTICLES_PER_EMITTER = 2000;
+const int FRAMES = 300;
+const float FRAME_TIME = 1.0f / 60;
+
+std::mt19937 s_random(11);
+
+std::vector<float> randomValues(int count, float low, float high)
+{
+    std::uniform_real_distribution<float> distribution(low, high);
+    std::vector<float> values(count);
+    for (auto& value : values)
+        value = distribution(s_random);
+    return values;
+}
+
+bool sameBits(const std::vector<float>& a, const std::vector<float>& b)
+{
+    return a.size() == b.size() && (a.empty() || memcmp(a.data(), b.data(), a.size() * sizeof(float)) == 0);
+}
+
+void testKernels()
+{
+    for (int count = 0; count < 40; ++count)
+    {
+        auto values = randomValues(count, -10, 10);
+        auto deltas = randomValues(count, -50, 50);
+        auto scalar = values;
+        auto simd = values;
+        ParticleKernels::Scalar::integrate(scalar.data(), deltas.data(), count, FRAME_TIME);
+        ParticleKernels::integrate(simd.data(), deltas.data(), count, FRAME_TIME);
+        ENGINE_CHECK(sameBits(scalar, simd));
+
+        ParticleKernels::Scalar::integrateNonNegative(scalar.data(), deltas.data(), count, 0.3f);
+        ParticleKernels::integrateNonNegative(simd.data(), deltas.data(), count, 0.3f);
+        ENGINE_CHECK(sameBits(scalar, simd));
+
+        ParticleKernels::Scalar::decay(scalar.data(), count, 2.5f);
+        ParticleKernels::decay(simd.data(), count, 2.5f);
+        ENGINE_CHECK(sameBits(scalar, simd));
+
+        for (int begin = 0; begin <= count; ++begin)
+            ENGINE_CHECK(ParticleKernels::Scalar::findExpired(scalar.data(), begin, count) == ParticleKernels::findExpired(scalar.data(), begin, count));
+    }
+
+    // positions the scalar code doesn't normalize: the origin, unit vectors and vectors shorter than the tolerance
+    const float specialX[] = { 0.0f, -0.0f, 1.0f, 0.0f, -1.0f, 0.6f, 1e-38f, 0.0f, 3.0f, -2.0f, 1e-20f, 0.0f };
+    const float specialY[] = { 0.0f, 0.0f, 0.0f, -1.0f, 0.0f, 0.8f, 1e-38f, 1e-39f, 4.0f, 0.0f, 0.0f, 5e-19f };
+    for (int count = 0; count < 40; ++count)
+    {
+        auto posx = randomValues(count, -300, 300);
+        auto posy = randomValues(count, -300, 300);
+        for (int i = 0; i < count; ++i)
+        {
+            if (i % 3 == 0)
+            {
+                posx[i] = specialX[(i / 3) % 12];
+                posy[i] = specialY[(i / 3) % 12];
+            }
+        }
+        auto dirX = randomValues(count, -100, 100);
+        auto dirY = randomValues(count, -100, 100);
+        auto radialAccel = randomValues(count, -40, 40);
+        auto tangentialAccel = randomValues(count, -40, 40);
+        std::vector<float> scalar[] = { posx, posy, dirX, dirY };
+        std::vector<float> simd[] = { posx, posy, dirX, dirY };
+        for (float flip : { 1.0f, -1.0f })
+        {
+            ParticleKernels::Scalar::updateGravityMode(scalar[0].data(), scalar[1].data(), scalar[2].data(), scalar[3].data(),
+                                                       radialAccel.data(), tangentialAccel.data(), count, 3.0f, -98.0f, FRAME_TIME, flip);
+            ParticleKernels::updateGravityMode(simd[0].data(), simd[1].data(), simd[2].data(), simd[3].data(),
+                                               radialAccel.data(), tangentialAccel.data(), count, 3.0f, -98.0f, FRAME_TIME, flip);
+        }
+        for (int k = 0; k < 4; ++k)
+            ENGINE_CHECK(sameBits(scalar[k], simd[k]));
+    }
+}
+
+// opens up the constructor and the particle data
+class Emitter : public ParticleSystem
+{
+public:
+    explicit Emitter(Mode mode)
+    {
+        initWithTotalParticles(PARTICLES_PER_EMITTER);
+        setEmitterMode(mode);
+        setDuration(DURATION_INFINITY);
+        setLife(2.0f);
+        setLifeVar(1.0f);
+        setEmissionRate(PARTICLES_PER_EMITTER / 2.0f);
+        setPosVar(Vec2(20, 20));
+        setAngle(90);
+        setAngleVar(180);
+        setStartSize(16);
+        setStartSizeVar(8);
+        setEndSize(0);
+        setEndSizeVar(4);
+        setStartSpinVar(90);
+        setEndSpin(180);
+        setStartColor(Color4F(1.0f, 0.5f, 0.2f, 1.0f));
+        setStartColorVar(Color4F(0.1f, 0.1f, 0.1f, 0.0f));
+        setEndColor(Color4F(0.2f, 0.2f, 1.0f, 0.0f));
+        if (mode == Mode::GRAVITY)
+        {
+            setGravity(Vec2(0, -90));
+            setSpeed(120);
+            setSpeedVar(40);
+            setRadialAccel(-20);
+            setRadialAccelVar(10);
+            setTangentialAccel(30);
+            setTangentialAccelVar(10);
+        }
+        else
+        {
+            setStartRadius(10);
+            setStartRadiusVar(5);
+            setEndRadius(200);
+            setRotatePerSecond(90);
+            setRotatePerSecondVar(30);
+        }
+    }
+
+    std::vector<float> snapshot() const
+    {
+        const float* arrays[] = {
+            _particleData.posx, _particleData.posy, _particleData.startPosX, _particleData.startPosY,
+            _particleData.colorR, _particleData.colorG, _particleData.colorB, _particleData.colorA,
+            _particleData.deltaColorR, _particleData.deltaColorG, _particleData.deltaColorB, _particleData.deltaColorA,
+            _particleData.size, _particleData.deltaSize, _particleData.rotation, _particleData.deltaRotation,
+            _particleData.timeToLive,
+        };
+        // the arrays of the other mode are never written
+        const float* modeArrays[] = {
+            _particleData.modeA.dirX, _particleData.modeA.dirY, _particleData.modeA.radialAccel, _particleData.modeA.tangentialAccel,
+            _particleData.modeB.angle, _particleData.modeB.degreesPerSecond, _particleData.modeB.radius, _particleData.modeB.deltaRadius,
+        };
+        std::vector<float> result;
+        for (auto array : arrays)
+            result.insert(result.end(), array, array + _particleCount);
+        for (int i = 0; i < 4; ++i)
+        {
+            auto array = modeArrays[_emitterMode == Mode::GRAVITY ? i : i + 4];
+            result.insert(result.end(), array, array + _particleCount);
+        }
+        return result;
+    }
+};
+
+// returns the update time, and the state of every particle in states
+double runEmitters(bool simd, std::vector<std::vector<float>>& states, unsigned int& particleCount)
+{
+    ParticleKernels::setSIMDEnabled(simd);
+    srand(3);
+    std::vector<Emitter*> emitters;
+    for (int i = 0; i < EMITTER_COUNT; ++i)
+        emitters.push_back(new (std::nothrow) Emitter(i % 2 ? ParticleSystem::Mode::RADIUS : ParticleSystem::Mode::GRAVITY));
+
+    enginetest::Stopwatch stopwatch;
+    for (int frame = 0; frame < FRAMES; ++frame)
+    {
+        for (auto emitter : emitters)
+            emitter->update(FRAME_TIME);
+    }
+    double milliseconds = stopwatch.getMilliseconds();
+
+    states.clear();
+    particleCount = 0;
+    for (auto emitter : emitters)
+    {
+        states.push_back(emitter->snapshot());
+        particleCount += emitter->getParticleCount();
+        emitter->release();
+    }
+    ParticleKernels::setSIMDEnabled(true);
+    return milliseconds;
+}
+
+}
+
+int main()
+{
+    printf("SIMD %s\n", ParticleKernels::isSIMDSupported() ? "supported" : "not supported, both runs use the scalar code");
+    testKernels();
+
+    std::vector<std::vector<float>> scalarStates;
+    std::vector<std::vector<float>> simdStates;
+    unsigned int scalarCount = 0;
+    unsigned int simdCount = 0;
+    // warm up
+    runEmitters(true, simdStates, simdCount);
+
+    double scalarTime = runEmitters(false, scalarStates, scalarCount);
+    double simdTime = runEmitters(true, simdStates, simdCount);
+    ENGINE_CHECK(scalarCount == simdCount);
+    ENGINE_CHECK(scalarStates.size() == simdStates.size());
+    for (size_t i = 0; i < scalarStates.size() && i < simdStates.size(); ++i)
+        ENGINE_CHECK(sameBits(scalarStates[i], simdStates[i]));
+
+    printf("%d emitters, %u live particles after %d frames\n", EMITTER_COUNT, simdCount, FRAMES);
+    printf("  scalar: %.2f ms per frame\n", scalarTime / FRAMES);
+    printf("  SIMD:   %.2f ms per frame\n", simdTime / FRAMES);
+    return enginetest::result("ParticleKernelsTest");
+}
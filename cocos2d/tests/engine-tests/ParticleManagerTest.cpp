@@ -0,0 +1,258 @@
+/****************************************************************************
+Copyright (c) 2019 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+// Runs free, relative and grouped particle systems under moving parents through their scheduled updates, once on
+// the cocos thread and once through ParticleManager on a JobSystem with workers, and checks that every particle and
+// vertex ends up the same and that finished systems remove themselves in both. Then times 48 systems both ways.
+
+#include <atomic>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "cocos2d.h"
+#include "EngineTest.h"
+
+USING_NS_CC;
+
+namespace {
+
+const int GROUP_COUNT = 8;
+const int EMITTERS_PER_GROUP = 6;
+const float FRAME_TIME = 1.0f / 60;
+
+// opens up the constructor and the particle data, its vertices are the corners of the particles in node space
+class Emitter : public ParticleSystem
+{
+public:
+    Emitter(int totalParticles, PositionType positionType, bool finite)
+    {
+        initWithTotalParticles(totalParticles);
+        setEmitterMode(Mode::GRAVITY);
+        setPositionType(positionType);
+        setDuration(finite ? 0.4f : DURATION_INFINITY);
+        setAutoRemoveOnFinish(finite);
+        setLife(1.0f);
+        setLifeVar(0.5f);
+        setEmissionRate(totalParticles / 1.5f);
+        setPosVar(Vec2(20, 20));
+        setAngle(90);
+        setAngleVar(180);
+        setStartSize(16);
+        setStartSizeVar(8);
+        setEndSize(0);
+        setStartSpinVar(90);
+        setEndSpin(180);
+        setStartColor(Color4F(1.0f, 0.5f, 0.2f, 1.0f));
+        setEndColor(Color4F(0.2f, 0.2f, 1.0f, 0.0f));
+        setGravity(Vec2(0, -90));
+        setSpeed(120);
+        setSpeedVar(40);
+        setRadialAccel(-20);
+        setTangentialAccel(30);
+        _vertices.resize(totalParticles * 2);
+    }
+
+    // the same position math as ParticleSystemQuad, from what prepareStep() captured
+    virtual void updateParticleQuads() override
+    {
+        Vec3 origin(_stepWorldPosition.x, _stepWorldPosition.y, 0);
+        if (_positionType == PositionType::FREE)
+            _stepWorldToNodeTransform.transformPoint(&origin);
+        for (int i = 0; i < _particleCount; ++i)
+        {
+            Vec2 position(_particleData.posx[i], _particleData.posy[i]);
+            if (_positionType == PositionType::FREE)
+            {
+                Vec3 start(_particleData.startPosX[i], _particleData.startPosY[i], 0);
+                _stepWorldToNodeTransform.transformPoint(&start);
+                position -= Vec2(origin.x - start.x, origin.y - start.y);
+            }
+            else if (_positionType == PositionType::RELATIVE)
+            {
+                position -= _position - Vec2(_particleData.startPosX[i], _particleData.startPosY[i]);
+            }
+            float half = _particleData.size[i] / 2;
+            _vertices[i * 2] = position - Vec2(half, half);
+            _vertices[i * 2 + 1] = position + Vec2(half, half);
+        }
+    }
+
+    std::vector<float> snapshot() const
+    {
+        const float* arrays[] = {
+            _particleData.posx, _particleData.posy, _particleData.startPosX, _particleData.startPosY,
+            _particleData.colorR, _particleData.colorG, _particleData.colorB, _particleData.colorA,
+            _particleData.size, _particleData.rotation, _particleData.timeToLive,
+            _particleData.modeA.dirX, _particleData.modeA.dirY,
+        };
+        std::vector<float> result;
+        for (auto array : arrays)
+            result.insert(result.end(), array, array + _particleCount);
+        for (int i = 0; i < _particleCount * 2; ++i)
+        {
+            result.push_back(_vertices[i].x);
+            result.push_back(_vertices[i].y);
+        }
+        return result;
+    }
+
+private:
+    std::vector<Vec2> _vertices;
+};
+
+bool sameBits(const std::vector<float>& a, const std::vector<float>& b)
+{
+    return a.size() == b.size() && (a.empty() || memcmp(a.data(), b.data(), a.size() * sizeof(float)) == 0);
+}
+
+void testJobSystem()
+{
+    JobSystem jobSystem(3);
+    ENGINE_CHECK(jobSystem.getWorkerCount() == 3);
+    int errors = 0;
+    for (int count = 0; count < 300; ++count)
+    {
+        std::vector<std::atomic<int>> calls(count);
+        for (auto& call : calls)
+            call = 0;
+        jobSystem.parallelFor(count, [&](int i) { ++calls[i]; });
+        for (auto& call : calls)
+            errors += call != 1;
+    }
+    ENGINE_CHECK(errors == 0);
+
+    // a call from a job runs on the thread of the job
+    std::atomic<int> nestedErrors(0);
+    jobSystem.parallelFor(16, [&](int) {
+        auto thread = std::this_thread::get_id();
+        jobSystem.parallelFor(8, [&](int) { nestedErrors += std::this_thread::get_id() != thread; });
+    });
+    ENGINE_CHECK(nestedErrors == 0);
+
+    JobSystem serial(0);
+    int sum = 0;
+    serial.parallelFor(100, [&](int i) { sum += i; });
+    ENGINE_CHECK(sum == 4950);
+}
+
+struct Run
+{
+    std::vector<std::vector<float>> states;
+    int removed = 0;
+    size_t queued = 0;
+    double milliseconds = 0;
+};
+
+// returns the state of every emitter after the frames, the finished ones removed themselves
+Run runScene(JobSystem* jobSystem, int totalParticles, bool finiteEmitters, int frames)
+{
+    auto director = Director::getInstance();
+    auto manager = director->getParticleManager();
+    manager->setJobSystem(jobSystem);
+    manager->setParallelEnabled(jobSystem != nullptr);
+
+    srand(7);
+    auto root = Node::create();
+    root->retain();
+    root->setPosition(Vec2(480, 320));
+    root->setScale(1.5f);
+    std::vector<Emitter*> emitters;
+    for (int i = 0; i < GROUP_COUNT; ++i)
+    {
+        auto group = Node::create();
+        group->setRotation(i * 45.0f);
+        root->addChild(group);
+        for (int j = 0; j < EMITTERS_PER_GROUP; ++j)
+        {
+            auto positionType = static_cast<ParticleSystem::PositionType>(j % 3);
+            auto emitter = new (std::nothrow) Emitter(totalParticles, positionType, finiteEmitters && j == 0);
+            emitter->setPosition(Vec2(j * 30.0f, 0));
+            group->addChild(emitter);
+            emitters.push_back(emitter);
+        }
+    }
+    root->onEnter();
+
+    Run run;
+    enginetest::Stopwatch stopwatch;
+    for (int frame = 0; frame < frames; ++frame)
+    {
+        for (int i = 0; i < GROUP_COUNT; ++i)
+        {
+            auto group = root->getChildren().at(i);
+            group->setRotation(group->getRotation() + 1);
+            group->setPosition(Vec2(frame * 0.5f, i * 4.0f));
+        }
+        director->getScheduler()->update(FRAME_TIME);
+        run.queued += manager->getQueuedEmitterCount();
+        manager->updateEmitters();
+    }
+
+    run.milliseconds = stopwatch.getMilliseconds();
+    ENGINE_CHECK(manager->getQueuedEmitterCount() == 0);
+    for (auto emitter : emitters)
+    {
+        if (emitter->getParent())
+            run.states.push_back(emitter->snapshot());
+        else
+            ++run.removed;
+        emitter->release();
+    }
+    root->onExit();
+    root->cleanup();
+    root->release();
+    manager->setJobSystem(nullptr);
+    manager->setParallelEnabled(true);
+    return run;
+}
+
+}
+
+int main()
+{
+    testJobSystem();
+
+    JobSystem jobSystem(3);
+    Run serial = runScene(nullptr, 300, true, 120);
+    Run parallel = runScene(&jobSystem, 300, true, 120);
+    ENGINE_CHECK(serial.queued == 0);
+    ENGINE_CHECK(parallel.queued > 0);
+    ENGINE_CHECK(serial.removed == GROUP_COUNT);
+    ENGINE_CHECK(parallel.removed == serial.removed);
+    ENGINE_CHECK(parallel.states.size() == serial.states.size());
+    int mismatches = 0;
+    for (size_t i = 0; i < serial.states.size() && i < parallel.states.size(); ++i)
+        mismatches += !sameBits(serial.states[i], parallel.states[i]);
+    printf("%d emitters left, %d removed themselves, %d differ\n", (int)serial.states.size(), serial.removed, mismatches);
+    ENGINE_CHECK(mismatches == 0);
+
+    const int frames = 300;
+    serial = runScene(nullptr, 2000, false, frames);
+    parallel = runScene(&jobSystem, 2000, false, frames);
+    printf("%d emitters with 2000 particles, %u cores\n", GROUP_COUNT * EMITTERS_PER_GROUP, std::thread::hardware_concurrency());
+    printf("  cocos thread:      %.2f ms per frame\n", serial.milliseconds / frames);
+    printf("  3 workers + cocos: %.2f ms per frame\n", parallel.milliseconds / frames);
+    return enginetest::result("ParticleManagerTest");
+}
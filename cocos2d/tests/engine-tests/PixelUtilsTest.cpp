@@ -0,0 +1,244 @@
+/****************************************************************************
+Copyright (c) 2019 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+// Compares the SIMD pixel kernels of PixelUtils bit for bit against the scalar reference, on every
+// color/alpha combination, on lengths around the block sizes and on unaligned buffers. Then measures
+// the throughput of both paths on a 2048x2048 image.
+
+#include <cstring>
+#include <functional>
+#include <random>
+#include <vector>
+
+#include "base/ccPixelUtils.h"
+#include "EngineTest.h"
+
+USING_NS_CC;
+
+namespace {
+
+typedef void (*ConvertFunction)(const unsigned char*, ssize_t, unsigned char*);
+typedef void (*InPlaceFunction)(unsigned char*, ssize_t);
+
+struct Conversion
+{
+    const char* name;
+    ConvertFunction dispatched;
+    ConvertFunction scalar;
+    int outBytesPerPixel;
+};
+
+const Conversion CONVERSIONS[] = {
+    { "RGBA4444", PixelUtils::convertRGBA8888ToRGBA4444, PixelUtils::Scalar::convertRGBA8888ToRGBA4444, 2 },
+    { "RGB565", PixelUtils::convertRGBA8888ToRGB565, PixelUtils::Scalar::convertRGBA8888ToRGB565, 2 },
+    { "RGB5A1", PixelUtils::convertRGBA8888ToRGB5A1, PixelUtils::Scalar::convertRGBA8888ToRGB5A1, 2 },
+    { "A8", PixelUtils::convertRGBA8888ToA8, PixelUtils::Scalar::convertRGBA8888ToA8, 1 },
+};
+
+// every value in every channel, paired with every alpha
+std::vector<unsigned char> allCombinations()
+{
+    std::vector<unsigned char> pixels;
+    pixels.reserve(256 * 256 * 4);
+    for (int alpha = 0; alpha < 256; ++alpha)
+    {
+        for (int color = 0; color < 256; ++color)
+        {
+            pixels.push_back(static_cast<unsigned char>(color));
+            pixels.push_back(static_cast<unsigned char>(255 - color));
+            pixels.push_back(static_cast<unsigned char>(color * 7));
+            pixels.push_back(static_cast<unsigned char>(alpha));
+        }
+    }
+    return pixels;
+}
+
+std::vector<unsigned char> randomPixels(size_t pixelCount, std::mt19937& random)
+{
+    std::vector<unsigned char> pixels(pixelCount * 4);
+    for (auto& byte : pixels)
+        byte = static_cast<unsigned char>(random());
+    return pixels;
+}
+
+// the scalar reference against the formulas of the header
+void testScalarReference(const std::vector<unsigned char>& pixels)
+{
+    const ssize_t pixelCount = pixels.size() / 4;
+    std::vector<unsigned char> out(pixels.size());
+    int errors = 0;
+
+    PixelUtils::Scalar::convertRGBA8888ToRGB565(pixels.data(), pixelCount, out.data());
+    for (ssize_t i = 0; i < pixelCount; ++i)
+    {
+        const unsigned char* p = &pixels[i * 4];
+        unsigned short expected = ((p[0] & 0xF8) << 8) | ((p[1] & 0xFC) << 3) | (p[2] >> 3);
+        unsigned short actual;
+        memcpy(&actual, &out[i * 2], 2);
+        errors += actual != expected;
+    }
+
+    PixelUtils::Scalar::convertRGBA8888ToRGBA4444(pixels.data(), pixelCount, out.data());
+    for (ssize_t i = 0; i < pixelCount; ++i)
+    {
+        const unsigned char* p = &pixels[i * 4];
+        unsigned short expected = ((p[0] & 0xF0) << 8) | ((p[1] & 0xF0) << 4) | (p[2] & 0xF0) | (p[3] >> 4);
+        unsigned short actual;
+        memcpy(&actual, &out[i * 2], 2);
+        errors += actual != expected;
+    }
+
+    PixelUtils::Scalar::convertRGBA8888ToRGB5A1(pixels.data(), pixelCount, out.data());
+    for (ssize_t i = 0; i < pixelCount; ++i)
+    {
+        const unsigned char* p = &pixels[i * 4];
+        unsigned short expected = ((p[0] & 0xF8) << 8) | ((p[1] & 0xF8) << 3) | ((p[2] & 0xF8) >> 2) | (p[3] >> 7);
+        unsigned short actual;
+        memcpy(&actual, &out[i * 2], 2);
+        errors += actual != expected;
+    }
+
+    PixelUtils::Scalar::convertRGBA8888ToA8(pixels.data(), pixelCount, out.data());
+    for (ssize_t i = 0; i < pixelCount; ++i)
+        errors += out[i] != pixels[i * 4 + 3];
+
+    std::vector<unsigned char> premultiplied(pixels);
+    PixelUtils::Scalar::premultiplyAlpha(premultiplied.data(), pixelCount);
+    for (ssize_t i = 0; i < pixelCount * 4; ++i)
+    {
+        unsigned int alpha = pixels[(i & ~3) + 3];
+        unsigned int expected = (i & 3) == 3 ? alpha : (pixels[i] * (alpha + 1)) >> 8;
+        errors += premultiplied[i] != expected;
+    }
+
+    printf("scalar reference: %d errors\n", errors);
+    ENGINE_CHECK(errors == 0);
+}
+
+// the dispatched kernels against the scalar reference, every length from 0 to 97 pixels at every byte offset
+void testDispatchedKernels(const std::vector<unsigned char>& pixels)
+{
+    int mismatches = 0;
+    std::vector<unsigned char> expected(pixels.size() + 64);
+    std::vector<unsigned char> actual(pixels.size() + 64);
+    std::vector<unsigned char> input(pixels.size() + 64);
+
+    auto checkLength = [&](ssize_t pixelCount, int inOffset, int outOffset) {
+        memcpy(&input[inOffset], pixels.data(), pixelCount * 4);
+        for (const auto& conversion : CONVERSIONS)
+        {
+            // guard bytes behind the output catch writes past the end
+            std::fill(expected.begin(), expected.end(), 0xA5);
+            std::fill(actual.begin(), actual.end(), 0xA5);
+            conversion.scalar(&input[inOffset], pixelCount, &expected[outOffset]);
+            conversion.dispatched(&input[inOffset], pixelCount, &actual[outOffset]);
+            if (memcmp(expected.data(), actual.data(), outOffset + pixelCount * conversion.outBytesPerPixel + 32) != 0)
+            {
+                if (mismatches++ < 10)
+                    printf("%s differs for %d pixels at offsets %d/%d\n", conversion.name, (int)pixelCount, inOffset, outOffset);
+            }
+        }
+
+        std::fill(expected.begin(), expected.end(), 0xA5);
+        std::fill(actual.begin(), actual.end(), 0xA5);
+        memcpy(&expected[inOffset], pixels.data(), pixelCount * 4);
+        memcpy(&actual[inOffset], pixels.data(), pixelCount * 4);
+        PixelUtils::Scalar::premultiplyAlpha(&expected[inOffset], pixelCount);
+        PixelUtils::premultiplyAlpha(&actual[inOffset], pixelCount);
+        if (memcmp(expected.data(), actual.data(), inOffset + pixelCount * 4 + 32) != 0)
+        {
+            if (mismatches++ < 10)
+                printf("premultiplyAlpha differs for %d pixels at offset %d\n", (int)pixelCount, inOffset);
+        }
+    };
+
+    for (ssize_t pixelCount = 0; pixelCount <= 97; ++pixelCount)
+    {
+        for (int inOffset = 0; inOffset < 4; ++inOffset)
+        {
+            for (int outOffset = 0; outOffset < 2; ++outOffset)
+                checkLength(pixelCount, inOffset, outOffset);
+        }
+    }
+    checkLength(pixels.size() / 4, 0, 0);
+    checkLength(pixels.size() / 4 - 3, 1, 1);
+
+    printf("dispatched kernels: %d mismatches\n", mismatches);
+    ENGINE_CHECK(mismatches == 0);
+}
+
+double megabytesPerSecond(size_t bytes, double milliseconds)
+{
+    return bytes / (1024.0 * 1024.0) / (milliseconds / 1000);
+}
+
+void benchmark(std::mt19937& random)
+{
+    const ssize_t pixelCount = 2048 * 2048;
+    const int ROUNDS = 10;
+    auto pixels = randomPixels(pixelCount, random);
+    std::vector<unsigned char> out(pixelCount * 2);
+
+    auto measure = [&](bool simd, const std::function<void()>& kernel) {
+        PixelUtils::setSIMDEnabled(simd);
+        kernel();
+        enginetest::Stopwatch stopwatch;
+        for (int i = 0; i < ROUNDS; ++i)
+            kernel();
+        return megabytesPerSecond(pixelCount * 4 * ROUNDS, stopwatch.getMilliseconds());
+    };
+
+    printf("2048x2048 RGBA8888 input, MB/s scalar -> %s\n", PixelUtils::isSIMDSupported() ? "SIMD" : "SIMD (not supported)");
+    for (const auto& conversion : CONVERSIONS)
+    {
+        auto kernel = [&]() { conversion.dispatched(pixels.data(), pixelCount, out.data()); };
+        double scalar = measure(false, kernel);
+        double simd = measure(true, kernel);
+        printf("  %-12s %8.0f -> %8.0f\n", conversion.name, scalar, simd);
+    }
+    auto premultiply = [&]() { PixelUtils::premultiplyAlpha(pixels.data(), pixelCount); };
+    double scalar = measure(false, premultiply);
+    double simd = measure(true, premultiply);
+    printf("  %-12s %8.0f -> %8.0f\n", "premultiply", scalar, simd);
+}
+
+}
+
+int main()
+{
+    std::mt19937 random(29);
+    printf("SIMD supported: %s\n", PixelUtils::isSIMDSupported() ? "yes" : "no");
+    PixelUtils::setSIMDEnabled(true);
+
+    auto pixels = allCombinations();
+    testScalarReference(pixels);
+    testDispatchedKernels(pixels);
+    auto noise = randomPixels(100003, random);
+    testDispatchedKernels(noise);
+
+    benchmark(random);
+    PixelUtils::setSIMDEnabled(true);
+
+    return enginetest::result("PixelUtilsTest");
+}
@@ -0,0 +1,194 @@
+/****************************************************************************
+Copyright (c) 2019 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+// Checks how the scheduler fires timers: how often, in which order within a frame, while paused, and when
+// they are scheduled or unscheduled from a callback. Then times a frame with 100k timers registered.
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include "base/CCScheduler.h"
+#include "EngineTest.h"
+
+USING_NS_CC;
+
+namespace {
+
+const float FRAME = 1.0f / 60;
+
+void runFrames(Scheduler* scheduler, int frames)
+{
+    for (int i = 0; i < frames; ++i)
+        scheduler->update(FRAME);
+}
+
+void testFireCounts()
+{
+    Scheduler scheduler;
+    const float intervals[] = { 0.0f, 0.1f, 0.25f, 0.5f, 1.0f, 3.0f };
+    int counts[6] = {};
+    char targets[6];
+    for (int i = 0; i < 6; ++i)
+    {
+        int* count = &counts[i];
+        scheduler.schedule([count](float) { ++*count; }, &targets[i], intervals[i], false, "count");
+    }
+    runFrames(&scheduler, 600);
+
+    // the first update after scheduling only starts a timer, it then fires on the first frame where its interval
+    // has passed
+    printf("fire counts over 600 frames:");
+    for (int i = 0; i < 6; ++i)
+        printf(" %g s: %d", intervals[i], counts[i]);
+    printf("\n");
+    ENGINE_CHECK(counts[0] == 599);
+    for (int i = 1; i < 6; ++i)
+    {
+        int lowest = static_cast<int>(10.0f / (intervals[i] + FRAME));
+        int highest = static_cast<int>(10.0f / intervals[i]);
+        if (!ENGINE_CHECK(counts[i] >= lowest && counts[i] <= highest))
+            printf("interval %g fired %d times, expected %d to %d\n", intervals[i], counts[i], lowest, highest);
+    }
+
+    // repeat and delay
+    int repeated = 0;
+    char target;
+    scheduler.schedule([&repeated](float) { ++repeated; }, &target, 0.1f, 4, 1.0f, false, "repeat");
+    runFrames(&scheduler, 50);
+    ENGINE_CHECK(repeated == 0);
+    runFrames(&scheduler, 60);
+    ENGINE_CHECK(repeated == 5);
+    runFrames(&scheduler, 60);
+    ENGINE_CHECK(repeated == 5);
+}
+
+void testPause()
+{
+    Scheduler scheduler;
+    int count = 0;
+    char target;
+    scheduler.schedule([&count](float) { ++count; }, &target, 1.0f, false, "pause");
+    runFrames(&scheduler, 150);
+    ENGINE_CHECK(count == 2);
+
+    // the time spent paused doesn't count towards the interval
+    scheduler.pauseTarget(&target);
+    runFrames(&scheduler, 600);
+    ENGINE_CHECK(count == 2);
+    scheduler.resumeTarget(&target);
+    runFrames(&scheduler, 20);
+    ENGINE_CHECK(count == 2);
+    runFrames(&scheduler, 20);
+    ENGINE_CHECK(count == 3);
+}
+
+void testOrderWithinFrame()
+{
+    Scheduler scheduler;
+    std::vector<int> fired;
+    const float intervals[] = { 0.3f, 0.1f, 0.2f, 0.1f };
+    char targets[4];
+    for (int i = 0; i < 4; ++i)
+        scheduler.schedule([&fired, i](float) { fired.push_back(i); }, &targets[i], intervals[i], 0, 0, false, "order");
+
+    // all four are due in the same frame, they fire by deadline and in scheduling order on ties
+    scheduler.update(FRAME);
+    scheduler.update(0.5f);
+    std::vector<int> expected = { 1, 3, 2, 0 };
+    ENGINE_CHECK(fired == expected);
+}
+
+void testChangesFromCallbacks()
+{
+    Scheduler scheduler;
+    char first;
+    char second;
+    char late;
+    int secondCount = 0;
+    int lateCount = 0;
+
+    // unscheduling a timer that is due in the same frame keeps it from firing
+    scheduler.schedule([&](float) { scheduler.unschedule("second", &second); }, &first, 0, 0, 0, false, "first");
+    scheduler.schedule([&](float) { ++secondCount; }, &second, 0, false, "second");
+    scheduler.update(FRAME);
+    ENGINE_CHECK(secondCount == 0);
+
+    // a timer scheduled by a callback is started on the next frame and first fires on the one after, like
+    // any timer it takes one update to start
+    int schedulerCount = 0;
+    scheduler.schedule([&](float) {
+        ++schedulerCount;
+        scheduler.schedule([&](float) { ++lateCount; }, &late, 0, 0, 0, false, "late");
+    }, &first, 0, 0, 0, false, "scheduler");
+    scheduler.update(FRAME);
+    scheduler.update(FRAME);
+    ENGINE_CHECK(schedulerCount == 1);
+    scheduler.update(FRAME);
+    ENGINE_CHECK(lateCount == 0);
+    scheduler.update(FRAME);
+    ENGINE_CHECK(lateCount == 1);
+
+    // a timer may unschedule itself
+    int selfCount = 0;
+    scheduler.schedule([&](float) {
+        ++selfCount;
+        scheduler.unschedule("self", &first);
+    }, &first, 0, false, "self");
+    runFrames(&scheduler, 3);
+    ENGINE_CHECK(selfCount == 1);
+}
+
+void benchmarkManyTimers()
+{
+    const int TIMER_COUNT = 100000;
+    Scheduler scheduler;
+    std::vector<char> targets(TIMER_COUNT);
+    std::mt19937 random(31);
+    long fired = 0;
+    for (int i = 0; i < TIMER_COUNT; ++i)
+    {
+        float interval = 50 + (random() % 1000) / 100.0f;
+        scheduler.schedule([&fired](float) { ++fired; }, &targets[i], interval, false, "timer");
+    }
+
+    // 62 seconds at 60 fps, nearly every timer fires once
+    const int FRAMES = 62 * 60;
+    enginetest::Stopwatch stopwatch;
+    runFrames(&scheduler, FRAMES);
+    printf("%d timers of 50-60 s: %.3f ms per frame, %ld fired\n", TIMER_COUNT, stopwatch.getMilliseconds() / FRAMES, fired);
+    ENGINE_CHECK(fired == TIMER_COUNT);
+}
+
+}
+
+int main()
+{
+    testFireCounts();
+    testPause();
+    testOrderWithinFrame();
+    testChangesFromCallbacks();
+    benchmarkManyTimers();
+    return enginetest::result("SchedulerTimerTest");
+}
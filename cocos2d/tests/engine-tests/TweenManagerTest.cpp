@@ -0,0 +1,220 @@
+/****************************************************************************
+Copyright (c) 2019 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+// Runs the same MoveTo + FadeTo animations through ActionManager and TweenManager and compares the
+// nodes frame by frame, checks that tweens follow the pause and cleanup rules of actions, then times
+// 50k animated nodes with both.
+
+#include <random>
+#include <vector>
+
+#include "cocos2d.h"
+#include "EngineTest.h"
+
+USING_NS_CC;
+
+namespace {
+
+const float FRAME = 1.0f / 60;
+
+std::vector<Node*> createRunningNodes(int count)
+{
+    std::vector<Node*> nodes;
+    nodes.reserve(count);
+    for (int i = 0; i < count; ++i)
+    {
+        auto node = Node::create();
+        node->retain();
+        // tweens and actions only advance on running nodes
+        node->onEnter();
+        nodes.push_back(node);
+    }
+    PoolManager::getInstance()->getCurrentPool()->clear();
+    return nodes;
+}
+
+void destroyNodes(std::vector<Node*>& nodes)
+{
+    for (auto node : nodes)
+    {
+        node->onExit();
+        node->cleanup();
+        node->release();
+    }
+    nodes.clear();
+}
+
+void testSameAsActions()
+{
+    const int COUNT = 200;
+    std::mt19937 random(33);
+    auto actionNodes = createRunningNodes(COUNT);
+    auto tweenNodes = createRunningNodes(COUNT);
+    ActionManager actionManager;
+    TweenManager tweenManager;
+
+    float longest = 0;
+    for (int i = 0; i < COUNT; ++i)
+    {
+        Vec2 start(random() % 500, random() % 500);
+        Vec2 end(random() % 500, random() % 500);
+        float duration = 0.1f + (random() % 200) / 100.0f;
+        GLubyte opacity = random() % 256;
+        longest = std::max(longest, duration);
+
+        actionNodes[i]->setPosition(start);
+        tweenNodes[i]->setPosition(start);
+        actionManager.addAction(MoveTo::create(duration, end), actionNodes[i], false);
+        actionManager.addAction(FadeTo::create(duration / 2, opacity), actionNodes[i], false);
+        tweenManager.moveTo(tweenNodes[i], duration, end);
+        tweenManager.fadeTo(tweenNodes[i], duration / 2, opacity);
+    }
+    ENGINE_CHECK(tweenManager.getNumberOfRunningTweens() == COUNT * 2);
+
+    // the two may be a frame apart while running, they have to agree at the end
+    float worstDistance = 0;
+    int frames = static_cast<int>(longest / FRAME) + 2;
+    for (int frame = 0; frame < frames; ++frame)
+    {
+        actionManager.update(FRAME);
+        tweenManager.update(FRAME);
+        for (int i = 0; i < COUNT; ++i)
+            worstDistance = std::max(worstDistance, actionNodes[i]->getPosition().distance(tweenNodes[i]->getPosition()));
+    }
+    int endMismatches = 0;
+    for (int i = 0; i < COUNT; ++i)
+    {
+        endMismatches += actionNodes[i]->getPosition() != tweenNodes[i]->getPosition();
+        endMismatches += actionNodes[i]->getOpacity() != tweenNodes[i]->getOpacity();
+    }
+    printf("actions vs tweens: worst distance while running %.2f points, %d mismatches at the end\n", worstDistance, endMismatches);
+    ENGINE_CHECK(endMismatches == 0);
+    // a frame of the fastest move: 500 * sqrt(2) points in 0.1 s
+    ENGINE_CHECK(worstDistance <= 500 * 1.415f * FRAME / 0.1f);
+    ENGINE_CHECK(tweenManager.getNumberOfRunningTweens() == 0);
+
+    destroyNodes(actionNodes);
+    destroyNodes(tweenNodes);
+}
+
+void testLifetime()
+{
+    // nodes forward pause, resume and cleanup to the tween manager of the director
+    auto tweenManager = Director::getInstance()->getTweenManager();
+    auto nodes = createRunningNodes(1);
+    auto node = nodes[0];
+
+    tweenManager->moveTo(node, 1.0f, Vec2(100, 0));
+    tweenManager->moveTo(node, 1.0f, Vec2(0, 100));
+    tweenManager->fadeTo(node, 1.0f, 0);
+    // a new tween of the same property replaces the running one
+    ENGINE_CHECK(tweenManager->getNumberOfRunningTweensInTarget(node) == 2);
+    ENGINE_CHECK(node->getReferenceCount() == 3);
+
+    tweenManager->update(0.5f);
+    Vec2 halfway = node->getPosition();
+    ENGINE_CHECK(halfway.x == 0 && halfway.y > 0 && halfway.y < 100);
+
+    node->pause();
+    tweenManager->update(0.25f);
+    ENGINE_CHECK(node->getPosition() == halfway);
+    node->resume();
+    tweenManager->update(0.25f);
+    ENGINE_CHECK(node->getPosition() != halfway);
+
+    tweenManager->removeTween(node, TweenManager::Property::OPACITY);
+    ENGINE_CHECK(!tweenManager->isTweening(node, TweenManager::Property::OPACITY));
+    node->cleanup();
+    ENGINE_CHECK(tweenManager->getNumberOfRunningTweensInTarget(node) == 0);
+    ENGINE_CHECK(node->getReferenceCount() == 1);
+
+    destroyNodes(nodes);
+}
+
+void benchmark()
+{
+    const int COUNT = 50000;
+    const int FRAMES = 120;
+    std::mt19937 random(50);
+
+    auto run = [&](const char* name, bool tweens) {
+        auto nodes = createRunningNodes(COUNT);
+        ActionManager actionManager;
+        TweenManager tweenManager;
+        enginetest::Stopwatch stopwatch;
+        for (auto node : nodes)
+        {
+            Vec2 end(random() % 1000, random() % 1000);
+            if (tweens)
+            {
+                tweenManager.moveTo(node, 2.5f, end);
+                tweenManager.fadeTo(node, 2.5f, 0);
+            }
+            else
+            {
+                actionManager.addAction(MoveTo::create(2.5f, end), node, false);
+                actionManager.addAction(FadeTo::create(2.5f, 0), node, false);
+            }
+        }
+        double startMilliseconds = stopwatch.getMilliseconds();
+        stopwatch.restart();
+        for (int frame = 0; frame < FRAMES; ++frame)
+        {
+            actionManager.update(FRAME);
+            tweenManager.update(FRAME);
+        }
+        printf("%s: starting %.2f ms, %.2f ms per frame\n", name, startMilliseconds, stopwatch.getMilliseconds() / FRAMES);
+        actionManager.removeAllActions();
+        tweenManager.removeAllTweens();
+        destroyNodes(nodes);
+    };
+
+    printf("%d nodes with MoveTo + FadeTo, %d frames\n", COUNT, FRAMES);
+    run("ActionManager", false);
+    run("TweenManager", true);
+
+    // the floor both share, the setters
+    auto nodes = createRunningNodes(COUNT);
+    enginetest::Stopwatch stopwatch;
+    for (int frame = 0; frame < FRAMES; ++frame)
+    {
+        for (auto node : nodes)
+        {
+            node->setPosition(frame, frame);
+            node->setOpacity(static_cast<GLubyte>(frame));
+        }
+    }
+    printf("setPosition + setOpacity only: %.2f ms per frame\n", stopwatch.getMilliseconds() / FRAMES);
+    destroyNodes(nodes);
+}
+
+}
+
+int main()
+{
+    testSameAsActions();
+    testLifetime();
+    benchmark();
+    return enginetest::result("TweenManagerTest");
+}
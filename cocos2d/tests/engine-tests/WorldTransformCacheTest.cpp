@@ -0,0 +1,206 @@
+/****************************************************************************
+Copyright (c) 2019 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+// Applies random edits to a forest of nodes, some of them protected children, and compares the cached world
+// transforms against a walk up the parents. Then times convertToNodeSpace() on deep leaves with and without
+// the cache.
+
+#include <random>
+#include <unordered_set>
+
+#include "cocos2d.h"
+#include "EngineTest.h"
+
+USING_NS_CC;
+
+namespace {
+
+std::mt19937 s_random(3);
+
+float randomFloat(float low, float high)
+{
+    return low + (high - low) * (s_random() % 10000) / 10000.0f;
+}
+
+bool nearlyEqual(const Mat4& a, const Mat4& b)
+{
+    for (int i = 0; i < 16; ++i)
+    {
+        if (std::abs(a.m[i] - b.m[i]) > 1e-3f * (1 + std::abs(a.m[i])))
+            return false;
+    }
+    return true;
+}
+
+std::unordered_set<Node*> s_protectedChildren;
+
+void detach(Node* node)
+{
+    if (!node->getParent())
+        return;
+    if (s_protectedChildren.erase(node))
+        static_cast<ProtectedNode*>(node->getParent())->removeProtectedChild(node);
+    else
+        node->removeFromParent();
+}
+
+void attach(Node* node, Node* parent)
+{
+    auto protectedParent = dynamic_cast<ProtectedNode*>(parent);
+    if (protectedParent && s_random() % 2)
+    {
+        protectedParent->addProtectedChild(node);
+        s_protectedChildren.insert(node);
+    }
+    else
+    {
+        parent->addChild(node);
+    }
+}
+
+void testRandomEdits()
+{
+    std::vector<Node*> nodes;
+    for (int i = 0; i < 300; ++i)
+    {
+        Node* node = s_random() % 4 ? Node::create() : ProtectedNode::create();
+        node->retain();
+        if (i > 0 && s_random() % 10)
+            attach(node, nodes[s_random() % nodes.size()]);
+        if (s_random() % 2)
+            node->setWorldTransformCacheEnabled(true);
+        nodes.push_back(node);
+    }
+
+    int checks = 0;
+    int mismatches = 0;
+    for (int round = 0; round < 20000; ++round)
+    {
+        auto node = nodes[s_random() % nodes.size()];
+        switch (s_random() % 12)
+        {
+        case 0: node->setPosition(randomFloat(-100, 100), randomFloat(-100, 100)); break;
+        case 1: node->setRotation(randomFloat(-180, 180)); break;
+        case 2: node->setScale(randomFloat(0.5f, 2)); break;
+        case 3: node->setAnchorPoint(Vec2(randomFloat(0, 1), randomFloat(0, 1))); break;
+        case 4: node->setContentSize(Size(randomFloat(1, 50), randomFloat(1, 50))); break;
+        case 5: node->setSkewX(randomFloat(-20, 20)); break;
+        case 6:
+        {
+            auto parent = nodes[s_random() % nodes.size()];
+            bool cycle = false;
+            for (auto ancestor = parent; ancestor; ancestor = ancestor->getParent())
+                cycle = cycle || ancestor == node;
+            if (!cycle)
+            {
+                detach(node);
+                attach(node, parent);
+            }
+            break;
+        }
+        case 7: detach(node); break;
+        case 8:
+        {
+            Mat4 translation;
+            Mat4::createTranslation(randomFloat(-5, 5), randomFloat(-5, 5), 0, &translation);
+            node->setAdditionalTransform(s_random() % 3 ? &translation : nullptr);
+            break;
+        }
+        case 9: node->setWorldTransformCacheEnabled(s_random() % 2 != 0); break;
+        case 10: node->setIgnoreAnchorPointForPosition(s_random() % 2 != 0); break;
+        default:
+            for (int i = 0; i < 3; ++i)
+            {
+                auto checked = nodes[s_random() % nodes.size()];
+                Mat4 walked = checked->getNodeToParentTransform(nullptr);
+                ++checks;
+                if (!nearlyEqual(checked->getNodeToWorldTransform(), walked))
+                    ++mismatches;
+                if (!nearlyEqual(checked->getWorldToNodeTransform(), walked.getInversed()))
+                    ++mismatches;
+            }
+        }
+    }
+    printf("%d transform checks, %d mismatches\n", checks, mismatches);
+    ENGINE_CHECK(mismatches == 0);
+
+    for (auto node : nodes)
+        detach(node);
+    for (auto node : nodes)
+        node->release();
+}
+
+void benchmarkDeepLeaves()
+{
+    auto root = Node::create();
+    root->retain();
+    std::vector<Node*> leaves;
+    Node* moving = nullptr;
+    for (int branch = 0; branch < 64; ++branch)
+    {
+        Node* parent = root;
+        for (int depth = 0; depth < 8; ++depth)
+        {
+            auto node = Node::create();
+            node->setPosition(randomFloat(0, 50), randomFloat(0, 50));
+            node->setRotation(randomFloat(-10, 10));
+            node->setScale(randomFloat(0.9f, 1.1f));
+            parent->addChild(node);
+            parent = node;
+        }
+        if (branch == 0)
+            moving = parent->getParent();
+        leaves.push_back(parent);
+    }
+
+    auto run = [&](const char* name) {
+        float sum = 0;
+        enginetest::Stopwatch stopwatch;
+        for (int frame = 0; frame < 2000; ++frame)
+        {
+            moving->setPosition(randomFloat(0, 50), randomFloat(0, 50));
+            for (int i = 0; i < 4; ++i)
+            {
+                for (auto leaf : leaves)
+                    sum += leaf->convertToNodeSpace(Vec2(100, 200)).x;
+            }
+        }
+        printf("%s: %.2f us per frame of 256 conversions (%g)\n", name, stopwatch.getMilliseconds() * 1000 / 2000, sum);
+    };
+    run("walking parents");
+    for (auto leaf : leaves)
+        leaf->setWorldTransformCacheEnabled(true);
+    run("cached leaves");
+
+    root->release();
+}
+
+}
+
+int main()
+{
+    testRandomEdits();
+    benchmarkDeepLeaves();
+    return enginetest::result("WorldTransformCacheTest");
+}
@@ -0,0 +1,78 @@
+#!/usr/bin/python
+# pack-assets.py
+# Packs resource folders into an asset pack which can be mounted with FileUtils::mountAssetPack.
+#
+# An asset pack is a plain zip archive. Files are stored uncompressed by default, so the engine
+# can return them as views into the mapped archive without copying; use --deflate for text files
+# you want smaller on disk (they are inflated into a heap buffer on every read).
+#
+# usage: pack-assets.py -o res/cards.pack Resources/res [--root Resources] [--deflate json,plist]
+
+import argparse
+import os
+import sys
+import zipfile
+
+
+def collect_files(folders, root):
+    files = []
+    for folder in folders:
+        for dir_path, dir_names, file_names in os.walk(folder):
+            dir_names.sort()
+            for file_name in sorted(file_names):
+                if file_name.startswith('.'):
+                    continue
+                full_path = os.path.join(dir_path, file_name)
+                # entry names use '/' and are relative to the mount point
+                name = os.path.relpath(full_path, root).replace(os.sep, '/')
+                files.append((full_path, name))
+    return files
+
+
+def pack(output, files, deflate_exts):
+    output_dir = os.path.dirname(output)
+    if output_dir and not os.path.isdir(output_dir):
+        os.makedirs(output_dir)
+
+    names = set()
+    with zipfile.ZipFile(output, 'w', zipfile.ZIP_STORED, allowZip64=False) as archive:
+        for full_path, name in files:
+            if name in names:
+                print('warning: %s is packed twice, keeping the first one' % name)
+                continue
+            names.add(name)
+
+            ext = os.path.splitext(name)[1][1:].lower()
+            compress_type = zipfile.ZIP_DEFLATED if ext in deflate_exts else zipfile.ZIP_STORED
+            archive.write(full_path, name, compress_type)
+
+    print('packed %d files into %s' % (len(names), output))
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Packs resource folders into an asset pack.')
+    parser.add_argument('folders', nargs='+', help='folders to pack')
+    parser.add_argument('-o', '--output', required=True, help='path of the pack to write')
+    parser.add_argument('--root', help='entry names are relative to this folder, defaults to the parent of each folder')
+    parser.add_argument('--deflate', default='', help='comma separated extensions to compress, e.g. json,plist')
+    args = parser.parse_args()
+
+    files = []
+    for folder in args.folders:
+        if not os.path.isdir(folder):
+            print('error: %s is not a folder' % folder)
+            return 1
+        root = args.root if args.root else os.path.dirname(os.path.abspath(folder))
+        files.extend(collect_files([folder], root))
+
+    if len(files) >= 0xffff:
+        print('error: %d files, asset packs support at most 65534 files' % len(files))
+        return 1
+
+    deflate_exts = set(ext.strip().lower() for ext in args.deflate.split(',') if ext.strip())
+    pack(args.output, files, deflate_exts)
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())